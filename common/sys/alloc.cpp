@@ -45,6 +45,9 @@ namespace embree
   }
 
   // FIXME: implement large pages under Windows
+  HugePageMode os_set_huge_pages(HugePageMode mode) {
+    return HUGEPAGES_OFF;
+  }
   
   void* os_malloc(size_t bytes, const int additional_flags) 
   {
@@ -83,6 +86,30 @@ namespace embree
   void* os_realloc (void* ptr, size_t bytesNew, size_t bytesOld) {
     NOT_IMPLEMENTED;
   }
+
+  // FIXME: use VirtualAllocExNuma when reserving the memory
+  void os_bind(void* ptr, size_t bytes, size_t node) {
+  }
+
+  void* os_map_file(const char* fileName, size_t& bytes)
+  {
+    HANDLE file = CreateFileA(fileName,GENERIC_READ,FILE_SHARE_READ,nullptr,OPEN_EXISTING,FILE_ATTRIBUTE_NORMAL,nullptr);
+    if (file == INVALID_HANDLE_VALUE) return nullptr;
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file,&size) || size.QuadPart == 0) { CloseHandle(file); return nullptr; }
+    HANDLE mapping = CreateFileMappingA(file,nullptr,PAGE_WRITECOPY,0,0,nullptr);
+    CloseHandle(file);
+    if (mapping == nullptr) return nullptr;
+    void* ptr = MapViewOfFile(mapping,FILE_MAP_COPY,0,0,0);
+    CloseHandle(mapping);
+    if (ptr == nullptr) return nullptr;
+    bytes = size.QuadPart;
+    return ptr;
+  }
+
+  void os_unmap_file(void* ptr, size_t bytes) {
+    if (ptr) UnmapViewOfFile(ptr);
+  }
 }
 #endif
 
@@ -92,15 +119,17 @@ namespace embree
 
 #if defined(__UNIX__)
 
+#include <stdio.h>
 #include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
 #include <errno.h>
 #include <stdlib.h>
 #include <string.h>
 
-#if defined(__MIC__)
-#define USE_HUGE_PAGES 1
-#else
-#define USE_HUGE_PAGES 0
+#if defined(__LINUX__)
+#include <sys/syscall.h>
 #endif
 
 namespace embree
@@ -119,43 +148,121 @@ namespace embree
     free((void*)ptr);
   }
 
-  void* os_malloc(size_t bytes, const int additional_flags)
+  static const size_t hugePageSize = 2*1024*1024;
+
+#if defined(__MIC__)
+  static HugePageMode hugePageMode = HUGEPAGES_ON;
+#else
+  static HugePageMode hugePageMode = HUGEPAGES_AUTO;
+#endif
+
+  /*! large allocations can get backed by huge pages, independent of the mode they always span full huge pages */
+  static __forceinline bool isHugePageCandidate(size_t bytes) {
+#if defined(__MIC__)
+    return bytes > 16*4096;
+#else
+    return bytes >= hugePageSize;
+#endif
+  }
+
+  /*! returns the number of bytes mapped for an allocation */
+  static __forceinline size_t mappedBytes(size_t bytes) 
   {
-    int flags = MAP_PRIVATE | MAP_ANON | additional_flags;
-#if USE_HUGE_PAGES
-    if (bytes > 16*4096) {
-      flags |= MAP_HUGETLB;
-      bytes = (bytes+2*1024*1024-1)&ssize_t(-2*1024*1024);
-    } else {
-      bytes = (bytes+4095)&ssize_t(-4096);
+    if (isHugePageCandidate(bytes)) return (bytes+hugePageSize-1) & ~(hugePageSize-1);
+    else                            return (bytes+4095) & ~size_t(4095);
+  }
+
+#if defined(__LINUX__) && !defined(__MIC__)
+
+  /*! returns the value of some entry of /proc/meminfo, 0 if not present */
+  static size_t readMemInfo(const char* key)
+  {
+    FILE* file = fopen("/proc/meminfo","r");
+    if (file == nullptr) return 0;
+    char line[256]; size_t value = 0;
+    while (fgets(line,sizeof(line),file)) {
+      if (strncmp(line,key,strlen(key)) != 0) continue;
+      value = strtoull(line+strlen(key),nullptr,10);
+      break;
     }
+    fclose(file);
+    return value;
+  }
+
+  /*! transparent huge pages can get disabled system wide */
+  static bool transparentHugePagesEnabled()
+  {
+    FILE* file = fopen("/sys/kernel/mm/transparent_hugepage/enabled","r");
+    if (file == nullptr) return false;
+    char line[256];
+    const bool enabled = fgets(line,sizeof(line),file) && strstr(line,"[never]") == nullptr;
+    fclose(file);
+    return enabled;
+  }
+
 #endif
-#if __MIC__
-    flags |= MAP_POPULATE;
+
+  HugePageMode os_set_huge_pages(HugePageMode mode)
+  {
+#if defined(__LINUX__) && !defined(__MIC__)
+    /* reserved huge pages need a pool of free 2MB pages */
+    if (mode == HUGEPAGES_ON && (readMemInfo("Hugepagesize:") != hugePageSize/1024 || readMemInfo("HugePages_Free:") == 0))
+      mode = HUGEPAGES_AUTO;
+    if (mode == HUGEPAGES_AUTO && !transparentHugePagesEnabled())
+      mode = HUGEPAGES_OFF;
+#elif !defined(__MIC__)
+    mode = HUGEPAGES_OFF;
+#endif
+    hugePageMode = mode;
+    return mode;
+  }
+
+  /*! maps pages of an allocation that is already rounded to full pages */
+  static void* mapPages(size_t bytes, int flags)
+  {
+    if (isHugePageCandidate(bytes) && hugePageMode != HUGEPAGES_OFF)
+    {
+      /* reserved huge pages get committed by mmap, thus a too small pool makes the call fail and not a later page fault */
+      if (hugePageMode == HUGEPAGES_ON) {
+        char* ptr = (char*) mmap(0, bytes, PROT_READ | PROT_WRITE, (flags & ~MAP_NORESERVE) | MAP_HUGETLB, -1, 0);
+        if (ptr != nullptr && ptr != MAP_FAILED) return ptr;
+      }
+
+#if !defined(__MIC__)
+      /* transparent huge pages only back aligned 2MB ranges, thus we map more and unmap the unaligned head and tail */
+      char* ptr = (char*) mmap(0, bytes+hugePageSize, PROT_READ | PROT_WRITE, flags, -1, 0);
+      if (ptr == nullptr || ptr == MAP_FAILED) throw std::bad_alloc();
+      char* aligned = (char*) (((size_t)ptr+hugePageSize-1) & ~(hugePageSize-1));
+      if (aligned != ptr) munmap(ptr,aligned-ptr);
+      munmap(aligned+bytes,ptr+hugePageSize-aligned);
+#if defined(MADV_HUGEPAGE)
+      madvise(aligned,bytes,MADV_HUGEPAGE);
 #endif
+      return aligned;
+#endif
+    }
+
     char* ptr = (char*) mmap(0, bytes, PROT_READ | PROT_WRITE, flags, -1, 0);
     if (ptr == nullptr || ptr == MAP_FAILED) throw std::bad_alloc();
     return ptr;
   }
 
+  void* os_malloc(size_t bytes, const int additional_flags)
+  {
+    int flags = MAP_PRIVATE | MAP_ANON | additional_flags;
+#if __MIC__
+    flags |= MAP_POPULATE;
+#endif
+    return mapPages(mappedBytes(bytes),flags);
+  }
+
   void* os_reserve(size_t bytes)
   {
     int flags = MAP_PRIVATE | MAP_ANON | MAP_NORESERVE;
-#if USE_HUGE_PAGES
-    if (bytes > 16*4096) {
-      flags |= MAP_HUGETLB;
-      bytes = (bytes+2*1024*1024-1)&ssize_t(-2*1024*1024);
-    } else {
-      bytes = (bytes+4095)&ssize_t(-4096);
-    }
-#endif
 #if __MIC__ // || 1
     flags |= MAP_POPULATE;
 #endif
-
-    char* ptr = (char*) mmap(0, bytes, PROT_READ | PROT_WRITE, flags, -1, 0);
-    if (ptr == nullptr || ptr == MAP_FAILED) throw std::bad_alloc();
-    return ptr;
+    return mapPages(mappedBytes(bytes),flags);
   }
 
   void os_commit (void* ptr, size_t bytes) {
@@ -163,16 +270,20 @@ namespace embree
 
   size_t os_shrink(void* ptr, size_t bytesNew, size_t bytesOld) 
   {
-    size_t pageSize = 4096;
-#if USE_HUGE_PAGES
-    if (bytesOld > 16*4096) pageSize = 2*1024*1024;
-#endif
-    bytesNew = (bytesNew+pageSize-1) & ~(pageSize-1);
+    bytesOld = mappedBytes(bytesOld);
+    bytesNew = mappedBytes(bytesNew);
     assert(bytesNew <= bytesOld);
-    if (bytesNew < bytesOld)
-      if (munmap((char*)ptr+bytesNew,bytesOld-bytesNew) == -1)
-        throw std::bad_alloc();
+    if (bytesNew == bytesOld) 
+      return bytesNew;
 
+    /* transparent huge pages get split, but reserved huge pages can only get unmapped in full */
+    if (munmap((char*)ptr+bytesNew,bytesOld-bytesNew) == -1) 
+    {
+      bytesNew = (bytesNew+hugePageSize-1) & ~(hugePageSize-1);
+      if (bytesNew < bytesOld)
+        if (munmap((char*)ptr+bytesNew,bytesOld-bytesNew) == -1)
+          throw std::bad_alloc();
+    }
     return bytesNew;
   }
 
@@ -181,14 +292,7 @@ namespace embree
     if (bytes == 0)
       return;
 
-#if USE_HUGE_PAGES
-    if (bytes > 16*4096) {
-      bytes = (bytes+2*1024*1024-1)&ssize_t(-2*1024*1024);
-    } else {
-      bytes = (bytes+4095)&ssize_t(-4096);
-    }
-#endif
-    if (munmap(ptr,bytes) == -1)
+    if (munmap(ptr,mappedBytes(bytes)) == -1)
       throw std::bad_alloc();
   }
 
@@ -218,6 +322,41 @@ namespace embree
 #endif
 
   }
+
+  void os_bind(void* ptr, size_t bytes, size_t node)
+  {
+    /* we call mbind directly to not depend on libnuma, a failing call only loses the placement hint */
+#if defined(__LINUX__) && defined(SYS_mbind) && !defined(__MIC__)
+    const int MPOL_PREFERRED = 1;
+    unsigned long mask[4] = { 0, 0, 0, 0 };
+    if (node >= 8*sizeof(mask)) return;
+    mask[node/(8*sizeof(unsigned long))] = 1ul << (node%(8*sizeof(unsigned long)));
+    size_t pageSize = 4096;
+    char* begin = (char*)((size_t)ptr & ~(pageSize-1));
+    char* end   = (char*)ptr + bytes;
+    syscall(SYS_mbind,begin,end-begin,MPOL_PREFERRED,mask,8*sizeof(mask),0);
+#endif
+  }
+
+  void* os_map_file(const char* fileName, size_t& bytes)
+  {
+    int fd = open(fileName,O_RDONLY);
+    if (fd == -1) return nullptr;
+    struct stat st;
+    if (fstat(fd,&st) == -1 || st.st_size == 0) { close(fd); return nullptr; }
+    char* ptr = (char*) mmap(0, st.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (ptr == nullptr || ptr == MAP_FAILED) return nullptr;
+    bytes = st.st_size;
+    return ptr;
+  }
+
+  void os_unmap_file(void* ptr, size_t bytes) 
+  {
+    if (ptr == nullptr) return;
+    if (munmap(ptr,bytes) == -1)
+      throw std::bad_alloc();
+  }
 }
 
 #endif
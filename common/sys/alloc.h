@@ -84,6 +84,12 @@ namespace embree
       }
     };
 
+  /*! pages backing large OS allocations, auto advises the OS to use transparent huge pages, on first tries reserved huge pages */
+  enum HugePageMode { HUGEPAGES_OFF = 0, HUGEPAGES_AUTO = 1, HUGEPAGES_ON = 2 };
+
+  /*! selects the pages of all following large OS allocations, returns the mode the system supports */
+  HugePageMode os_set_huge_pages(HugePageMode mode);
+
   /*! allocates pages directly from OS */
   void* os_malloc (size_t bytes, const int additional_flags = 0);
   void* os_reserve(size_t bytes);
@@ -92,6 +98,13 @@ namespace embree
   void  os_free   (void* ptr, size_t bytes);
   void* os_realloc(void* ptr, size_t bytesNew, size_t bytesOld); // FIXME: remove, not used and not implemented completely
 
+  /*! prefers physical pages of the specified NUMA node for a reserved range, has no effect on single node systems */
+  void  os_bind(void* ptr, size_t bytes, size_t node);
+
+  /*! maps a file copy-on-write into memory, returns nullptr if the file cannot get mapped */
+  void* os_map_file  (const char* fileName, size_t& bytes);
+  void  os_unmap_file(void* ptr, size_t bytes);
+
   /*! allocator that performs OS allocations */
   template<typename T>
     struct os_allocator
@@ -319,6 +319,18 @@ namespace embree
     if (isa == AVX512KNL) return "AVX512KNL";
     return "UNKNOWN";
   }
+
+  static __thread size_t threadNumaNode = 0;
+  static __thread size_t threadNumaNodeQueries = 0;
+
+  size_t getThreadNumaNode()
+  {
+    if (unlikely(threadNumaNodeQueries-- == 0)) {
+      threadNumaNode = getNumaNode();
+      threadNumaNodeQueries = 4096;
+    }
+    return threadNumaNode;
+  }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -372,6 +384,23 @@ namespace embree
     return nThreads;
   }
 
+  size_t getNumberOfNumaNodes()
+  {
+    static int nNodes = -1;
+    if (nNodes != -1) return nNodes;
+    ULONG highestNode = 0;
+    if (!GetNumaHighestNodeNumber(&highestNode)) highestNode = 0;
+    nNodes = highestNode+1;
+    return nNodes;
+  }
+
+  size_t getNumaNode()
+  {
+    UCHAR node = 0;
+    if (!GetNumaProcessorNode((UCHAR)GetCurrentProcessorNumber(),&node)) return 0;
+    return node < getNumberOfNumaNodes() ? node : 0;
+  }
+
   int getTerminalWidth() 
   {
     HANDLE handle = GetStdHandle(STD_OUTPUT_HANDLE);
@@ -398,6 +427,7 @@ namespace embree
 
 #include <stdio.h>
 #include <unistd.h>
+#include <sys/syscall.h>
 
 namespace embree
 {
@@ -409,6 +439,30 @@ namespace embree
     if (bytes != -1) buf[bytes] = '\0';
     return std::string(buf);
   }
+
+  size_t getNumberOfNumaNodes()
+  {
+    static int nNodes = -1;
+    if (nNodes != -1) return nNodes;
+    int n = 0;
+    for (char dir[64]; n<1024; n++) {
+      sprintf(dir, "/sys/devices/system/node/node%d", n);
+      if (access(dir, F_OK) != 0) break;
+    }
+    nNodes = n > 0 ? n : 1;
+    return nNodes;
+  }
+
+  size_t getNumaNode()
+  {
+#if defined(SYS_getcpu)
+    unsigned cpu = 0, node = 0;
+    if (syscall(SYS_getcpu,&cpu,&node,nullptr) != 0) return 0;
+    return node < getNumberOfNumaNodes() ? node : 0;
+#else
+    return 0;
+#endif
+  }
 }
 
 #endif
@@ -430,6 +484,14 @@ namespace embree
     if (_NSGetExecutablePath(buf, &size) != 0) return std::string();
     return std::string(buf);
   }
+
+  size_t getNumberOfNumaNodes() {
+    return 1;
+  }
+
+  size_t getNumaNode() {
+    return 0;
+  }
 }
 
 #endif
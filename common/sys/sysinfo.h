@@ -164,6 +164,15 @@ namespace embree
 
   /*! return the number of logical threads of the system */
   size_t getNumberOfLogicalThreads();
+
+  /*! returns the number of NUMA nodes of the system */
+  size_t getNumberOfNumaNodes();
+
+  /*! returns the NUMA node the calling thread currently runs on */
+  size_t getNumaNode();
+
+  /*! returns the NUMA node of the calling thread, cached per thread and refreshed from time to time as threads may migrate */
+  size_t getThreadNumaNode();
   
   /*! returns the size of the terminal window in characters */
   int getTerminalWidth();
@@ -23,6 +23,9 @@
 /*! invalid geometry ID */
 #define RTC_INVALID_GEOMETRY_ID ((unsigned)-1)
 
+/*! maximal number of time steps of motion blurred geometries */
+#define RTC_MAX_TIME_STEPS 16
+
 /*! \brief Specifies the type of buffers when mapping buffers */
 enum RTCBufferType {
   RTC_INDEX_BUFFER         = 0x01000000,
@@ -45,6 +48,10 @@ enum RTCBufferType {
   RTC_VERTEX_CREASE_WEIGHT_BUFFER = 0x08000000,
 
   RTC_HOLE_BUFFER          = 0x09000001,
+
+  RTC_TRANSFORM_BUFFER     = 0x0A000000,
+  RTC_INSTANCE_MASK_BUFFER = 0x0B000000,
+  RTC_INSTANCE_ID_BUFFER   = 0x0C000000,
 };
 
 /*! \brief Supported types of matrix layout for functions involving matrices */
@@ -122,6 +129,37 @@ RTCORE_API unsigned rtcNewInstance (RTCScene target,                  //!< the s
                                     RTCScene source                   //!< the scene to instantiate
   );
 
+/*! \brief Creates a new motion blurred scene instance. 
+
+  Same as rtcNewInstance, but the instance gets numTimeSteps many
+  local to world transformations (1 for normal instances, and 2 or
+  more for motion blur) that have to get set through
+  rtcSetTransform2. The timesteps are distributed uniformly over the
+  [0,1] shutter interval and the transformation for the ray time gets
+  linearly interpolated between the two neighbouring timesteps. */
+RTCORE_API unsigned rtcNewInstance2 (RTCScene target,                 //!< the scene the instance belongs to
+                                     RTCScene source,                 //!< the scene to instantiate
+                                     size_t numTimeSteps = 1          //!< number of motion blur time steps
+  );
+
+/*! \brief Creates a new array of scene instances. 
+
+  An instance array instantiates the source scene numInstances many
+  times using a single geometry. The local to world transformations
+  of the instances have to get specified through the transform buffer
+  (RTC_TRANSFORM_BUFFER) as column major 3x4 matrices of 12 floats
+  each. Optionally, the application can set a per instance ray mask
+  through the instance mask buffer (RTC_INSTANCE_MASK_BUFFER) and a
+  per instance ID through the instance ID buffer
+  (RTC_INSTANCE_ID_BUFFER). If any geometry is hit, the instance ID
+  (instID) member of the ray will get set to the ID stored in the
+  instance ID buffer, or to the index of the hit instance inside the
+  array if no instance ID buffer is set. */
+RTCORE_API unsigned rtcNewInstanceArray (RTCScene target,             //!< the scene the instance array belongs to
+                                         RTCScene source,             //!< the scene to instantiate
+                                         size_t numInstances          //!< number of instances of the array
+  );
+
 /*! \brief Sets transformation of the instance */
 RTCORE_API void rtcSetTransform (RTCScene scene,                          //!< scene handle
                                  unsigned geomID,                         //!< ID of geometry
@@ -129,19 +167,31 @@ RTCORE_API void rtcSetTransform (RTCScene scene,                          //!< s
                                  const float* xfm                         //!< transformation matrix
                                  );
 
+/*! \brief Sets transformation of some timestep of a motion blurred instance */
+RTCORE_API void rtcSetTransform2 (RTCScene scene,                         //!< scene handle
+                                  unsigned geomID,                        //!< ID of geometry
+                                  RTCMatrixType layout,                   //!< layout of transformation matrix
+                                  const float* xfm,                       //!< transformation matrix
+                                  size_t timeStep = 0                     //!< timestep to set the transformation for
+                                  );
+
 /*! \brief Creates a new triangle mesh. The number of triangles
   (numTriangles), number of vertices (numVertices), and number of time
-  steps (1 for normal meshes, and 2 for linear motion blur), have to
+  steps (1 for normal meshes, and 2 or more for motion blur), have to
   get specified. The triangle indices can be set be mapping and
   writing to the index buffer (RTC_INDEX_BUFFER) and the triangle
   vertices can be set by mapping and writing into the vertex buffer
   (RTC_VERTEX_BUFFER). In case of linear motion blur, two vertex
   buffers have to get filled (RTC_VERTEX_BUFFER0, RTC_VERTEX_BUFFER1),
-  one for each time step. The index buffer has the default layout of
-  three 32 bit integer indices for each triangle. An index points to
-  the ith vertex. The vertex buffer stores single precision x,y,z
-  floating point coordinates aligned to 16 bytes. The value of the 4th
-  float used for alignment can be arbitrary. */
+  one for each time step. For multi segment motion blur up to
+  RTC_MAX_TIME_STEPS time steps are supported, the vertex buffer of
+  time step t is RTC_VERTEX_BUFFER0+t and the time steps are
+  distributed uniformly over the [0,1] shutter interval. The index
+  buffer has the default layout of three 32 bit integer indices for
+  each triangle. An index points to the ith vertex. The vertex buffer
+  stores single precision x,y,z floating point coordinates aligned to
+  16 bytes. The value of the 4th float used for alignment can be
+  arbitrary. */
 RTCORE_API unsigned rtcNewTriangleMesh (RTCScene scene,                    //!< the scene the mesh belongs to
                                         RTCGeometryFlags flags,            //!< geometry flags
                                         size_t numTriangles,               //!< number of triangles
@@ -149,6 +199,25 @@ RTCORE_API unsigned rtcNewTriangleMesh (RTCScene scene,                    //!<
                                         size_t numTimeSteps = 1            //!< number of motion blur time steps
   );
 
+/*! \brief Creates a new quad mesh. The number of quads (numQuads),
+  number of vertices (numVertices), and number of time steps have to
+  get specified. Quad meshes currently support a single time step
+  only. The quad indices can be set by mapping and writing to the
+  index buffer (RTC_INDEX_BUFFER) and the quad vertices can be set by
+  mapping and writing into the vertex buffer (RTC_VERTEX_BUFFER). The
+  index buffer has the default layout of four 32 bit integer indices
+  for each quad. An index points to the ith vertex. The vertices of a
+  quad should be planar, non-planar quads are intersected as the two
+  triangles (v0,v1,v3) and (v2,v3,v1). The vertex buffer stores single
+  precision x,y,z floating point coordinates aligned to 16 bytes. The
+  value of the 4th float used for alignment can be arbitrary. */
+RTCORE_API unsigned rtcNewQuadMesh (RTCScene scene,                        //!< the scene the mesh belongs to
+                                    RTCGeometryFlags flags,                //!< geometry flags
+                                    size_t numQuads,                       //!< number of quads
+                                    size_t numVertices,                    //!< number of vertices
+                                    size_t numTimeSteps = 1                //!< number of motion blur time steps
+  );
+
 /*! \brief Creates a new subdivision mesh. The number of faces
  (numFaces), edges/indices (numEdges), vertices (numVertices), edge
  creases (numEdgeCreases), vertex creases (numVertexCreases), holes
@@ -217,18 +286,21 @@ RTCORE_API unsigned rtcNewSubdivisionMesh (RTCScene scene,                //!< t
 /*! \brief Creates a new hair geometry, consisting of multiple hairs
   represented as cubic bezier curves with varying radii. The number of
   curves (numCurves), number of vertices (numVertices), and number of
-  time steps (1 for normal curves, and 2 for linear motion blur), have
+  time steps (1 for normal curves, and 2 or more for motion blur), have
   to get specified at construction time. Further, the curve index
   buffer (RTC_INDEX_BUFFER) and the curve vertex buffer
   (RTC_VERTEX_BUFFER) have to get set by mapping and writing to the
   appropiate buffers. In case of linear motion blur, two vertex
   buffers have to get filled (RTC_VERTEX_BUFFER0, RTC_VERTEX_BUFFER1),
-  one for each time step. The index buffer has the default layout of a
-  single 32 bit integer index for each curve, that references the
-  start vertex of the curve. The vertex buffer stores 4 control points
-  per curve, each such control point consists of a single precision
-  (x,y,z) position and radius, stored in that order in
-  memory. Individual hairs are considered to be subpixel sized which
+  one for each time step. For multi segment motion blur up to
+  RTC_MAX_TIME_STEPS time steps are supported, the vertex buffer of
+  time step t is RTC_VERTEX_BUFFER0+t and the time steps are
+  distributed uniformly over the [0,1] shutter interval. The index
+  buffer has the default layout of a single 32 bit integer index for
+  each curve, that references the start vertex of the curve. The
+  vertex buffer stores 4 control points per curve, each such control
+  point consists of a single precision (x,y,z) position and radius,
+  stored in that order in memory. Individual hairs are considered to be subpixel sized which
   allows the implementation to approximate the intersection
   calculation. This in particular means that zooming onto one hair
   might show geometric artefacts. */
@@ -239,6 +311,21 @@ RTCORE_API unsigned rtcNewHairGeometry (RTCScene scene,                    //!<
                                         size_t numTimeSteps = 1            //!< number of motion blur time steps
   );
 
+/*! \brief Creates a new point geometry, consisting of multiple
+  spheres, e.g. for particles or point clouds. The number of points
+  (numPoints) and number of time steps (1 for static points, and 2 or
+  more for motion blur) have to get specified at construction
+  time. The points are set by mapping and writing to the vertex buffer
+  (RTC_VERTEX_BUFFER), for motion blur the vertex buffer of time step
+  t is RTC_VERTEX_BUFFER0+t. Point geometries have no index
+  buffer. Each point consists of a single precision (x,y,z) center
+  and radius, stored in that order in memory. */
+RTCORE_API unsigned rtcNewPointGeometry (RTCScene scene,                   //!< the scene the points belong to
+                                         RTCGeometryFlags flags,           //!< geometry flags
+                                         size_t numPoints,                 //!< number of points
+                                         size_t numTimeSteps = 1           //!< number of motion blur time steps
+  );
+
 /*! \brief Sets 32 bit ray mask. */
 RTCORE_API void rtcSetMask (RTCScene scene, unsigned geomID, int mask);
 
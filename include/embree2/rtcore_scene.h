@@ -25,6 +25,7 @@ struct RTCRay;
 struct RTCRay4;
 struct RTCRay8;
 struct RTCRay16;
+struct RTCRayNp;
 
 /*! scene flags */
 enum RTCSceneFlags 
@@ -38,9 +39,12 @@ enum RTCSceneFlags
   RTC_SCENE_COHERENT   = (1 << 9),    //!< optimize data structures for coherent rays
   RTC_SCENE_INCOHERENT = (1 << 10),    //!< optimize data structures for in-coherent rays (enabled by default)
   RTC_SCENE_HIGH_QUALITY = (1 << 11),  //!< create higher quality data structures
+  RTC_SCENE_RELAYOUT   = (1 << 12),    //!< reorder nodes and leaves into a cache friendly memory layout after build
+  RTC_SCENE_RESTRUCTURE = (1 << 13),   //!< optimize the hierarchies of fast builders by treelet restructuring
 
   /* traversal algorithm flags */
-  RTC_SCENE_ROBUST     = (1 << 16)     //!< use more robust traversal algorithms
+  RTC_SCENE_ROBUST     = (1 << 16),    //!< use more robust traversal algorithms
+  RTC_SCENE_REORDER_RAYS = (1 << 17)   //!< reorder rays of ray streams for coherence before packet traversal
 };
 
 /*! enabled algorithm flags */
@@ -51,6 +55,7 @@ enum RTCAlgorithmFlags
   RTC_INTERSECT8 = (1 << 2),    //!< enables the rtcIntersect8 and rtcOccluded8 functions for this scene
   RTC_INTERSECT16 = (1 << 3),   //!< enables the rtcIntersect16 and rtcOccluded16 functions for this scene
   RTC_INTERPOLATE = (1 << 4),   //!< enables the rtcInterpolate function for this scene
+  RTC_INTERSECT_STREAM = (1 << 5), //!< enables the rtcIntersect1M/Np and rtcOccluded1M/Np functions for this scene
 };
 
 /*! \brief Defines an opaque scene type */
@@ -88,6 +93,21 @@ RTCORE_API void rtcCommit (RTCScene scene);
  *  coprocessor. */
 RTCORE_API void rtcCommitThread(RTCScene scene, unsigned int threadID, unsigned int numThreads);
 
+/*! Stores the acceleration structures of a committed static scene
+ *  into a file. The leaves of all acceleration structures have to
+ *  store their primitive data directly, which excludes e.g. user
+ *  geometries, instances, subdivision meshes, and scenes build with
+ *  the RTC_SCENE_COMPACT flag. */
+RTCORE_API void rtcSaveScene (RTCScene scene, const char* fileName);
+
+/*! Commits a static scene by mapping the acceleration structures
+ *  stored with rtcSaveScene into memory instead of building
+ *  them. The scene has to contain the same geometries with the same
+ *  buffer contents as when it got saved, and the device has to use
+ *  the same acceleration structure configuration. Only the number of
+ *  geometries and primitives is verified. */
+RTCORE_API void rtcLoadScene (RTCScene scene, const char* fileName);
+
 /*! Intersects a single ray with the scene. The ray has to be aligned
  *  to 16 bytes. This function can only be called for scenes with the
  *  RTC_INTERSECT1 flag set. */
@@ -138,6 +158,34 @@ RTCORE_API void rtcOccluded8 (const void* valid, RTCScene scene, RTCRay8& ray);
  *  instructions. */
 RTCORE_API void rtcOccluded16 (const void* valid, RTCScene scene, RTCRay16& ray);
 
+/*! Intersects a stream of M rays with the scene. Consecutive rays
+ *  are stride bytes apart, the stride has to be a multiple of 16
+ *  bytes and at least sizeof(RTCRay). The rays are internally traced
+ *  using the widest ray packets enabled for the scene through the
+ *  RTC_INTERSECT4/8/16 flags and supported by the CPU, and as single
+ *  rays otherwise. Thus intersection filter functions and user
+ *  geometries have to provide callbacks of that packet size. This
+ *  function can only be called for scenes with the
+ *  RTC_INTERSECT_STREAM flag set. The rays have to be aligned to 16
+ *  bytes. */
+RTCORE_API void rtcIntersect1M (RTCScene scene, RTCRay* rays, size_t M, size_t stride);
+
+/*! Tests if a stream of M rays is occluded by the scene. Consecutive
+ *  rays are stride bytes apart. See rtcIntersect1M for the
+ *  requirements on stride, alignment, and enabled scene flags. */
+RTCORE_API void rtcOccluded1M (RTCScene scene, RTCRay* rays, size_t M, size_t stride);
+
+/*! Intersects a stream of N rays in struct of array layout with the
+ *  scene. Each ray component is stored in a separate array, see
+ *  RTCRayNp. The rays are traced in packets the same way as for
+ *  rtcIntersect1M. This function can only be called for scenes with
+ *  the RTC_INTERSECT_STREAM flag set. */
+RTCORE_API void rtcIntersectNp (RTCScene scene, const RTCRayNp& rays, size_t N);
+
+/*! Tests if a stream of N rays in struct of array layout is occluded
+ *  by the scene. See rtcIntersectNp for details. */
+RTCORE_API void rtcOccludedNp (RTCScene scene, const RTCRayNp& rays, size_t N);
+
 /*! Deletes the scene. All contained geometry get also destroyed. */
 RTCORE_API void rtcDeleteScene (RTCScene scene);
 
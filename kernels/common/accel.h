@@ -24,7 +24,7 @@ namespace embree
   class AccelData : public RefCount 
   {
   public:
-    enum Type { TY_UNKNOWN = 0, TY_ACCELN = 1, TY_ACCEL_INSTANCE = 2, TY_BVH4 = 3, TY_BVH8 = 4 };
+    enum Type { TY_UNKNOWN = 0, TY_ACCELN = 1, TY_ACCEL_INSTANCE = 2, TY_BVH4 = 3, TY_BVH8 = 4, TY_ACCEL_SEGMENTS = 5 };
 
   public:
     AccelData (const Type type) 
@@ -33,6 +33,55 @@ namespace embree
     /*! clears the acceleration structure data */
     virtual void clear() = 0;
 
+    /*! writes the acceleration structure data to a stream, returns false if the data cannot get stored */
+    virtual bool save(std::ostream& stream) { return false; }
+
+    /*! restores the acceleration structure data from memory filled by save, returns false if the data does not match */
+    virtual bool load(char* ptr, size_t bytes) { return false; }
+
+    /*! reorders the acceleration structure data into a cache friendly memory layout */
+    virtual void relayout() {}
+
+    /*! creates a copy of the acceleration structure data placed on the specified NUMA node, returns nullptr if the data cannot get copied */
+    virtual AccelData* clone(size_t node) { return nullptr; }
+
+    /*! replicates the acceleration structure data on each NUMA node, traversal uses the replica local to the calling thread */
+    virtual void replicate() {}
+
+  public:
+
+    /*! header written in front of the data of a stored hierarchy */
+    struct FileHeader
+    {
+      FileHeader (const std::string& name, size_t N, size_t flags) 
+      {
+        memset(this,0,sizeof(FileHeader));
+        strncpy(primTy,name.c_str(),sizeof(primTy)-1);
+        this->N = N;
+        this->flags = flags;
+      }
+
+      /*! checks if the stored hierarchy is of the same type */
+      __forceinline bool matches(const FileHeader& other) const {
+        return strncmp(primTy,other.primTy,sizeof(primTy)) == 0 && N == other.N && flags == other.flags;
+      }
+
+      /*! bytes of the header, the node and leaf data starts at the next cache line */
+      static __forceinline size_t headerBytes() {
+        return (sizeof(FileHeader)+63) & ~size_t(63);
+      }
+
+    public:
+      char primTy[32];       //!< name of the primitive type stored in the leaves
+      size_t N;              //!< branching factor of the hierarchy
+      size_t flags;          //!< type specific flags that change the node layout
+      size_t root;           //!< root reference relative to the start of the node data
+      size_t numPrimitives;  //!< number of primitives the hierarchy is build over
+      size_t numVertices;    //!< number of vertices the hierarchy references
+      size_t bytes;          //!< bytes of node and leaf data following the header
+      BBox3fa bounds;        //!< bounds of the hierarchy
+    };
+
   public:
     BBox3fa bounds;
     Type type;
@@ -155,10 +204,10 @@ namespace embree
     struct Intersectors 
     {
       Intersectors() 
-        : ptr(nullptr) {}
+        : ptr(nullptr), replicas(nullptr) {}
 
       Intersectors (ErrorFunc error) 
-        : ptr(nullptr), intersector1(error), intersector4(error), intersector8(error), intersector16(error) {}
+        : ptr(nullptr), replicas(nullptr), intersector1(error), intersector4(error), intersector8(error), intersector16(error) {}
 
       void print(size_t ident) 
       {
@@ -196,8 +245,15 @@ namespace embree
 	}
       }
 
+      /*! returns the data to traverse, which is the replica on the NUMA node of the calling thread if the data got replicated */
+      __forceinline AccelData* localPtr() const {
+        if (likely(replicas == nullptr)) return ptr;
+        return replicas[getThreadNumaNode()];
+      }
+
     public:
       AccelData* ptr;
+      AccelData** replicas; //!< per NUMA node copies of the data ptr points to, nullptr if not replicated
       Intersector1 intersector1;
       Intersector4 intersector1_nofilter;
       Intersector4 intersector4;
@@ -233,49 +289,49 @@ namespace embree
     /*! Intersects a single ray with the scene. */
     __forceinline void intersect (RTCRay& ray) {
       assert(intersectors.intersector1.intersect);
-      intersectors.intersector1.intersect(intersectors.ptr,ray);
+      intersectors.intersector1.intersect(intersectors.localPtr(),ray);
     }
 
     /*! Intersects a packet of 4 rays with the scene. */
     __forceinline void intersect4 (const void* valid, RTCRay4& ray) {
       assert(intersectors.intersector4.intersect);
-      intersectors.intersector4.intersect(valid,intersectors.ptr,ray);
+      intersectors.intersector4.intersect(valid,intersectors.localPtr(),ray);
     }
 
     /*! Intersects a packet of 8 rays with the scene. */
     __forceinline void intersect8 (const void* valid, RTCRay8& ray) {
       assert(intersectors.intersector8.intersect);
-      intersectors.intersector8.intersect(valid,intersectors.ptr,ray);
+      intersectors.intersector8.intersect(valid,intersectors.localPtr(),ray);
     }
 
     /*! Intersects a packet of 16 rays with the scene. */
     __forceinline void intersect16 (const void* valid, RTCRay16& ray) {
       assert(intersectors.intersector16.intersect);
-      intersectors.intersector16.intersect(valid,intersectors.ptr,ray);
+      intersectors.intersector16.intersect(valid,intersectors.localPtr(),ray);
     }
 
     /*! Tests if single ray is occluded by the scene. */
     __forceinline void occluded (RTCRay& ray) {
       assert(intersectors.intersector1.occluded);
-      intersectors.intersector1.occluded(intersectors.ptr,ray);
+      intersectors.intersector1.occluded(intersectors.localPtr(),ray);
     }
     
     /*! Tests if a packet of 4 rays is occluded by the scene. */
     __forceinline void occluded4 (const void* valid, RTCRay4& ray) {
       assert(intersectors.intersector4.occluded);
-      intersectors.intersector4.occluded(valid,intersectors.ptr,ray);
+      intersectors.intersector4.occluded(valid,intersectors.localPtr(),ray);
     }
 
     /*! Tests if a packet of 8 rays is occluded by the scene. */
     __forceinline void occluded8 (const void* valid, RTCRay8& ray) {
       assert(intersectors.intersector8.occluded);
-      intersectors.intersector8.occluded(valid,intersectors.ptr,ray);
+      intersectors.intersector8.occluded(valid,intersectors.localPtr(),ray);
     }
 
     /*! Tests if a packet of 16 rays is occluded by the scene. */
     __forceinline void occluded16 (const void* valid, RTCRay16& ray) {
       assert(intersectors.intersector16.occluded);
-      intersectors.intersector16.occluded(valid,intersectors.ptr,ray);
+      intersectors.intersector16.occluded(valid,intersectors.localPtr(),ray);
     }
 
   public:
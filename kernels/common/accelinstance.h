@@ -25,30 +25,72 @@ namespace embree
   {
   public:
     AccelInstance (AccelData* accel, Builder* builder, Intersectors& intersectors)
-      : accel(accel), builder(builder), Accel(AccelData::TY_ACCEL_INSTANCE,intersectors) {}
+      : accel(accel), builder(builder), replicas(nullptr), numReplicas(0), Accel(AccelData::TY_ACCEL_INSTANCE,intersectors) {}
 
     void immutable () {
       delete builder; builder = nullptr;
     }
 
     ~AccelInstance() {
+      clearReplicas();
       delete builder; builder = nullptr;
       delete accel;   accel = nullptr;
     }
 
   public:
     void build (size_t threadIndex, size_t threadCount) {
+      clearReplicas();
       if (builder) builder->build(threadIndex,threadCount);
       bounds = accel->bounds;
     }
 
     void clear() {
+      clearReplicas();
       accel->clear();
-      builder->clear();
+      if (builder) builder->clear();
+    }
+
+    bool save(std::ostream& stream) {
+      return accel->save(stream);
+    }
+
+    bool load(char* ptr, size_t bytes) 
+    {
+      clearReplicas();
+      if (!accel->load(ptr,bytes)) return false;
+      bounds = accel->bounds;
+      return true;
+    }
+
+    void relayout() {
+      accel->relayout();
+    }
+
+    void replicate() 
+    {
+      clearReplicas();
+      const size_t numNodes = getNumberOfNumaNodes();
+      replicas = new AccelData*[numNodes];
+      for (numReplicas=0; numReplicas<numNodes; numReplicas++) {
+        replicas[numReplicas] = accel->clone(numReplicas);
+        if (replicas[numReplicas] == nullptr) { clearReplicas(); return; }
+      }
+      intersectors.replicas = replicas;
+    }
+
+  private:
+    void clearReplicas() 
+    {
+      intersectors.replicas = nullptr;
+      for (size_t i=0; i<numReplicas; i++) delete replicas[i];
+      delete[] replicas; replicas = nullptr;
+      numReplicas = 0;
     }
 
   private:
     AccelData* accel;
     Builder* builder;
+    AccelData** replicas;
+    size_t numReplicas;
   };
 }
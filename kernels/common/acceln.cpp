@@ -21,7 +21,7 @@
 namespace embree
 {
   AccelN::AccelN () 
-    : Accel(AccelData::TY_ACCELN), accels(nullptr), validAccels(nullptr) {}
+    : Accel(AccelData::TY_ACCELN), accels(nullptr), validAccels(nullptr), unified(false) {}
 
   AccelN::~AccelN() 
   {
@@ -116,6 +116,125 @@ namespace embree
     }
   }
 
+  /*! calculates the distance at which a ray enters some bounds, returns inf if the ray misses the bounds */
+  __forceinline float entryDistance(const BBox3fa& bounds, const Vec3fa& org, const Vec3fa& rdir, const float tnear, const float tfar)
+  {
+    const Vec3fa t0 = (bounds.lower-org)*rdir;
+    const Vec3fa t1 = (bounds.upper-org)*rdir;
+    const float tmin = max(reduce_max(min(t0,t1)),tnear);
+    const float tmax = min(reduce_min(max(t0,t1)),tfar);
+    return tmin <= tmax ? tmin : float(inf);
+  }
+
+  /*! sorts the acceleration structures by their entry distance, returns the number of hit acceleration structures */
+  __forceinline size_t sortByDistance(const size_t N, float* dist, size_t* order)
+  {
+    size_t M = 0;
+    for (size_t i=0; i<N; i++) 
+    {
+      if (dist[i] == float(inf)) continue;
+      size_t j = M++;
+      for (; j>0 && dist[order[j-1]] > dist[i]; j--) order[j] = order[j-1];
+      order[j] = i;
+    }
+    return M;
+  }
+
+  void AccelN::intersectUnified (void* ptr, RTCRay& ray) 
+  {
+    AccelN* This = (AccelN*)ptr;
+    const Vec3fa org(ray.org[0],ray.org[1],ray.org[2]);
+    const Vec3fa rdir = rcp_safe(Vec3fa(ray.dir[0],ray.dir[1],ray.dir[2]));
+    
+    /* visit acceleration structures front to back and skip the ones behind the closest hit found so far */
+    float dist[16]; size_t order[16];
+    for (size_t i=0; i<This->validAccels.size(); i++) 
+      dist[i] = entryDistance(This->validBounds[i],org,rdir,ray.tnear,ray.tfar);
+    const size_t M = sortByDistance(This->validAccels.size(),dist,order);
+    for (size_t k=0; k<M; k++) {
+      const size_t i = order[k];
+      if (dist[i] > ray.tfar) break;
+      This->validAccels[i]->intersect(ray);
+    }
+  }
+
+  void AccelN::occludedUnified (void* ptr, RTCRay& ray) 
+  {
+    AccelN* This = (AccelN*)ptr;
+    const Vec3fa org(ray.org[0],ray.org[1],ray.org[2]);
+    const Vec3fa rdir = rcp_safe(Vec3fa(ray.dir[0],ray.dir[1],ray.dir[2]));
+
+    for (size_t i=0; i<This->validAccels.size(); i++) 
+    {
+      if (entryDistance(This->validBounds[i],org,rdir,ray.tnear,ray.tfar) == float(inf)) continue;
+      This->validAccels[i]->occluded(ray); 
+      if (ray.geomID == 0) break;
+    }
+  }
+
+  /*! calculates which rays of a packet enter some bounds and the closest entry distance of these rays */
+  template<int K, typename RayK>
+  __forceinline float entryDistanceK(const BBox3fa& bounds, const int* valid, const RayK& ray, const bool occlusion, int* valid_o)
+  {
+    float dist = inf;
+    for (size_t k=0; k<K; k++) 
+    {
+      valid_o[k] = 0;
+      if (!valid[k] || (occlusion && ray.geomID[k] == 0)) continue;
+      const Vec3fa org(ray.orgx[k],ray.orgy[k],ray.orgz[k]);
+      const Vec3fa rdir = rcp_safe(Vec3fa(ray.dirx[k],ray.diry[k],ray.dirz[k]));
+      const float d = entryDistance(bounds,org,rdir,ray.tnear[k],ray.tfar[k]);
+      if (d == float(inf)) continue;
+      valid_o[k] = -1;
+      dist = min(dist,d);
+    }
+    return dist;
+  }
+
+  /*! traces a packet through all acceleration structures, front to back, only passing on the rays that still enter the bounds */
+  template<int K, typename RayK, typename Trace>
+  __forceinline void traceUnifiedK(const AccelN* This, const void* valid_i, RayK& ray, const bool occlusion, const Trace& trace)
+  {
+    const int* valid = (const int*) valid_i;
+    __aligned(64) int valid_s[K];
+    float dist[16]; size_t order[16];
+    for (size_t i=0; i<This->validAccels.size(); i++)
+      dist[i] = entryDistanceK<K>(This->validBounds[i],valid,ray,occlusion,valid_s);
+    const size_t M = sortByDistance(This->validAccels.size(),dist,order);
+
+    for (size_t k=0; k<M; k++) 
+    {
+      /* recalculate the active rays, as earlier acceleration structures may have shortened the rays */
+      const size_t i = order[k];
+      if (entryDistanceK<K>(This->validBounds[i],valid,ray,occlusion,valid_s) == float(inf)) continue;
+      trace(This->validAccels[i],valid_s);
+    }
+  }
+
+  void AccelN::intersect4Unified (const void* valid, void* ptr, RTCRay4& ray) {
+    traceUnifiedK<4>((AccelN*)ptr,valid,ray,false,[&] (Accel* accel, const int* valid_s) { accel->intersect4(valid_s,ray); });
+  }
+
+  void AccelN::intersect8Unified (const void* valid, void* ptr, RTCRay8& ray) {
+    traceUnifiedK<8>((AccelN*)ptr,valid,ray,false,[&] (Accel* accel, const int* valid_s) { accel->intersect8(valid_s,ray); });
+  }
+
+  void AccelN::intersect16Unified (const void* valid, void* ptr, RTCRay16& ray) {
+    traceUnifiedK<16>((AccelN*)ptr,valid,ray,false,[&] (Accel* accel, const int* valid_s) { accel->intersect16(valid_s,ray); });
+  }
+
+  void AccelN::occluded4Unified (const void* valid, void* ptr, RTCRay4& ray) {
+    traceUnifiedK<4>((AccelN*)ptr,valid,ray,true,[&] (Accel* accel, const int* valid_s) { accel->occluded4(valid_s,ray); });
+  }
+
+  void AccelN::occluded8Unified (const void* valid, void* ptr, RTCRay8& ray) {
+    traceUnifiedK<8>((AccelN*)ptr,valid,ray,true,[&] (Accel* accel, const int* valid_s) { accel->occluded8(valid_s,ray); });
+  }
+
+  void AccelN::occluded16Unified (const void* valid, void* ptr, RTCRay16& ray) {
+    traceUnifiedK<16>((AccelN*)ptr,valid,ray,true,[&] (Accel* accel, const int* valid_s) { accel->occluded16(valid_s,ray); });
+  }
+
   void AccelN::print(size_t ident)
   {
     for (size_t i=0; i<validAccels.size(); i++)
@@ -144,19 +263,40 @@ namespace embree
       });
 #endif
 
+    updateValidAccels();
+  }
+
+  void AccelN::updateValidAccels()
+  {
     /* create list of non-empty acceleration structures */
     validAccels.clear();
+    validBounds.clear();
     for (size_t i=0; i<accels.size(); i++) {
       if (accels[i]->bounds.empty()) continue;
       validAccels.push_back(accels[i]);
+
+      /* enlarge bounds to conservatively cull acceleration structures with floating point ray/box tests */
+      const BBox3fa& b = accels[i]->bounds;
+      const Vec3fa eps = 16.0f*float(ulp)*max(abs(b.lower),abs(b.upper));
+      validBounds.push_back(BBox3fa(b.lower-eps,b.upper+eps));
     }
 
     if (validAccels.size() == 1) {
       intersectors = validAccels[0]->intersectors;
     }
+    else if (unified)
+    {
+      intersectors.ptr = this;
+      intersectors.replicas = nullptr;
+      intersectors.intersector1  = Intersector1(&intersectUnified,&occludedUnified,"AccelN::intersector1Unified");
+      intersectors.intersector4  = Intersector4(&intersect4Unified,&occluded4Unified,"AccelN::intersector4Unified");
+      intersectors.intersector8  = Intersector8(&intersect8Unified,&occluded8Unified,"AccelN::intersector8Unified");
+      intersectors.intersector16 = Intersector16(&intersect16Unified,&occluded16Unified,"AccelN::intersector16Unified");
+    }
     else 
     {
       intersectors.ptr = this;
+      intersectors.replicas = nullptr;
       intersectors.intersector1  = Intersector1(&intersect,&occluded,"AccelN::intersector1");
       intersectors.intersector4  = Intersector4(&intersect4,&occluded4,"AccelN::intersector4");
       intersectors.intersector8  = Intersector8(&intersect8,&occluded8,"AccelN::intersector8");
@@ -180,4 +320,71 @@ namespace embree
     for (size_t i=0; i<accels.size(); i++) 
       accels[i]->clear();
   }
+
+  bool AccelN::saveAccels(std::ostream& stream, Accel* const* accels, size_t N)
+  {
+    stream.write((char*)&N,sizeof(N));
+
+    for (size_t i=0; i<N; i++)
+    {
+      /* reserve space for the size, which gets written after the data */
+      const std::streampos pos = stream.tellp();
+      size_t bytes = 0;
+      stream.write((char*)&bytes,sizeof(bytes));
+      while (size_t(stream.tellp()) % 64) stream.put(0);
+
+      const std::streampos begin = stream.tellp();
+      if (!accels[i]->save(stream)) return false;
+      const std::streampos end = stream.tellp();
+
+      bytes = end-begin;
+      stream.seekp(pos);
+      stream.write((char*)&bytes,sizeof(bytes));
+      stream.seekp(end);
+    }
+    return stream.good();
+  }
+
+  bool AccelN::loadAccels(char*& ptr, char* end, Accel* const* accels, size_t N)
+  {
+    if (ptr+sizeof(size_t) > end || *(size_t*)ptr != N) 
+      return false;
+    ptr += sizeof(size_t);
+
+    for (size_t i=0; i<N; i++)
+    {
+      if (ptr+sizeof(size_t) > end) return false;
+      const size_t bytes = *(size_t*)ptr;
+      ptr = (char*) ALIGN_PTR(ptr+sizeof(size_t),64);
+      if (ptr+bytes > end || !accels[i]->load(ptr,bytes)) return false;
+      ptr += bytes;
+    }
+    return true;
+  }
+
+  bool AccelN::save(std::ostream& stream) {
+    return saveAccels(stream,accels.data(),accels.size());
+  }
+
+  bool AccelN::load(char* ptr, size_t bytes)
+  {
+    if (!loadAccels(ptr,ptr+bytes,accels.data(),accels.size()))
+      return false;
+
+    updateValidAccels();
+    return true;
+  }
+
+  void AccelN::relayout()
+  {
+    for (size_t i=0; i<accels.size(); i++)
+      accels[i]->relayout();
+  }
+
+  void AccelN::replicate()
+  {
+    for (size_t i=0; i<accels.size(); i++)
+      accels[i]->replicate();
+    updateValidAccels();
+  }
 }
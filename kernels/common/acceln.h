@@ -20,7 +20,9 @@
 
 namespace embree
 {
-  /*! merges N acceleration structures together, by processing them in order */
+  /*! merges N acceleration structures together, by processing them
+   *  in order or by tracing through a shared top level over the bounds
+   *  of all acceleration structures */
   class AccelN : public Accel
   {
   public:
@@ -42,15 +44,44 @@ namespace embree
     static void occluded8 (const void* valid, void* ptr, RTCRay8& ray);
     static void occluded16 (const void* valid, void* ptr, RTCRay16& ray);
 
+  public:
+    static void intersectUnified (void* ptr, RTCRay& ray);
+    static void intersect4Unified (const void* valid, void* ptr, RTCRay4& ray);
+    static void intersect8Unified (const void* valid, void* ptr, RTCRay8& ray);
+    static void intersect16Unified (const void* valid, void* ptr, RTCRay16& ray);
+
+  public:
+    static void occludedUnified (void* ptr, RTCRay& ray);
+    static void occluded4Unified (const void* valid, void* ptr, RTCRay4& ray);
+    static void occluded8Unified (const void* valid, void* ptr, RTCRay8& ray);
+    static void occluded16Unified (const void* valid, void* ptr, RTCRay16& ray);
+
   public:
     void print(size_t ident);
     void immutable();
     void build (size_t threadIndex, size_t threadCount);
     void select(bool filter4, bool filter8, bool filter16);
     void clear ();
+    bool save (std::ostream& stream);
+    bool load (char* ptr, size_t bytes);
+    void relayout ();
+    void replicate ();
+
+  public:
+    /*! stores a list of acceleration structures, each preceded by its size and starting at a cache line aligned offset */
+    static bool saveAccels(std::ostream& stream, Accel* const* accels, size_t N);
+
+    /*! loads a list of acceleration structures stored with saveAccels, advances ptr behind the data */
+    static bool loadAccels(char*& ptr, char* end, Accel* const* accels, size_t N);
+
+  private:
+    /*! selects the non-empty acceleration structures and the intersectors after a build or load */
+    void updateValidAccels();
       
   public:
     darray_t<Accel*,16> accels;
     darray_t<Accel*,16> validAccels;
+    darray_t<BBox3fa,16> validBounds; //!< slightly enlarged bounds of each valid acceleration structure
+    bool unified;                     //!< traces all acceleration structures in one pass, culling them by the current hit distance
   };
 }
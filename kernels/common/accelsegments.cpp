@@ -0,0 +1,243 @@
+// ======================================================================== //
+// Copyright 2009-2015 Intel Corporation                                    //
+//                                                                          //
+// Licensed under the Apache License, Version 2.0 (the "License");          //
+// you may not use this file except in compliance with the License.         //
+// You may obtain a copy of the License at                                  //
+//                                                                          //
+//     http://www.apache.org/licenses/LICENSE-2.0                           //
+//                                                                          //
+// Unless required by applicable law or agreed to in writing, software      //
+// distributed under the License is distributed on an "AS IS" BASIS,        //
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. //
+// See the License for the specific language governing permissions and      //
+// limitations under the License.                                           //
+// ======================================================================== //
+
+#include "accelsegments.h"
+#include "acceln.h"
+#include "scene.h"
+#include "../../include/embree2/rtcore_ray.h"
+#include "../algorithms/parallel_for.h"
+
+namespace embree
+{
+  AccelSegments::AccelSegments (Scene* scene, Geometry::Type gtype, const CreateAccelFunc& createAccel)
+    : Accel(AccelData::TY_ACCEL_SEGMENTS), scene(scene), gtype(gtype), createAccel(createAccel) {}
+
+  AccelSegments::~AccelSegments()
+  {
+    for (size_t i=0; i<segments.size(); i++)
+      delete segments[i];
+  }
+
+  /*! traces the rays of a packet segment by segment, remapping the time of the active rays */
+  template<int K, typename RayK, typename Trace>
+  __forceinline void traceSegmentsK(const AccelSegments* This, const void* valid_i, RayK& ray, const Trace& trace)
+  {
+    const int* valid = (const int*) valid_i;
+    float time[K]; size_t segment[K]; bool todo[K];
+    for (size_t k=0; k<K; k++) {
+      time[k] = ray.time[k];
+      segment[k] = This->segment(time[k]);
+      todo[k] = valid[k] != 0;
+    }
+
+    for (size_t k0=0; k0<K; k0++)
+    {
+      if (!todo[k0]) continue;
+      const size_t i = segment[k0];
+
+      __aligned(64) int valid_s[K];
+      for (size_t k=0; k<K; k++) {
+        valid_s[k] = todo[k] && segment[k] == i ? -1 : 0;
+        if (!valid_s[k]) continue;
+        ray.time[k] = This->localTime(i,time[k]);
+        todo[k] = false;
+      }
+      trace(This->segments[i],valid_s);
+    }
+
+    for (size_t k=0; k<K; k++)
+      ray.time[k] = time[k];
+  }
+
+  void AccelSegments::intersect (void* ptr, RTCRay& ray)
+  {
+    AccelSegments* This = (AccelSegments*)ptr;
+    const float time = ray.time;
+    const size_t i = This->segment(time);
+    ray.time = This->localTime(i,time);
+    This->segments[i]->intersect(ray);
+    ray.time = time;
+  }
+
+  void AccelSegments::intersect4 (const void* valid, void* ptr, RTCRay4& ray)
+  {
+    traceSegmentsK<4>((AccelSegments*)ptr,valid,ray,[&] (Accel* accel, const int* valid_s) { accel->intersect4(valid_s,ray); });
+  }
+
+  void AccelSegments::intersect8 (const void* valid, void* ptr, RTCRay8& ray)
+  {
+    traceSegmentsK<8>((AccelSegments*)ptr,valid,ray,[&] (Accel* accel, const int* valid_s) { accel->intersect8(valid_s,ray); });
+  }
+
+  void AccelSegments::intersect16 (const void* valid, void* ptr, RTCRay16& ray)
+  {
+    traceSegmentsK<16>((AccelSegments*)ptr,valid,ray,[&] (Accel* accel, const int* valid_s) { accel->intersect16(valid_s,ray); });
+  }
+
+  void AccelSegments::occluded (void* ptr, RTCRay& ray)
+  {
+    AccelSegments* This = (AccelSegments*)ptr;
+    const float time = ray.time;
+    const size_t i = This->segment(time);
+    ray.time = This->localTime(i,time);
+    This->segments[i]->occluded(ray);
+    ray.time = time;
+  }
+
+  void AccelSegments::occluded4 (const void* valid, void* ptr, RTCRay4& ray)
+  {
+    traceSegmentsK<4>((AccelSegments*)ptr,valid,ray,[&] (Accel* accel, const int* valid_s) { accel->occluded4(valid_s,ray); });
+  }
+
+  void AccelSegments::occluded8 (const void* valid, void* ptr, RTCRay8& ray)
+  {
+    traceSegmentsK<8>((AccelSegments*)ptr,valid,ray,[&] (Accel* accel, const int* valid_s) { accel->occluded8(valid_s,ray); });
+  }
+
+  void AccelSegments::occluded16 (const void* valid, void* ptr, RTCRay16& ray)
+  {
+    traceSegmentsK<16>((AccelSegments*)ptr,valid,ray,[&] (Accel* accel, const int* valid_s) { accel->occluded16(valid_s,ray); });
+  }
+
+  void AccelSegments::print(size_t ident)
+  {
+    for (size_t i=0; i<segments.size(); i++)
+    {
+      for (size_t j=0; j<ident; j++) std::cout << " ";
+      std::cout << "segments[" << i << "] = [" << times[i] << ", " << times[i+1] << "]" << std::endl;
+      segments[i]->intersectors.print(ident+2);
+    }
+  }
+
+  void AccelSegments::immutable()
+  {
+    for (size_t i=0; i<segments.size(); i++)
+      segments[i]->immutable();
+  }
+
+  std::vector<float> AccelSegments::collectTimeSteps() const
+  {
+    std::vector<float> times;
+    times.push_back(0.0f);
+    times.push_back(1.0f);
+    for (size_t i=0; i<scene->size(); i++)
+    {
+      Geometry* geom = scene->get(i);
+      if (geom == nullptr || !geom->isEnabled()) continue;
+      if (geom->getType() != gtype || geom->numTimeSteps <= 2) continue;
+      for (size_t j=1; j+1<geom->numTimeSteps; j++)
+        times.push_back(float(j)/float(geom->numTimeSteps-1));
+    }
+    std::sort(times.begin(),times.end());
+    times.erase(std::unique(times.begin(),times.end()),times.end());
+    return times;
+  }
+
+  void AccelSegments::updateSegments()
+  {
+    const std::vector<float> new_times = collectTimeSteps();
+    if (new_times == times) return;
+
+    for (size_t i=0; i<segments.size(); i++)
+      delete segments[i];
+    segments.clear();
+    times = new_times;
+    for (size_t i=0; i+1<times.size(); i++)
+      segments.push_back(createAccel(BBox1f(times[i],times[i+1])));
+  }
+
+  void AccelSegments::build (size_t threadIndex, size_t threadCount)
+  {
+    /* recreate the time segments if the timesteps changed */
+    updateSegments();
+
+    /* build all time segments in parallel */
+    parallel_for (segments.size(), [&] (size_t i) {
+        segments[i]->intersectors.select(scene->numIntersectionFilters4,scene->numIntersectionFilters8,scene->numIntersectionFilters16);
+        segments[i]->build(threadIndex,threadCount);
+      });
+
+    updateIntersectors();
+  }
+
+  void AccelSegments::updateIntersectors()
+  {
+    if (segments.size() == 1) {
+      intersectors = segments[0]->intersectors;
+    }
+    else
+    {
+      intersectors = Intersectors();
+      intersectors.ptr = this;
+      intersectors.intersector1  = Intersector1(&intersect,&occluded,"AccelSegments::intersector1");
+      intersectors.intersector4  = Intersector4(&intersect4,&occluded4,"AccelSegments::intersector4");
+      intersectors.intersector8  = Intersector8(&intersect8,&occluded8,"AccelSegments::intersector8");
+      intersectors.intersector16 = Intersector16(&intersect16,&occluded16,"AccelSegments::intersector16");
+    }
+
+    /*! calculate bounds */
+    bounds = empty;
+    for (size_t i=0; i<segments.size(); i++)
+      bounds.extend(segments[i]->bounds);
+  }
+
+  void AccelSegments::clear()
+  {
+    for (size_t i=0; i<segments.size(); i++)
+      segments[i]->clear();
+  }
+
+  bool AccelSegments::save(std::ostream& stream)
+  {
+    const size_t numTimes = times.size();
+    stream.write((char*)&numTimes,sizeof(numTimes));
+    stream.write((char*)times.data(),numTimes*sizeof(float));
+    return AccelN::saveAccels(stream,segments.data(),segments.size());
+  }
+
+  bool AccelSegments::load(char* ptr, size_t bytes)
+  {
+    char* end = ptr+bytes;
+    updateSegments();
+
+    /* the stored time segments have to match the timesteps of the geometries */
+    if (ptr+sizeof(size_t) > end || *(size_t*)ptr != times.size()) return false;
+    ptr += sizeof(size_t);
+    if (ptr+times.size()*sizeof(float) > end || memcmp(ptr,times.data(),times.size()*sizeof(float)) != 0) return false;
+    ptr += times.size()*sizeof(float);
+
+    for (size_t i=0; i<segments.size(); i++)
+      segments[i]->intersectors.select(scene->numIntersectionFilters4,scene->numIntersectionFilters8,scene->numIntersectionFilters16);
+    if (!AccelN::loadAccels(ptr,end,segments.data(),segments.size()))
+      return false;
+
+    updateIntersectors();
+    return true;
+  }
+
+  void AccelSegments::relayout()
+  {
+    for (size_t i=0; i<segments.size(); i++)
+      segments[i]->relayout();
+  }
+
+  void AccelSegments::replicate()
+  {
+    for (size_t i=0; i<segments.size(); i++)
+      segments[i]->replicate();
+    updateIntersectors();
+  }
+}
@@ -0,0 +1,98 @@
+// ======================================================================== //
+// Copyright 2009-2015 Intel Corporation                                    //
+//                                                                          //
+// Licensed under the Apache License, Version 2.0 (the "License");          //
+// you may not use this file except in compliance with the License.         //
+// You may obtain a copy of the License at                                  //
+//                                                                          //
+//     http://www.apache.org/licenses/LICENSE-2.0                           //
+//                                                                          //
+// Unless required by applicable law or agreed to in writing, software      //
+// distributed under the License is distributed on an "AS IS" BASIS,        //
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. //
+// See the License for the specific language governing permissions and      //
+// limitations under the License.                                           //
+// ======================================================================== //
+
+#pragma once
+
+#include "accel.h"
+#include "geometry.h"
+
+#include <functional>
+#include <algorithm>
+
+namespace embree
+{
+  class Scene;
+
+  /*! Splits the shutter interval at the timesteps of all motion
+   *  blurred geometries of some type and builds one acceleration
+   *  structure per time segment. Within a segment all geometries move
+   *  linearly, thus the bounds stay tight for any number of
+   *  timesteps. Each ray is traced through the segment that contains
+   *  the ray time, with the ray time remapped to [0,1] inside that
+   *  segment. */
+  class AccelSegments : public Accel
+  {
+  public:
+
+    /*! creates the acceleration structure for one time segment */
+    typedef std::function<Accel* (const BBox1f& time_range)> CreateAccelFunc;
+
+    AccelSegments (Scene* scene, Geometry::Type gtype, const CreateAccelFunc& createAccel);
+    ~AccelSegments();
+
+  public:
+    static void intersect (void* ptr, RTCRay& ray);
+    static void intersect4 (const void* valid, void* ptr, RTCRay4& ray);
+    static void intersect8 (const void* valid, void* ptr, RTCRay8& ray);
+    static void intersect16 (const void* valid, void* ptr, RTCRay16& ray);
+
+  public:
+    static void occluded (void* ptr, RTCRay& ray);
+    static void occluded4 (const void* valid, void* ptr, RTCRay4& ray);
+    static void occluded8 (const void* valid, void* ptr, RTCRay8& ray);
+    static void occluded16 (const void* valid, void* ptr, RTCRay16& ray);
+
+  public:
+    void print(size_t ident);
+    void immutable();
+    void build (size_t threadIndex, size_t threadCount);
+    void clear ();
+    bool save (std::ostream& stream);
+    bool load (char* ptr, size_t bytes);
+    void relayout ();
+    void replicate ();
+
+  public:
+
+    /*! returns the time segment that contains some time */
+    __forceinline size_t segment(float time) const {
+      return std::upper_bound(times.begin()+1,times.end()-1,time)-(times.begin()+1);
+    }
+
+    /*! maps some time into the [0,1] range of the i'th time segment */
+    __forceinline float localTime(size_t i, float time) const {
+      return (time-times[i])/(times[i+1]-times[i]);
+    }
+
+  private:
+
+    /*! collects the sorted timesteps of all motion blurred geometries */
+    std::vector<float> collectTimeSteps() const;
+
+    /*! recreates the time segments if the timesteps changed */
+    void updateSegments();
+
+    /*! selects the intersectors and calculates the bounds after a build or load */
+    void updateIntersectors();
+
+  public:
+    Scene* scene;
+    Geometry::Type gtype;         //!< type of geometries to split in time
+    CreateAccelFunc createAccel;
+    std::vector<float> times;     //!< boundaries of the time segments, starting with 0 and ending with 1
+    std::vector<Accel*> segments; //!< acceleration structure for each time segment
+  };
+}
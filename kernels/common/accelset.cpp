@@ -26,6 +26,12 @@ namespace embree
     enabling();
   }
 
+  AccelSet::AccelSet (Scene* parent, Geometry::Type type, size_t numItems, size_t numTimeSteps) 
+    : Geometry(parent,type,numItems,numTimeSteps,RTC_GEOMETRY_STATIC), numItems(numItems) 
+  {
+    intersectors.ptr = nullptr; 
+  }
+
   void AccelSet::enabling () { 
     atomic_add(&parent->numUserGeometries1,numItems); 
   }
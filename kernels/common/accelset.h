@@ -133,6 +133,12 @@ namespace embree
       
       /*! construction */
       AccelSet (Scene* parent, size_t items);
+
+    protected:
+      /*! construction of derived geometry types, does not register the items with the scene */
+      AccelSet (Scene* parent, Geometry::Type type, size_t items, size_t numTimeSteps);
+
+    public:
       
       /*! makes the acceleration structure immutable */
       virtual void immutable () {}
@@ -29,6 +29,9 @@ namespace embree
     //static const size_t maxAllocationSize = 2*1024*1024-maxAlignment;
     static const size_t maxAllocationSize = 4*1024*1024-maxAlignment;
 
+    /*! maximal number of slots of blocks threads allocate from concurrently */
+    static const size_t maxSlots = 16;
+
   public:
 
     /*! Per thread structure holding the current memory block. */
@@ -75,26 +78,20 @@ namespace embree
           return alloc->malloc(bytes,maxAlignment);
 	}
 
-#if 0 // FIXME: this optimization is broken
-
-        /* get new partial block if allocation failed */
-	if (alloc->usedBlocks) 
-	{
-	  size_t blockSize = allocBlockSize;
-	  ptr = (char*) alloc->usedBlocks->malloc_some(blockSize,maxAlignment);
-	  bytesWasted += end-cur;
-	  cur = 0; end = blockSize;
-	  
-	  /* retry allocation */
-	  size_t ofs = (align - cur) & (align-1); 
-	  cur += bytes + ofs;
-	  if (likely(cur <= end)) { bytesWasted += ofs; return &ptr[cur - bytes]; }
-	  cur -= bytes + ofs;
-	}
-#endif
-
-        /* get new full block if allocation failed */
+        /* get new partial block if allocation failed, which uses up the tail of the current memory block */
         size_t blockSize = allocBlockSize;
+        ptr = (char*) alloc->malloc_some(blockSize,maxAlignment);
+        bytesWasted += end-cur;
+        cur = 0; end = blockSize;
+
+        /* retry allocation */
+        ofs = (align - cur) & (align-1); 
+        cur += bytes + ofs;
+        if (likely(cur <= end)) { bytesWasted += ofs; return &ptr[cur - bytes]; }
+        cur -= bytes + ofs;
+
+        /* get new full block if the partial block was too small */
+        blockSize = allocBlockSize;
 	ptr = (char*) alloc->malloc(blockSize,maxAlignment);
 	bytesWasted += end-cur;
 	cur = 0; end = blockSize;
@@ -163,11 +160,12 @@ namespace embree
       ThreadLocal alloc1;
     };
 
-    FastAllocator (MemoryMonitorInterface* device) 
-      : device(device), growSize(4096), usedBlocks(nullptr), freeBlocks(nullptr), slotMask(0),
+    /*! in NUMA mode the blocks are placed on the NUMA node of the allocating thread, which only has an effect on multi socket systems */
+    FastAllocator (MemoryMonitorInterface* device, bool numa = false) 
+      : device(device), growSize(4096), usedBlocks(nullptr), freeBlocks(nullptr), slotMask(0), numa(numa && getNumberOfNumaNodes() > 1),
         thread_local_allocators(this), thread_local_allocators2(this) 
     {
-      for (size_t i=0; i<4; i++)
+      for (size_t i=0; i<maxSlots; i++)
         threadUsedBlocks[i] = nullptr;
     }
 
@@ -180,7 +178,7 @@ namespace embree
       cleanup();
       if (usedBlocks) usedBlocks->clear(device); usedBlocks = nullptr;
       if (freeBlocks) freeBlocks->clear(device); freeBlocks = nullptr;
-      for (size_t i=0; i<4; i++) threadUsedBlocks[i] = nullptr;
+      for (size_t i=0; i<maxSlots; i++) threadUsedBlocks[i] = nullptr;
     }
 
     /*! returns a fast thread local allocator */
@@ -229,7 +227,7 @@ namespace embree
         freeBlocks = usedBlocks;
         usedBlocks = nextUsedBlock;
       }
-      for (size_t i=0; i<4; i++) 
+      for (size_t i=0; i<maxSlots; i++) 
         threadUsedBlocks[i] = nullptr;
      
       /* reset all thread local allocators */
@@ -237,14 +235,37 @@ namespace embree
       thread_local_allocators2.reset();
     }
 
-    /*! shrinks all memory blocks to the actually used size */
-    void shrink () {
+    /*! shrinks all memory blocks to the actually used size, must not get called while other threads allocate */
+    void shrink () 
+    {
+      /* give the unused ends of the thread local blocks back, which only works for the last allocation of a memory block */
+      for (bool released = true; released; ) 
+      {
+        released = false;
+        for (size_t t=0; t<thread_local_allocators.threads.size(); t++)
+          released |= releaseTail(*thread_local_allocators.threads[t]);
+        for (size_t t=0; t<thread_local_allocators2.threads.size(); t++) {
+          released |= releaseTail(thread_local_allocators2.threads[t]->alloc0);
+          released |= releaseTail(thread_local_allocators2.threads[t]->alloc1);
+        }
+      }
       if (usedBlocks) usedBlocks->shrink(device);
       if (freeBlocks) freeBlocks->clear(device); freeBlocks = nullptr;
     }
 
     /*! thread safe allocation of memory */
-    void* malloc(size_t bytes, size_t align) 
+    void* malloc(size_t bytes, size_t align) {
+      return allocate(bytes,align,false);
+    }
+
+    /*! thread safe allocation of at most the requested bytes, returns the smaller tail of the current memory block instead of skipping it */
+    void* malloc_some(size_t& bytes, size_t align) {
+      return allocate(bytes,align,true);
+    }
+
+  private:
+
+    void* allocate(size_t& bytes, size_t align, bool partial) 
     {
       assert(align <= maxAlignment);
 
@@ -258,9 +279,14 @@ namespace embree
         size_t threadIndex = TaskSchedulerTBB::threadIndex();
 #endif
         size_t slot = threadIndex & slotMask;
+        ssize_t node = -1;
+        if (numa) {
+          node = getThreadNumaNode();
+          slot = (node*(slotMask+1) + slot) & (maxSlots-1);
+        }
 	Block* myUsedBlocks = threadUsedBlocks[slot];
         if (myUsedBlocks) {
-          void* ptr = myUsedBlocks->malloc(device,bytes,align); 
+          void* ptr = partial ? myUsedBlocks->malloc_some(device,bytes,align) : myUsedBlocks->malloc(device,bytes,align); 
           if (ptr) return ptr;
         }
 
@@ -273,22 +299,42 @@ namespace embree
           Lock<AtomicMutex> lock(mutex);
 	  if (myUsedBlocks == threadUsedBlocks[slot])
 	  {
-	    if (freeBlocks) {
-	      Block* nextFreeBlock = freeBlocks->next;
-	      freeBlocks->next = usedBlocks;
+	    if (Block* freeBlock = removeFreeBlock(node)) {
+	      freeBlock->next = usedBlocks;
 	      __memory_barrier();
-	      usedBlocks = freeBlocks;
-              threadUsedBlocks[slot] = freeBlocks;
-	      freeBlocks = nextFreeBlock;
+	      usedBlocks = freeBlock;
+              threadUsedBlocks[slot] = freeBlock;
 	    } else {
 	      growSize = min(2*growSize,size_t(maxAllocationSize+maxAlignment));
-	      usedBlocks = threadUsedBlocks[slot] = Block::create(device,growSize-maxAlignment, growSize-maxAlignment, usedBlocks);
+	      usedBlocks = threadUsedBlocks[slot] = Block::create(device,growSize-maxAlignment, growSize-maxAlignment, usedBlocks, node);
 	    }
 	  }
         }
       }
     }
 
+    /*! returns the unused end of a thread local block to its memory block if it got allocated last */
+    bool releaseTail(ThreadLocal& alloc)
+    {
+      if (alloc.ptr == nullptr || alloc.cur == alloc.end) return false;
+      for (Block* block = usedBlocks; block; block = block->next) {
+        if (!block->release(alloc.ptr+alloc.cur,alloc.ptr+alloc.end)) continue;
+        alloc.end = alloc.cur;
+        return true;
+      }
+      return false;
+    }
+
+  public:
+
+    /*! allocates a single block of memory that holds exactly the specified number of bytes, optionally placed on some NUMA node */
+    void* malloc_block(size_t bytes, ssize_t node = -1)
+    {
+      Lock<AtomicMutex> lock(mutex);
+      usedBlocks = Block::create(device,bytes,bytes,usedBlocks,node);
+      return usedBlocks->malloc(device,bytes,maxAlignment);
+    }
+
     void* ptr() {
       return usedBlocks->ptr();
     }
@@ -375,21 +421,38 @@ namespace embree
 
   private:
 
+    struct Block;
+
+    /*! removes the first free block placed on the specified NUMA node from the free list, any node matches for node -1 */
+    Block* removeFreeBlock(ssize_t node)
+    {
+      Block* prev = nullptr;
+      for (Block* block = freeBlocks; block; prev = block, block = block->next) 
+      {
+        if (node != -1 && block->node != node) continue;
+        if (prev) prev->next = block->next;
+        else      freeBlocks = block->next;
+        return block;
+      }
+      return nullptr;
+    }
+
     struct Block 
     {
-      static Block* create(MemoryMonitorInterface* device, size_t bytesAllocate, size_t bytesReserve, Block* next = nullptr)
+      static Block* create(MemoryMonitorInterface* device, size_t bytesAllocate, size_t bytesReserve, Block* next = nullptr, ssize_t node = -1)
       {
         const size_t sizeof_Header = offsetof(Block,data[0]);
         bytesAllocate = ((sizeof_Header+bytesAllocate+4095) & ~(4095)); // always consume full pages
         bytesReserve  = ((sizeof_Header+bytesReserve +4095) & ~(4095)); // always consume full pages
         if (device) device->memoryMonitor(bytesAllocate,false);
         void* ptr = os_reserve(bytesReserve);
+        if (node != -1) os_bind(ptr,bytesReserve,node);
         os_commit(ptr,bytesAllocate);
-        return new (ptr) Block(bytesAllocate-sizeof_Header,bytesReserve-sizeof_Header,next);
+        return new (ptr) Block(bytesAllocate-sizeof_Header,bytesReserve-sizeof_Header,next,node);
       }
 
-      Block (size_t bytesAllocate, size_t bytesReserve, Block* next) 
-      : cur(0), allocEnd(bytesAllocate), reserveEnd(bytesReserve), next(next) 
+      Block (size_t bytesAllocate, size_t bytesReserve, Block* next, ssize_t node) 
+      : cur(0), allocEnd(bytesAllocate), reserveEnd(bytesReserve), next(next), node(node) 
       {
         //for (size_t i=0; i<allocEnd; i+=4096) data[i] = 0;
       }
@@ -421,15 +484,27 @@ namespace embree
       {
         assert(align <= maxAlignment);
         bytes = (bytes+(align-1)) & ~(align-1);
+	if (unlikely(cur >= reserveEnd)) return nullptr;
 	const size_t i = atomic_add(&cur,bytes);
-	if (unlikely(i+bytes > reserveEnd)) bytes = reserveEnd-i;
-	if (i+bytes > allocEnd) {
-          if (device) device->memoryMonitor(i+bytes-max(i,allocEnd),true);
-          os_commit(&data[i],bytes); // FIXME: optimize, may get called frequently
+	if (unlikely(i >= reserveEnd)) return nullptr;
+        const size_t n = min(bytes,reserveEnd-i); // only one thread gets the tail of the block
+	if (i+n > allocEnd) {
+          if (device) device->memoryMonitor(i+n-max(i,allocEnd),true);
+          os_commit(&data[i],n); // FIXME: optimize, may get called frequently
         }
+        bytes = n;
 	return &data[i];
       }
 
+      /*! gives back the range [begin,end) if it ends at the current location of the allocator */
+      bool release(char* begin, char* end)
+      {
+        if (end != &data[cur]) return false;
+        const size_t ofs = min(size_t(ALIGN_PTR(begin-data,maxAlignment)),size_t(end-data));
+        cur = ofs;
+        return true;
+      }
+
       void* ptr() {
         return &data[cur];
       }
@@ -480,7 +555,8 @@ namespace embree
       size_t allocEnd;           //!< end of the allocated memory region
       size_t reserveEnd;         //!< end of the reserved memory region
       Block* next;               //!< pointer to next block in list
-      char align[maxAlignment-4*sizeof(size_t)]; //!< align data to maxAlignment
+      ssize_t node;              //!< NUMA node the block is placed on, -1 if not placed explicitly
+      char align[maxAlignment-5*sizeof(size_t)]; //!< align data to maxAlignment
       char data[1];              //!< here starts memory to use for allocations
     };
 
@@ -488,7 +564,8 @@ namespace embree
     MemoryMonitorInterface* device;
     AtomicMutex mutex;
     size_t slotMask;
-    Block* volatile threadUsedBlocks[4];
+    bool numa;
+    Block* volatile threadUsedBlocks[maxSlots];
     Block* volatile usedBlocks;
     Block* volatile freeBlocks;
     size_t growSize;
@@ -152,6 +152,9 @@ namespace embree
     if (FileName::homeFolder() != FileName("")) // home folder is not available on KNC
       State::parseFile(FileName::homeFolder()+FileName(".embree" TOSTRING(__EMBREE_VERSION_MAJOR__)));
     
+    /*! select pages of large allocations before anything gets allocated */
+    State::hugepages = os_set_huge_pages(State::hugepages);
+
     /*! set tessellation cache size */
     setCacheSize( State::tessellation_cache_size );
 
@@ -306,6 +309,10 @@ namespace embree
     std::cout << "  CPU      : " << stringOfCPUModel(getCPUModel()) << " (" << getCPUVendor() << ")" << std::endl;
     std::cout << "  ISA      : " << stringOfCPUFeatures(getCPUFeatures()) << std::endl;
     std::cout << "  Threads  : " << getNumberOfLogicalThreads() << std::endl;
+    std::cout << "  Pages    : ";
+    if      (State::hugepages == HUGEPAGES_ON  ) std::cout << "2MB huge pages for large allocations" << std::endl;
+    else if (State::hugepages == HUGEPAGES_AUTO) std::cout << "2MB transparent huge pages for large allocations" << std::endl;
+    else                                         std::cout << "4KB" << std::endl;
 #if !defined(__MIC__)
     const bool hasFTZ = _mm_getcsr() & _MM_FLUSH_ZERO_ON;
     const bool hasDAZ = _mm_getcsr() & _MM_DENORMALS_ZERO_ON;
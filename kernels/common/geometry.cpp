@@ -121,7 +121,7 @@ namespace embree
     if (parent->isStatic() && parent->isBuild())
       throw_RTCError(RTC_INVALID_OPERATION,"static scenes cannot get modified");
 
-    if (type != TRIANGLE_MESH && type != BEZIER_CURVES && type != SUBDIV_MESH)
+    if (type != TRIANGLE_MESH && type != QUAD_MESH && type != POINTS && type != BEZIER_CURVES && type != SUBDIV_MESH)
       throw_RTCError(RTC_INVALID_OPERATION,"filter functions not supported for this geometry"); 
     
     intersectionFilter1 = filter;
@@ -132,7 +132,7 @@ namespace embree
     if (parent->isStatic() && parent->isBuild())
       throw_RTCError(RTC_INVALID_OPERATION,"static scenes cannot get modified");
 
-    if (type != TRIANGLE_MESH && type != BEZIER_CURVES && type != SUBDIV_MESH)
+    if (type != TRIANGLE_MESH && type != QUAD_MESH && type != POINTS && type != BEZIER_CURVES && type != SUBDIV_MESH)
       throw_RTCError(RTC_INVALID_OPERATION,"filter functions not supported for this geometry"); 
 
     atomic_sub(&parent->numIntersectionFilters4,intersectionFilter4 != nullptr);
@@ -146,7 +146,7 @@ namespace embree
     if (parent->isStatic() && parent->isBuild())
       throw_RTCError(RTC_INVALID_OPERATION,"static scenes cannot get modified");
     
-    if (type != TRIANGLE_MESH && type != BEZIER_CURVES && type != SUBDIV_MESH)
+    if (type != TRIANGLE_MESH && type != QUAD_MESH && type != POINTS && type != BEZIER_CURVES && type != SUBDIV_MESH)
       throw_RTCError(RTC_INVALID_OPERATION,"filter functions not supported for this geometry"); 
 
     atomic_sub(&parent->numIntersectionFilters8,intersectionFilter8 != nullptr);
@@ -160,7 +160,7 @@ namespace embree
     if (parent->isStatic() && parent->isBuild())
       throw_RTCError(RTC_INVALID_OPERATION,"static scenes cannot get modified");
 
-    if (type != TRIANGLE_MESH && type != BEZIER_CURVES && type != SUBDIV_MESH)
+    if (type != TRIANGLE_MESH && type != QUAD_MESH && type != POINTS && type != BEZIER_CURVES && type != SUBDIV_MESH)
       throw_RTCError(RTC_INVALID_OPERATION,"filter functions not supported for this geometry"); 
 
     atomic_sub(&parent->numIntersectionFilters16,intersectionFilter16 != nullptr);
@@ -174,7 +174,7 @@ namespace embree
     if (parent->isStatic() && parent->isBuild())
       throw_RTCError(RTC_INVALID_OPERATION,"static scenes cannot get modified");
 
-    if (type != TRIANGLE_MESH && type != BEZIER_CURVES && type != SUBDIV_MESH)
+    if (type != TRIANGLE_MESH && type != QUAD_MESH && type != POINTS && type != BEZIER_CURVES && type != SUBDIV_MESH)
       throw_RTCError(RTC_INVALID_OPERATION,"filter functions not supported for this geometry"); 
 
     occlusionFilter1 = filter;
@@ -185,7 +185,7 @@ namespace embree
     if (parent->isStatic() && parent->isBuild())
       throw_RTCError(RTC_INVALID_OPERATION,"static scenes cannot get modified");
 
-    if (type != TRIANGLE_MESH && type != BEZIER_CURVES && type != SUBDIV_MESH)
+    if (type != TRIANGLE_MESH && type != QUAD_MESH && type != POINTS && type != BEZIER_CURVES && type != SUBDIV_MESH)
       throw_RTCError(RTC_INVALID_OPERATION,"filter functions not supported for this geometry"); 
 
     atomic_sub(&parent->numIntersectionFilters4,occlusionFilter4 != nullptr);
@@ -199,7 +199,7 @@ namespace embree
     if (parent->isStatic() && parent->isBuild())
       throw_RTCError(RTC_INVALID_OPERATION,"static scenes cannot get modified");
 
-    if (type != TRIANGLE_MESH && type != BEZIER_CURVES && type != SUBDIV_MESH)
+    if (type != TRIANGLE_MESH && type != QUAD_MESH && type != POINTS && type != BEZIER_CURVES && type != SUBDIV_MESH)
       throw_RTCError(RTC_INVALID_OPERATION,"filter functions not supported for this geometry"); 
 
     atomic_sub(&parent->numIntersectionFilters8,occlusionFilter8 != nullptr);
@@ -213,7 +213,7 @@ namespace embree
     if (parent->isStatic() && parent->isBuild())
       throw_RTCError(RTC_INVALID_OPERATION,"static scenes cannot get modified");
 
-    if (type != TRIANGLE_MESH && type != BEZIER_CURVES && type != SUBDIV_MESH) 
+    if (type != TRIANGLE_MESH && type != QUAD_MESH && type != POINTS && type != BEZIER_CURVES && type != SUBDIV_MESH) 
       throw_RTCError(RTC_INVALID_OPERATION,"filter functions not supported for this geometry"); 
 
     atomic_sub(&parent->numIntersectionFilters16,occlusionFilter16 != nullptr);
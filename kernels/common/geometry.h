@@ -29,7 +29,7 @@ namespace embree
   public:
 
     /*! type of geometry */
-    enum Type { TRIANGLE_MESH = 1, USER_GEOMETRY = 2, BEZIER_CURVES = 4, SUBDIV_MESH = 8 };
+    enum Type { TRIANGLE_MESH = 1, USER_GEOMETRY = 2, BEZIER_CURVES = 4, SUBDIV_MESH = 8, INSTANCE = 16, QUAD_MESH = 32, POINTS = 64 };
 
   public:
     
@@ -188,8 +188,8 @@ namespace embree
     /*! for instances only */
   public:
     
-    /*! Sets transformation of the instance */
-    virtual void setTransform(const AffineSpace3fa& transform) {
+    /*! Sets transformation of some timestep of the instance */
+    virtual void setTransform(const AffineSpace3fa& transform, size_t timeStep) {
       throw_RTCError(RTC_INVALID_OPERATION,"operation not supported for this geometry"); 
     }
 
@@ -252,7 +252,7 @@ namespace embree
     unsigned id;               //!< internal geometry ID
     Type type;                 //!< geometry type 
     ssize_t numPrimitives;     //!< number of primitives of this geometry
-    unsigned numTimeSteps;     //!< number of time steps (1 or 2)
+    unsigned numTimeSteps;     //!< number of time steps (1 to RTC_MAX_TIME_STEPS)
     RTCGeometryFlags flags;    //!< flags of geometry
     bool enabled;              //!< true if geometry is enabled
     bool modified;             //!< true if geometry is modified
@@ -17,6 +17,7 @@
 #pragma once
 
 #include "default.h"
+#include "../../include/embree2/rtcore_ray.h"
 
 namespace embree
 {
@@ -54,6 +55,10 @@ namespace embree
     int geomID;        //!< geometry ID
     int primID;        //!< primitive ID
     int instID;        //!< instance ID
+    int instIDPath[RTC_MAX_INSTANCE_DEPTH-1]; //!< instance IDs of nested instances below instID
+
+    /*! returns the instance ID of some instancing level */
+    __forceinline int& instIDLevel(const size_t level) { return level == 0 ? instID : instIDPath[level-1]; }
 
 #if defined(__MIC__)    
     __forceinline void update(const bool16 &m_mask,
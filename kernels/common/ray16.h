@@ -68,6 +68,10 @@ namespace embree
     int16 geomID;   //!< geometry ID
     int16 primID;   //!< primitive ID
     int16 instID;   //!< instance ID
+    int16 instIDPath[RTC_MAX_INSTANCE_DEPTH-1]; //!< instance IDs of nested instances below instID
+
+    /*! returns the instance IDs of some instancing level */
+    __forceinline int16& instIDLevel(const size_t level) { return level == 0 ? instID : instIDPath[level-1]; }
 
     template<int PFHINT>
     __forceinline void prefetchHitData() const
@@ -136,6 +140,7 @@ namespace embree
 	ray[i].Ng.x = Ng.x[i]; ray[i].Ng.y = Ng.y[i]; ray[i].Ng.z = Ng.z[i];
 	ray[i].u = u[i]; ray[i].v = v[i];
 	ray[i].geomID = geomID[i]; ray[i].primID = primID[i]; ray[i].instID = instID[i];
+	for (size_t l=0; l<RTC_MAX_INSTANCE_DEPTH-1; l++) ray[i].instIDPath[l] = instIDPath[l][i];
       }
     }
 
@@ -150,6 +155,7 @@ namespace embree
 	Ng.x[i] = ray[i].Ng.x; Ng.y[i] = ray[i].Ng.y; Ng.z[i] = ray[i].Ng.z;
 	u[i] = ray[i].u; v[i] = ray[i].v;
 	geomID[i] = ray[i].geomID; primID[i] = ray[i].primID; instID[i] = ray[i].instID;
+	for (size_t l=0; l<RTC_MAX_INSTANCE_DEPTH-1; l++) instIDPath[l][i] = ray[i].instIDPath[l];
       }
     }
 
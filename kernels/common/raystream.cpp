@@ -0,0 +1,398 @@
+// ======================================================================== //
+// Copyright 2009-2015 Intel Corporation                                    //
+//                                                                          //
+// Licensed under the Apache License, Version 2.0 (the "License");          //
+// you may not use this file except in compliance with the License.         //
+// You may obtain a copy of the License at                                  //
+//                                                                          //
+//     http://www.apache.org/licenses/LICENSE-2.0                           //
+//                                                                          //
+// Unless required by applicable law or agreed to in writing, software      //
+// distributed under the License is distributed on an "AS IS" BASIS,        //
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. //
+// See the License for the specific language governing permissions and      //
+// limitations under the License.                                           //
+// ======================================================================== //
+
+#include "raystream.h"
+#include "scene.h"
+#include "../../include/embree2/rtcore_ray.h"
+
+namespace embree
+{
+  /*! returns the i'th ray of a stream with the specified byte stride */
+  __forceinline RTCRay& getRay(RTCRay* rays, const size_t stride, const size_t i) {
+    return *(RTCRay*)((char*)rays + i*stride);
+  }
+
+  /*! stream of individual rays with some byte stride */
+  struct RayStream1M
+  {
+    __forceinline RayStream1M (RTCRay* rays, const size_t stride) 
+      : rays(rays), stride(stride) {}
+
+    __forceinline Vec3fa org(const size_t i) const { const RTCRay& r = getRay(rays,stride,i); return Vec3fa(r.org[0],r.org[1],r.org[2]); }
+    __forceinline Vec3fa dir(const size_t i) const { const RTCRay& r = getRay(rays,stride,i); return Vec3fa(r.dir[0],r.dir[1],r.dir[2]); }
+
+    /*! copies ray i into lane k of an SOA packet */
+    template<typename RTCRayK>
+    __forceinline void load(RTCRayK& ray, const size_t k, const size_t i) const
+    {
+      const RTCRay& r = getRay(rays,stride,i);
+      ray.orgx[k] = r.org[0]; ray.orgy[k] = r.org[1]; ray.orgz[k] = r.org[2];
+      ray.dirx[k] = r.dir[0]; ray.diry[k] = r.dir[1]; ray.dirz[k] = r.dir[2];
+      ray.tnear[k] = r.tnear; ray.tfar[k] = r.tfar;
+      ray.time[k] = r.time; ray.mask[k] = r.mask;
+      ray.geomID[k] = r.geomID; ray.primID[k] = r.primID; ray.instID[k] = r.instID;
+      for (size_t l=0; l<RTC_MAX_INSTANCE_DEPTH-1; l++) ray.instIDPath[l][k] = r.instIDPath[l];
+    }
+
+    /*! copies the hit data of lane k of an SOA packet back to ray i */
+    template<typename RTCRayK>
+    __forceinline void storeHit(const RTCRayK& ray, const size_t k, const size_t i) const
+    {
+      if (ray.geomID[k] == RTC_INVALID_GEOMETRY_ID) return;
+      RTCRay& r = getRay(rays,stride,i);
+      r.tfar = ray.tfar[k];
+      r.Ng[0] = ray.Ngx[k]; r.Ng[1] = ray.Ngy[k]; r.Ng[2] = ray.Ngz[k];
+      r.u = ray.u[k]; r.v = ray.v[k];
+      r.geomID = ray.geomID[k]; r.primID = ray.primID[k]; r.instID = ray.instID[k];
+      for (size_t l=0; l<RTC_MAX_INSTANCE_DEPTH-1; l++) r.instIDPath[l] = ray.instIDPath[l][k];
+    }
+
+    /*! copies the occlusion result of lane k of an SOA packet back to ray i */
+    template<typename RTCRayK>
+    __forceinline void storeOcclusion(const RTCRayK& ray, const size_t k, const size_t i) const {
+      getRay(rays,stride,i).geomID = ray.geomID[k];
+    }
+
+    /*! copies K rays starting at ray index 'begin' into an SOA packet */
+    template<int K, typename RTCRayK>
+    __forceinline void gather(RTCRayK& ray, int* valid, const size_t begin, const size_t end) const
+    {
+      for (size_t k=0; k<K; k++) {
+        valid[k] = begin+k < end ? -1 : 0;
+        if (valid[k]) load(ray,k,begin+k);
+      }
+    }
+
+    /*! copies the hit data of an SOA packet back into the stream */
+    template<int K, typename RTCRayK>
+    __forceinline void scatterHit(const RTCRayK& ray, const size_t begin, const size_t end) const {
+      for (size_t k=0; k<K && begin+k<end; k++) storeHit(ray,k,begin+k);
+    }
+
+    /*! copies the occlusion result of an SOA packet back into the stream */
+    template<int K, typename RTCRayK>
+    __forceinline void scatterOcclusion(const RTCRayK& ray, const size_t begin, const size_t end) const {
+      for (size_t k=0; k<K && begin+k<end; k++) storeOcclusion(ray,k,begin+k);
+    }
+
+  private:
+    RTCRay* rays;
+    const size_t stride;
+  };
+
+  /*! stream of rays with each ray component stored in a separate array */
+  struct RayStreamNp
+  {
+    __forceinline RayStreamNp (const RTCRayNp& rays) 
+      : rays(rays) {}
+
+    __forceinline Vec3fa org(const size_t i) const { return Vec3fa(rays.orgx[i],rays.orgy[i],rays.orgz[i]); }
+    __forceinline Vec3fa dir(const size_t i) const { return Vec3fa(rays.dirx[i],rays.diry[i],rays.dirz[i]); }
+
+    /*! copies ray i into lane k of an SOA packet */
+    template<typename RTCRayK>
+    __forceinline void load(RTCRayK& ray, const size_t k, const size_t i) const
+    {
+      ray.orgx[k] = rays.orgx[i]; ray.orgy[k] = rays.orgy[i]; ray.orgz[k] = rays.orgz[i];
+      ray.dirx[k] = rays.dirx[i]; ray.diry[k] = rays.diry[i]; ray.dirz[k] = rays.dirz[i];
+      ray.tnear[k] = rays.tnear[i]; ray.tfar[k] = rays.tfar[i];
+      ray.time[k] = rays.time ? rays.time[i] : 0.0f; 
+      ray.mask[k] = rays.mask ? rays.mask[i] : -1;
+      ray.geomID[k] = rays.geomID[i]; ray.primID[k] = rays.primID[i]; 
+      ray.instID[k] = rays.instID ? rays.instID[i] : RTC_INVALID_GEOMETRY_ID;
+      for (size_t l=0; l<RTC_MAX_INSTANCE_DEPTH-1; l++) 
+        ray.instIDPath[l][k] = rays.instIDPath[l] ? rays.instIDPath[l][i] : RTC_INVALID_GEOMETRY_ID;
+    }
+
+    /*! copies the hit data of lane k of an SOA packet back to ray i */
+    template<typename RTCRayK>
+    __forceinline void storeHit(const RTCRayK& ray, const size_t k, const size_t i) const
+    {
+      if (ray.geomID[k] == RTC_INVALID_GEOMETRY_ID) return;
+      rays.tfar[i] = ray.tfar[k];
+      rays.Ngx[i] = ray.Ngx[k]; rays.Ngy[i] = ray.Ngy[k]; rays.Ngz[i] = ray.Ngz[k];
+      rays.u[i] = ray.u[k]; rays.v[i] = ray.v[k];
+      rays.geomID[i] = ray.geomID[k]; rays.primID[i] = ray.primID[k]; 
+      if (rays.instID) rays.instID[i] = ray.instID[k];
+      for (size_t l=0; l<RTC_MAX_INSTANCE_DEPTH-1; l++) 
+        if (rays.instIDPath[l]) rays.instIDPath[l][i] = ray.instIDPath[l][k];
+    }
+
+    /*! copies the occlusion result of lane k of an SOA packet back to ray i */
+    template<typename RTCRayK>
+    __forceinline void storeOcclusion(const RTCRayK& ray, const size_t k, const size_t i) const {
+      rays.geomID[i] = ray.geomID[k];
+    }
+
+    /*! copies K rays starting at ray index 'begin' into an SOA packet,
+     *  each component is a contiguous copy of up to K elements */
+    template<int K, typename RTCRayK>
+    __forceinline void gather(RTCRayK& ray, int* valid, const size_t begin, const size_t end) const
+    {
+      const size_t n = min(size_t(K),end-begin);
+      for (size_t k=0; k<K; k++) valid[k] = k < n ? -1 : 0;
+      const size_t bytes = n*sizeof(float);
+      memcpy(ray.orgx,rays.orgx+begin,bytes); memcpy(ray.orgy,rays.orgy+begin,bytes); memcpy(ray.orgz,rays.orgz+begin,bytes);
+      memcpy(ray.dirx,rays.dirx+begin,bytes); memcpy(ray.diry,rays.diry+begin,bytes); memcpy(ray.dirz,rays.dirz+begin,bytes);
+      memcpy(ray.tnear,rays.tnear+begin,bytes); memcpy(ray.tfar,rays.tfar+begin,bytes);
+      if (rays.time) memcpy(ray.time,rays.time+begin,bytes); else for (size_t k=0; k<n; k++) ray.time[k] = 0.0f;
+      if (rays.mask) memcpy(ray.mask,rays.mask+begin,bytes); else for (size_t k=0; k<n; k++) ray.mask[k] = -1;
+      memcpy(ray.geomID,rays.geomID+begin,bytes); memcpy(ray.primID,rays.primID+begin,bytes);
+      if (rays.instID) memcpy(ray.instID,rays.instID+begin,bytes); else for (size_t k=0; k<n; k++) ray.instID[k] = RTC_INVALID_GEOMETRY_ID;
+      for (size_t l=0; l<RTC_MAX_INSTANCE_DEPTH-1; l++) {
+        if (rays.instIDPath[l]) memcpy(ray.instIDPath[l],rays.instIDPath[l]+begin,bytes); 
+        else for (size_t k=0; k<n; k++) ray.instIDPath[l][k] = RTC_INVALID_GEOMETRY_ID;
+      }
+    }
+
+    /*! copies the hit data of an SOA packet back into the stream */
+    template<int K, typename RTCRayK>
+    __forceinline void scatterHit(const RTCRayK& ray, const size_t begin, const size_t end) const {
+      for (size_t k=0; k<K && begin+k<end; k++) storeHit(ray,k,begin+k);
+    }
+
+    /*! copies the occlusion result of an SOA packet back into the stream */
+    template<int K, typename RTCRayK>
+    __forceinline void scatterOcclusion(const RTCRayK& ray, const size_t begin, const size_t end) const {
+      memcpy(rays.geomID+begin,ray.geomID,min(size_t(K),end-begin)*sizeof(int));
+    }
+
+  private:
+    const RTCRayNp& rays;
+  };
+
+  /*! view of a stream that visits the rays in the order given by an index permutation */
+  template<typename Stream>
+  struct SortedRayStream
+  {
+    __forceinline SortedRayStream (const Stream& stream, const unsigned int* ids) 
+      : stream(stream), ids(ids) {}
+
+    template<int K, typename RTCRayK>
+    __forceinline void gather(RTCRayK& ray, int* valid, const size_t begin, const size_t end) const
+    {
+      for (size_t k=0; k<K; k++) {
+        valid[k] = begin+k < end ? -1 : 0;
+        if (valid[k]) stream.load(ray,k,ids[begin+k]);
+      }
+    }
+
+    template<int K, typename RTCRayK>
+    __forceinline void scatterHit(const RTCRayK& ray, const size_t begin, const size_t end) const {
+      for (size_t k=0; k<K && begin+k<end; k++) stream.storeHit(ray,k,ids[begin+k]);
+    }
+
+    template<int K, typename RTCRayK>
+    __forceinline void scatterOcclusion(const RTCRayK& ray, const size_t begin, const size_t end) const {
+      for (size_t k=0; k<K && begin+k<end; k++) stream.storeOcclusion(ray,k,ids[begin+k]);
+    }
+
+  private:
+    const Stream& stream;
+    const unsigned int* ids;
+  };
+
+  /*! Calculates an order of the rays of a stream that groups rays by
+   *  their direction octant first and then by the morton code of their
+   *  origin, such that consecutive packets contain coherent rays. */
+  template<typename Stream>
+  void sortRays(const Stream& stream, const size_t M, std::vector<unsigned int>& ids)
+  {
+    BBox3fa bounds(empty);
+    for (size_t i=0; i<M; i++)
+      bounds.extend(stream.org(i));
+    
+    const Vec3fa base = bounds.lower;
+    const Vec3fa diag = bounds.upper-bounds.lower;
+    const Vec3fa scale = Vec3fa(1023.0f)*rcp(max(diag,Vec3fa(1E-19f)));
+
+    std::vector<uint64_t> keys(M);
+    for (size_t i=0; i<M; i++)
+    {
+      const Vec3fa d = stream.dir(i);
+      const unsigned int octant = (d.x < 0.0f ? 1 : 0) | (d.y < 0.0f ? 2 : 0) | (d.z < 0.0f ? 4 : 0);
+      const Vec3fa p = (stream.org(i)-base)*scale;
+      const unsigned int x = clamp(int(p.x),0,1023);
+      const unsigned int y = clamp(int(p.y),0,1023);
+      const unsigned int z = clamp(int(p.z),0,1023);
+      const unsigned int code = (octant << 30) | bitInterleave(x,y,z);
+      keys[i] = (uint64_t(code) << 32) | uint64_t(i);
+    }
+    std::sort(keys.begin(),keys.end());
+
+    ids.resize(M);
+    for (size_t i=0; i<M; i++)
+      ids[i] = (unsigned int) keys[i];
+  }
+
+  /*! SOA layout of a single ray, used to trace streams through the single ray interface */
+  struct RTCRay1
+  {
+    float orgx[1], orgy[1], orgz[1];
+    float dirx[1], diry[1], dirz[1];
+    float tnear[1], tfar[1], time[1];
+    int   mask[1];
+    float Ngx[1], Ngy[1], Ngz[1];
+    float u[1], v[1];
+    int   geomID[1], primID[1], instID[1];
+    int   instIDPath[RTC_MAX_INSTANCE_DEPTH-1][1];
+  };
+
+  __forceinline RTCRay toAOS(const RTCRay1& ray1)
+  {
+    RTCRay ray;
+    ray.org[0] = ray1.orgx[0]; ray.org[1] = ray1.orgy[0]; ray.org[2] = ray1.orgz[0];
+    ray.dir[0] = ray1.dirx[0]; ray.dir[1] = ray1.diry[0]; ray.dir[2] = ray1.dirz[0];
+    ray.tnear = ray1.tnear[0]; ray.tfar = ray1.tfar[0];
+    ray.time = ray1.time[0]; ray.mask = ray1.mask[0];
+    ray.geomID = ray1.geomID[0]; ray.primID = ray1.primID[0]; ray.instID = ray1.instID[0];
+    for (size_t l=0; l<RTC_MAX_INSTANCE_DEPTH-1; l++) ray.instIDPath[l] = ray1.instIDPath[l][0];
+    return ray;
+  }
+
+  __forceinline void intersectPacket(Scene* scene, const int* valid, RTCRay1& ray1)
+  {
+    if (!valid[0]) return;
+    RTCRay ray = toAOS(ray1);
+    scene->intersect(ray);
+    ray1.tfar[0] = ray.tfar;
+    ray1.Ngx[0] = ray.Ng[0]; ray1.Ngy[0] = ray.Ng[1]; ray1.Ngz[0] = ray.Ng[2];
+    ray1.u[0] = ray.u; ray1.v[0] = ray.v;
+    ray1.geomID[0] = ray.geomID; ray1.primID[0] = ray.primID; ray1.instID[0] = ray.instID;
+    for (size_t l=0; l<RTC_MAX_INSTANCE_DEPTH-1; l++) ray1.instIDPath[l][0] = ray.instIDPath[l];
+  }
+
+  __forceinline void occludedPacket(Scene* scene, const int* valid, RTCRay1& ray1)
+  {
+    if (!valid[0]) return;
+    RTCRay ray = toAOS(ray1);
+    scene->occluded(ray);
+    ray1.geomID[0] = ray.geomID;
+  }
+
+  /*! dispatch to the packet intersectors of matching width */
+  __forceinline void intersectPacket(Scene* scene, const void* valid, RTCRay4&  ray) { scene->intersect4 (valid,ray); }
+  __forceinline void intersectPacket(Scene* scene, const void* valid, RTCRay8&  ray) { scene->intersect8 (valid,ray); }
+  __forceinline void intersectPacket(Scene* scene, const void* valid, RTCRay16& ray) { scene->intersect16(valid,ray); }
+  __forceinline void occludedPacket (Scene* scene, const void* valid, RTCRay4&  ray) { scene->occluded4  (valid,ray); }
+  __forceinline void occludedPacket (Scene* scene, const void* valid, RTCRay8&  ray) { scene->occluded8  (valid,ray); }
+  __forceinline void occludedPacket (Scene* scene, const void* valid, RTCRay16& ray) { scene->occluded16 (valid,ray); }
+
+  template<int K, typename RTCRayK, typename Stream>
+  void intersectStream(Scene* scene, const Stream& stream, const size_t M)
+  {
+    __aligned(64) int valid[K];
+    RTCRayK ray;
+    for (size_t i=0; i<M; i+=K)
+    {
+      stream.template gather<K>(ray,valid,i,M);
+      intersectPacket(scene,valid,ray);
+      stream.template scatterHit<K>(ray,i,M);
+    }
+  }
+
+  template<int K, typename RTCRayK, typename Stream>
+  void occludedStream(Scene* scene, const Stream& stream, const size_t M)
+  {
+    __aligned(64) int valid[K];
+    RTCRayK ray;
+    for (size_t i=0; i<M; i+=K)
+    {
+      stream.template gather<K>(ray,valid,i,M);
+      occludedPacket(scene,valid,ray);
+      stream.template scatterOcclusion<K>(ray,i,M);
+    }
+  }
+
+  /*! traces the stream in packets of K rays, single rays are traced as packets of size 1 */
+  template<typename Stream>
+  void intersectStream(Scene* scene, const Stream& stream, const size_t M, const size_t K)
+  {
+    switch (K) {
+    case 16: intersectStream<16,RTCRay16>(scene,stream,M); break;
+    case  8: intersectStream< 8,RTCRay8 >(scene,stream,M); break;
+    case  4: intersectStream< 4,RTCRay4 >(scene,stream,M); break;
+    default: intersectStream< 1,RTCRay1 >(scene,stream,M); break;
+    }
+  }
+
+  template<typename Stream>
+  void occludedStream(Scene* scene, const Stream& stream, const size_t M, const size_t K)
+  {
+    switch (K) {
+    case 16: occludedStream<16,RTCRay16>(scene,stream,M); break;
+    case  8: occludedStream< 8,RTCRay8 >(scene,stream,M); break;
+    case  4: occludedStream< 4,RTCRay4 >(scene,stream,M); break;
+    default: occludedStream< 1,RTCRay1 >(scene,stream,M); break;
+    }
+  }
+
+  size_t RayStream::packetSize(const Scene* scene)
+  {
+#if defined(RTCORE_RAY_PACKETS)
+#if defined(__TARGET_SIMD16__)
+    if ((scene->aflags & RTC_INTERSECT16) && hasISA(AVX512KNL)) return 16;
+#endif
+#if defined(__TARGET_SIMD8__)
+    if ((scene->aflags & RTC_INTERSECT8) && hasISA(AVX)) return 8;
+#endif
+#if defined(__TARGET_SIMD4__)
+    if (scene->aflags & RTC_INTERSECT4) return 4;
+#endif
+#endif
+    return 1;
+  }
+
+  template<typename Stream>
+  void intersect(Scene* scene, const Stream& stream, const size_t M)
+  {
+    const size_t K = RayStream::packetSize(scene);
+    if (scene->isReorderRays() && K > 1 && M > K) {
+      std::vector<unsigned int> ids; sortRays(stream,M,ids);
+      intersectStream(scene,SortedRayStream<Stream>(stream,ids.data()),M,K);
+    }
+    else 
+      intersectStream(scene,stream,M,K);
+  }
+
+  template<typename Stream>
+  void occluded(Scene* scene, const Stream& stream, const size_t M)
+  {
+    const size_t K = RayStream::packetSize(scene);
+    if (scene->isReorderRays() && K > 1 && M > K) {
+      std::vector<unsigned int> ids; sortRays(stream,M,ids);
+      occludedStream(scene,SortedRayStream<Stream>(stream,ids.data()),M,K);
+    }
+    else 
+      occludedStream(scene,stream,M,K);
+  }
+
+  void RayStream::intersect1M (Scene* scene, RTCRay* rays, const size_t M, const size_t stride) {
+    intersect(scene,RayStream1M(rays,stride),M);
+  }
+
+  void RayStream::occluded1M (Scene* scene, RTCRay* rays, const size_t M, const size_t stride) {
+    occluded(scene,RayStream1M(rays,stride),M);
+  }
+
+  void RayStream::intersectNp (Scene* scene, const RTCRayNp& rays, const size_t N) {
+    intersect(scene,RayStreamNp(rays),N);
+  }
+
+  void RayStream::occludedNp (Scene* scene, const RTCRayNp& rays, const size_t N) {
+    occluded(scene,RayStreamNp(rays),N);
+  }
+}
@@ -0,0 +1,46 @@
+// ======================================================================== //
+// Copyright 2009-2015 Intel Corporation                                    //
+//                                                                          //
+// Licensed under the Apache License, Version 2.0 (the "License");          //
+// you may not use this file except in compliance with the License.         //
+// You may obtain a copy of the License at                                  //
+//                                                                          //
+//     http://www.apache.org/licenses/LICENSE-2.0                           //
+//                                                                          //
+// Unless required by applicable law or agreed to in writing, software      //
+// distributed under the License is distributed on an "AS IS" BASIS,        //
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. //
+// See the License for the specific language governing permissions and      //
+// limitations under the License.                                           //
+// ======================================================================== //
+
+#pragma once
+
+#include "default.h"
+
+namespace embree
+{
+  class Scene;
+
+  /*! Traces streams of individual rays by repacking them into the
+   *  widest ray packets enabled for the scene. */
+  class RayStream
+  {
+  public:
+
+    /*! returns the packet size used to trace streams for some scene, 1 if single rays are used */
+    static size_t packetSize(const Scene* scene);
+
+    /*! Intersects a stream of M rays with the scene. */
+    static void intersect1M (Scene* scene, RTCRay* rays, const size_t M, const size_t stride);
+
+    /*! Tests if a stream of M rays is occluded by the scene. */
+    static void occluded1M  (Scene* scene, RTCRay* rays, const size_t M, const size_t stride);
+
+    /*! Intersects a stream of N rays in SOA layout with the scene. */
+    static void intersectNp (Scene* scene, const RTCRayNp& rays, const size_t N);
+
+    /*! Tests if a stream of N rays in SOA layout is occluded by the scene. */
+    static void occludedNp  (Scene* scene, const RTCRayNp& rays, const size_t N);
+  };
+}
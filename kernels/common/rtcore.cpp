@@ -23,6 +23,7 @@
 #include "device.h"
 #include "scene.h"
 #include "raystream_log.h"
+#include "raystream.h"
 
 namespace embree
 {  
@@ -218,6 +219,28 @@ namespace embree
     RTCORE_CATCH_END(scene->device);
   }
 
+  RTCORE_API void rtcSaveScene (RTCScene hscene, const char* fileName) 
+  {
+    Scene* scene = (Scene*) hscene;
+    RTCORE_CATCH_BEGIN;
+    RTCORE_TRACE(rtcSaveScene);
+    RTCORE_VERIFY_HANDLE(hscene);
+    RTCORE_VERIFY_HANDLE(fileName);
+    scene->save(fileName);
+    RTCORE_CATCH_END(scene->device);
+  }
+
+  RTCORE_API void rtcLoadScene (RTCScene hscene, const char* fileName) 
+  {
+    Scene* scene = (Scene*) hscene;
+    RTCORE_CATCH_BEGIN;
+    RTCORE_TRACE(rtcLoadScene);
+    RTCORE_VERIFY_HANDLE(hscene);
+    RTCORE_VERIFY_HANDLE(fileName);
+    scene->load(fileName);
+    RTCORE_CATCH_END(scene->device);
+  }
+
   RTCORE_API void rtcCommitThread(RTCScene hscene, unsigned int threadID, unsigned int numThreads) 
   {
     Scene* scene = (Scene*) hscene;
@@ -496,6 +519,70 @@ namespace embree
   }
 #endif
   
+  RTCORE_API void rtcIntersect1M (RTCScene hscene, RTCRay* rays, const size_t M, const size_t stride) 
+  {
+    Scene* scene = (Scene*) hscene;
+    RTCORE_CATCH_BEGIN;
+    RTCORE_TRACE(rtcIntersect1M);
+    RTCORE_VERIFY_HANDLE(hscene);
+    if ((scene->aflags & RTC_INTERSECT_STREAM) == 0) throw_RTCError(RTC_INVALID_OPERATION,"rtcIntersect1M and rtcOccluded1M not enabled");
+    if (stride < sizeof(RTCRay) || (stride & 0x0F)) throw_RTCError(RTC_INVALID_ARGUMENT, "invalid ray stride");
+#if defined(DEBUG)
+    if (scene->isModified()) throw_RTCError(RTC_INVALID_OPERATION,"scene got not committed");
+    if (((size_t)rays) & 0x0F        ) throw_RTCError(RTC_INVALID_ARGUMENT, "rays not aligned to 16 bytes");   
+#endif
+    STAT3(normal.travs,M,M,M);
+    RayStream::intersect1M(scene,rays,M,stride);
+    RTCORE_CATCH_END(scene->device);
+  }
+
+  RTCORE_API void rtcOccluded1M (RTCScene hscene, RTCRay* rays, const size_t M, const size_t stride) 
+  {
+    Scene* scene = (Scene*) hscene;
+    RTCORE_CATCH_BEGIN;
+    RTCORE_TRACE(rtcOccluded1M);
+    RTCORE_VERIFY_HANDLE(hscene);
+    if ((scene->aflags & RTC_INTERSECT_STREAM) == 0) throw_RTCError(RTC_INVALID_OPERATION,"rtcIntersect1M and rtcOccluded1M not enabled");
+    if (stride < sizeof(RTCRay) || (stride & 0x0F)) throw_RTCError(RTC_INVALID_ARGUMENT, "invalid ray stride");
+#if defined(DEBUG)
+    if (scene->isModified()) throw_RTCError(RTC_INVALID_OPERATION,"scene got not committed");
+    if (((size_t)rays) & 0x0F        ) throw_RTCError(RTC_INVALID_ARGUMENT, "rays not aligned to 16 bytes");   
+#endif
+    STAT3(shadow.travs,M,M,M);
+    RayStream::occluded1M(scene,rays,M,stride);
+    RTCORE_CATCH_END(scene->device);
+  }
+  
+  RTCORE_API void rtcIntersectNp (RTCScene hscene, const RTCRayNp& rays, const size_t N) 
+  {
+    Scene* scene = (Scene*) hscene;
+    RTCORE_CATCH_BEGIN;
+    RTCORE_TRACE(rtcIntersectNp);
+    RTCORE_VERIFY_HANDLE(hscene);
+    if ((scene->aflags & RTC_INTERSECT_STREAM) == 0) throw_RTCError(RTC_INVALID_OPERATION,"rtcIntersectNp and rtcOccludedNp not enabled");
+#if defined(DEBUG)
+    if (scene->isModified()) throw_RTCError(RTC_INVALID_OPERATION,"scene got not committed");
+#endif
+    STAT3(normal.travs,N,N,N);
+    RayStream::intersectNp(scene,rays,N);
+    RTCORE_CATCH_END(scene->device);
+  }
+
+  RTCORE_API void rtcOccludedNp (RTCScene hscene, const RTCRayNp& rays, const size_t N) 
+  {
+    Scene* scene = (Scene*) hscene;
+    RTCORE_CATCH_BEGIN;
+    RTCORE_TRACE(rtcOccludedNp);
+    RTCORE_VERIFY_HANDLE(hscene);
+    if ((scene->aflags & RTC_INTERSECT_STREAM) == 0) throw_RTCError(RTC_INVALID_OPERATION,"rtcIntersectNp and rtcOccludedNp not enabled");
+#if defined(DEBUG)
+    if (scene->isModified()) throw_RTCError(RTC_INVALID_OPERATION,"scene got not committed");
+#endif
+    STAT3(shadow.travs,N,N,N);
+    RayStream::occludedNp(scene,rays,N);
+    RTCORE_CATCH_END(scene->device);
+  }
+  
   RTCORE_API void rtcDeleteScene (RTCScene hscene) 
   {
     Scene* scene = (Scene*) hscene;
@@ -521,45 +608,86 @@ namespace embree
     return -1;
   }
 
-  RTCORE_API void rtcSetTransform (RTCScene hscene, unsigned geomID, RTCMatrixType layout, const float* xfm) 
+  RTCORE_API unsigned rtcNewInstance2 (RTCScene htarget, RTCScene hsource, size_t numTimeSteps) 
   {
-    Scene* scene = (Scene*) hscene;
+    Scene* target = (Scene*) htarget;
+    Scene* source = (Scene*) hsource;
     RTCORE_CATCH_BEGIN;
-    RTCORE_TRACE(rtcSetTransform);
-    RTCORE_VERIFY_HANDLE(hscene);
-    RTCORE_VERIFY_GEOMID(geomID);
-    RTCORE_VERIFY_HANDLE(xfm);
+    RTCORE_TRACE(rtcNewInstance2);
+    RTCORE_VERIFY_HANDLE(htarget);
+    RTCORE_VERIFY_HANDLE(hsource);
+    if (target->device != source->device) throw_RTCError(RTC_INVALID_OPERATION,"scenes do not belong to the same device");
+    return target->newInstance(source,numTimeSteps);
+    RTCORE_CATCH_END(target->device);
+    return -1;
+  }
 
-    AffineSpace3fa transform = one;
+  RTCORE_API unsigned rtcNewInstanceArray (RTCScene htarget, RTCScene hsource, size_t numInstances) 
+  {
+    Scene* target = (Scene*) htarget;
+    Scene* source = (Scene*) hsource;
+    RTCORE_CATCH_BEGIN;
+    RTCORE_TRACE(rtcNewInstanceArray);
+    RTCORE_VERIFY_HANDLE(htarget);
+    RTCORE_VERIFY_HANDLE(hsource);
+    if (target->device != source->device) throw_RTCError(RTC_INVALID_OPERATION,"scenes do not belong to the same device");
+    return target->newInstanceArray(source,numInstances);
+    RTCORE_CATCH_END(target->device);
+    return -1;
+  }
+
+  /*! converts a user specified transformation matrix */
+  static AffineSpace3fa convertTransform(RTCMatrixType layout, const float* xfm)
+  {
     switch (layout) 
     {
     case RTC_MATRIX_ROW_MAJOR:
-      transform = AffineSpace3fa(Vec3fa(xfm[ 0],xfm[ 4],xfm[ 8]),
-                                 Vec3fa(xfm[ 1],xfm[ 5],xfm[ 9]),
-                                 Vec3fa(xfm[ 2],xfm[ 6],xfm[10]),
-                                 Vec3fa(xfm[ 3],xfm[ 7],xfm[11]));
-      break;
+      return AffineSpace3fa(Vec3fa(xfm[ 0],xfm[ 4],xfm[ 8]),
+                            Vec3fa(xfm[ 1],xfm[ 5],xfm[ 9]),
+                            Vec3fa(xfm[ 2],xfm[ 6],xfm[10]),
+                            Vec3fa(xfm[ 3],xfm[ 7],xfm[11]));
 
     case RTC_MATRIX_COLUMN_MAJOR:
-      transform = AffineSpace3fa(Vec3fa(xfm[ 0],xfm[ 1],xfm[ 2]),
-                                 Vec3fa(xfm[ 3],xfm[ 4],xfm[ 5]),
-                                 Vec3fa(xfm[ 6],xfm[ 7],xfm[ 8]),
-                                 Vec3fa(xfm[ 9],xfm[10],xfm[11]));
-      break;
+      return AffineSpace3fa(Vec3fa(xfm[ 0],xfm[ 1],xfm[ 2]),
+                            Vec3fa(xfm[ 3],xfm[ 4],xfm[ 5]),
+                            Vec3fa(xfm[ 6],xfm[ 7],xfm[ 8]),
+                            Vec3fa(xfm[ 9],xfm[10],xfm[11]));
 
     case RTC_MATRIX_COLUMN_MAJOR_ALIGNED16:
-      transform = AffineSpace3fa(Vec3fa(xfm[ 0],xfm[ 1],xfm[ 2]),
-                                 Vec3fa(xfm[ 4],xfm[ 5],xfm[ 6]),
-                                 Vec3fa(xfm[ 8],xfm[ 9],xfm[10]),
-                                 Vec3fa(xfm[12],xfm[13],xfm[14]));
-      break;
+      return AffineSpace3fa(Vec3fa(xfm[ 0],xfm[ 1],xfm[ 2]),
+                            Vec3fa(xfm[ 4],xfm[ 5],xfm[ 6]),
+                            Vec3fa(xfm[ 8],xfm[ 9],xfm[10]),
+                            Vec3fa(xfm[12],xfm[13],xfm[14]));
 
     default: 
       throw_RTCError(RTC_INVALID_OPERATION,"Unknown matrix type");
-      break;
+      return one;
     }
-    ((Scene*) scene)->get_locked(geomID)->setTransform(transform);
+  }
 
+  RTCORE_API void rtcSetTransform (RTCScene hscene, unsigned geomID, RTCMatrixType layout, const float* xfm) 
+  {
+    Scene* scene = (Scene*) hscene;
+    RTCORE_CATCH_BEGIN;
+    RTCORE_TRACE(rtcSetTransform);
+    RTCORE_VERIFY_HANDLE(hscene);
+    RTCORE_VERIFY_GEOMID(geomID);
+    RTCORE_VERIFY_HANDLE(xfm);
+    const AffineSpace3fa transform = convertTransform(layout,xfm);
+    ((Scene*) scene)->get_locked(geomID)->setTransform(transform,0);
+    RTCORE_CATCH_END(scene->device);
+  }
+
+  RTCORE_API void rtcSetTransform2 (RTCScene hscene, unsigned geomID, RTCMatrixType layout, const float* xfm, size_t timeStep) 
+  {
+    Scene* scene = (Scene*) hscene;
+    RTCORE_CATCH_BEGIN;
+    RTCORE_TRACE(rtcSetTransform2);
+    RTCORE_VERIFY_HANDLE(hscene);
+    RTCORE_VERIFY_GEOMID(geomID);
+    RTCORE_VERIFY_HANDLE(xfm);
+    const AffineSpace3fa transform = convertTransform(layout,xfm);
+    ((Scene*) scene)->get_locked(geomID)->setTransform(transform,timeStep);
     RTCORE_CATCH_END(scene->device);
   }
 
@@ -585,6 +713,17 @@ namespace embree
     return -1;
   }
 
+  RTCORE_API unsigned rtcNewQuadMesh (RTCScene hscene, RTCGeometryFlags flags, size_t numQuads, size_t numVertices, size_t numTimeSteps) 
+  {
+    Scene* scene = (Scene*) hscene;
+    RTCORE_CATCH_BEGIN;
+    RTCORE_TRACE(rtcNewQuadMesh);
+    RTCORE_VERIFY_HANDLE(hscene);
+    return scene->newQuadMesh(flags,numQuads,numVertices,numTimeSteps);
+    RTCORE_CATCH_END(scene->device);
+    return -1;
+  }
+
   RTCORE_API unsigned rtcNewHairGeometry (RTCScene hscene, RTCGeometryFlags flags, size_t numCurves, size_t numVertices, size_t numTimeSteps) 
   {
     Scene* scene = (Scene*) hscene;
@@ -596,6 +735,17 @@ namespace embree
     return -1;
   }
 
+  RTCORE_API unsigned rtcNewPointGeometry (RTCScene hscene, RTCGeometryFlags flags, size_t numPoints, size_t numTimeSteps) 
+  {
+    Scene* scene = (Scene*) hscene;
+    RTCORE_CATCH_BEGIN;
+    RTCORE_TRACE(rtcNewPointGeometry);
+    RTCORE_VERIFY_HANDLE(hscene);
+    return scene->newPoints(flags,numPoints,numTimeSteps);
+    RTCORE_CATCH_END(scene->device);
+    return -1;
+  }
+
   RTCORE_API unsigned rtcNewSubdivisionMesh (RTCScene hscene, RTCGeometryFlags flags, size_t numFaces, size_t numEdges, size_t numVertices, 
                                              size_t numEdgeCreases, size_t numVertexCreases, size_t numHoles, size_t numTimeSteps) 
   {
@@ -138,10 +138,22 @@ namespace embree
     return rtcNewInstance(target,source);
   }
   
+  extern "C" unsigned ispcNewInstance2 (RTCScene target, RTCScene source, size_t numTimeSteps) {
+    return rtcNewInstance2(target,source,numTimeSteps);
+  }
+  
+  extern "C" unsigned ispcNewInstanceArray (RTCScene target, RTCScene source, size_t numInstances) {
+    return rtcNewInstanceArray(target,source,numInstances);
+  }
+  
   extern "C" void ispcSetTransform (RTCScene scene, unsigned geomID, RTCMatrixType layout, const float* xfm) {
     return rtcSetTransform(scene,geomID,layout,xfm);
   }
   
+  extern "C" void ispcSetTransform2 (RTCScene scene, unsigned geomID, RTCMatrixType layout, const float* xfm, size_t timeStep) {
+    return rtcSetTransform2(scene,geomID,layout,xfm,timeStep);
+  }
+  
   extern "C" unsigned ispcNewUserGeometry (RTCScene scene, size_t numItems) {
     return rtcNewUserGeometry(scene,numItems);
   }
@@ -150,10 +162,18 @@ namespace embree
     return rtcNewTriangleMesh((RTCScene)scene,flags,numTriangles,numVertices,numTimeSteps);
   }
   
+  extern "C" unsigned ispcNewQuadMesh (RTCScene scene, RTCGeometryFlags flags, size_t numQuads, size_t numVertices, size_t numTimeSteps) {
+    return rtcNewQuadMesh((RTCScene)scene,flags,numQuads,numVertices,numTimeSteps);
+  }
+  
   extern "C" unsigned ispcNewBezierCurves (RTCScene scene, RTCGeometryFlags flags, size_t numCurves, size_t numVertices, size_t numTimeSteps) {
     return rtcNewHairGeometry(scene,flags,numCurves,numVertices,numTimeSteps);
   }
 
+  extern "C" unsigned ispcNewPointGeometry (RTCScene scene, RTCGeometryFlags flags, size_t numPoints, size_t numTimeSteps) {
+    return rtcNewPointGeometry(scene,flags,numPoints,numTimeSteps);
+  }
+
   extern "C" unsigned ispcNewSubdivisionMesh (RTCScene scene, RTCGeometryFlags flags, size_t numFaces, size_t numEdges, 
                                               size_t numVertices, size_t numEdgeCreases, size_t numVertexCreases, size_t numHoles, size_t numTimeSteps) 
   {
@@ -41,14 +41,15 @@ namespace embree
   Scene::Scene (Device* device, RTCSceneFlags sflags, RTCAlgorithmFlags aflags)
     : device(device), 
       Accel(AccelData::TY_UNKNOWN),
-      flags(sflags), aflags(aflags), numMappedBuffers(0), is_build(false), modified(true), 
+      flags(sflags), aflags(aflags), numMappedBuffers(0), is_build(false), modified(true), mappedFile(nullptr), mappedFileBytes(0),
       needTriangleIndices(false), needTriangleVertices(false), 
+      needQuadIndices(false), needQuadVertices(false), needPointVertices(false), 
       needBezierIndices(false), needBezierVertices(false),
       needSubdivIndices(false), needSubdivVertices(false),
-      numTriangles(0), numTriangles2(0), 
+      numTriangles(0), numTriangles2(0), numQuads(0), numPoints(0), numPoints2(0), 
       numBezierCurves(0), numBezierCurves2(0), 
       numSubdivPatches(0), numSubdivPatches2(0), 
-      numUserGeometries1(0), numSubdivEnableDisableEvents(0),
+      numUserGeometries1(0), numInstances(0), numInstances2(0), numSubdivEnableDisableEvents(0),
       numIntersectionFilters4(0), numIntersectionFilters8(0), numIntersectionFilters16(0),
       commitCounter(0), commitCounterSubdiv(0), 
       progress_monitor_function(nullptr), progress_monitor_ptr(nullptr), progress_monitor_counter(0)
@@ -68,9 +69,12 @@ namespace embree
 
     if (aflags & RTC_INTERPOLATE) {
       needTriangleIndices = true;
+      needQuadIndices = true;
       needBezierIndices = true;
       //needSubdivIndices = true; // not required for interpolation
       needTriangleVertices = true;
+      needQuadVertices = true;
+      needPointVertices = true;
       needBezierVertices = true;
       needSubdivVertices = true;
     }
@@ -139,12 +143,23 @@ namespace embree
 #else
     createTriangleAccel();
     accels.add(BVH4::BVH4Triangle4vMB(this));
-    accels.add(BVH4::BVH4UserGeometry(this));
+    createQuadAccel();
+    createPointAccel();
+    accels.add(BVH4::BVH4Sphere4MB(this));
+    createUserGeometryAccel();
+    accels.add(BVH4::BVH4InstanceGeometry(this));
+    accels.add(BVH4::BVH4InstanceGeometryMB(this));
     createHairAccel();
     accels.add(BVH4::BVH4OBBBezier1iMB(this,false));
     createSubdivAccel();
 #endif
 
+    /* select how rays get traced through the acceleration structures of the different geometry types */
+    if      (device->toplevel_traverser == "default"   ) accels.unified = false;
+    else if (device->toplevel_traverser == "sequential") accels.unified = false;
+    else if (device->toplevel_traverser == "unified"   ) accels.unified = true;
+    else THROW_RUNTIME_ERROR("unknown traverser "+device->toplevel_traverser+" for AccelN");
+
     /* increment number of scenes */
     numScenes++;
   }
@@ -162,16 +177,14 @@ namespace embree
 #if defined (__TARGET_AVX__)
           if (hasISA(AVX))
 	  {
-            // FIXME: there appears to be a bug in the spatial split builder, performance and SAH is lower than for standard builder
-            //if (isHighQuality()) accels.add(BVH8::BVH8Triangle4SpatialSplit(this)); 
-            /*else*/               accels.add(BVH8::BVH8Triangle4ObjectSplit(this)); 
+            if (isHighQuality()) accels.add(BVH8::BVH8Triangle4SpatialSplit(this)); 
+            else                 accels.add(BVH8::BVH8Triangle4ObjectSplit(this)); 
           }
           else 
 #endif
           {
-            // FIXME: there appears to be a bug in the spatial split builder, performance and SAH is lower than for standard builder
-            //if (isHighQuality()) accels.add(BVH4::BVH4Triangle4SpatialSplit(this));           
-            /*else*/               accels.add(BVH4::BVH4Triangle4ObjectSplit(this)); 
+            if (isHighQuality()) accels.add(BVH4::BVH4Triangle4SpatialSplit(this));           
+            else                 accels.add(BVH4::BVH4Triangle4ObjectSplit(this)); 
           }
           break;
 
@@ -208,15 +221,43 @@ namespace embree
 #if defined (__TARGET_AVX__)
     else if (device->tri_accel == "bvh4.bvh4.triangle8")    accels.add(BVH4::BVH4BVH4Triangle8ObjectSplit(this));
     else if (device->tri_accel == "bvh4.triangle8")         accels.add(BVH4::BVH4Triangle8(this));
+    else if (device->tri_accel == "bvh8.bvh8.triangle4")    accels.add(BVH8::BVH8BVH8Triangle4ObjectSplit(this));
     else if (device->tri_accel == "bvh8.triangle4")         accels.add(BVH8::BVH8Triangle4(this));
     else if (device->tri_accel == "bvh8.triangle8")         accels.add(BVH8::BVH8Triangle8(this));
     else if (device->tri_accel == "bvh8.trianglepairs8")    accels.add(BVH8::BVH8TrianglePairs8(this));
+    else if (device->tri_accel == "bvh8q.triangle4")        accels.add(BVH8::BVH8Triangle4Quantized(this));
     //else if (device->tri_accel == "bvh8.triangle8v")    accels.add(BVH8::BVH8Triangle8v(this));
 
 #endif
     else THROW_RUNTIME_ERROR("unknown triangle acceleration structure "+device->tri_accel);
   }
 
+  void Scene::createQuadAccel()
+  {
+    if (device->quad_accel == "default") 
+    {
+#if defined (__TARGET_AVX__)
+      if (hasISA(AVX))
+        accels.add(BVH8::BVH8Quad4v(this));
+      else
+#endif
+        accels.add(BVH4::BVH4Quad4v(this));
+    }
+    else if (device->quad_accel == "bvh4.quad4v")       accels.add(BVH4::BVH4Quad4v(this));
+#if defined (__TARGET_AVX__)
+    else if (device->quad_accel == "bvh8.quad4v")       accels.add(BVH8::BVH8Quad4v(this));
+#endif
+    else THROW_RUNTIME_ERROR("unknown quad acceleration structure "+device->quad_accel);
+  }
+
+  void Scene::createPointAccel()
+  {
+    if      (device->point_builder == "default") accels.add(isStatic() ? BVH4::BVH4Sphere4(this) : BVH4::BVH4Sphere4Morton(this));
+    else if (device->point_builder == "sah"    ) accels.add(BVH4::BVH4Sphere4(this));
+    else if (device->point_builder == "morton" ) accels.add(BVH4::BVH4Sphere4Morton(this));
+    else THROW_RUNTIME_ERROR("unknown builder "+device->point_builder+" for BVH4<Sphere4>");
+  }
+
   void Scene::createHairAccel()
   {
     if (device->hair_accel == "default") 
@@ -245,9 +286,22 @@ namespace embree
     else if (device->hair_accel == "bvh4.bezier1i"    ) accels.add(BVH4::BVH4Bezier1i(this));
     else if (device->hair_accel == "bvh4obb.bezier1v" ) accels.add(BVH4::BVH4OBBBezier1v(this,false));
     else if (device->hair_accel == "bvh4obb.bezier1i" ) accels.add(BVH4::BVH4OBBBezier1i(this,false));
+#if defined (__TARGET_AVX__)
+    else if (device->hair_accel == "bvh8.bezier1v"    ) accels.add(BVH8::BVH8Bezier1v(this));
+#endif
     else THROW_RUNTIME_ERROR("unknown hair acceleration structure "+device->hair_accel);
   }
 
+  void Scene::createUserGeometryAccel()
+  {
+    if      (device->user_accel == "default"    ) accels.add(BVH4::BVH4UserGeometry(this));
+    else if (device->user_accel == "bvh4.object") accels.add(BVH4::BVH4UserGeometry(this));
+#if defined (__TARGET_AVX__)
+    else if (device->user_accel == "bvh8.object") accels.add(BVH8::BVH8UserGeometry(this));
+#endif
+    else THROW_RUNTIME_ERROR("unknown user geometry acceleration structure "+device->user_accel);
+  }
+
   void Scene::createSubdivAccel()
   {
     if (device->subdiv_accel == "default") 
@@ -274,6 +328,9 @@ namespace embree
     delete group; group = nullptr;
 #endif
 
+    /* release acceleration structures loaded from file */
+    os_unmap_file(mappedFile,mappedFileBytes);
+
     /* decrement number of scenes */
     numScenes--;
   }
@@ -287,8 +344,26 @@ namespace embree
     return geom->id;
   }
   
-  unsigned Scene::newInstance (Scene* scene) {
-    Geometry* geom = new Instance(this,scene);
+  unsigned Scene::newInstance (Scene* scene, size_t numTimeSteps) 
+  {
+#if defined(__MIC__)
+    if (numTimeSteps != 1) {
+      throw_RTCError(RTC_INVALID_OPERATION,"motion blurred instances not supported");
+      return -1;
+    }
+#else
+    if (numTimeSteps == 0 || numTimeSteps > RTC_MAX_TIME_STEPS) {
+      throw_RTCError(RTC_INVALID_OPERATION,"only 1 to " TOSTRING(RTC_MAX_TIME_STEPS) " time steps supported");
+      return -1;
+    }
+#endif
+
+    Geometry* geom = new Instance(this,scene,1,numTimeSteps,false);
+    return geom->id;
+  }
+
+  unsigned Scene::newInstanceArray (Scene* scene, size_t numInstances) {
+    Geometry* geom = new Instance(this,scene,numInstances,1,true);
     return geom->id;
   }
 
@@ -299,15 +374,64 @@ namespace embree
       return -1;
     }
 
+#if defined(__MIC__)
     if (numTimeSteps == 0 || numTimeSteps > 2) {
       throw_RTCError(RTC_INVALID_OPERATION,"only 1 or 2 time steps supported");
       return -1;
     }
+#else
+    if (numTimeSteps == 0 || numTimeSteps > RTC_MAX_TIME_STEPS) {
+      throw_RTCError(RTC_INVALID_OPERATION,"only 1 to " TOSTRING(RTC_MAX_TIME_STEPS) " time steps supported");
+      return -1;
+    }
+#endif
     
     Geometry* geom = new TriangleMesh(this,gflags,numTriangles,numVertices,numTimeSteps);
     return geom->id;
   }
 
+  unsigned Scene::newQuadMesh (RTCGeometryFlags gflags, size_t numQuads, size_t numVertices, size_t numTimeSteps) 
+  {
+    if (isStatic() && (gflags != RTC_GEOMETRY_STATIC)) {
+      throw_RTCError(RTC_INVALID_OPERATION,"static scenes can only contain static geometries");
+      return -1;
+    }
+
+#if defined(__MIC__)
+    throw_RTCError(RTC_INVALID_OPERATION,"quad meshes not supported");
+    return -1;
+#else
+    if (numTimeSteps != 1) {
+      throw_RTCError(RTC_INVALID_OPERATION,"only 1 time step supported for quad meshes");
+      return -1;
+    }
+    
+    Geometry* geom = new QuadMesh(this,gflags,numQuads,numVertices,numTimeSteps);
+    return geom->id;
+#endif
+  }
+
+  unsigned Scene::newPoints (RTCGeometryFlags gflags, size_t numPoints, size_t numTimeSteps) 
+  {
+    if (isStatic() && (gflags != RTC_GEOMETRY_STATIC)) {
+      throw_RTCError(RTC_INVALID_OPERATION,"static scenes can only contain static geometries");
+      return -1;
+    }
+
+#if defined(__MIC__)
+    throw_RTCError(RTC_INVALID_OPERATION,"points not supported");
+    return -1;
+#else
+    if (numTimeSteps == 0 || numTimeSteps > RTC_MAX_TIME_STEPS) {
+      throw_RTCError(RTC_INVALID_OPERATION,"only 1 to " TOSTRING(RTC_MAX_TIME_STEPS) " time steps supported");
+      return -1;
+    }
+    
+    Geometry* geom = new Points(this,gflags,numPoints,numTimeSteps);
+    return geom->id;
+#endif
+  }
+
   unsigned Scene::newSubdivisionMesh (RTCGeometryFlags gflags, size_t numFaces, size_t numEdges, size_t numVertices, size_t numEdgeCreases, size_t numVertexCreases, size_t numHoles, size_t numTimeSteps) 
   {
     if (isStatic() && (gflags != RTC_GEOMETRY_STATIC)) {
@@ -338,10 +462,17 @@ namespace embree
       return -1;
     }
 
+#if defined(__MIC__)
     if (numTimeSteps == 0 || numTimeSteps > 2) {
       throw_RTCError(RTC_INVALID_OPERATION,"only 1 or 2 time steps supported");
       return -1;
     }
+#else
+    if (numTimeSteps == 0 || numTimeSteps > RTC_MAX_TIME_STEPS) {
+      throw_RTCError(RTC_INVALID_OPERATION,"only 1 to " TOSTRING(RTC_MAX_TIME_STEPS) " time steps supported");
+      return -1;
+    }
+#endif
     
     Geometry* geom = new BezierCurves(this,gflags,numCurves,numVertices,numTimeSteps);
     return geom->id;
@@ -402,10 +533,16 @@ namespace embree
   
     /* build all hierarchies of this scene */
     accels.build(0,0);
-    
+    finishBuild();
+  }
+
+  void Scene::finishBuild()
+  {
     /* make static geometry immutable */
     if (isStatic()) 
     {
+      if (isRelayout()) accels.relayout();
+      if (device->numa_replication) accels.replicate();
       accels.immutable();
       for (size_t i=0; i<geometries.size(); i++)
         if (geometries[i]) geometries[i]->immutable();
@@ -656,6 +793,76 @@ namespace embree
     }
   }
 
+  /*! header of a file written by Scene::save */
+  struct SceneFileHeader
+  {
+    size_t magick;          //!< identifies the file type and version
+    size_t numGeometries;   //!< number of geometries of the saved scene
+    size_t numPrimitives;   //!< number of enabled primitives of the saved scene
+  };
+
+  static const size_t sceneFileMagick = 0x35238766LL;
+
+  void Scene::save(const char* fileName)
+  {
+    if (!isStatic()) 
+      throw_RTCError(RTC_INVALID_OPERATION,"only static scenes can get saved");
+
+    if (!isBuild() || isModified())
+      throw_RTCError(RTC_INVALID_OPERATION,"scene got not committed");
+
+    std::ofstream file(fileName,std::ios::out | std::ios::binary);
+    if (!file.is_open()) 
+      throw_RTCError(RTC_INVALID_ARGUMENT,"cannot open file "+std::string(fileName));
+
+    SceneFileHeader header;
+    header.magick = sceneFileMagick;
+    header.numGeometries = size();
+    header.numPrimitives = numPrimitives();
+    file.write((char*)&header,sizeof(header));
+
+    if (!accels.save(file))
+      throw_RTCError(RTC_INVALID_OPERATION,"acceleration structures of this scene cannot get saved");
+  }
+
+  void Scene::load(const char* fileName)
+  {
+    Lock<MutexSys> lock(buildMutex);
+
+    if (!isStatic()) 
+      throw_RTCError(RTC_INVALID_OPERATION,"only static scenes can get loaded");
+
+    if (isBuild())
+      throw_RTCError(RTC_INVALID_OPERATION,"scene got already committed");
+
+    if (!ready())
+      throw_RTCError(RTC_INVALID_OPERATION,"not all buffers are unmapped");
+
+    size_t bytes = 0;
+    char* ptr = (char*) os_map_file(fileName,bytes);
+    if (ptr == nullptr)
+      throw_RTCError(RTC_INVALID_ARGUMENT,"cannot map file "+std::string(fileName));
+
+    /* select fast code path if no intersection filter is present */
+    accels.select(numIntersectionFilters4,numIntersectionFilters8,numIntersectionFilters16);
+
+    /* the scene has to contain the same geometries as the saved scene */
+    const SceneFileHeader* header = (const SceneFileHeader*) ptr;
+    bool valid = bytes >= sizeof(SceneFileHeader) && header->magick == sceneFileMagick;
+    valid = valid && header->numGeometries == size() && header->numPrimitives == numPrimitives();
+    valid = valid && accels.load(ptr+sizeof(SceneFileHeader),bytes-sizeof(SceneFileHeader));
+    if (!valid)
+    {
+      accels.clear();
+      os_unmap_file(ptr,bytes);
+      throw_RTCError(RTC_INVALID_OPERATION,"file "+std::string(fileName)+" does not match scene");
+    }
+
+    mappedFile = ptr;
+    mappedFileBytes = bytes;
+    finishBuild();
+  }
+
   void Scene::setProgressMonitorFunction(RTCProgressMonitorFunc func, void* ptr) 
   {
     static MutexSys mutex;
@@ -19,6 +19,8 @@
 #include "default.h"
 #include "device.h"
 #include "scene_triangle_mesh.h"
+#include "scene_quad_mesh.h"
+#include "scene_points.h"
 #include "scene_user_geometry.h"
 #include "scene_instance.h"
 #include "scene_bezier_curves.h"
@@ -40,6 +42,9 @@ namespace embree
   __forceinline bool isCoherent  (RTCSceneFlags flags) { return flags & RTC_SCENE_COHERENT; }
   __forceinline bool isIncoherent(RTCSceneFlags flags) { return flags & RTC_SCENE_INCOHERENT; }
   __forceinline bool isHighQuality(RTCSceneFlags flags) { return flags & RTC_SCENE_HIGH_QUALITY; }
+  __forceinline bool isRelayout  (RTCSceneFlags flags) { return flags & RTC_SCENE_RELAYOUT; }
+  __forceinline bool isRestructure(RTCSceneFlags flags) { return flags & RTC_SCENE_RESTRUCTURE; }
+  __forceinline bool isReorderRays(RTCSceneFlags flags) { return flags & RTC_SCENE_REORDER_RAYS; }
   __forceinline bool isInterpolatable(RTCAlgorithmFlags flags) { return flags & RTC_INTERPOLATE; }
 
   /*! Base class all scenes are derived from */
@@ -63,7 +68,8 @@ namespace embree
         if (geom == nullptr) return nullptr;
         if (!all && !geom->isEnabled()) return nullptr;
         if (geom->getType() != Ty::geom_type) return nullptr;
-        if (geom->numTimeSteps != timeSteps) return nullptr;
+        if (timeSteps == 1 && geom->numTimeSteps != 1) return nullptr;
+        if (timeSteps == 2 && geom->numTimeSteps <  2) return nullptr; // iterates over all motion blurred geometries
         return (Ty*) geom;
       }
 
@@ -101,7 +107,10 @@ namespace embree
     Scene (Device* device, RTCSceneFlags flags, RTCAlgorithmFlags aflags);
 
     void createTriangleAccel();
+    void createQuadAccel();
+    void createPointAccel();
     void createHairAccel();
+    void createUserGeometryAccel();
     void createSubdivAccel();
 
     /*! Scene destruction */
@@ -114,11 +123,20 @@ namespace embree
     unsigned int newUserGeometry (size_t items);
 
     /*! Creates a new scene instance. */
-    unsigned int newInstance (Scene* scene);
+    unsigned int newInstance (Scene* scene, size_t numTimeSteps = 1);
+
+    /*! Creates a new array of scene instances. */
+    unsigned int newInstanceArray (Scene* scene, size_t numInstances);
 
     /*! Creates a new triangle mesh. */
     unsigned int newTriangleMesh (RTCGeometryFlags flags, size_t maxTriangles, size_t maxVertices, size_t numTimeSteps);
 
+    /*! Creates a new quad mesh. */
+    unsigned int newQuadMesh (RTCGeometryFlags flags, size_t maxQuads, size_t maxVertices, size_t numTimeSteps);
+
+    /*! Creates a new set of points. */
+    unsigned int newPoints (RTCGeometryFlags flags, size_t numPoints, size_t numTimeSteps);
+
     /*! Creates a new collection of quadratic bezier curves. */
     unsigned int newBezierCurves (RTCGeometryFlags flags, size_t maxCurves, size_t maxVertices, size_t numTimeSteps);
 
@@ -132,7 +150,14 @@ namespace embree
     /*! stores scene into binary file */
     void write(std::ofstream& file);
 
+    /*! stores the acceleration structures of a committed scene into a file */
+    void save(const char* fileName);
+
+    /*! commits the scene using acceleration structures stored with save */
+    void load(const char* fileName);
+
     void updateInterface();
+    void finishBuild();
 
     /*! build task */
 #if defined(TASKING_LOCKSTEP)
@@ -190,6 +215,30 @@ namespace embree
       if (geometries[i]->getType() != Geometry::TRIANGLE_MESH) return nullptr;
       else return (TriangleMesh*) geometries[i]; 
     }
+    __forceinline QuadMesh* getQuadMesh(size_t i) { 
+      assert(i < geometries.size()); 
+      assert(geometries[i]);
+      assert(geometries[i]->getType() == Geometry::QUAD_MESH);
+      return (QuadMesh*) geometries[i]; 
+    }
+    __forceinline const QuadMesh* getQuadMesh(size_t i) const { 
+      assert(i < geometries.size()); 
+      assert(geometries[i]);
+      assert(geometries[i]->getType() == Geometry::QUAD_MESH);
+      return (QuadMesh*) geometries[i]; 
+    }
+    __forceinline Points* getPoints(size_t i) { 
+      assert(i < geometries.size()); 
+      assert(geometries[i]);
+      assert(geometries[i]->getType() == Geometry::POINTS);
+      return (Points*) geometries[i]; 
+    }
+    __forceinline const Points* getPoints(size_t i) const { 
+      assert(i < geometries.size()); 
+      assert(geometries[i]);
+      assert(geometries[i]->getType() == Geometry::POINTS);
+      return (Points*) geometries[i]; 
+    }
     __forceinline SubdivMesh* getSubdivMesh(size_t i) { 
       assert(i < geometries.size()); 
       assert(geometries[i]);
@@ -225,6 +274,9 @@ namespace embree
     __forceinline bool isCoherent() const { return embree::isCoherent(flags); }
     __forceinline bool isRobust() const { return embree::isRobust(flags); }
     __forceinline bool isHighQuality() const { return embree::isHighQuality(flags); }
+    __forceinline bool isRelayout() const { return embree::isRelayout(flags); }
+    __forceinline bool isRestructure() const { return embree::isRestructure(flags); }
+    __forceinline bool isReorderRays() const { return embree::isReorderRays(flags); }
     __forceinline bool isInterpolatable() const { return embree::isInterpolatable(aflags); }
 
     /* test if scene got already build */
@@ -246,6 +298,9 @@ namespace embree
     RTCAlgorithmFlags aflags;
     bool needTriangleIndices; 
     bool needTriangleVertices; 
+    bool needQuadIndices;
+    bool needQuadVertices;
+    bool needPointVertices;
     bool needBezierIndices;
     bool needBezierVertices;
     bool needSubdivIndices;
@@ -254,6 +309,8 @@ namespace embree
     MutexSys buildMutex;
     AtomicMutex geometriesMutex;
     bool modified;                   //!< true if scene got modified
+    void* mappedFile;                //!< file mapped by load that holds the acceleration structures
+    size_t mappedFileBytes;          //!< size of the mapped file
     
     /*! global lock step task scheduler */
 #if defined(TASKING_LOCKSTEP)
@@ -276,15 +333,20 @@ namespace embree
   public:
     atomic_t numTriangles;             //!< number of enabled triangles
     atomic_t numTriangles2;            //!< number of enabled motion blur triangles
+    atomic_t numQuads;                 //!< number of enabled quads
+    atomic_t numPoints;                //!< number of enabled points
+    atomic_t numPoints2;               //!< number of enabled motion blur points
     atomic_t numBezierCurves;          //!< number of enabled curves
     atomic_t numBezierCurves2;         //!< number of enabled motion blur curves
     atomic_t numSubdivPatches;         //!< number of enabled subdivision patches
     atomic_t numSubdivPatches2;        //!< number of enabled motion blur subdivision patches
     atomic_t numUserGeometries1;       //!< number of enabled user geometries
+    atomic_t numInstances;             //!< number of enabled instances
+    atomic_t numInstances2;            //!< number of enabled motion blur instances
     atomic_t numSubdivEnableDisableEvents; //!< number of enable/disable calls for any subdiv geometry
 
     __forceinline size_t numPrimitives() const {
-    return numTriangles + numTriangles2 + numBezierCurves + numBezierCurves2 + numSubdivPatches + numSubdivPatches2 + numUserGeometries1;
+    return numTriangles + numTriangles2 + numQuads + numPoints + numPoints2 + numBezierCurves + numBezierCurves2 + numSubdivPatches + numSubdivPatches2 + numUserGeometries1 + numInstances + numInstances2;
    }
 
     template<typename Mesh, int timeSteps> __forceinline size_t getNumPrimitives                    () const { THROW_RUNTIME_ERROR("NOT IMPLEMENTED"); }
@@ -296,9 +358,14 @@ namespace embree
 
   template<> __forceinline size_t Scene::getNumPrimitives<TriangleMesh,1>() const { return numTriangles; } 
   template<> __forceinline size_t Scene::getNumPrimitives<TriangleMesh,2>() const { return numTriangles2; } 
+  template<> __forceinline size_t Scene::getNumPrimitives<QuadMesh,1>() const { return numQuads; } 
+  template<> __forceinline size_t Scene::getNumPrimitives<Points,1>() const { return numPoints; } 
+  template<> __forceinline size_t Scene::getNumPrimitives<Points,2>() const { return numPoints2; } 
   template<> __forceinline size_t Scene::getNumPrimitives<BezierCurves,1>() const { return numBezierCurves; } 
   template<> __forceinline size_t Scene::getNumPrimitives<BezierCurves,2>() const { return numBezierCurves2; } 
   template<> __forceinline size_t Scene::getNumPrimitives<SubdivMesh,1>() const { return numSubdivPatches; } 
   template<> __forceinline size_t Scene::getNumPrimitives<SubdivMesh,2>() const { return numSubdivPatches2; } 
   template<> __forceinline size_t Scene::getNumPrimitives<AccelSet,1>() const { return numUserGeometries1; } 
+  template<> __forceinline size_t Scene::getNumPrimitives<Instance,1>() const { return numInstances; }
+  template<> __forceinline size_t Scene::getNumPrimitives<Instance,2>() const { return numInstances2; } 
 }
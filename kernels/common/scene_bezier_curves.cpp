@@ -68,18 +68,19 @@ namespace embree
     }
 #endif
 
+    /* vertex buffers of all timesteps */
+    if (type >= RTC_VERTEX_BUFFER0 && type < RTC_VERTEX_BUFFER0+RTC_MAX_TIME_STEPS) 
+    {
+      const size_t t = type - RTC_VERTEX_BUFFER0;
+      vertices[t].set(ptr,offset,stride); 
+      vertices[t].checkPadding16();
+      return;
+    }
+
     switch (type) {
     case RTC_INDEX_BUFFER  : 
       curves.set(ptr,offset,stride); 
       break;
-    case RTC_VERTEX_BUFFER0: 
-      vertices[0].set(ptr,offset,stride); 
-      vertices[0].checkPadding16();
-      break;
-    case RTC_VERTEX_BUFFER1: 
-      vertices[1].set(ptr,offset,stride); 
-      vertices[1].checkPadding16();
-      break;
     case RTC_USER_VERTEX_BUFFER0  : 
       if (userbuffers[0] == nullptr) userbuffers[0].reset(new Buffer(parent->device,numVertices(),stride)); 
       userbuffers[0]->set(ptr,offset,stride);  
@@ -103,10 +104,11 @@ namespace embree
       return nullptr;
     }
 
+    if (type >= RTC_VERTEX_BUFFER0 && type < RTC_VERTEX_BUFFER0+numTimeSteps) 
+      return vertices[type - RTC_VERTEX_BUFFER0].map(parent->numMappedBuffers);
+
     switch (type) {
     case RTC_INDEX_BUFFER  : return curves.map(parent->numMappedBuffers);
-    case RTC_VERTEX_BUFFER0: return vertices[0].map(parent->numMappedBuffers);
-    case RTC_VERTEX_BUFFER1: return vertices[1].map(parent->numMappedBuffers);
     default: throw_RTCError(RTC_INVALID_ARGUMENT,"unknown buffer type"); return nullptr;
     }
   }
@@ -116,10 +118,13 @@ namespace embree
     if (parent->isStatic() && parent->isBuild()) 
       throw_RTCError(RTC_INVALID_OPERATION,"static geometries cannot get modified");
 
+    if (type >= RTC_VERTEX_BUFFER0 && type < RTC_VERTEX_BUFFER0+numTimeSteps) {
+      vertices[type - RTC_VERTEX_BUFFER0].unmap(parent->numMappedBuffers);
+      return;
+    }
+
     switch (type) {
     case RTC_INDEX_BUFFER  : curves.unmap(parent->numMappedBuffers); break;
-    case RTC_VERTEX_BUFFER0: vertices[0].unmap(parent->numMappedBuffers); break;
-    case RTC_VERTEX_BUFFER1: vertices[1].unmap(parent->numMappedBuffers); break;
     default: throw_RTCError(RTC_INVALID_ARGUMENT,"unknown buffer type"); break;
     }
   }
@@ -129,13 +134,14 @@ namespace embree
     const bool freeIndices = !parent->needBezierIndices;
     const bool freeVertices  = !parent->needBezierVertices;
     if (freeIndices) curves.free();
-    if (freeVertices ) vertices[0].free();
-    if (freeVertices ) vertices[1].free();
+    if (freeVertices ) 
+      for (size_t t=0; t<numTimeSteps; t++) vertices[t].free();
   }
 
   bool BezierCurves::verify () 
   {
-    if (numTimeSteps == 2 && vertices[0].size() != vertices[1].size())
+    for (size_t t=1; t<numTimeSteps; t++)
+      if (vertices[t].size() != vertices[0].size())
         return false;
 
     for (size_t i=0; i<numPrimitives; i++) {
@@ -162,7 +168,7 @@ namespace embree
 
 
     /* calculate base pointer and stride */
-    assert((buffer >= RTC_VERTEX_BUFFER0 && buffer <= RTC_VERTEX_BUFFER1) ||
+    assert((buffer >= RTC_VERTEX_BUFFER0 && buffer < RTC_VERTEX_BUFFER0+numTimeSteps) ||
            (buffer >= RTC_USER_VERTEX_BUFFER0 && buffer <= RTC_USER_VERTEX_BUFFER1));
     const char* src = nullptr; 
     size_t stride = 0;
@@ -75,6 +75,16 @@ namespace embree
     __forceinline float radius(size_t i, size_t j = 0) const {
       return vertices[j][i].w;
     }
+
+    /*! returns i'th vertex linearly interpolated between the timesteps at time in [0,1] */
+    __forceinline const Vec3fa interpolateVertex(size_t i, float time) const 
+    {
+      if (numTimeSteps == 1) return vertex(i);
+      const float t = clamp(time,0.0f,1.0f)*float(numTimeSteps-1);
+      const size_t j = min(size_t(t),size_t(numTimeSteps-2));
+      const float f = t-float(j);
+      return (1.0f-f)*vertex(i,j) + f*vertex(i,j+1);
+    }
     
     /*! check if the i'th primitive is valid */
     __forceinline bool valid(size_t i, BBox3fa* bbox = nullptr) const 
@@ -137,6 +147,38 @@ namespace embree
       return enlarge(b,Vec3fa(max(r0,r1,r2,r3)));
     }
     
+    /*! calculates bounding boxes of the i'th bezier curve at time 0 and 1, whose linear interpolation conservatively bounds the curve at each timestep */
+    __forceinline std::pair<BBox3fa,BBox3fa> linearBounds(size_t i) const {
+      return linearBoundsFromTimeSteps([&] (size_t j) { return bounds(i,j); });
+    }
+
+    /*! calculates bounding boxes of the i'th bezier curve at time 0 and 1, whose linear interpolation conservatively bounds the curve at each timestep */
+    __forceinline std::pair<BBox3fa,BBox3fa> linearBounds(const AffineSpace3fa& space, size_t i) const {
+      return linearBoundsFromTimeSteps([&] (size_t j) { return bounds(space,i,j); });
+    }
+
+  private:
+
+    /*! enlarges the bounds of the first and last timestep until their linear interpolation contains the bounds of all inner timesteps */
+    template<typename BoundsFunc>
+      __forceinline std::pair<BBox3fa,BBox3fa> linearBoundsFromTimeSteps(const BoundsFunc& bounds) const
+    {
+      BBox3fa b0 = bounds(0);
+      BBox3fa b1 = bounds(numTimeSteps-1);
+      for (size_t j=1; j+1<numTimeSteps; j++)
+      {
+        const float t1 = float(j)/float(numTimeSteps-1), t0 = 1.0f-t1;
+        const BBox3fa bj = bounds(j);
+        const Vec3fa dlower = min(bj.lower - (t0*b0.lower + t1*b1.lower),Vec3fa(zero));
+        const Vec3fa dupper = max(bj.upper - (t0*b0.upper + t1*b1.upper),Vec3fa(zero));
+        b0.lower += dlower; b1.lower += dlower;
+        b0.upper += dupper; b1.upper += dupper;
+      }
+      return std::make_pair(b0,b1);
+    }
+
+  public:
+
 #if defined(__MIC__)
     
     __forceinline const Vec3fa* fristVertexPtr(size_t i) const { // FIXME: remove, use buffer to access vertices instead!
@@ -171,7 +213,7 @@ namespace embree
     
   public:
     BufferT<int> curves;                            //!< array of curve indices
-    array_t<BufferT<Vec3fa>,2> vertices;            //!< vertex array
+    array_t<BufferT<Vec3fa>,RTC_MAX_TIME_STEPS> vertices; //!< vertex array for each timestep
     array_t<std::unique_ptr<Buffer>,2> userbuffers; //!< user buffers
   };
 }
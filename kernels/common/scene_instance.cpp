@@ -25,8 +25,10 @@ namespace embree
   extern AccelSet::Intersector8 InstanceIntersector8;
   extern AccelSet::Intersector16 InstanceIntersector16;
 
-  Instance::Instance (Scene* parent, Accel* object) 
-    : AccelSet(parent,1), local2world(one), world2local(one), object(object)
+  __thread size_t Instance::depth = 0;
+
+  Instance::Instance (Scene* parent, Accel* object, size_t numInstances, size_t numTimeSteps, bool isArray) 
+    : AccelSet(parent,Geometry::INSTANCE,numInstances,numTimeSteps), local2world(one), world2local(one), object(object), isArray(isArray)
   {
     intersectors.ptr = this;
     boundsFunc = InstanceBoundsFunc;
@@ -34,14 +36,99 @@ namespace embree
     intersectors.intersector4 = InstanceIntersector4; 
     intersectors.intersector8 = InstanceIntersector8; 
     intersectors.intersector16 = InstanceIntersector16;
+    if (numTimeSteps > 1) {
+      local2worldMB.resize(numTimeSteps);
+      for (size_t t=0; t<numTimeSteps; t++)
+        local2worldMB[t] = one;
+    }
+    if (isArray) {
+      transforms.init(parent->device,numInstances,sizeof(AffineSpace3f));
+      masks.init(parent->device,numInstances,sizeof(unsigned));
+      ids.init(parent->device,numInstances,sizeof(unsigned));
+    }
+    enabling();
+  }
+
+  void Instance::enabling () { 
+    if (numTimeSteps == 1) atomic_add(&parent->numInstances ,numItems); 
+    else                   atomic_add(&parent->numInstances2,numItems); 
   }
   
-  void Instance::setTransform(const AffineSpace3fa& xfm)
+  void Instance::disabling() { 
+    if (numTimeSteps == 1) atomic_add(&parent->numInstances ,-(ssize_t)numItems); 
+    else                   atomic_add(&parent->numInstances2,-(ssize_t)numItems); 
+  }
+  
+  void Instance::setTransform(const AffineSpace3fa& xfm, size_t timeStep)
   {
     if (parent->isStatic() && parent->isBuild())
       throw_RTCError(RTC_INVALID_OPERATION,"static scenes cannot get modified");
 
-    local2world = xfm;
-    world2local = rcp(xfm);
+    if (isArray)
+      throw_RTCError(RTC_INVALID_OPERATION,"transformations of instance arrays have to get set through the transform buffer");
+
+    if (timeStep >= numTimeSteps)
+      throw_RTCError(RTC_INVALID_OPERATION,"invalid timestep");
+
+    if (timeStep == 0) {
+      local2world = xfm;
+      world2local = rcp(xfm);
+    }
+    if (numTimeSteps > 1)
+      local2worldMB[timeStep] = xfm;
+  }
+
+  void Instance::setMask (unsigned mask) 
+  {
+    if (parent->isStatic() && parent->isBuild())
+      throw_RTCError(RTC_INVALID_OPERATION,"static geometries cannot get modified");
+
+    this->mask = mask; 
+    Geometry::update();
+  }
+
+  void Instance::setBuffer(RTCBufferType type, void* ptr, size_t offset, size_t stride) 
+  { 
+    if (parent->isStatic() && parent->isBuild())
+      throw_RTCError(RTC_INVALID_OPERATION,"static geometries cannot get modified");
+
+    /* verify that all accesses are 4 bytes aligned */
+    if (((size_t(ptr) + offset) & 0x3) || (stride & 0x3)) 
+      throw_RTCError(RTC_INVALID_OPERATION,"data must be 4 bytes aligned");
+
+    switch (type) {
+    case RTC_TRANSFORM_BUFFER    : transforms.set(ptr,offset,stride); break;
+    case RTC_INSTANCE_MASK_BUFFER: masks     .set(ptr,offset,stride); break;
+    case RTC_INSTANCE_ID_BUFFER  : ids       .set(ptr,offset,stride); break;
+    default: throw_RTCError(RTC_INVALID_ARGUMENT,"unknown buffer type");
+    }
+  }
+
+  void* Instance::map(RTCBufferType type) 
+  {
+    if (parent->isStatic() && parent->isBuild()) {
+      throw_RTCError(RTC_INVALID_OPERATION,"static geometries cannot get modified");
+      return nullptr;
+    }
+
+    switch (type) {
+    case RTC_TRANSFORM_BUFFER    : return transforms.map(parent->numMappedBuffers);
+    case RTC_INSTANCE_MASK_BUFFER: return masks     .map(parent->numMappedBuffers);
+    case RTC_INSTANCE_ID_BUFFER  : return ids       .map(parent->numMappedBuffers);
+    default: throw_RTCError(RTC_INVALID_ARGUMENT,"unknown buffer type"); return nullptr;
+    }
+  }
+
+  void Instance::unmap(RTCBufferType type) 
+  {
+    if (parent->isStatic() && parent->isBuild()) 
+      throw_RTCError(RTC_INVALID_OPERATION,"static geometries cannot get modified");
+
+    switch (type) {
+    case RTC_TRANSFORM_BUFFER    : transforms.unmap(parent->numMappedBuffers); break;
+    case RTC_INSTANCE_MASK_BUFFER: masks     .unmap(parent->numMappedBuffers); break;
+    case RTC_INSTANCE_ID_BUFFER  : ids       .unmap(parent->numMappedBuffers); break;
+    default: throw_RTCError(RTC_INVALID_ARGUMENT,"unknown buffer type"); break;
+    }
   }
 }
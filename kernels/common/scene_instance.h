@@ -17,20 +17,100 @@
 #pragma once
 
 #include "accelset.h"
+#include "buffer.h"
 
 namespace embree
 {
-  /*! Instanced acceleration structure */
+  /*! Instanced acceleration structure, optionally instantiated
+   *  multiple times through an array of transformations. */
   struct Instance : public AccelSet
   {
   public:
-    Instance (Scene* parent, Accel* object); 
-    virtual void setTransform(const AffineSpace3fa& local2world);
+
+    /*! type of this geometry */
+    static const Geometry::Type geom_type = Geometry::INSTANCE;
+
+  public:
+    Instance (Scene* parent, Accel* object, size_t numInstances, size_t numTimeSteps, bool isArray); 
+    virtual void setTransform(const AffineSpace3fa& local2world, size_t timeStep);
+    virtual void setMask (unsigned mask);
+    virtual void setBuffer(RTCBufferType type, void* ptr, size_t offset, size_t stride);
+    virtual void* map(RTCBufferType type);
+    virtual void unmap(RTCBufferType type);
     virtual void build(size_t threadIndex, size_t threadCount) {}
+
+    void enabling ();
+    void disabling();
+
+  public:
+    using AccelSet::bounds;
+
+    /*! returns the local to world transformation of the i'th instance */
+    __forceinline AffineSpace3fa getLocal2World(size_t i) const 
+    {
+      if (!isArray) return local2world;
+      const AffineSpace3f& xfm = transforms[i];
+      return AffineSpace3fa(Vec3fa(xfm.l.vx.x,xfm.l.vx.y,xfm.l.vx.z),
+                            Vec3fa(xfm.l.vy.x,xfm.l.vy.y,xfm.l.vy.z),
+                            Vec3fa(xfm.l.vz.x,xfm.l.vz.y,xfm.l.vz.z),
+                            Vec3fa(xfm.p.x,xfm.p.y,xfm.p.z));
+    }
+
+    /*! returns the world to local transformation of the i'th instance */
+    __forceinline AffineSpace3fa getWorld2Local(size_t i) const {
+      if (!isArray) return world2local;
+      return rcp(getLocal2World(i));
+    }
+
+    /*! returns the local to world transformation of the i'th instance at some time */
+    __forceinline AffineSpace3fa getLocal2World(size_t i, float time) const 
+    {
+      if (numTimeSteps == 1) return getLocal2World(i);
+      const float t = clamp(time,0.0f,1.0f)*float(numTimeSteps-1);
+      const size_t j = min(size_t(t),size_t(numTimeSteps-2));
+      const float f = t-float(j);
+      return (1.0f-f)*local2worldMB[j] + f*local2worldMB[j+1];
+    }
+
+    /*! returns the world to local transformation of the i'th instance at some time */
+    __forceinline AffineSpace3fa getWorld2Local(size_t i, float time) const {
+      if (numTimeSteps == 1) return getWorld2Local(i);
+      return rcp(getLocal2World(i,time));
+    }
+
+    /*! calculates the bounds of the i'th instance at some time */
+    __forceinline BBox3fa bounds(size_t i, float time) const {
+      return xfmBounds(getLocal2World(i,time),object->bounds);
+    }
+
+    /*! calculates the bounds of the i'th instance over a time range that does not cross a timestep */
+    __forceinline BBox3fa bounds(size_t i, const BBox1f& time_range) const {
+      return merge(bounds(i,time_range.lower),bounds(i,time_range.upper));
+    }
+
+    /*! returns the instance ID reported for hits of the i'th instance */
+    __forceinline unsigned getInstID(size_t i) {
+      if (!isArray) return id;
+      return ids ? ids[i] : unsigned(i);
+    }
+
+    /*! returns the ray mask of the i'th instance */
+    __forceinline unsigned getMask(size_t i) {
+      return masks ? masks[i] : mask;
+    }
     
   public:
     AffineSpace3fa local2world; //!< transforms from local space to world space
     AffineSpace3fa world2local; //!< transforms from world space to local space
     Accel* object;              //!< pointer to instanced acceleration structure
+    bool isArray;               //!< true if the instance got created as instance array
+    avector<AffineSpace3fa> local2worldMB; //!< local to world transformation of each timestep of a motion blurred instance
+
+    BufferT<AffineSpace3f> transforms; //!< column major local to world transformations of an instance array
+    BufferT<unsigned> masks;           //!< optional per instance ray masks of an instance array
+    BufferT<unsigned> ids;             //!< optional per instance IDs of an instance array
+
+  public:
+    static __thread size_t depth; //!< instancing level the ray traversal of this thread is currently at
   };
 }
@@ -0,0 +1,169 @@
+// ======================================================================== //
+// Copyright 2009-2015 Intel Corporation                                    //
+//                                                                          //
+// Licensed under the Apache License, Version 2.0 (the "License");          //
+// you may not use this file except in compliance with the License.         //
+// You may obtain a copy of the License at                                  //
+//                                                                          //
+//     http://www.apache.org/licenses/LICENSE-2.0                           //
+//                                                                          //
+// Unless required by applicable law or agreed to in writing, software      //
+// distributed under the License is distributed on an "AS IS" BASIS,        //
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. //
+// See the License for the specific language governing permissions and      //
+// limitations under the License.                                           //
+// ======================================================================== //
+
+#include "scene_points.h"
+#include "scene.h"
+
+namespace embree
+{
+  Points::Points (Scene* parent, RTCGeometryFlags flags, size_t numPoints, size_t numTimeSteps)
+    : Geometry(parent,POINTS,numPoints,numTimeSteps,flags)
+  {
+    for (size_t i=0; i<numTimeSteps; i++) {
+      vertices[i].init(parent->device,numPoints,sizeof(Vec3fa));
+    }
+    enabling();
+  }
+  
+  void Points::enabling() 
+  { 
+    if (numTimeSteps == 1) atomic_add(&parent->numPoints ,size());
+    else                   atomic_add(&parent->numPoints2,size());
+  }
+  
+  void Points::disabling() 
+  { 
+    if (numTimeSteps == 1) atomic_add(&parent->numPoints ,-(ssize_t)size());
+    else                   atomic_add(&parent->numPoints2,-(ssize_t)size());
+  }
+
+  void Points::setMask (unsigned mask) 
+  {
+    if (parent->isStatic() && parent->isBuild())
+      throw_RTCError(RTC_INVALID_OPERATION,"static scenes cannot get modified");
+
+    this->mask = mask; 
+    Geometry::update();
+  }
+
+  void Points::setBuffer(RTCBufferType type, void* ptr, size_t offset, size_t stride) 
+  { 
+    if (parent->isStatic() && parent->isBuild()) 
+      throw_RTCError(RTC_INVALID_OPERATION,"static scenes cannot get modified");
+
+    /* verify that all accesses are 4 bytes aligned */
+    if (((size_t(ptr) + offset) & 0x3) || (stride & 0x3)) 
+      throw_RTCError(RTC_INVALID_OPERATION,"data must be 4 bytes aligned");
+
+    /* vertex buffers of all timesteps */
+    if (type >= RTC_VERTEX_BUFFER0 && type < RTC_VERTEX_BUFFER0+numTimeSteps) 
+    {
+      const size_t t = type - RTC_VERTEX_BUFFER0;
+      vertices[t].set(ptr,offset,stride); 
+      vertices[t].checkPadding16();
+      return;
+    }
+
+    switch (type) {
+    case RTC_USER_VERTEX_BUFFER0: 
+      if (userbuffers[0] == nullptr) userbuffers[0].reset(new Buffer(parent->device,size(),stride)); 
+      userbuffers[0]->set(ptr,offset,stride);  
+      userbuffers[0]->checkPadding16();
+      break;
+    case RTC_USER_VERTEX_BUFFER1: 
+      if (userbuffers[1] == nullptr) userbuffers[1].reset(new Buffer(parent->device,size(),stride)); 
+      userbuffers[1]->set(ptr,offset,stride);  
+      userbuffers[1]->checkPadding16();
+      break;
+
+    default: 
+      throw_RTCError(RTC_INVALID_ARGUMENT,"unknown buffer type");
+    }
+  }
+
+  void* Points::map(RTCBufferType type) 
+  {
+    if (parent->isStatic() && parent->isBuild())
+      throw_RTCError(RTC_INVALID_OPERATION,"static scenes cannot get modified");
+
+    if (type >= RTC_VERTEX_BUFFER0 && type < RTC_VERTEX_BUFFER0+numTimeSteps) 
+      return vertices[type - RTC_VERTEX_BUFFER0].map(parent->numMappedBuffers);
+
+    throw_RTCError(RTC_INVALID_ARGUMENT,"unknown buffer type"); 
+    return nullptr;
+  }
+
+  void Points::unmap(RTCBufferType type) 
+  {
+    if (parent->isStatic() && parent->isBuild())
+      throw_RTCError(RTC_INVALID_OPERATION,"static scenes cannot get modified");
+
+    if (type >= RTC_VERTEX_BUFFER0 && type < RTC_VERTEX_BUFFER0+numTimeSteps) {
+      vertices[type - RTC_VERTEX_BUFFER0].unmap(parent->numMappedBuffers);
+      return;
+    }
+
+    throw_RTCError(RTC_INVALID_ARGUMENT,"unknown buffer type"); 
+  }
+
+  void Points::immutable () 
+  {
+    const bool freeVertices = !parent->needPointVertices;
+    if (freeVertices) 
+      for (size_t t=0; t<numTimeSteps; t++) vertices[t].free();
+  }
+
+  bool Points::verify () 
+  {
+    /*! verify consistent size of vertex arrays */
+    for (size_t t=1; t<numTimeSteps; t++)
+      if (vertices[t].size() != vertices[0].size())
+        return false;
+
+    /*! verify proper points */
+    for (size_t j=0; j<numTimeSteps; j++) 
+    {
+      BufferT<Vec3fa>& verts = vertices[j];
+      for (size_t i=0; i<verts.size(); i++) {
+	if (!isvalid(verts[i]) || verts[i].w < 0.0f) 
+	  return false;
+      }
+    }
+    return true;
+  }
+
+  void Points::interpolate(unsigned primID, float u, float v, RTCBufferType buffer, float* P, float* dPdu, float* dPdv, size_t numFloats) 
+  {
+#if defined(DEBUG) // FIXME: use function pointers and also throw error in release mode
+    if ((parent->aflags & RTC_INTERPOLATE) == 0) 
+      throw_RTCError(RTC_INVALID_OPERATION,"rtcInterpolate can only get called when RTC_INTERPOLATE is enabled for the scene");
+#endif
+
+    /* calculate base pointer and stride */
+    assert((buffer >= RTC_VERTEX_BUFFER0 && buffer < RTC_VERTEX_BUFFER0+numTimeSteps) ||
+           (buffer >= RTC_USER_VERTEX_BUFFER0 && buffer <= RTC_USER_VERTEX_BUFFER1));
+    const char* src = nullptr; 
+    size_t stride = 0;
+    if (buffer >= RTC_USER_VERTEX_BUFFER0) {
+      src    = userbuffers[buffer&0xFFFF]->getPtr();
+      stride = userbuffers[buffer&0xFFFF]->getStride();
+    } else {
+      src    = vertices[buffer&0xFFFF].getPtr();
+      stride = vertices[buffer&0xFFFF].getStride();
+    }
+
+    /* the data of a point is constant over the sphere */
+    for (size_t i=0; i<numFloats; i+=4)
+    {
+      size_t ofs = i*sizeof(float);
+      const float4 p = float4::loadu((float*)&src[primID*stride+ofs]);
+      const bool4 valid = int4(i)+int4(step) < int4(numFloats);
+      if (P   ) float4::storeu(valid,P+i,p);
+      if (dPdu) float4::storeu(valid,dPdu+i,float4(zero));
+      if (dPdv) float4::storeu(valid,dPdv+i,float4(zero));
+    }
+  }
+}
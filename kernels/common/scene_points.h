@@ -0,0 +1,106 @@
+// ======================================================================== //
+// Copyright 2009-2015 Intel Corporation                                    //
+//                                                                          //
+// Licensed under the Apache License, Version 2.0 (the "License");          //
+// you may not use this file except in compliance with the License.         //
+// You may obtain a copy of the License at                                  //
+//                                                                          //
+//     http://www.apache.org/licenses/LICENSE-2.0                           //
+//                                                                          //
+// Unless required by applicable law or agreed to in writing, software      //
+// distributed under the License is distributed on an "AS IS" BASIS,        //
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. //
+// See the License for the specific language governing permissions and      //
+// limitations under the License.                                           //
+// ======================================================================== //
+
+#pragma once
+
+#include "geometry.h"
+#include "buffer.h"
+
+namespace embree
+{
+  /*! Points with radius, rendered as spheres */
+  struct Points : public Geometry
+  {
+    /*! type of this geometry */
+    static const Geometry::Type geom_type = Geometry::POINTS;
+
+  public:
+
+    /*! points construction */
+    Points (Scene* parent, RTCGeometryFlags flags, size_t numPoints, size_t numTimeSteps); 
+
+    /* geometry interface */
+  public:
+    void enabling();
+    void disabling();
+    void setMask (unsigned mask);
+    void setBuffer(RTCBufferType type, void* ptr, size_t offset, size_t stride);
+    void* map(RTCBufferType type);
+    void unmap(RTCBufferType type);
+    void immutable ();
+    bool verify ();
+    void interpolate(unsigned primID, float u, float v, RTCBufferType buffer, float* P, float* dPdu, float* dPdv, size_t numFloats);
+
+  public:
+
+    /*! returns number of points */
+    __forceinline size_t size() const {
+      return vertices[0].size();
+    }
+
+    /*! returns i'th point (center and radius) of j'th timestep */
+    __forceinline const Vec3fa vertex(size_t i, size_t j = 0) const {
+      return vertices[j][i];
+    }
+
+    /*! returns the i'th point at some time in [0,1], interpolating linearly between the enclosing timesteps */
+    __forceinline const Vec3fa interpolateVertex(size_t i, float time) const 
+    {
+      if (numTimeSteps == 1) return vertex(i);
+      const float t = clamp(time,0.0f,1.0f)*float(numTimeSteps-1);
+      const size_t j = min(size_t(t),size_t(numTimeSteps-2));
+      const float f = t-float(j);
+      return (1.0f-f)*vertex(i,j) + f*vertex(i,j+1);
+    }
+
+    /*! calculates the bounds of the sphere of some point */
+    static __forceinline BBox3fa sphereBounds(const Vec3fa& p) {
+      const Vec3fa r = Vec3fa(p.w);
+      return BBox3fa(p-r,p+r);
+    }
+
+    /*! calculates the bounds of the i'th point */
+    __forceinline BBox3fa bounds(size_t i) const {
+      return sphereBounds(vertex(i));
+    }
+
+    /*! calculates the bounds of the i'th point over some time range */
+    __forceinline BBox3fa bounds(size_t i, const BBox1f& time_range) const {
+      return merge(sphereBounds(interpolateVertex(i,time_range.lower)),
+                   sphereBounds(interpolateVertex(i,time_range.upper)));
+    }
+
+    /*! check if the i'th primitive is valid */
+    __forceinline bool valid(size_t i, BBox3fa* bbox = nullptr) const 
+    {
+      for (size_t j=0; j<numTimeSteps; j++) 
+      {
+        const Vec3fa p = vertex(i,j);
+        if (!isvalid(p) || p.w < 0.0f)
+          return false;
+      }
+
+      if (bbox) 
+        *bbox = bounds(i);
+
+      return true;
+    }
+    
+  public:
+    array_t<BufferT<Vec3fa>,RTC_MAX_TIME_STEPS> vertices; //!< point array for each timestep
+    array_t<std::unique_ptr<Buffer>,2> userbuffers; //!< user buffers
+  };
+}
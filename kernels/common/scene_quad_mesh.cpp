@@ -0,0 +1,196 @@
+// ======================================================================== //
+// Copyright 2009-2015 Intel Corporation                                    //
+//                                                                          //
+// Licensed under the Apache License, Version 2.0 (the "License");          //
+// you may not use this file except in compliance with the License.         //
+// You may obtain a copy of the License at                                  //
+//                                                                          //
+//     http://www.apache.org/licenses/LICENSE-2.0                           //
+//                                                                          //
+// Unless required by applicable law or agreed to in writing, software      //
+// distributed under the License is distributed on an "AS IS" BASIS,        //
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. //
+// See the License for the specific language governing permissions and      //
+// limitations under the License.                                           //
+// ======================================================================== //
+
+#include "scene_quad_mesh.h"
+#include "scene.h"
+
+namespace embree
+{
+  QuadMesh::QuadMesh (Scene* parent, RTCGeometryFlags flags, size_t numQuads, size_t numVertices, size_t numTimeSteps)
+    : Geometry(parent,QUAD_MESH,numQuads,numTimeSteps,flags)
+  {
+    quads.init(parent->device,numQuads,sizeof(Quad));
+    for (size_t i=0; i<numTimeSteps; i++) {
+      vertices[i].init(parent->device,numVertices,sizeof(Vec3fa));
+    }
+    enabling();
+  }
+  
+  void QuadMesh::enabling() { 
+    atomic_add(&parent->numQuads,quads.size());
+  }
+  
+  void QuadMesh::disabling() { 
+    atomic_add(&parent->numQuads,-(ssize_t)quads.size());
+  }
+
+  void QuadMesh::setMask (unsigned mask) 
+  {
+    if (parent->isStatic() && parent->isBuild())
+      throw_RTCError(RTC_INVALID_OPERATION,"static scenes cannot get modified");
+
+    this->mask = mask; 
+    Geometry::update();
+  }
+
+  void QuadMesh::setBuffer(RTCBufferType type, void* ptr, size_t offset, size_t stride) 
+  { 
+    if (parent->isStatic() && parent->isBuild()) 
+      throw_RTCError(RTC_INVALID_OPERATION,"static scenes cannot get modified");
+
+    /* verify that all accesses are 4 bytes aligned */
+    if (((size_t(ptr) + offset) & 0x3) || (stride & 0x3)) 
+      throw_RTCError(RTC_INVALID_OPERATION,"data must be 4 bytes aligned");
+
+    /* vertex buffers of all timesteps */
+    if (type >= RTC_VERTEX_BUFFER0 && type < RTC_VERTEX_BUFFER0+numTimeSteps) 
+    {
+      const size_t t = type - RTC_VERTEX_BUFFER0;
+      vertices[t].set(ptr,offset,stride); 
+      vertices[t].checkPadding16();
+      return;
+    }
+
+    switch (type) {
+    case RTC_INDEX_BUFFER  : 
+      quads.set(ptr,offset,stride); 
+      break;
+
+    case RTC_USER_VERTEX_BUFFER0: 
+      if (userbuffers[0] == nullptr) userbuffers[0].reset(new Buffer(parent->device,numVertices(),stride)); 
+      userbuffers[0]->set(ptr,offset,stride);  
+      userbuffers[0]->checkPadding16();
+      break;
+    case RTC_USER_VERTEX_BUFFER1: 
+      if (userbuffers[1] == nullptr) userbuffers[1].reset(new Buffer(parent->device,numVertices(),stride)); 
+      userbuffers[1]->set(ptr,offset,stride);  
+      userbuffers[1]->checkPadding16();
+      break;
+
+    default: 
+      throw_RTCError(RTC_INVALID_ARGUMENT,"unknown buffer type");
+    }
+  }
+
+  void* QuadMesh::map(RTCBufferType type) 
+  {
+    if (parent->isStatic() && parent->isBuild())
+      throw_RTCError(RTC_INVALID_OPERATION,"static scenes cannot get modified");
+
+    if (type >= RTC_VERTEX_BUFFER0 && type < RTC_VERTEX_BUFFER0+numTimeSteps) 
+      return vertices[type - RTC_VERTEX_BUFFER0].map(parent->numMappedBuffers);
+
+    switch (type) {
+    case RTC_INDEX_BUFFER  : return quads.map(parent->numMappedBuffers);
+    default                : throw_RTCError(RTC_INVALID_ARGUMENT,"unknown buffer type"); return nullptr;
+    }
+  }
+
+  void QuadMesh::unmap(RTCBufferType type) 
+  {
+    if (parent->isStatic() && parent->isBuild())
+      throw_RTCError(RTC_INVALID_OPERATION,"static scenes cannot get modified");
+
+    if (type >= RTC_VERTEX_BUFFER0 && type < RTC_VERTEX_BUFFER0+numTimeSteps) {
+      vertices[type - RTC_VERTEX_BUFFER0].unmap(parent->numMappedBuffers);
+      return;
+    }
+
+    switch (type) {
+    case RTC_INDEX_BUFFER  : quads.unmap(parent->numMappedBuffers); break;
+    default                : throw_RTCError(RTC_INVALID_ARGUMENT,"unknown buffer type"); break;
+    }
+  }
+
+  void QuadMesh::immutable () 
+  {
+    const bool freeQuads    = !parent->needQuadIndices;
+    const bool freeVertices = !parent->needQuadVertices;
+    if (freeQuads) quads.free(); 
+    if (freeVertices) 
+      for (size_t t=0; t<numTimeSteps; t++) vertices[t].free();
+  }
+
+  bool QuadMesh::verify () 
+  {
+    /*! verify consistent size of vertex arrays */
+    for (size_t t=1; t<numTimeSteps; t++)
+      if (vertices[t].size() != vertices[0].size())
+        return false;
+
+    /*! verify proper quad indices */
+    for (size_t i=0; i<quads.size(); i++) {     
+      if (quads[i].v[0] >= numVertices()) return false; 
+      if (quads[i].v[1] >= numVertices()) return false; 
+      if (quads[i].v[2] >= numVertices()) return false; 
+      if (quads[i].v[3] >= numVertices()) return false; 
+    }
+
+    /*! verify proper quad vertices */
+    for (size_t j=0; j<numTimeSteps; j++) 
+    {
+      BufferT<Vec3fa>& verts = vertices[j];
+      for (size_t i=0; i<verts.size(); i++) {
+	if (!isvalid(verts[i])) 
+	  return false;
+      }
+    }
+    return true;
+  }
+
+  void QuadMesh::interpolate(unsigned primID, float u, float v, RTCBufferType buffer, float* P, float* dPdu, float* dPdv, size_t numFloats) 
+  {
+#if defined(DEBUG) // FIXME: use function pointers and also throw error in release mode
+    if ((parent->aflags & RTC_INTERPOLATE) == 0) 
+      throw_RTCError(RTC_INVALID_OPERATION,"rtcInterpolate can only get called when RTC_INTERPOLATE is enabled for the scene");
+#endif
+
+    /* calculate base pointer and stride */
+    assert((buffer >= RTC_VERTEX_BUFFER0 && buffer < RTC_VERTEX_BUFFER0+numTimeSteps) ||
+           (buffer >= RTC_USER_VERTEX_BUFFER0 && buffer <= RTC_USER_VERTEX_BUFFER1));
+    const char* src = nullptr; 
+    size_t stride = 0;
+    if (buffer >= RTC_USER_VERTEX_BUFFER0) {
+      src    = userbuffers[buffer&0xFFFF]->getPtr();
+      stride = userbuffers[buffer&0xFFFF]->getStride();
+    } else {
+      src    = vertices[buffer&0xFFFF].getPtr();
+      stride = vertices[buffer&0xFFFF].getStride();
+    }
+
+    /* the quad is interpolated like the two triangles (v0,v1,v3) and
+     * (v2,v3,v1) it gets intersected as */
+    for (size_t i=0; i<numFloats; i+=4)
+    {
+      size_t ofs = i*sizeof(float);
+      const Quad& q = quad(primID);
+      const float4 p0 = float4::loadu((float*)&src[q.v[0]*stride+ofs]);
+      const float4 p1 = float4::loadu((float*)&src[q.v[1]*stride+ofs]);
+      const float4 p2 = float4::loadu((float*)&src[q.v[2]*stride+ofs]);
+      const float4 p3 = float4::loadu((float*)&src[q.v[3]*stride+ofs]);
+      const bool4 valid = int4(i)+int4(step) < int4(numFloats);
+      if (u+v <= 1.0f) {
+        if (P   ) float4::storeu(valid,P+i,(1.0f-u-v)*p0 + u*p1 + v*p3);
+        if (dPdu) float4::storeu(valid,dPdu+i,p1-p0);
+        if (dPdv) float4::storeu(valid,dPdv+i,p3-p0);
+      } else {
+        if (P   ) float4::storeu(valid,P+i,(u+v-1.0f)*p2 + (1.0f-u)*p3 + (1.0f-v)*p1);
+        if (dPdu) float4::storeu(valid,dPdu+i,p2-p3);
+        if (dPdv) float4::storeu(valid,dPdv+i,p2-p1);
+      }
+    }
+  }
+}
@@ -86,6 +86,16 @@ namespace embree
       return vertices[j].getPtr(i);
     }
 
+    /*! returns i'th vertex linearly interpolated between the timesteps at time in [0,1] */
+    __forceinline const Vec3fa interpolateVertex(size_t i, float time) const 
+    {
+      if (numTimeSteps == 1) return vertex(i);
+      const float t = clamp(time,0.0f,1.0f)*float(numTimeSteps-1);
+      const size_t j = min(size_t(t),size_t(numTimeSteps-2));
+      const float f = t-float(j);
+      return (1.0f-f)*vertex(i,j) + f*vertex(i,j+1);
+    }
+
 #if defined(__MIC__)    
     /*! returns the stride in bytes of the triangle buffer */
     __forceinline size_t getTriangleBufferStride() const {
@@ -108,6 +118,18 @@ namespace embree
       return BBox3fa(min(v0,v1,v2),max(v0,v1,v2));
     }
 
+    /*! calculates the bounds of the i'th triangle over a time range that does not cross a timestep */
+    __forceinline BBox3fa bounds(size_t i, const BBox1f& time_range) const 
+    {
+      const Triangle& tri = triangle(i);
+      BBox3fa bounds = empty;
+      for (size_t k=0; k<3; k++) {
+        bounds.extend(interpolateVertex(tri.v[k],time_range.lower));
+        bounds.extend(interpolateVertex(tri.v[k],time_range.upper));
+      }
+      return bounds;
+    }
+
     /*! check if the i'th primitive is valid */
     __forceinline bool valid(size_t i, BBox3fa* bbox = nullptr) const 
     {
@@ -191,7 +213,7 @@ namespace embree
     
   public:
     BufferT<Triangle> triangles;                    //!< array of triangles
-    array_t<BufferT<Vec3fa>,2> vertices;            //!< vertex array
+    array_t<BufferT<Vec3fa>,RTC_MAX_TIME_STEPS> vertices; //!< vertex array for each timestep
     array_t<std::unique_ptr<Buffer>,2> userbuffers; //!< user buffers
   };
 }
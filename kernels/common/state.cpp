@@ -34,21 +34,38 @@ namespace embree
 
   void State::clear(bool singledevice)
   {
+    toplevel_traverser = "default";
+
     tri_accel = "default";
     tri_builder = "default";
     tri_traverser = "default";
     tri_builder_replication_factor = 2.0f;
+    twolevel_subtree_quality_loss = 0.2f;
+    twolevel_max_quality_loss = 0.5f;
     
     tri_accel_mb = "default";
     tri_builder_mb = "default";
     tri_traverser_mb = "default";
     
+    quad_accel = "default";
+
+    point_builder = "default";
+
     hair_accel = "default";
     hair_builder = "default";
     hair_traverser = "default";
     hair_builder_replication_factor = 3.0f;
 
+    user_accel = "default";
+
     memory_preallocation_factor     = 1.0f; 
+    numa = true;
+    numa_replication = false;
+#if defined(__MIC__)
+    hugepages = HUGEPAGES_ON;
+#else
+    hugepages = HUGEPAGES_AUTO;
+#endif
 
     tessellation_cache_size = 128*1024*1024;
 
@@ -154,6 +171,8 @@ namespace embree
       else if (tok == Token::Id("float_exceptions") && cin->trySymbol("=")) 
         float_exceptions = cin->get().Int();
 
+      else if (tok == Token::Id("toplevel_traverser") && cin->trySymbol("="))
+        toplevel_traverser = cin->get().Identifier();
       else if ((tok == Token::Id("tri_accel") || tok == Token::Id("accel")) && cin->trySymbol("="))
         tri_accel = cin->get().Identifier();
       else if ((tok == Token::Id("tri_builder") || tok == Token::Id("builder")) && cin->trySymbol("="))
@@ -161,7 +180,11 @@ namespace embree
       else if ((tok == Token::Id("tri_traverser") || tok == Token::Id("traverser")) && cin->trySymbol("="))
         tri_traverser = cin->get().Identifier();
       else if (tok == Token::Id("tri_builder_replication_factor") && cin->trySymbol("="))
-        tri_builder_replication_factor = cin->get().Int();
+        tri_builder_replication_factor = cin->get().Float();
+      else if (tok == Token::Id("twolevel_subtree_quality_loss") && cin->trySymbol("="))
+        twolevel_subtree_quality_loss = cin->get().Float();
+      else if (tok == Token::Id("twolevel_max_quality_loss") && cin->trySymbol("="))
+        twolevel_max_quality_loss = cin->get().Float();
       
       else if ((tok == Token::Id("tri_accel_mb") || tok == Token::Id("accel_mb")) && cin->trySymbol("="))
         tri_accel_mb = cin->get().Identifier();
@@ -170,6 +193,12 @@ namespace embree
       else if ((tok == Token::Id("tri_traverser_mb") || tok == Token::Id("traverser_mb")) && cin->trySymbol("="))
         tri_traverser_mb = cin->get().Identifier();
       
+      else if (tok == Token::Id("quad_accel") && cin->trySymbol("="))
+        quad_accel = cin->get().Identifier();
+
+      else if (tok == Token::Id("point_builder") && cin->trySymbol("="))
+        point_builder = cin->get().Identifier();
+
       else if (tok == Token::Id("hair_accel") && cin->trySymbol("="))
         hair_accel = cin->get().Identifier();
       else if (tok == Token::Id("hair_builder") && cin->trySymbol("="))
@@ -178,6 +207,9 @@ namespace embree
         hair_traverser = cin->get().Identifier();
       else if (tok == Token::Id("hair_builder_replication_factor") && cin->trySymbol("="))
         hair_builder_replication_factor = cin->get().Int();
+
+      else if (tok == Token::Id("user_accel") && cin->trySymbol("="))
+        user_accel = cin->get().Identifier();
       
       else if (tok == Token::Id("subdiv_accel") && cin->trySymbol("="))
         subdiv_accel = cin->get().Identifier();
@@ -198,12 +230,28 @@ namespace embree
             else if (flag == Token::Id("coherent")) scene_flags |= RTC_SCENE_COHERENT;
             else if (flag == Token::Id("incoherent")) scene_flags |= RTC_SCENE_INCOHERENT;
             else if (flag == Token::Id("high_quality")) scene_flags |= RTC_SCENE_HIGH_QUALITY;
+            else if (flag == Token::Id("relayout")) scene_flags |= RTC_SCENE_RELAYOUT;
+            else if (flag == Token::Id("restructure")) scene_flags |= RTC_SCENE_RESTRUCTURE;
             else if (flag == Token::Id("robust")) scene_flags |= RTC_SCENE_ROBUST;
+            else if (flag == Token::Id("reorder_rays")) scene_flags |= RTC_SCENE_REORDER_RAYS;
           } while (cin->trySymbol("|"));
         }
       }
       else if (tok == Token::Id("memory_preallocation_factor") && cin->trySymbol("=")) 
         memory_preallocation_factor = cin->get().Float();
+
+      else if (tok == Token::Id("numa") && cin->trySymbol("=")) 
+        numa = cin->get().Int();
+
+      else if (tok == Token::Id("numa_replication") && cin->trySymbol("=")) 
+        numa_replication = cin->get().Int();
+
+      else if (tok == Token::Id("hugepages") && cin->trySymbol("=")) {
+        std::string mode = strlwr(cin->get().Identifier());
+        if      (mode == "on" ) hugepages = HUGEPAGES_ON;
+        else if (mode == "off") hugepages = HUGEPAGES_OFF;
+        else                    hugepages = HUGEPAGES_AUTO;
+      }
       
       else if (tok == Token::Id("regression") && cin->trySymbol("=")) 
         regression_testing = cin->get().Int();
@@ -236,30 +284,45 @@ namespace embree
     std::cout << "general:" << std::endl;
     std::cout << "  build threads = " << g_numThreads << std::endl;
     std::cout << "  verbosity     = " << verbose << std::endl;
+    std::cout << "  toplevel      = " << toplevel_traverser << std::endl;
     
     std::cout << "triangles:" << std::endl;
     std::cout << "  accel         = " << tri_accel << std::endl;
     std::cout << "  builder       = " << tri_builder << std::endl;
     std::cout << "  traverser     = " << tri_traverser << std::endl;
     std::cout << "  replications  = " << tri_builder_replication_factor << std::endl;
+    std::cout << "  subtree loss  = " << twolevel_subtree_quality_loss << std::endl;
+    std::cout << "  max loss      = " << twolevel_max_quality_loss << std::endl;
     
     std::cout << "motion blur triangles:" << std::endl;
     std::cout << "  accel         = " << tri_accel_mb << std::endl;
     std::cout << "  builder       = " << tri_builder_mb << std::endl;
     std::cout << "  traverser     = " << tri_traverser_mb << std::endl;
     
+    std::cout << "quads:" << std::endl;
+    std::cout << "  accel         = " << quad_accel << std::endl;
+    
+    std::cout << "points:" << std::endl;
+    std::cout << "  builder       = " << point_builder << std::endl;
+    
     std::cout << "hair:" << std::endl;
     std::cout << "  accel         = " << hair_accel << std::endl;
     std::cout << "  builder       = " << hair_builder << std::endl;
     std::cout << "  traverser     = " << hair_traverser << std::endl;
     std::cout << "  replications  = " << hair_builder_replication_factor << std::endl;
+
+    std::cout << "user geometries:" << std::endl;
+    std::cout << "  accel         = " << user_accel << std::endl;
     
     std::cout << "subdivision surfaces:" << std::endl;
     std::cout << "  accel         = " << subdiv_accel << std::endl;
     
-#if defined(__MIC__)
     std::cout << "memory allocation:" << std::endl;
+#if defined(__MIC__)
     std::cout << "  preallocation_factor  = " << memory_preallocation_factor << std::endl;
 #endif
+    std::cout << "  numa                  = " << numa << " (" << getNumberOfNumaNodes() << " nodes)" << std::endl;
+    std::cout << "  numa_replication      = " << numa_replication << std::endl;
+    std::cout << "  hugepages             = " << (hugepages == HUGEPAGES_ON ? "on" : hugepages == HUGEPAGES_OFF ? "off" : "auto") << std::endl;
   }
 }
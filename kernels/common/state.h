@@ -60,25 +60,42 @@ namespace embree
   private:
     //static State state;                      //!< single state object
 
+  public:
+    std::string toplevel_traverser;        //!< traverser to use across the acceleration structures of all geometry types
+
   public:
     std::string tri_accel;                 //!< acceleration structure to use for triangles
     std::string tri_builder;               //!< builder to use for triangles
     std::string tri_traverser;             //!< traverser to use for triangles
     double      tri_builder_replication_factor; //!< maximally factor*N many primitives in accel
+    float       twolevel_subtree_quality_loss;  //!< relative SAH cost increase of a toplevel subtree that triggers its rebuild
+    float       twolevel_max_quality_loss;      //!< relative SAH cost increase of the toplevel BVH that triggers a full rebuild
 
   public:
     std::string tri_accel_mb;              //!< acceleration structure to use for motion blur triangles
     std::string tri_builder_mb;            //!< builder to use for motion blur triangles
     std::string tri_traverser_mb;          //!< traverser to use for triangles
 
+  public:
+    std::string quad_accel;                //!< acceleration structure to use for quads
+
+  public:
+    std::string point_builder;             //!< builder to use for points
+
   public:
     std::string hair_accel;                //!< hair acceleration structure to use
     std::string hair_builder;              //!< builder to use for hair
     std::string hair_traverser;            //!< traverser to use for hair
     double      hair_builder_replication_factor; //!< maximally factor*N many primitives in accel
 
+  public:
+    std::string user_accel;                //!< acceleration structure to use for user geometries
+
   public:
     float       memory_preallocation_factor; 
+    bool        numa;                      //!< places the nodes of the hierarchies on the NUMA node of the building thread
+    bool        numa_replication;          //!< replicates the hierarchies of static scenes on each NUMA node
+    HugePageMode hugepages;                //!< pages of large allocations, the mode the system supports after device creation
     size_t      tessellation_cache_size;   //!< size of the shared tessellation cache 
     std::string subdiv_accel;              //!< acceleration structure to use for subdivision surfaces
 
@@ -50,8 +50,9 @@ namespace embree
             Bezier1v& prim = prims[i];
             const size_t geomID = prim.geomID();
             const BezierCurves* curves = scene->getBezierCurves(geomID);
-            bounds0.extend(curves->bounds(prim.primID(),0));
-            bounds1.extend(curves->bounds(prim.primID(),1));
+            const std::pair<BBox3fa,BBox3fa> bounds = curves->linearBounds(prim.primID());
+            bounds0.extend(bounds.first);
+            bounds1.extend(bounds.second);
           }
           return std::pair<BBox3fa,BBox3fa>(bounds0,bounds1);
         }
@@ -80,10 +80,10 @@ namespace embree
             const Vec3fa a1 = curves->vertex(curve+1,0);
             const Vec3fa a0 = curves->vertex(curve+0,0);
             
-            const Vec3fa b3 = curves->vertex(curve+3,1);
-            const Vec3fa b2 = curves->vertex(curve+2,1);
-            const Vec3fa b1 = curves->vertex(curve+1,1);
-            const Vec3fa b0 = curves->vertex(curve+0,1);
+            const Vec3fa b3 = curves->vertex(curve+3,curves->numTimeSteps-1);
+            const Vec3fa b2 = curves->vertex(curve+2,curves->numTimeSteps-1);
+            const Vec3fa b1 = curves->vertex(curve+1,curves->numTimeSteps-1);
+            const Vec3fa b0 = curves->vertex(curve+0,curves->numTimeSteps-1);
             
             if (sqr_length(a3 - a0) > 1E-18f && sqr_length(a1 - a0) > 1E-18f &&
                 sqr_length(b3 - b0) > 1E-18f && sqr_length(b1 - b0) > 1E-18f) 
@@ -130,8 +130,9 @@ namespace embree
             centBounds.extend(center2(bounds));
 
             const BezierCurves* curves = scene->getBezierCurves(prim.geomID());
-            s0t0.extend(curves->bounds(space,prim.primID(),0));
-            s1t1.extend(curves->bounds(space,prim.primID(),1));
+            const std::pair<BBox3fa,BBox3fa> bounds01 = curves->linearBounds(space,prim.primID());
+            s0t0.extend(bounds01.first);
+            s1t1.extend(bounds01.second);
           }
           
           PrimInfoMB ret;
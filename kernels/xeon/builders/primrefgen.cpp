@@ -112,6 +112,51 @@ namespace embree
       return pinfo;
     }
 
+    template<typename Mesh>
+    PrimInfo createPrimRefArrayMBlur(Scene* scene, const BBox1f& time_range, mvector<PrimRef>& prims, BuildProgressMonitor& progressMonitor)
+    {
+      ParallelForForPrefixSumState<PrimInfo> pstate;
+      Scene::Iterator<Mesh,2> iter(scene);
+      
+      /* first try */
+      progressMonitor(0);
+      pstate.init(iter,size_t(1024));
+      PrimInfo pinfo = parallel_for_for_prefix_sum( pstate, iter, PrimInfo(empty), [&](Mesh* mesh, const range<size_t>& r, size_t k, const PrimInfo& base) -> PrimInfo
+      {
+        PrimInfo pinfo(empty);
+        for (size_t j=r.begin(); j<r.end(); j++)
+        {
+          if (!mesh->valid(j)) continue;
+          const BBox3fa bounds = mesh->bounds(j,time_range);
+          const PrimRef prim(bounds,mesh->id,j);
+          pinfo.add(bounds,bounds.center2());
+          prims[k++] = prim;
+        }
+        return pinfo;
+      }, [](const PrimInfo& a, const PrimInfo& b) -> PrimInfo { return PrimInfo::merge(a,b); });
+      
+      /* if we need to filter out geometry, run again */
+      if (pinfo.size() != prims.size())
+      {
+        progressMonitor(0);
+        pinfo = parallel_for_for_prefix_sum( pstate, iter, PrimInfo(empty), [&](Mesh* mesh, const range<size_t>& r, size_t k, const PrimInfo& base) -> PrimInfo
+        {
+          k = base.size();
+          PrimInfo pinfo(empty);
+          for (size_t j=r.begin(); j<r.end(); j++)
+          {
+            if (!mesh->valid(j)) continue;
+            const BBox3fa bounds = mesh->bounds(j,time_range);
+            const PrimRef prim(bounds,mesh->id,j);
+            pinfo.add(bounds,bounds.center2());
+            prims[k++] = prim;
+          }
+          return pinfo;
+        }, [](const PrimInfo& a, const PrimInfo& b) -> PrimInfo { return PrimInfo::merge(a,b); });
+      }
+      return pinfo;
+    }
+
     template<typename Mesh, size_t timeSteps>
       PrimInfo createPrimRefList(Scene* scene, PrimRefList& prims_o, BuildProgressMonitor& progressMonitor)
     {
@@ -160,10 +205,10 @@ namespace embree
 	  Vec3fa p2 = mesh->vertex(ofs+2,0);
 	  Vec3fa p3 = mesh->vertex(ofs+3,0);
 	  if (timeSteps == 2) {
-	    p0 = 0.5f*(p0+mesh->vertex(ofs+0,1));
-	    p1 = 0.5f*(p1+mesh->vertex(ofs+1,1));
-	    p2 = 0.5f*(p2+mesh->vertex(ofs+2,1));
-	    p3 = 0.5f*(p3+mesh->vertex(ofs+3,1));
+	    p0 = 0.5f*(p0+mesh->vertex(ofs+0,mesh->numTimeSteps-1));
+	    p1 = 0.5f*(p1+mesh->vertex(ofs+1,mesh->numTimeSteps-1));
+	    p2 = 0.5f*(p2+mesh->vertex(ofs+2,mesh->numTimeSteps-1));
+	    p3 = 0.5f*(p3+mesh->vertex(ofs+3,mesh->numTimeSteps-1));
 	  }
           if (!isvalid((float4)p0) || !isvalid((float4)p1) || !isvalid((float4)p2) || !isvalid((float4)p3))
               continue;
@@ -195,10 +240,10 @@ namespace embree
             Vec3fa p2 = mesh->vertex(ofs+2,0);
             Vec3fa p3 = mesh->vertex(ofs+3,0);
             if (timeSteps == 2) {
-              p0 = 0.5f*(p0+mesh->vertex(ofs+0,1));
-              p1 = 0.5f*(p1+mesh->vertex(ofs+1,1));
-              p2 = 0.5f*(p2+mesh->vertex(ofs+2,1));
-              p3 = 0.5f*(p3+mesh->vertex(ofs+3,1));
+              p0 = 0.5f*(p0+mesh->vertex(ofs+0,mesh->numTimeSteps-1));
+              p1 = 0.5f*(p1+mesh->vertex(ofs+1,mesh->numTimeSteps-1));
+              p2 = 0.5f*(p2+mesh->vertex(ofs+2,mesh->numTimeSteps-1));
+              p3 = 0.5f*(p3+mesh->vertex(ofs+3,mesh->numTimeSteps-1));
             }
             if (!isvalid((float4)p0) || !isvalid((float4)p1) || !isvalid((float4)p2) || !isvalid((float4)p3))
               continue;
@@ -215,14 +260,24 @@ namespace embree
     }
     
     template PrimInfo createPrimRefArray<TriangleMesh>(TriangleMesh* mesh, mvector<PrimRef>& prims, BuildProgressMonitor& progressMonitor);
+    template PrimInfo createPrimRefArray<QuadMesh>(QuadMesh* mesh, mvector<PrimRef>& prims, BuildProgressMonitor& progressMonitor);
+    template PrimInfo createPrimRefArray<Points>(Points* mesh, mvector<PrimRef>& prims, BuildProgressMonitor& progressMonitor);
     template PrimInfo createPrimRefArray<BezierCurves>(BezierCurves* mesh, mvector<PrimRef>& prims, BuildProgressMonitor& progressMonitor);
     template PrimInfo createPrimRefArray<AccelSet>(AccelSet* mesh, mvector<PrimRef>& prims, BuildProgressMonitor& progressMonitor);
+    template PrimInfo createPrimRefArray<Instance>(Instance* mesh, mvector<PrimRef>& prims, BuildProgressMonitor& progressMonitor);
 
     template PrimInfo createPrimRefArray<TriangleMesh,1>(Scene* scene, mvector<PrimRef>& prims, BuildProgressMonitor& progressMonitor);
     template PrimInfo createPrimRefArray<TriangleMesh,2>(Scene* scene, mvector<PrimRef>& prims, BuildProgressMonitor& progressMonitor);
+    template PrimInfo createPrimRefArray<QuadMesh,1>(Scene* scene, mvector<PrimRef>& prims, BuildProgressMonitor& progressMonitor);
+    template PrimInfo createPrimRefArray<Points,1>(Scene* scene, mvector<PrimRef>& prims, BuildProgressMonitor& progressMonitor);
     template PrimInfo createPrimRefArray<BezierCurves,1>(Scene* scene, mvector<PrimRef>& prims, BuildProgressMonitor& progressMonitor);
     template PrimInfo createPrimRefArray<SubdivMesh,1>(Scene* scene, mvector<PrimRef>& prims, BuildProgressMonitor& progressMonitor);
     template PrimInfo createPrimRefArray<AccelSet,1>(Scene* scene, mvector<PrimRef>& prims, BuildProgressMonitor& progressMonitor);
+    template PrimInfo createPrimRefArray<Instance,1>(Scene* scene, mvector<PrimRef>& prims, BuildProgressMonitor& progressMonitor);
+
+    template PrimInfo createPrimRefArrayMBlur<TriangleMesh>(Scene* scene, const BBox1f& time_range, mvector<PrimRef>& prims, BuildProgressMonitor& progressMonitor);
+    template PrimInfo createPrimRefArrayMBlur<Points>(Scene* scene, const BBox1f& time_range, mvector<PrimRef>& prims, BuildProgressMonitor& progressMonitor);
+    template PrimInfo createPrimRefArrayMBlur<Instance>(Scene* scene, const BBox1f& time_range, mvector<PrimRef>& prims, BuildProgressMonitor& progressMonitor);
 
     template PrimInfo createBezierRefArray<1>(Scene* scene, mvector<BezierPrim>& prims, BuildProgressMonitor& progressMonitor);
     template PrimInfo createBezierRefArray<2>(Scene* scene, mvector<BezierPrim>& prims, BuildProgressMonitor& progressMonitor);
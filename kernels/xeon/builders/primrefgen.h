@@ -31,6 +31,9 @@ namespace embree
     template<typename Mesh, size_t timeSteps>
       PrimInfo createPrimRefArray(Scene* scene, mvector<PrimRef>& prims, BuildProgressMonitor& progressMonitor);
 
+    template<typename Mesh>
+      PrimInfo createPrimRefArrayMBlur(Scene* scene, const BBox1f& time_range, mvector<PrimRef>& prims, BuildProgressMonitor& progressMonitor);
+
     template<typename Mesh, size_t timeSteps>
       PrimInfo createPrimRefList(Scene* scene, PrimRefList& prims, BuildProgressMonitor& progressMonitor);
 
@@ -24,11 +24,17 @@
 #include "../geometry/triangle4v.h"
 #include "../geometry/triangle4v_mb.h"
 #include "../geometry/triangle4i.h"
+#include "../geometry/quad4v.h"
+#include "../geometry/sphere4.h"
+#include "../geometry/sphere4_mb.h"
 #include "../geometry/subdivpatch1.h"
 #include "../geometry/subdivpatch1cached.h"
 #include "../geometry/object.h"
+#include "../geometry/instance.h"
 
 #include "../../common/accelinstance.h"
+#include "../../common/accelsegments.h"
+#include "../../algorithms/parallel_for.h"
 
 namespace embree
 {
@@ -42,10 +48,15 @@ namespace embree
   DECLARE_SYMBOL(Accel::Intersector1,BVH4Triangle4vIntersector1Pluecker);
   DECLARE_SYMBOL(Accel::Intersector1,BVH4Triangle4iIntersector1Pluecker);
   DECLARE_SYMBOL(Accel::Intersector1,BVH4Triangle4vMBIntersector1Moeller);
+  DECLARE_SYMBOL(Accel::Intersector1,BVH4Quad4vIntersector1Moeller);
+  DECLARE_SYMBOL(Accel::Intersector1,BVH4Sphere4Intersector1);
+  DECLARE_SYMBOL(Accel::Intersector1,BVH4Sphere4MBIntersector1);
   DECLARE_SYMBOL(Accel::Intersector1,BVH4Subdivpatch1Intersector1);
   DECLARE_SYMBOL(Accel::Intersector1,BVH4Subdivpatch1CachedIntersector1);
   DECLARE_SYMBOL(Accel::Intersector1,BVH4GridAOSIntersector1);
   DECLARE_SYMBOL(Accel::Intersector1,BVH4VirtualIntersector1);
+  DECLARE_SYMBOL(Accel::Intersector1,BVH4InstanceIntersector1);
+  DECLARE_SYMBOL(Accel::Intersector1,BVH4InstanceMBIntersector1);
 
   DECLARE_SYMBOL(Accel::Intersector4,BVH4Bezier1vIntersector4Chunk);
   DECLARE_SYMBOL(Accel::Intersector4,BVH4Bezier1iIntersector4Chunk);
@@ -64,10 +75,21 @@ namespace embree
   DECLARE_SYMBOL(Accel::Intersector4,BVH4Triangle4vIntersector4HybridPluecker);
   DECLARE_SYMBOL(Accel::Intersector4,BVH4Triangle4iIntersector4ChunkPluecker);
   DECLARE_SYMBOL(Accel::Intersector4,BVH4Triangle4vMBIntersector4ChunkMoeller);
+  DECLARE_SYMBOL(Accel::Intersector4,BVH4Quad4vIntersector4ChunkMoeller);
+  DECLARE_SYMBOL(Accel::Intersector4,BVH4Quad4vIntersector4ChunkMoellerNoFilter);
+  DECLARE_SYMBOL(Accel::Intersector4,BVH4Quad4vIntersector4HybridMoeller);
+  DECLARE_SYMBOL(Accel::Intersector4,BVH4Quad4vIntersector4HybridMoellerNoFilter);
+  DECLARE_SYMBOL(Accel::Intersector4,BVH4Sphere4Intersector4Chunk);
+  DECLARE_SYMBOL(Accel::Intersector4,BVH4Sphere4Intersector4ChunkNoFilter);
+  DECLARE_SYMBOL(Accel::Intersector4,BVH4Sphere4Intersector4Hybrid);
+  DECLARE_SYMBOL(Accel::Intersector4,BVH4Sphere4Intersector4HybridNoFilter);
+  DECLARE_SYMBOL(Accel::Intersector4,BVH4Sphere4MBIntersector4Chunk);
   DECLARE_SYMBOL(Accel::Intersector4,BVH4Subdivpatch1Intersector4);
   DECLARE_SYMBOL(Accel::Intersector4,BVH4Subdivpatch1CachedIntersector4);
   DECLARE_SYMBOL(Accel::Intersector4,BVH4GridAOSIntersector4);
   DECLARE_SYMBOL(Accel::Intersector4,BVH4VirtualIntersector4Chunk);
+  DECLARE_SYMBOL(Accel::Intersector4,BVH4InstanceIntersector4Chunk);
+  DECLARE_SYMBOL(Accel::Intersector4,BVH4InstanceMBIntersector4Chunk);
 
   DECLARE_SYMBOL(Accel::Intersector8,BVH4Bezier1vIntersector8Chunk);
   DECLARE_SYMBOL(Accel::Intersector8,BVH4Bezier1iIntersector8Chunk);
@@ -86,10 +108,17 @@ namespace embree
   DECLARE_SYMBOL(Accel::Intersector8,BVH4Triangle4vIntersector8HybridPluecker);
   DECLARE_SYMBOL(Accel::Intersector8,BVH4Triangle4iIntersector8ChunkPluecker);
   DECLARE_SYMBOL(Accel::Intersector8,BVH4Triangle4vMBIntersector8ChunkMoeller);
+  DECLARE_SYMBOL(Accel::Intersector8,BVH4Quad4vIntersector8HybridMoeller);
+  DECLARE_SYMBOL(Accel::Intersector8,BVH4Quad4vIntersector8HybridMoellerNoFilter);
+  DECLARE_SYMBOL(Accel::Intersector8,BVH4Sphere4Intersector8Hybrid);
+  DECLARE_SYMBOL(Accel::Intersector8,BVH4Sphere4Intersector8HybridNoFilter);
+  DECLARE_SYMBOL(Accel::Intersector8,BVH4Sphere4MBIntersector8Chunk);
   DECLARE_SYMBOL(Accel::Intersector8,BVH4Subdivpatch1Intersector8);
   DECLARE_SYMBOL(Accel::Intersector8,BVH4Subdivpatch1CachedIntersector8);
   DECLARE_SYMBOL(Accel::Intersector8,BVH4GridAOSIntersector8);
   DECLARE_SYMBOL(Accel::Intersector8,BVH4VirtualIntersector8Chunk);
+  DECLARE_SYMBOL(Accel::Intersector8,BVH4InstanceIntersector8Chunk);
+  DECLARE_SYMBOL(Accel::Intersector8,BVH4InstanceMBIntersector8Chunk);
 
   DECLARE_SYMBOL(Accel::Intersector16,BVH4Bezier1vIntersector16Chunk);
   DECLARE_SYMBOL(Accel::Intersector16,BVH4Bezier1iIntersector16Chunk);
@@ -108,10 +137,17 @@ namespace embree
   DECLARE_SYMBOL(Accel::Intersector16,BVH4Triangle4vIntersector16HybridPluecker);
   DECLARE_SYMBOL(Accel::Intersector16,BVH4Triangle4iIntersector16ChunkPluecker);
   DECLARE_SYMBOL(Accel::Intersector16,BVH4Triangle4vMBIntersector16ChunkMoeller);
+  DECLARE_SYMBOL(Accel::Intersector16,BVH4Quad4vIntersector16HybridMoeller);
+  DECLARE_SYMBOL(Accel::Intersector16,BVH4Quad4vIntersector16HybridMoellerNoFilter);
+  DECLARE_SYMBOL(Accel::Intersector16,BVH4Sphere4Intersector16Hybrid);
+  DECLARE_SYMBOL(Accel::Intersector16,BVH4Sphere4Intersector16HybridNoFilter);
+  DECLARE_SYMBOL(Accel::Intersector16,BVH4Sphere4MBIntersector16Chunk);
   DECLARE_SYMBOL(Accel::Intersector16,BVH4Subdivpatch1Intersector16);
   DECLARE_SYMBOL(Accel::Intersector16,BVH4Subdivpatch1CachedIntersector16);
   DECLARE_SYMBOL(Accel::Intersector16,BVH4GridAOSIntersector16);
   DECLARE_SYMBOL(Accel::Intersector16,BVH4VirtualIntersector16Chunk);
+  DECLARE_SYMBOL(Accel::Intersector16,BVH4InstanceIntersector16Chunk);
+  DECLARE_SYMBOL(Accel::Intersector16,BVH4InstanceMBIntersector16Chunk);
 
   DECLARE_BUILDER(void,Scene,const createTriangleMeshAccelTy,BVH4BuilderTwoLevelSAH);
 
@@ -123,7 +159,10 @@ namespace embree
   DECLARE_BUILDER(void,Scene,size_t,BVH4Triangle8SceneBuilderSAH);
   DECLARE_BUILDER(void,Scene,size_t,BVH4Triangle4vSceneBuilderSAH);
   DECLARE_BUILDER(void,Scene,size_t,BVH4Triangle4iSceneBuilderSAH);
-  DECLARE_BUILDER(void,Scene,size_t,BVH4Triangle4vMBSceneBuilderSAH);
+  DECLARE_BUILDER(void,Scene,const BBox1f&,BVH4Triangle4vMBSceneBuilderSAH);
+  DECLARE_BUILDER(void,Scene,size_t,BVH4Quad4vSceneBuilderSAH);
+  DECLARE_BUILDER(void,Scene,size_t,BVH4Sphere4SceneBuilderSAH);
+  DECLARE_BUILDER(void,Scene,const BBox1f&,BVH4Sphere4MBSceneBuilderSAH);
 
   DECLARE_BUILDER(void,Scene,size_t,BVH4Triangle4SceneBuilderSpatialSAH);
   DECLARE_BUILDER(void,Scene,size_t,BVH4Triangle8SceneBuilderSpatialSAH);
@@ -137,6 +176,8 @@ namespace embree
   DECLARE_BUILDER(void,Scene,size_t,BVH4Bezier1vSceneBuilderSAH);
   DECLARE_BUILDER(void,Scene,size_t,BVH4Bezier1iSceneBuilderSAH);
   DECLARE_BUILDER(void,Scene,size_t,BVH4VirtualSceneBuilderSAH);
+  DECLARE_BUILDER(void,Scene,size_t,BVH4InstanceSceneBuilderSAH);
+  DECLARE_BUILDER(void,Scene,const BBox1f&,BVH4InstanceMBSceneBuilderSAH);
 
   DECLARE_BUILDER(void,Scene,size_t,BVH4SubdivPatch1BuilderBinnedSAH);
   DECLARE_BUILDER(void,Scene,size_t,BVH4SubdivPatch1CachedBuilderBinnedSAH);
@@ -151,12 +192,23 @@ namespace embree
   DECLARE_BUILDER(void,Scene,size_t,BVH4Triangle8SceneBuilderMortonGeneral);
   DECLARE_BUILDER(void,Scene,size_t,BVH4Triangle4vSceneBuilderMortonGeneral);
   DECLARE_BUILDER(void,Scene,size_t,BVH4Triangle4iSceneBuilderMortonGeneral);
+  DECLARE_BUILDER(void,Scene,size_t,BVH4Sphere4SceneBuilderMortonGeneral);
+
+  DECLARE_BUILDER(void,Scene,size_t,BVH4Triangle4SceneBuilderHybrid);
+  DECLARE_BUILDER(void,Scene,size_t,BVH4Triangle8SceneBuilderHybrid);
+  DECLARE_BUILDER(void,Scene,size_t,BVH4Triangle4vSceneBuilderHybrid);
+  DECLARE_BUILDER(void,Scene,size_t,BVH4Triangle4iSceneBuilderHybrid);
 
   DECLARE_BUILDER(void,TriangleMesh,size_t,BVH4Triangle4MeshBuilderMortonGeneral);
   DECLARE_BUILDER(void,TriangleMesh,size_t,BVH4Triangle8MeshBuilderMortonGeneral);
   DECLARE_BUILDER(void,TriangleMesh,size_t,BVH4Triangle4vMeshBuilderMortonGeneral);
   DECLARE_BUILDER(void,TriangleMesh,size_t,BVH4Triangle4iMeshBuilderMortonGeneral);
 
+  DECLARE_BUILDER(void,TriangleMesh,size_t,BVH4Triangle4MeshBuilderHybrid);
+  DECLARE_BUILDER(void,TriangleMesh,size_t,BVH4Triangle8MeshBuilderHybrid);
+  DECLARE_BUILDER(void,TriangleMesh,size_t,BVH4Triangle4vMeshBuilderHybrid);
+  DECLARE_BUILDER(void,TriangleMesh,size_t,BVH4Triangle4iMeshBuilderHybrid);
+
   void BVH4Register () 
   {
     int features = getCPUFeatures();
@@ -173,6 +225,9 @@ namespace embree
     SELECT_SYMBOL_DEFAULT_AVX(features,BVH4Triangle4vSceneBuilderSAH);
     SELECT_SYMBOL_DEFAULT_AVX(features,BVH4Triangle4iSceneBuilderSAH);
     SELECT_SYMBOL_DEFAULT_AVX(features,BVH4Triangle4vMBSceneBuilderSAH);
+    SELECT_SYMBOL_DEFAULT_AVX(features,BVH4Quad4vSceneBuilderSAH);
+    SELECT_SYMBOL_DEFAULT_AVX(features,BVH4Sphere4SceneBuilderSAH);
+    SELECT_SYMBOL_DEFAULT_AVX(features,BVH4Sphere4MBSceneBuilderSAH);
 
     SELECT_SYMBOL_DEFAULT_AVX(features,BVH4Triangle4SceneBuilderSpatialSAH);
     SELECT_SYMBOL_AVX        (features,BVH4Triangle8SceneBuilderSpatialSAH);
@@ -186,6 +241,8 @@ namespace embree
     SELECT_SYMBOL_DEFAULT_AVX(features,BVH4Bezier1vSceneBuilderSAH);
     SELECT_SYMBOL_DEFAULT_AVX(features,BVH4Bezier1iSceneBuilderSAH);
     SELECT_SYMBOL_DEFAULT_AVX(features,BVH4VirtualSceneBuilderSAH);
+    SELECT_SYMBOL_DEFAULT_AVX(features,BVH4InstanceSceneBuilderSAH);
+    SELECT_SYMBOL_DEFAULT_AVX(features,BVH4InstanceMBSceneBuilderSAH);
 
     SELECT_SYMBOL_DEFAULT_AVX(features,BVH4SubdivPatch1BuilderBinnedSAH);
     SELECT_SYMBOL_DEFAULT_AVX_AVX512(features,BVH4SubdivPatch1CachedBuilderBinnedSAH);
@@ -200,12 +257,23 @@ namespace embree
     SELECT_SYMBOL_AVX        (features,BVH4Triangle8SceneBuilderMortonGeneral);
     SELECT_SYMBOL_DEFAULT_AVX(features,BVH4Triangle4vSceneBuilderMortonGeneral);
     SELECT_SYMBOL_DEFAULT_AVX(features,BVH4Triangle4iSceneBuilderMortonGeneral);
+    SELECT_SYMBOL_DEFAULT_AVX(features,BVH4Sphere4SceneBuilderMortonGeneral);
+
+    SELECT_SYMBOL_DEFAULT_AVX(features,BVH4Triangle4SceneBuilderHybrid);
+    SELECT_SYMBOL_AVX        (features,BVH4Triangle8SceneBuilderHybrid);
+    SELECT_SYMBOL_DEFAULT_AVX(features,BVH4Triangle4vSceneBuilderHybrid);
+    SELECT_SYMBOL_DEFAULT_AVX(features,BVH4Triangle4iSceneBuilderHybrid);
 
     SELECT_SYMBOL_DEFAULT_AVX(features,BVH4Triangle4MeshBuilderMortonGeneral);
     SELECT_SYMBOL_AVX        (features,BVH4Triangle8MeshBuilderMortonGeneral);
     SELECT_SYMBOL_DEFAULT_AVX(features,BVH4Triangle4vMeshBuilderMortonGeneral);
     SELECT_SYMBOL_DEFAULT_AVX(features,BVH4Triangle4iMeshBuilderMortonGeneral);
 
+    SELECT_SYMBOL_DEFAULT_AVX(features,BVH4Triangle4MeshBuilderHybrid);
+    SELECT_SYMBOL_AVX        (features,BVH4Triangle8MeshBuilderHybrid);
+    SELECT_SYMBOL_DEFAULT_AVX(features,BVH4Triangle4vMeshBuilderHybrid);
+    SELECT_SYMBOL_DEFAULT_AVX(features,BVH4Triangle4iMeshBuilderHybrid);
+
     /* select intersectors1 */
     SELECT_SYMBOL_DEFAULT_AVX_AVX2      (features,BVH4Bezier1vIntersector1);
     SELECT_SYMBOL_DEFAULT_AVX_AVX2      (features,BVH4Bezier1iIntersector1);
@@ -217,10 +285,15 @@ namespace embree
     SELECT_SYMBOL_DEFAULT_SSE41_AVX     (features,BVH4Triangle4vIntersector1Pluecker);
     SELECT_SYMBOL_DEFAULT_SSE41_AVX     (features,BVH4Triangle4iIntersector1Pluecker);
     SELECT_SYMBOL_DEFAULT_SSE41_AVX_AVX2(features,BVH4Triangle4vMBIntersector1Moeller);
+    SELECT_SYMBOL_DEFAULT_SSE41_AVX_AVX2(features,BVH4Quad4vIntersector1Moeller);
+    SELECT_SYMBOL_DEFAULT_SSE41_AVX_AVX2(features,BVH4Sphere4Intersector1);
+    SELECT_SYMBOL_DEFAULT_SSE41_AVX_AVX2(features,BVH4Sphere4MBIntersector1);
     SELECT_SYMBOL_DEFAULT_SSE41_AVX_AVX2(features,BVH4Subdivpatch1Intersector1);
     SELECT_SYMBOL_DEFAULT_SSE41_AVX_AVX2(features,BVH4Subdivpatch1CachedIntersector1);
     SELECT_SYMBOL_DEFAULT_SSE41_AVX_AVX2(features,BVH4GridAOSIntersector1);
     SELECT_SYMBOL_DEFAULT_SSE41_AVX_AVX2(features,BVH4VirtualIntersector1);
+    SELECT_SYMBOL_DEFAULT_SSE41_AVX_AVX2(features,BVH4InstanceIntersector1);
+    SELECT_SYMBOL_DEFAULT_SSE41_AVX_AVX2(features,BVH4InstanceMBIntersector1);
 
 #if defined (RTCORE_RAY_PACKETS)
 
@@ -245,10 +318,25 @@ namespace embree
     SELECT_SYMBOL_SSE42_AVX             (features,BVH4Triangle4vIntersector4HybridPluecker);
     SELECT_SYMBOL_DEFAULT_SSE41_AVX     (features,BVH4Triangle4iIntersector4ChunkPluecker);
     SELECT_SYMBOL_DEFAULT_SSE41_AVX_AVX2(features,BVH4Triangle4vMBIntersector4ChunkMoeller);
+    SELECT_SYMBOL_DEFAULT_SSE41_AVX_AVX2(features,BVH4Quad4vIntersector4ChunkMoeller);
+    SELECT_SYMBOL_DEFAULT_SSE41_AVX_AVX2(features,BVH4Quad4vIntersector4ChunkMoellerNoFilter);
+    SELECT_SYMBOL_DEFAULT2              (features,BVH4Quad4vIntersector4HybridMoeller,BVH4Quad4vIntersector4ChunkMoeller); // hybrid not supported below SSE4.2
+    SELECT_SYMBOL_DEFAULT2              (features,BVH4Quad4vIntersector4HybridMoellerNoFilter,BVH4Quad4vIntersector4ChunkMoellerNoFilter); // hybrid not supported below SSE4.2
+    SELECT_SYMBOL_SSE42_AVX_AVX2        (features,BVH4Quad4vIntersector4HybridMoeller);
+    SELECT_SYMBOL_SSE42_AVX_AVX2        (features,BVH4Quad4vIntersector4HybridMoellerNoFilter);
+    SELECT_SYMBOL_DEFAULT_SSE41_AVX_AVX2(features,BVH4Sphere4Intersector4Chunk);
+    SELECT_SYMBOL_DEFAULT_SSE41_AVX_AVX2(features,BVH4Sphere4Intersector4ChunkNoFilter);
+    SELECT_SYMBOL_DEFAULT2              (features,BVH4Sphere4Intersector4Hybrid,BVH4Sphere4Intersector4Chunk); // hybrid not supported below SSE4.2
+    SELECT_SYMBOL_DEFAULT2              (features,BVH4Sphere4Intersector4HybridNoFilter,BVH4Sphere4Intersector4ChunkNoFilter); // hybrid not supported below SSE4.2
+    SELECT_SYMBOL_SSE42_AVX_AVX2        (features,BVH4Sphere4Intersector4Hybrid);
+    SELECT_SYMBOL_SSE42_AVX_AVX2        (features,BVH4Sphere4Intersector4HybridNoFilter);
+    SELECT_SYMBOL_DEFAULT_SSE41_AVX_AVX2(features,BVH4Sphere4MBIntersector4Chunk);
     SELECT_SYMBOL_DEFAULT_AVX_AVX2      (features,BVH4Subdivpatch1Intersector4);
     SELECT_SYMBOL_DEFAULT_AVX_AVX2      (features,BVH4Subdivpatch1CachedIntersector4);
     SELECT_SYMBOL_DEFAULT_AVX_AVX2      (features,BVH4GridAOSIntersector4);
     SELECT_SYMBOL_DEFAULT_SSE41_AVX_AVX2(features,BVH4VirtualIntersector4Chunk);
+    SELECT_SYMBOL_DEFAULT_SSE41_AVX_AVX2(features,BVH4InstanceIntersector4Chunk);
+    SELECT_SYMBOL_DEFAULT_SSE41_AVX_AVX2(features,BVH4InstanceMBIntersector4Chunk);
    
     /* select intersectors8 */
     SELECT_SYMBOL_AVX_AVX2(features,BVH4Bezier1vIntersector8Chunk);
@@ -268,10 +356,17 @@ namespace embree
     SELECT_SYMBOL_AVX     (features,BVH4Triangle4vIntersector8HybridPluecker);
     SELECT_SYMBOL_AVX     (features,BVH4Triangle4iIntersector8ChunkPluecker);
     SELECT_SYMBOL_AVX_AVX2(features,BVH4Triangle4vMBIntersector8ChunkMoeller);
+    SELECT_SYMBOL_AVX_AVX2(features,BVH4Quad4vIntersector8HybridMoeller);
+    SELECT_SYMBOL_AVX_AVX2(features,BVH4Quad4vIntersector8HybridMoellerNoFilter);
+    SELECT_SYMBOL_AVX_AVX2(features,BVH4Sphere4Intersector8Hybrid);
+    SELECT_SYMBOL_AVX_AVX2(features,BVH4Sphere4Intersector8HybridNoFilter);
+    SELECT_SYMBOL_AVX_AVX2(features,BVH4Sphere4MBIntersector8Chunk);
     SELECT_SYMBOL_AVX_AVX2(features,BVH4Subdivpatch1Intersector8);
     SELECT_SYMBOL_AVX_AVX2(features,BVH4Subdivpatch1CachedIntersector8);
     SELECT_SYMBOL_AVX_AVX2(features,BVH4GridAOSIntersector8);
     SELECT_SYMBOL_AVX_AVX2(features,BVH4VirtualIntersector8Chunk);
+    SELECT_SYMBOL_AVX_AVX2(features,BVH4InstanceIntersector8Chunk);
+    SELECT_SYMBOL_AVX_AVX2(features,BVH4InstanceMBIntersector8Chunk);
 
     /* select intersectors16 */
     SELECT_SYMBOL_AVX512(features,BVH4Bezier1vIntersector16Chunk);
@@ -291,17 +386,24 @@ namespace embree
     SELECT_SYMBOL_AVX512(features,BVH4Triangle4vIntersector16HybridPluecker);
     SELECT_SYMBOL_AVX512(features,BVH4Triangle4iIntersector16ChunkPluecker);
     SELECT_SYMBOL_AVX512(features,BVH4Triangle4vMBIntersector16ChunkMoeller);
+    SELECT_SYMBOL_AVX512(features,BVH4Quad4vIntersector16HybridMoeller);
+    SELECT_SYMBOL_AVX512(features,BVH4Quad4vIntersector16HybridMoellerNoFilter);
+    SELECT_SYMBOL_AVX512(features,BVH4Sphere4Intersector16Hybrid);
+    SELECT_SYMBOL_AVX512(features,BVH4Sphere4Intersector16HybridNoFilter);
+    SELECT_SYMBOL_AVX512(features,BVH4Sphere4MBIntersector16Chunk);
     SELECT_SYMBOL_AVX512(features,BVH4Subdivpatch1Intersector16);
     SELECT_SYMBOL_AVX512(features,BVH4Subdivpatch1CachedIntersector16);
     SELECT_SYMBOL_AVX512(features,BVH4GridAOSIntersector16);
     SELECT_SYMBOL_AVX512(features,BVH4VirtualIntersector16Chunk);
+    SELECT_SYMBOL_AVX512(features,BVH4InstanceIntersector16Chunk);
+    SELECT_SYMBOL_AVX512(features,BVH4InstanceMBIntersector16Chunk);
 
 #endif
   }
 
   BVH4::BVH4 (const PrimitiveType& primTy, Scene* scene, bool listMode)
     : AccelData(AccelData::TY_BVH4), primTy(primTy), device(scene->device), scene(scene), listMode(listMode),
-      root(emptyNode), alloc(scene->device), numPrimitives(0), numVertices(0), data_mem(nullptr), size_data_mem(0) {}
+      root(emptyNode), alloc(scene->device,scene->device->numa), numPrimitives(0), numVertices(0), data_mem(nullptr), size_data_mem(0) {}
 
   BVH4::~BVH4 () 
   {
@@ -401,6 +503,278 @@ namespace embree
     else return node;
   }
 
+  /*! returns the size of the node a reference points to */
+  static __forceinline size_t nodeBytes(BVH4::NodeRef node)
+  {
+    if      (node.isNode()         ) return sizeof(BVH4::Node);
+    else if (node.isNodeMB()       ) return sizeof(BVH4::NodeMB);
+    else if (node.isUnalignedNode()) return sizeof(BVH4::UnalignedNode);
+    else                             return sizeof(BVH4::UnalignedNodeMB);
+  }
+
+  /*! leaves are padded to the alignment required for the leaf encoding */
+  static __forceinline size_t leafBytes(size_t bytes) {
+    return (bytes+BVH4::align_mask) & ~BVH4::align_mask;
+  }
+
+  void BVH4::saveBytes(NodeRef node, size_t& nodeBytes, size_t& leafBytes) const
+  {
+    if (node == emptyNode) 
+      return;
+
+    if (node.isLeaf()) {
+      size_t num; node.leaf(num);
+      leafBytes += embree::leafBytes(num*primTy.bytes);
+      return;
+    }
+
+    nodeBytes += embree::nodeBytes(node);
+    const BaseNode* n = node.baseNode(0);
+    for (size_t i=0; i<N; i++)
+      saveBytes(n->child(i),nodeBytes,leafBytes);
+  }
+
+  BVH4::NodeRef BVH4::saveRecursion(NodeRef node, char* data, size_t& nodeOfs, size_t& leafOfs) const
+  {
+    if (node == emptyNode)
+      return node;
+
+    if (node.isLeaf()) 
+    {
+      size_t num; char* prims = node.leaf(num);
+      const size_t bytes = num*primTy.bytes;
+      memcpy(data+leafOfs,prims,bytes);
+      NodeRef ref = encodeLeaf((void*)leafOfs,num);
+      leafOfs += embree::leafBytes(bytes);
+      return ref;
+    }
+
+    const size_t bytes = embree::nodeBytes(node);
+    const size_t ofs = nodeOfs; nodeOfs += bytes;
+    BaseNode* n = (BaseNode*) (data+ofs);
+    memcpy(n,node.baseNode(0),bytes);
+    for (size_t i=0; i<N; i++)
+      n->child(i) = saveRecursion(n->child(i),data,nodeOfs,leafOfs);
+    return NodeRef(ofs | (node & align_mask));
+  }
+
+  void BVH4::relocate(NodeRef& node, size_t base)
+  {
+    if (node == emptyNode)
+      return;
+
+    node = NodeRef(node + base);
+    if (node.isLeaf()) 
+      return;
+
+    BaseNode* n = node.baseNode(0);
+    for (size_t i=0; i<N; i++)
+      relocate(n->child(i),base);
+  }
+
+  bool BVH4::save(std::ostream& stream)
+  {
+    /* leaves have to be free of pointers to get stored */
+    if (root != emptyNode && (!primTy.relocatable || listMode || objects.size()))
+      return false;
+
+    /* all nodes are stored in front of the leaves, thus relocation only touches node pages */
+    size_t nodeBytes = 0, leafBytes = 0;
+    saveBytes(root,nodeBytes,leafBytes);
+    std::vector<char> data(nodeBytes+leafBytes);
+    size_t nodeOfs = 0, leafOfs = nodeBytes;
+    NodeRef ref = saveRecursion(root,data.data(),nodeOfs,leafOfs);
+    assert(nodeOfs == nodeBytes && leafOfs == nodeBytes+leafBytes);
+
+    FileHeader header(primTy.name,N,0);
+    header.root = ref;
+    header.numPrimitives = numPrimitives;
+    header.numVertices = numVertices;
+    header.bytes = data.size();
+    header.bounds = bounds;
+
+    const char zeros[64] = { 0 };
+    stream.write((char*)&header,sizeof(header));
+    stream.write(zeros,FileHeader::headerBytes()-sizeof(header));
+    stream.write(data.data(),data.size());
+    return stream.good();
+  }
+
+  bool BVH4::load(char* ptr, size_t bytes)
+  {
+    const FileHeader& header = *(FileHeader*) ptr;
+    if (bytes < FileHeader::headerBytes() || !header.matches(FileHeader(primTy.name,N,0)))
+      return false;
+    if (header.bytes > bytes-FileHeader::headerBytes() || (!primTy.relocatable && header.root != emptyNode))
+      return false;
+
+    clear();
+    NodeRef ref = header.root;
+    relocate(ref,(size_t)ptr+FileHeader::headerBytes());
+    set(ref,header.bounds,header.numPrimitives);
+    numVertices = header.numVertices;
+    return true;
+  }
+
+  /*! nodes and leaves of the relayouted hierarchy start at cache line boundaries */
+  static __forceinline size_t cacheLineBytes(size_t bytes) {
+    return (bytes+63) & ~size_t(63);
+  }
+
+  size_t BVH4::relayoutBytes(NodeRef node) const
+  {
+    size_t bytes = cacheLineBytes(embree::nodeBytes(node));
+    const BaseNode* n = node.baseNode(0);
+    for (size_t i=0; i<N; i++)
+    {
+      NodeRef child = n->child(i);
+      if (child == emptyNode) continue;
+      if (child.isLeaf()) { size_t num; child.leaf(num); bytes += cacheLineBytes(num*primTy.bytes); }
+      else bytes += relayoutBytes(child);
+    }
+    return bytes;
+  }
+
+  BVH4::NodeRef BVH4::relayoutRecursion(NodeRef node, char* data, size_t& ofs) const
+  {
+    const size_t bytes = embree::nodeBytes(node);
+    const size_t nodeOfs = ofs; ofs += cacheLineBytes(bytes);
+    BaseNode* n = (BaseNode*) (data+nodeOfs);
+    memcpy(n,node.baseNode(0),bytes);
+
+    /* the leaves are stored directly behind their parent node */
+    for (size_t i=0; i<N; i++)
+    {
+      NodeRef child = n->child(i);
+      if (child == emptyNode || !child.isLeaf()) continue;
+      size_t num; char* prims = child.leaf(num);
+      memcpy(data+ofs,prims,num*primTy.bytes);
+      n->child(i) = encodeLeaf((void*)ofs,num);
+      ofs += cacheLineBytes(num*primTy.bytes);
+    }
+
+    /* followed by the child subtrees in depth first order */
+    for (size_t i=0; i<N; i++)
+    {
+      NodeRef child = n->child(i);
+      if (child == emptyNode || child.isLeaf()) continue;
+      n->child(i) = relayoutRecursion(child,data,ofs);
+    }
+    return NodeRef(nodeOfs | (node & align_mask));
+  }
+
+  bool BVH4::relayoutable() const {
+    return root != emptyNode && !root.isLeaf() && primTy.relocatable && !listMode && !objects.size();
+  }
+
+  template<typename Allocate>
+  BVH4::NodeRef BVH4::relayoutCopy(const Allocate& allocate) const
+  {
+    /* the top nodes are stored first in breadth first order */
+    std::vector<NodeRef> top; top.push_back(root);
+    for (size_t i=0; i<top.size() && top.size() < maxRelayoutTopNodes; i++) {
+      const BaseNode* n = top[i].baseNode(0);
+      for (size_t c=0; c<N && top.size() < maxRelayoutTopNodes; c++)
+        if (n->child(c) != emptyNode && !n->child(c).isLeaf()) top.push_back(n->child(c));
+    }
+
+    /* followed by the leaves of the top nodes and the remaining subtrees in the order they are referenced */
+    std::vector<size_t> topOfs(top.size());
+    size_t topBytes = 0;
+    for (size_t i=0; i<top.size(); i++) {
+      topOfs[i] = topBytes;
+      topBytes += cacheLineBytes(embree::nodeBytes(top[i]));
+    }
+    std::vector<NodeRef> subtrees;
+    for (size_t i=0, next=1; i<top.size(); i++)
+    {
+      const BaseNode* n = top[i].baseNode(0);
+      for (size_t c=0; c<N; c++)
+      {
+        NodeRef child = n->child(c);
+        if (child == emptyNode) continue;
+        if (child.isLeaf()) { size_t num; child.leaf(num); topBytes += cacheLineBytes(num*primTy.bytes); }
+        else if (next < top.size() && top[next] == child) next++;
+        else subtrees.push_back(child);
+      }
+    }
+
+    /* the subtrees are copied in parallel */
+    std::vector<size_t> subtreeOfs(subtrees.size()+1);
+    parallel_for(size_t(0), subtrees.size(), [&] (const range<size_t>& r) {
+        for (size_t i=r.begin(); i<r.end(); i++) subtreeOfs[i+1] = relayoutBytes(subtrees[i]);
+      });
+    subtreeOfs[0] = topBytes;
+    for (size_t i=0; i<subtrees.size(); i++) subtreeOfs[i+1] += subtreeOfs[i];
+    const size_t bytes = subtreeOfs[subtrees.size()];
+
+    char* data = allocate(bytes);
+    parallel_for(size_t(0), subtrees.size(), [&] (const range<size_t>& r) {
+        for (size_t i=r.begin(); i<r.end(); i++) {
+          size_t ofs = subtreeOfs[i];
+          subtrees[i] = relayoutRecursion(subtrees[i],data,ofs);
+        }
+      });
+
+    size_t leafOfs = topOfs.back()+cacheLineBytes(embree::nodeBytes(top.back()));
+    for (size_t i=0, next=1, s=0; i<top.size(); i++)
+    {
+      BaseNode* n = (BaseNode*) (data+topOfs[i]);
+      memcpy(n,top[i].baseNode(0),embree::nodeBytes(top[i]));
+      for (size_t c=0; c<N; c++)
+      {
+        NodeRef child = n->child(c);
+        if (child == emptyNode) continue;
+        if (child.isLeaf()) {
+          size_t num; char* prims = child.leaf(num);
+          memcpy(data+leafOfs,prims,num*primTy.bytes);
+          n->child(c) = encodeLeaf((void*)leafOfs,num);
+          leafOfs += cacheLineBytes(num*primTy.bytes);
+        }
+        else if (next < top.size() && top[next] == child)
+          n->child(c) = NodeRef(topOfs[next++] | (child & align_mask));
+        else
+          n->child(c) = subtrees[s++];
+      }
+    }
+    assert(leafOfs == topBytes);
+    return NodeRef(0 | (root & align_mask));
+  }
+
+  void BVH4::relayout()
+  {
+    /* leaves get copied, thus they must not be referenced from elsewhere */
+    if (!relayoutable())
+      return;
+
+    size_t bytes = 0;
+    char* data = nullptr;
+    NodeRef ref = relayoutCopy([&] (size_t n) { bytes = n; return data = (char*) alignedMalloc(n,64); });
+
+    /* replace the old nodes and leaves by a single block */
+    alloc.clear();
+    char* ptr = (char*) alloc.malloc_block(bytes);
+    memcpy(ptr,data,bytes);
+    alignedFree(data);
+    relocate(ref,(size_t)ptr);
+    root = ref;
+  }
+
+  AccelData* BVH4::clone(size_t node)
+  {
+    if (!relayoutable())
+      return nullptr;
+
+    /* the copy is written directly into a block placed on the NUMA node */
+    BVH4* bvh = new BVH4(primTy,scene,listMode);
+    char* ptr = nullptr;
+    NodeRef ref = relayoutCopy([&] (size_t bytes) { return ptr = (char*) bvh->alloc.malloc_block(bytes,node); });
+    relocate(ref,(size_t)ptr);
+    bvh->set(ref,bounds,numPrimitives);
+    bvh->numVertices = numVertices;
+    return bvh;
+  }
+
   double BVH4::preBuild(const char* builderName)
   {
     if (builderName == nullptr) 
@@ -597,6 +971,45 @@ namespace embree
     return intersectors;
   }
 
+  Accel::Intersectors BVH4Quad4vIntersectors(BVH4* bvh)
+  {
+    Accel::Intersectors intersectors;
+    intersectors.ptr = bvh;
+    intersectors.intersector1           = BVH4Quad4vIntersector1Moeller;
+    intersectors.intersector4_filter    = BVH4Quad4vIntersector4HybridMoeller;
+    intersectors.intersector4_nofilter  = BVH4Quad4vIntersector4HybridMoellerNoFilter;
+    intersectors.intersector8_filter    = BVH4Quad4vIntersector8HybridMoeller;
+    intersectors.intersector8_nofilter  = BVH4Quad4vIntersector8HybridMoellerNoFilter;
+    intersectors.intersector16_filter   = BVH4Quad4vIntersector16HybridMoeller;
+    intersectors.intersector16_nofilter = BVH4Quad4vIntersector16HybridMoellerNoFilter;
+    return intersectors;
+  }
+
+  Accel::Intersectors BVH4Sphere4Intersectors(BVH4* bvh)
+  {
+    Accel::Intersectors intersectors;
+    intersectors.ptr = bvh;
+    intersectors.intersector1           = BVH4Sphere4Intersector1;
+    intersectors.intersector4_filter    = BVH4Sphere4Intersector4Hybrid;
+    intersectors.intersector4_nofilter  = BVH4Sphere4Intersector4HybridNoFilter;
+    intersectors.intersector8_filter    = BVH4Sphere4Intersector8Hybrid;
+    intersectors.intersector8_nofilter  = BVH4Sphere4Intersector8HybridNoFilter;
+    intersectors.intersector16_filter   = BVH4Sphere4Intersector16Hybrid;
+    intersectors.intersector16_nofilter = BVH4Sphere4Intersector16HybridNoFilter;
+    return intersectors;
+  }
+
+  Accel::Intersectors BVH4Sphere4MBIntersectors(BVH4* bvh)
+  {
+    Accel::Intersectors intersectors;
+    intersectors.ptr = bvh;
+    intersectors.intersector1  = BVH4Sphere4MBIntersector1;
+    intersectors.intersector4  = BVH4Sphere4MBIntersector4Chunk;
+    intersectors.intersector8  = BVH4Sphere4MBIntersector8Chunk;
+    intersectors.intersector16 = BVH4Sphere4MBIntersector16Chunk;
+    return intersectors;
+  }
+
   Accel* BVH4::BVH4Bezier1v(Scene* scene)
   { 
     BVH4* accel = new BVH4(Bezier1v::type,scene,LeafMode);
@@ -656,6 +1069,7 @@ namespace embree
     else if (scene->device->tri_builder == "sah_spatial" ) builder = BVH4Triangle4SceneBuilderSpatialSAH(accel,scene,0);
     else if (scene->device->tri_builder == "sah_presplit") builder = BVH4Triangle4SceneBuilderSAH(accel,scene,MODE_HIGH_QUALITY);
     else if (scene->device->tri_builder == "morton"      ) builder = BVH4Triangle4SceneBuilderMortonGeneral(accel,scene,0);
+    else if (scene->device->tri_builder == "hybrid"      ) builder = BVH4Triangle4SceneBuilderHybrid(accel,scene,0);
     else THROW_RUNTIME_ERROR("unknown builder "+scene->device->tri_builder+" for BVH4<Triangle4>");
 
     return new AccelInstance(accel,builder,intersectors);
@@ -678,6 +1092,7 @@ namespace embree
     else if (scene->device->tri_builder == "sah_spatial" ) builder = BVH4Triangle8SceneBuilderSpatialSAH(accel,scene,0);
     else if (scene->device->tri_builder == "sah_presplit") builder = BVH4Triangle8SceneBuilderSAH(accel,scene,MODE_HIGH_QUALITY);
     else if (scene->device->tri_builder == "morton"      ) builder = BVH4Triangle8SceneBuilderMortonGeneral(accel,scene,0);
+    else if (scene->device->tri_builder == "hybrid"      ) builder = BVH4Triangle8SceneBuilderHybrid(accel,scene,0);
     else THROW_RUNTIME_ERROR("unknown builder "+scene->device->tri_builder+" for BVH4<Triangle8>");
 
     return new AccelInstance(accel,builder,intersectors);
@@ -685,12 +1100,19 @@ namespace embree
 #endif
 
   Accel* BVH4::BVH4Triangle4vMB(Scene* scene)
+  {
+    return new AccelSegments(scene,Geometry::TRIANGLE_MESH,[scene] (const BBox1f& time_range) { 
+        return BVH4Triangle4vMB(scene,time_range); 
+      });
+  }
+
+  Accel* BVH4::BVH4Triangle4vMB(Scene* scene, const BBox1f& time_range)
   {
     BVH4* accel = new BVH4(Triangle4vMB::type,scene,LeafMode);
     Accel::Intersectors intersectors = BVH4Triangle4vMBIntersectors(accel);
     Builder* builder = nullptr;
-    if       (scene->device->tri_builder_mb == "default"    ) builder = BVH4Triangle4vMBSceneBuilderSAH(accel,scene,0);
-    else  if (scene->device->tri_builder_mb == "sah") builder = BVH4Triangle4vMBSceneBuilderSAH(accel,scene,0);
+    if       (scene->device->tri_builder_mb == "default"    ) builder = BVH4Triangle4vMBSceneBuilderSAH(accel,scene,time_range);
+    else  if (scene->device->tri_builder_mb == "sah") builder = BVH4Triangle4vMBSceneBuilderSAH(accel,scene,time_range);
     else THROW_RUNTIME_ERROR("unknown builder "+scene->device->tri_builder_mb+" for BVH4<Triangle4vMB>");
     return new AccelInstance(accel,builder,intersectors);
   }
@@ -711,6 +1133,7 @@ namespace embree
     else if (scene->device->tri_builder == "sah_spatial" ) builder = BVH4Triangle4vSceneBuilderSpatialSAH(accel,scene,0);
     else if (scene->device->tri_builder == "sah_presplit") builder = BVH4Triangle4vSceneBuilderSAH(accel,scene,MODE_HIGH_QUALITY);
     else if (scene->device->tri_builder == "morton"      ) builder = BVH4Triangle4vSceneBuilderMortonGeneral(accel,scene,0);
+    else if (scene->device->tri_builder == "hybrid"      ) builder = BVH4Triangle4vSceneBuilderHybrid(accel,scene,0);
     else THROW_RUNTIME_ERROR("unknown builder "+scene->device->tri_builder+" for BVH4<Triangle4v>");
 
     return new AccelInstance(accel,builder,intersectors);
@@ -727,12 +1150,52 @@ namespace embree
     else if (scene->device->tri_builder == "sah_spatial" ) builder = BVH4Triangle4iSceneBuilderSpatialSAH(accel,scene,0);
     else if (scene->device->tri_builder == "sah_presplit") builder = BVH4Triangle4iSceneBuilderSAH(accel,scene,MODE_HIGH_QUALITY);
     else if (scene->device->tri_builder == "morton"      ) builder = BVH4Triangle4iSceneBuilderMortonGeneral(accel,scene,0);
+    else if (scene->device->tri_builder == "hybrid"      ) builder = BVH4Triangle4iSceneBuilderHybrid(accel,scene,0);
     else THROW_RUNTIME_ERROR("unknown builder "+scene->device->tri_builder+" for BVH4<Triangle4i>");
 
     scene->needTriangleVertices = true;
     return new AccelInstance(accel,builder,intersectors);
   }
 
+  Accel* BVH4::BVH4Quad4v(Scene* scene)
+  {
+    BVH4* accel = new BVH4(Quad4v::type,scene,LeafMode);
+    Accel::Intersectors intersectors = BVH4Quad4vIntersectors(accel);
+    Builder* builder = BVH4Quad4vSceneBuilderSAH(accel,scene,0);
+    return new AccelInstance(accel,builder,intersectors);
+  }
+
+  Accel* BVH4::BVH4Sphere4(Scene* scene)
+  {
+    BVH4* accel = new BVH4(Sphere4::type,scene,LeafMode);
+    Accel::Intersectors intersectors = BVH4Sphere4Intersectors(accel);
+    Builder* builder = BVH4Sphere4SceneBuilderSAH(accel,scene,0);
+    return new AccelInstance(accel,builder,intersectors);
+  }
+
+  Accel* BVH4::BVH4Sphere4Morton(Scene* scene)
+  {
+    BVH4* accel = new BVH4(Sphere4::type,scene,LeafMode);
+    Accel::Intersectors intersectors = BVH4Sphere4Intersectors(accel);
+    Builder* builder = BVH4Sphere4SceneBuilderMortonGeneral(accel,scene,0);
+    return new AccelInstance(accel,builder,intersectors);
+  }
+
+  Accel* BVH4::BVH4Sphere4MB(Scene* scene)
+  {
+    return new AccelSegments(scene,Geometry::POINTS,[scene] (const BBox1f& time_range) { 
+        return BVH4Sphere4MB(scene,time_range); 
+      });
+  }
+
+  Accel* BVH4::BVH4Sphere4MB(Scene* scene, const BBox1f& time_range)
+  {
+    BVH4* accel = new BVH4(Sphere4MB::type,scene,LeafMode);
+    Accel::Intersectors intersectors = BVH4Sphere4MBIntersectors(accel);
+    Builder* builder = BVH4Sphere4MBSceneBuilderSAH(accel,scene,time_range);
+    return new AccelInstance(accel,builder,intersectors);
+  }
+
   void createTriangleMeshTriangle4(TriangleMesh* mesh, AccelData*& accel, Builder*& builder)
   {
     if (mesh->numTimeSteps != 1) THROW_RUNTIME_ERROR("internal error");
@@ -740,7 +1203,10 @@ namespace embree
     switch (mesh->flags) {
     case RTC_GEOMETRY_STATIC:     builder = BVH4Triangle4MeshBuilderSAH(accel,mesh,LeafMode); break;
     case RTC_GEOMETRY_DEFORMABLE: builder = BVH4Triangle4MeshRefitSAH(accel,mesh,LeafMode); break;
-    case RTC_GEOMETRY_DYNAMIC:    builder = BVH4Triangle4MeshBuilderMortonGeneral(accel,mesh,LeafMode); break;
+    case RTC_GEOMETRY_DYNAMIC:
+      if (mesh->parent->device->tri_builder == "morton") builder = BVH4Triangle4MeshBuilderMortonGeneral(accel,mesh,LeafMode);
+      else                                               builder = BVH4Triangle4MeshBuilderHybrid(accel,mesh,LeafMode);
+      break;
     default: THROW_RUNTIME_ERROR("internal error"); 
     }
   } 
@@ -753,7 +1219,10 @@ namespace embree
     switch (mesh->flags) {
     case RTC_GEOMETRY_STATIC:     builder = BVH4Triangle8MeshBuilderSAH(accel,mesh,LeafMode); break;
     case RTC_GEOMETRY_DEFORMABLE: builder = BVH4Triangle8MeshRefitSAH(accel,mesh,LeafMode); break;
-    case RTC_GEOMETRY_DYNAMIC:    builder = BVH4Triangle8MeshBuilderMortonGeneral(accel,mesh,LeafMode); break;
+    case RTC_GEOMETRY_DYNAMIC:
+      if (mesh->parent->device->tri_builder == "morton") builder = BVH4Triangle8MeshBuilderMortonGeneral(accel,mesh,LeafMode);
+      else                                               builder = BVH4Triangle8MeshBuilderHybrid(accel,mesh,LeafMode);
+      break;
     default: THROW_RUNTIME_ERROR("internal error"); 
     }
   } 
@@ -766,7 +1235,10 @@ namespace embree
     switch (mesh->flags) {
     case RTC_GEOMETRY_STATIC:     builder = BVH4Triangle4vMeshBuilderSAH(accel,mesh,LeafMode); break;
     case RTC_GEOMETRY_DEFORMABLE: builder = BVH4Triangle4vMeshRefitSAH(accel,mesh,LeafMode); break;
-    case RTC_GEOMETRY_DYNAMIC:    builder = BVH4Triangle4vMeshBuilderMortonGeneral(accel,mesh,LeafMode); break;
+    case RTC_GEOMETRY_DYNAMIC:
+      if (mesh->parent->device->tri_builder == "morton") builder = BVH4Triangle4vMeshBuilderMortonGeneral(accel,mesh,LeafMode);
+      else                                               builder = BVH4Triangle4vMeshBuilderHybrid(accel,mesh,LeafMode);
+      break;
     default: THROW_RUNTIME_ERROR("internal error"); 
     }
   } 
@@ -778,7 +1250,10 @@ namespace embree
     switch (mesh->flags) {
     case RTC_GEOMETRY_STATIC:     builder = BVH4Triangle4iMeshBuilderSAH(accel,mesh,LeafMode); break;
     case RTC_GEOMETRY_DEFORMABLE: builder = BVH4Triangle4iMeshRefitSAH(accel,mesh,LeafMode); break;
-    case RTC_GEOMETRY_DYNAMIC:    builder = BVH4Triangle4iMeshBuilderMortonGeneral(accel,mesh,LeafMode); break;
+    case RTC_GEOMETRY_DYNAMIC:
+      if (mesh->parent->device->tri_builder == "morton") builder = BVH4Triangle4iMeshBuilderMortonGeneral(accel,mesh,LeafMode);
+      else                                               builder = BVH4Triangle4iMeshBuilderHybrid(accel,mesh,LeafMode);
+      break;
     default: THROW_RUNTIME_ERROR("internal error"); 
     }
   } 
@@ -927,6 +1402,39 @@ namespace embree
     return new AccelInstance(accel,builder,intersectors);
   }
 
+  Accel* BVH4::BVH4InstanceGeometry(Scene* scene)
+  {
+    BVH4* accel = new BVH4(InstancePrimitive::type,scene,LeafMode);
+    Accel::Intersectors intersectors;
+    intersectors.ptr = accel; 
+    intersectors.intersector1  = BVH4InstanceIntersector1;
+    intersectors.intersector4  = BVH4InstanceIntersector4Chunk;
+    intersectors.intersector8  = BVH4InstanceIntersector8Chunk;
+    intersectors.intersector16 = BVH4InstanceIntersector16Chunk;
+    Builder* builder = BVH4InstanceSceneBuilderSAH(accel,scene,LeafMode);
+    return new AccelInstance(accel,builder,intersectors);
+  }
+
+  Accel* BVH4::BVH4InstanceGeometryMB(Scene* scene)
+  {
+    return new AccelSegments(scene,Geometry::INSTANCE,[scene] (const BBox1f& time_range) { 
+        return BVH4InstanceGeometryMB(scene,time_range); 
+      });
+  }
+
+  Accel* BVH4::BVH4InstanceGeometryMB(Scene* scene, const BBox1f& time_range)
+  {
+    BVH4* accel = new BVH4(InstancePrimitiveMB::type,scene,LeafMode);
+    Accel::Intersectors intersectors;
+    intersectors.ptr = accel; 
+    intersectors.intersector1  = BVH4InstanceMBIntersector1;
+    intersectors.intersector4  = BVH4InstanceMBIntersector4Chunk;
+    intersectors.intersector8  = BVH4InstanceMBIntersector8Chunk;
+    intersectors.intersector16 = BVH4InstanceMBIntersector16Chunk;
+    Builder* builder = BVH4InstanceMBSceneBuilderSAH(accel,scene,time_range);
+    return new AccelInstance(accel,builder,intersectors);
+  }
+
   Accel* BVH4::BVH4Triangle4ObjectSplit(TriangleMesh* mesh)
   {
     BVH4* accel = new BVH4(Triangle4::type,mesh->parent,LeafMode);
@@ -76,6 +76,9 @@ namespace embree
     /*! Maximal number of primitive blocks in a leaf. */
     static const size_t maxLeafBlocks = items_mask-tyLeaf;
 
+    /*! Number of top nodes that relayout stores first in breadth first order (64 KB of nodes). */
+    static const size_t maxRelayoutTopNodes = 512;
+
     /*! Cost of one traversal step. */
     static const int travCost = 1;
     static const int travCostAligned = 1;
@@ -687,6 +690,7 @@ namespace embree
 
     /*! BVH4 instantiations */
     static Accel* BVH4Triangle4vMB(Scene* scene);
+    static Accel* BVH4Triangle4vMB(Scene* scene, const BBox1f& time_range);
 
     static Accel* BVH4Bezier1v(Scene* scene);
     static Accel* BVH4Bezier1i(Scene* scene);
@@ -699,10 +703,18 @@ namespace embree
     static Accel* BVH4Triangle8(Scene* scene);
     static Accel* BVH4Triangle4v(Scene* scene);
     static Accel* BVH4Triangle4i(Scene* scene);
+    static Accel* BVH4Quad4v(Scene* scene);
+    static Accel* BVH4Sphere4(Scene* scene);
+    static Accel* BVH4Sphere4Morton(Scene* scene);
+    static Accel* BVH4Sphere4MB(Scene* scene);
+    static Accel* BVH4Sphere4MB(Scene* scene, const BBox1f& time_range);
     static Accel* BVH4SubdivPatch1(Scene* scene);
     static Accel* BVH4SubdivPatch1Cached(Scene* scene);
     static Accel* BVH4SubdivGridEager(Scene* scene);
     static Accel* BVH4UserGeometry(Scene* scene);
+    static Accel* BVH4InstanceGeometry(Scene* scene);
+    static Accel* BVH4InstanceGeometryMB(Scene* scene);
+    static Accel* BVH4InstanceGeometryMB(Scene* scene, const BBox1f& time_range);
     
     static Accel* BVH4BVH4Triangle4ObjectSplit(Scene* scene);
     static Accel* BVH4BVH4Triangle8ObjectSplit(Scene* scene);
@@ -757,6 +769,29 @@ namespace embree
       alloc.cleanup();
     }
 
+    /*! stores nodes and leaves into a stream, with all references relative to the stored data */
+    bool save(std::ostream& stream);
+
+    /*! uses a hierarchy stored by save in place, only the references inside the nodes get relocated */
+    bool load(char* ptr, size_t bytes);
+
+    /*! helper functions for save and load */
+    void saveBytes(NodeRef node, size_t& nodeBytes, size_t& leafBytes) const;
+    NodeRef saveRecursion(NodeRef node, char* data, size_t& nodeOfs, size_t& leafOfs) const;
+    static void relocate(NodeRef& node, size_t base);
+
+    /*! stores the top nodes first and each subtree in depth first order with the leaves behind their parent into a single block */
+    void relayout();
+
+    /*! creates a relayouted copy of the hierarchy placed on the specified NUMA node */
+    AccelData* clone(size_t node);
+
+    /*! helper functions for relayout */
+    bool relayoutable() const;
+    template<typename Allocate> NodeRef relayoutCopy(const Allocate& allocate) const;
+    size_t relayoutBytes(NodeRef node) const;
+    NodeRef relayoutRecursion(NodeRef node, char* data, size_t& ofs) const;
+
   public:
 
     /*! Encodes a node */
@@ -193,7 +193,9 @@ namespace embree
             progress,
             prims.data(),pinfo,BVH4::N,BVH4::maxBuildDepthLeaf,1,1,BVH4::maxLeafBlocks);
         
-        bvh->set(root,pinfo.geomBounds,pinfo.size());
+        /* the primrefs bound the curves at mid time only, thus use the bounds of both timesteps */
+        const std::pair<BBox3fa,BBox3fa> bounds = HeuristicArrayBinningSAH<BezierPrim>(prims.data()).computePrimInfoMB(scene,pinfo);
+        bvh->set(root,merge(bounds.first,bounds.second),pinfo.size());
 
         //});
         
@@ -16,6 +16,7 @@
 
 #include "bvh4.h"
 #include "bvh4_rotate.h"
+#include "bvh4_restructure.h"
 #include "bvh4_statistics.h"
 #include "../../common/profile.h"
 #include "../../algorithms/parallel_prefix_sum.h"
@@ -23,15 +24,18 @@
 
 #include "../builders/primrefgen.h"
 #include "../builders/bvh_builder_morton.h"
+#include "../builders/bvh_builder_sah.h"
 
 #include "../geometry/triangle4.h"
 #include "../geometry/triangle8.h"
 #include "../geometry/triangle4v.h"
 #include "../geometry/triangle4i.h"
+#include "../geometry/sphere4.h"
 
 #define ROTATE_TREE 1 // specifies number of tree rotation rounds to perform
 #define PROFILE 0
 #define BLOCK_SIZE 4096
+#define CLUSTER_SIZE 64 // maximal number of primitives per cluster of the hybrid builder
 
 namespace embree 
 {
@@ -320,6 +324,51 @@ namespace embree
       size_t encodeMask;
     };
 
+    struct CreateSphere4Leaf
+    {
+      __forceinline CreateSphere4Leaf (Scene* scene, MortonID32Bit* morton, size_t encodeShift, size_t encodeMask)
+        : scene(scene), morton(morton), encodeShift(encodeShift), encodeMask(encodeMask) {}
+      
+      void operator() (MortonBuildRecord<BVH4::NodeRef>& current, FastAllocator::ThreadLocal2* alloc, BBox3fa& box_o)
+      {
+        BBox3fa bounds(empty);
+        size_t items = current.size();
+        size_t start = current.begin;
+        assert(items<=4);
+        
+        /* allocate leaf node */
+        Sphere4* accel = (Sphere4*) alloc->alloc1.malloc(sizeof(Sphere4));
+        *current.parent = BVH4::encodeLeaf((char*)accel,1);
+        
+        int4 vgeomID = -1, vprimID = -1;
+        Vec3f4 c = zero; float4 r = zero;
+
+        for (size_t i=0; i<items; i++)
+        {
+          const size_t index = morton[start+i].index;
+          const size_t primID = index & encodeMask; 
+          const size_t geomID = index >> encodeShift; 
+          const Points* points = scene->getPoints(geomID);
+          const Vec3fa p = points->vertex(primID);
+          bounds.extend(Points::sphereBounds(p));
+          vgeomID [i] = geomID;
+          vprimID [i] = primID;
+          c.x[i] = p.x; c.y[i] = p.y; c.z[i] = p.z; r[i] = p.w;
+        }
+        Sphere4::store_nt(accel,Sphere4(c,r,vgeomID,vprimID));
+        box_o = bounds;
+#if ROTATE_TREE
+        box_o.lower.a = current.size();
+#endif
+      }
+    private:
+      Scene* scene;
+      MortonID32Bit* morton;
+      size_t encodeShift;
+      size_t encodeMask;
+    };
+
+    template<typename Mesh>
     struct CalculateBounds
     {
       __forceinline CalculateBounds (Scene* scene, size_t encodeShift, size_t encodeMask)
@@ -330,7 +379,7 @@ namespace embree
         const size_t index = morton.index;
         const size_t primID = index & encodeMask; 
         const size_t geomID = index >> encodeShift; 
-        const TriangleMesh* mesh = scene->getTriangleMesh(geomID);
+        const Mesh* mesh = (const Mesh*) scene->get(geomID);
         return mesh->bounds(primID);
       }
       
@@ -355,13 +404,158 @@ namespace embree
     };
     
 
+    /*! Hybrid builder. The morton codes are used to quickly partition
+     *  the primitives into small clusters, each cluster gets build using
+     *  the morton builder, and the top levels of the BVH get build using
+     *  the binned SAH builder over the cluster bounds. */
+    template<typename CreateLeafFunc, typename CalculateBoundsFunc, typename ProgressMonitor>
+      class BVH4HybridBuilder
+    {
+      typedef MortonBuildRecord<BVH4::NodeRef> BuildRecord;
+      static const size_t SINGLE_THREADED_THRESHOLD = 4096;
+
+      struct CreateAlloc 
+      {
+        __forceinline CreateAlloc (BVH4* bvh) : bvh(bvh) {}
+        __forceinline FastAllocator::ThreadLocal2* operator() () const { return bvh->alloc.threadLocal2(); }
+        BVH4* bvh;
+      };
+
+      typedef GeneralBVHBuilderMorton<BVH4::NodeRef,BBox3fa,FastAllocator::ThreadLocal2*,CreateAlloc,AllocBVH4Node,SetBVH4Bounds,CreateLeafFunc,CalculateBoundsFunc,ProgressMonitor> MortonBuilder;
+
+    public:
+
+      BVH4HybridBuilder (BVH4* bvh, CreateLeafFunc& createLeaf, CalculateBoundsFunc& calculateBounds, ProgressMonitor& progressMonitor, size_t minLeafSize, size_t maxLeafSize)
+        : bvh(bvh), createAlloc(bvh), setBounds(bvh), 
+        builder(BBox3fa(empty),createAlloc,allocNode,setBounds,createLeaf,calculateBounds,progressMonitor,BVH4::N,BVH4::maxBuildDepth,minLeafSize,maxLeafSize),
+        progressMonitor(progressMonitor), prims(bvh->device) {}
+
+      /*! recursively splits at the topmost differing morton code bit until the clusters are small enough */
+      void createClusters(BuildRecord& current, std::vector<BuildRecord>& clusters)
+      {
+        if (current.size() <= CLUSTER_SIZE) {
+          clusters.push_back(current);
+          return;
+        }
+        BuildRecord left, right;
+        builder.split(current,left,right);
+        createClusters(left,clusters);
+        createClusters(right,clusters);
+      }
+
+      /*! splits large ranges in parallel and collects the clusters of small ranges sequentially */
+      void createClustersParallel(BuildRecord& current)
+      {
+        if (current.size() <= SINGLE_THREADED_THRESHOLD) 
+        {
+          std::vector<BuildRecord> local;
+          createClusters(current,local);
+          Lock<AtomicMutex> lock(mutex);
+          clusters.insert(clusters.end(),local.begin(),local.end());
+          return;
+        }
+        
+        BuildRecord left, right;
+        builder.split(current,left,right);
+        SPAWN_BEGIN;
+        SPAWN(([&]{ createClustersParallel(left); }));
+        SPAWN(([&]{ createClustersParallel(right); }));
+        SPAWN_END;
+      }
+
+      /* build function */
+      std::pair<BVH4::NodeRef,BBox3fa> build(MortonID32Bit* src, MortonID32Bit* tmp, size_t numPrimitives)
+      {
+        /* sort morton codes */
+        builder.morton = tmp;
+        radix_sort_copy_u32(src,tmp,numPrimitives);
+
+        /* partition the primitives into clusters */
+        BuildRecord br(0,numPrimitives,nullptr,1);
+        createClustersParallel(br);
+
+        /* build BVH for each cluster using the morton builder */
+        prims.resize(clusters.size());
+        const PrimInfo pinfo = parallel_reduce(size_t(0), clusters.size(), size_t(1), PrimInfo(empty), [&] (const range<size_t>& r) -> PrimInfo
+        {
+          FastAllocator::ThreadLocal2* alloc = bvh->alloc.threadLocal2();
+          PrimInfo pinfo(empty);
+          for (size_t i=r.begin(); i<r.end(); i++) 
+          {
+            BVH4::NodeRef root;
+            BuildRecord& current = clusters[i];
+            current.parent = &root;
+            const BBox3fa bounds = builder.recurse(current,alloc,false);
+            progressMonitor(current.size());
+#if ROTATE_TREE
+            for (int j=0; j<ROTATE_TREE; j++) 
+              BVH4Rotate::rotate(bvh,root);
+            if (!root.isLeaf()) root.setBarrier();
+#endif
+            pinfo.add(bounds);
+            prims[i] = PrimRef(bounds,(size_t)root);
+          }
+          return pinfo;
+        }, [] (const PrimInfo& a, const PrimInfo& b) { return PrimInfo::merge(a,b); });
+
+        if (clusters.size() == 1) 
+          return std::make_pair((BVH4::NodeRef)prims[0].ID(),pinfo.geomBounds);
+        
+        /* build top levels over the cluster bounds using the SAH builder */
+        BVH4::NodeRef root;
+        BVHBuilderBinnedSAH::build<BVH4::NodeRef>
+          (root,
+           [&] { return bvh->alloc.threadLocal2(); },
+           [&] (const isa::BVHBuilderBinnedSAH::BuildRecord& current, BVHBuilderBinnedSAH::BuildRecord* children, const size_t N, FastAllocator::ThreadLocal2* alloc) -> int
+           {
+             BVH4::Node* node = (BVH4::Node*) alloc->alloc0.malloc(sizeof(BVH4::Node)); node->clear();
+             for (size_t i=0; i<N; i++) {
+               node->set(i,children[i].pinfo.geomBounds);
+               children[i].parent = (size_t*)&node->child(i);
+             }
+             *current.parent = bvh->encodeNode(node);
+             return 0;
+           },
+           [&] (const BVHBuilderBinnedSAH::BuildRecord& current, FastAllocator::ThreadLocal2* alloc) -> int
+           {
+             assert(current.prims.size() == 1);
+             *current.parent = (BVH4::NodeRef) prims[current.prims.begin()].ID();
+             return 1;
+           },
+           [&] (size_t dn) { progressMonitor(0); },
+           prims.data(),pinfo,BVH4::N,BVH4::maxBuildDepthLeaf,1,1,1,1.0f,1.0f);
+
+        return std::make_pair(root,pinfo.geomBounds);
+      }
+
+    private:
+      BVH4* bvh;
+      CreateAlloc createAlloc;
+      AllocBVH4Node allocNode;
+      SetBVH4Bounds setBounds;
+      MortonBuilder builder;
+      ProgressMonitor& progressMonitor;
+      AtomicMutex mutex;
+      std::vector<BuildRecord> clusters;
+      mvector<PrimRef> prims;
+    };
+
+    template<typename CreateLeafFunc, typename CalculateBoundsFunc, typename ProgressMonitor>
+      std::pair<BVH4::NodeRef,BBox3fa> bvh4_builder_hybrid_internal(BVH4* bvh, CreateLeafFunc& createLeaf, CalculateBoundsFunc& calculateBounds, ProgressMonitor& progressMonitor,
+                                                                    MortonID32Bit* src, MortonID32Bit* tmp, size_t numPrimitives, 
+                                                                    const size_t minLeafSize, const size_t maxLeafSize)
+    {
+      BVH4HybridBuilder<CreateLeafFunc,CalculateBoundsFunc,ProgressMonitor> builder(bvh,createLeaf,calculateBounds,progressMonitor,minLeafSize,maxLeafSize);
+      return builder.build(src,tmp,numPrimitives);
+    }
+
     template<typename Mesh, typename CreateLeaf>
       class BVH4MeshBuilderMorton : public Builder
     {
     public:
       
-      BVH4MeshBuilderMorton (BVH4* bvh, Mesh* mesh, const size_t minLeafSize, const size_t maxLeafSize)
-        : bvh(bvh), mesh(mesh), minLeafSize(minLeafSize), maxLeafSize(maxLeafSize), morton(bvh->device) {}
+      BVH4MeshBuilderMorton (BVH4* bvh, Mesh* mesh, const size_t minLeafSize, const size_t maxLeafSize, const bool hybrid = false)
+        : bvh(bvh), mesh(mesh), minLeafSize(minLeafSize), maxLeafSize(maxLeafSize), hybrid(hybrid), morton(bvh->device) {}
 
       /*! Destruction */
       ~BVH4MeshBuilderMorton () {
@@ -466,11 +660,13 @@ namespace embree
             SetBVH4Bounds setBounds(bvh);
             CreateLeaf createLeaf(mesh,morton.data());
             CalculateMeshBounds<Mesh> calculateBounds(mesh);
-            auto node_bounds = bvh_builder_morton_internal<BVH4::NodeRef>(
-              [&] () { return bvh->alloc.threadLocal2(); },
-              BBox3fa(empty),
-              allocNode,setBounds,createLeaf,calculateBounds,progress,
-              dest,morton.data(),numPrimitivesGen,4,BVH4::maxBuildDepth,minLeafSize,maxLeafSize);
+            auto node_bounds = hybrid 
+              ? bvh4_builder_hybrid_internal(bvh,createLeaf,calculateBounds,progress,dest,morton.data(),numPrimitivesGen,minLeafSize,maxLeafSize)
+              : bvh_builder_morton_internal<BVH4::NodeRef>(
+                [&] () { return bvh->alloc.threadLocal2(); },
+                BBox3fa(empty),
+                allocNode,setBounds,createLeaf,calculateBounds,progress,
+                dest,morton.data(),numPrimitivesGen,4,BVH4::maxBuildDepth,minLeafSize,maxLeafSize);
             bvh->set(node_bounds.first,node_bounds.second,numPrimitives);
 
 #if ROTATE_TREE
@@ -478,6 +674,10 @@ namespace embree
               BVH4Rotate::rotate(bvh,bvh->root);
             bvh->clearBarrier(bvh->root);
 #endif
+
+            /* optionally optimize the BVH further by treelet restructuring */
+            if (bvh->scene->isRestructure())
+              BVH4Restructure::restructure(bvh);
             
         /* clear temporary data for static geometry */
         if (mesh->isStatic()) 
@@ -497,6 +697,7 @@ namespace embree
       Mesh* mesh;
       const size_t minLeafSize;
       const size_t maxLeafSize;
+      const bool hybrid;
       mvector<MortonID32Bit> morton;
     };
     
@@ -507,14 +708,21 @@ namespace embree
     Builder* BVH4Triangle4vMeshBuilderMortonGeneral (void* bvh, TriangleMesh* mesh, size_t mode) { return new class BVH4MeshBuilderMorton<TriangleMesh,CreateTriangle4vLeaf>((BVH4*)bvh,mesh,4,4*BVH4::maxLeafBlocks); }
     Builder* BVH4Triangle4iMeshBuilderMortonGeneral (void* bvh, TriangleMesh* mesh, size_t mode) { return new class BVH4MeshBuilderMorton<TriangleMesh,CreateTriangle4iLeaf>((BVH4*)bvh,mesh,4,4*BVH4::maxLeafBlocks); }
 
+    Builder* BVH4Triangle4MeshBuilderHybrid  (void* bvh, TriangleMesh* mesh, size_t mode) { return new class BVH4MeshBuilderMorton<TriangleMesh,CreateTriangle4Leaf> ((BVH4*)bvh,mesh,4,4*BVH4::maxLeafBlocks,true); }
+#if defined(__AVX__)
+    Builder* BVH4Triangle8MeshBuilderHybrid  (void* bvh, TriangleMesh* mesh, size_t mode) { return new class BVH4MeshBuilderMorton<TriangleMesh,CreateTriangle8Leaf> ((BVH4*)bvh,mesh,8,8*BVH4::maxLeafBlocks,true); }
+#endif
+    Builder* BVH4Triangle4vMeshBuilderHybrid (void* bvh, TriangleMesh* mesh, size_t mode) { return new class BVH4MeshBuilderMorton<TriangleMesh,CreateTriangle4vLeaf>((BVH4*)bvh,mesh,4,4*BVH4::maxLeafBlocks,true); }
+    Builder* BVH4Triangle4iMeshBuilderHybrid (void* bvh, TriangleMesh* mesh, size_t mode) { return new class BVH4MeshBuilderMorton<TriangleMesh,CreateTriangle4iLeaf>((BVH4*)bvh,mesh,4,4*BVH4::maxLeafBlocks,true); }
+
 
     template<typename Mesh, typename CreateLeaf>
       class BVH4SceneBuilderMorton : public Builder
     {
     public:
       
-      BVH4SceneBuilderMorton (BVH4* bvh, Scene* scene, const size_t minLeafSize, const size_t maxLeafSize)
-        : bvh(bvh), scene(scene), minLeafSize(minLeafSize), maxLeafSize(maxLeafSize), encodeShift(0), encodeMask(-1), morton(scene->device) {}
+      BVH4SceneBuilderMorton (BVH4* bvh, Scene* scene, const size_t minLeafSize, const size_t maxLeafSize, const bool hybrid = false)
+        : bvh(bvh), scene(scene), minLeafSize(minLeafSize), maxLeafSize(maxLeafSize), hybrid(hybrid), encodeShift(0), encodeMask(-1), morton(scene->device) {}
       
       /*! Destruction */
       ~BVH4SceneBuilderMorton () {
@@ -526,6 +734,13 @@ namespace embree
       {
         /* calculate size of scene */
         size_t numPrimitives = scene->getNumPrimitives<Mesh,1>();
+
+        /* skip build for empty scene */
+        if (numPrimitives == 0) {
+          morton.resize(0);
+          bvh->set(BVH4::emptyNode,empty,0);
+          return;
+        }
         
         /* calculate groupID, primID encoding */ // FIXME: does not work for all scenes, use 64 bit IDs !!!
         Scene::Iterator<Mesh,1> iter2(scene);
@@ -540,13 +755,7 @@ namespace embree
         /* preallocate arrays */
         morton.resize(numPrimitives);
 
-        /* skip build for empty scene */
-        if (numPrimitives == 0) {
-          bvh->set(BVH4::emptyNode,empty,0);
-          return;
-        }
-
-        double t0 = bvh->preBuild(TOSTRING(isa) "::BVH4BuilderMorton");
+        double t0 = bvh->preBuild(hybrid ? TOSTRING(isa) "::BVH4BuilderHybrid" : TOSTRING(isa) "::BVH4BuilderMorton");
 
 #if PROFILE
 	profile(2,20,numPrimitives,[&] (ProfileTimer& timer)
@@ -646,11 +855,13 @@ namespace embree
             AllocBVH4Node allocNode;
             SetBVH4Bounds setBounds(bvh);
             CreateLeaf createLeaf(scene,morton.data(),encodeShift,encodeMask);
-            CalculateBounds calculateBounds(scene,encodeShift,encodeMask);
-            auto node_bounds = bvh_builder_morton_internal<BVH4::NodeRef>(
-              [&] () { return bvh->alloc.threadLocal2(); },
+            CalculateBounds<Mesh> calculateBounds(scene,encodeShift,encodeMask);
+            auto node_bounds = hybrid 
+              ? bvh4_builder_hybrid_internal(bvh,createLeaf,calculateBounds,progress,dest,morton.data(),numPrimitivesGen,minLeafSize,maxLeafSize)
+              : bvh_builder_morton_internal<BVH4::NodeRef>(
+                [&] () { return bvh->alloc.threadLocal2(); },
                 BBox3fa(empty),
-              allocNode,setBounds,createLeaf,calculateBounds,progress,
+                allocNode,setBounds,createLeaf,calculateBounds,progress,
                 dest,morton.data(),numPrimitivesGen,4,BVH4::maxBuildDepth,minLeafSize,maxLeafSize);
             bvh->set(node_bounds.first,node_bounds.second,numPrimitives);
 
@@ -660,6 +871,10 @@ namespace embree
             bvh->clearBarrier(bvh->root);
 #endif
 
+            /* optionally optimize the BVH further by treelet restructuring */
+            if (bvh->scene->isRestructure())
+              BVH4Restructure::restructure(bvh);
+
 #if PROFILE
         }); 
 #endif
@@ -683,6 +898,7 @@ namespace embree
       Scene* scene;
       const size_t minLeafSize;
       const size_t maxLeafSize;
+      const bool hybrid;
       size_t encodeShift;
       size_t encodeMask;
       mvector<MortonID32Bit> morton;
@@ -694,6 +910,14 @@ namespace embree
 #endif
     Builder* BVH4Triangle4vSceneBuilderMortonGeneral (void* bvh, Scene* scene, size_t mode) { return new class BVH4SceneBuilderMorton<TriangleMesh,CreateTriangle4vLeaf>((BVH4*)bvh,scene,4,4*BVH4::maxLeafBlocks); }
     Builder* BVH4Triangle4iSceneBuilderMortonGeneral (void* bvh, Scene* scene, size_t mode) { return new class BVH4SceneBuilderMorton<TriangleMesh,CreateTriangle4iLeaf>((BVH4*)bvh,scene,4,4*BVH4::maxLeafBlocks); }
+    Builder* BVH4Sphere4SceneBuilderMortonGeneral    (void* bvh, Scene* scene, size_t mode) { return new class BVH4SceneBuilderMorton<Points,CreateSphere4Leaf>        ((BVH4*)bvh,scene,4,4*BVH4::maxLeafBlocks); }
+
+    Builder* BVH4Triangle4SceneBuilderHybrid  (void* bvh, Scene* scene, size_t mode) { return new class BVH4SceneBuilderMorton<TriangleMesh,CreateTriangle4Leaf> ((BVH4*)bvh,scene,4,4*BVH4::maxLeafBlocks,true); }
+#if defined(__AVX__)
+    Builder* BVH4Triangle8SceneBuilderHybrid  (void* bvh, Scene* scene, size_t mode) { return new class BVH4SceneBuilderMorton<TriangleMesh,CreateTriangle8Leaf> ((BVH4*)bvh,scene,8,8*BVH4::maxLeafBlocks,true); }
+#endif
+    Builder* BVH4Triangle4vSceneBuilderHybrid (void* bvh, Scene* scene, size_t mode) { return new class BVH4SceneBuilderMorton<TriangleMesh,CreateTriangle4vLeaf>((BVH4*)bvh,scene,4,4*BVH4::maxLeafBlocks,true); }
+    Builder* BVH4Triangle4iSceneBuilderHybrid (void* bvh, Scene* scene, size_t mode) { return new class BVH4SceneBuilderMorton<TriangleMesh,CreateTriangle4iLeaf>((BVH4*)bvh,scene,4,4*BVH4::maxLeafBlocks,true); }
 
   }
 }
@@ -28,7 +28,11 @@
 #include "../geometry/triangle4v.h"
 #include "../geometry/triangle4i.h"
 #include "../geometry/triangle4v_mb.h"
+#include "../geometry/quad4v.h"
+#include "../geometry/sphere4.h"
+#include "../geometry/sphere4_mb.h"
 #include "../geometry/object.h"
+#include "../geometry/instance.h"
 
 #define ROTATE_TREE 0
 #define PROFILE 0
@@ -181,8 +185,11 @@ namespace embree
 #endif
     Builder* BVH4Triangle4vSceneBuilderSAH (void* bvh, Scene* scene, size_t mode) { return new BVH4BuilderSAH<TriangleMesh,Triangle4v>((BVH4*)bvh,scene,2,2,1.0f,4,inf,mode); }
     Builder* BVH4Triangle4iSceneBuilderSAH (void* bvh, Scene* scene, size_t mode) { return new BVH4BuilderSAH<TriangleMesh,Triangle4i>((BVH4*)bvh,scene,2,2,1.0f,4,inf,mode); }
+    Builder* BVH4Quad4vSceneBuilderSAH     (void* bvh, Scene* scene, size_t mode) { return new BVH4BuilderSAH<QuadMesh,Quad4v>((BVH4*)bvh,scene,4,4,1.0f,4,inf,mode); }
+    Builder* BVH4Sphere4SceneBuilderSAH    (void* bvh, Scene* scene, size_t mode) { return new BVH4BuilderSAH<Points,Sphere4>((BVH4*)bvh,scene,4,4,1.0f,4,inf,mode); }
     
     Builder* BVH4VirtualSceneBuilderSAH    (void* bvh, Scene* scene, size_t mode) { return new BVH4BuilderSAH<AccelSet,Object>((BVH4*)bvh,scene,1,1,1.0f,1,1,mode); }
+    Builder* BVH4InstanceSceneBuilderSAH   (void* bvh, Scene* scene, size_t mode) { return new BVH4BuilderSAH<Instance,InstancePrimitive>((BVH4*)bvh,scene,1,1,1.0f,1,1,mode); }
 
     /* entry functions for the mesh builders */
     Builder* BVH4Triangle4MeshBuilderSAH  (void* bvh, TriangleMesh* mesh, size_t mode) { return new BVH4BuilderSAH<TriangleMesh,Triangle4>((BVH4*)bvh,mesh,4,4,1.0f,4,inf,mode); }
@@ -270,15 +277,15 @@ namespace embree
       const float intCost;
       const size_t minLeafSize;
       const size_t maxLeafSize;
-      const float presplitFactor;
+      const float replicationFactor;
 
       BVH4BuilderSpatialSAH (BVH4* bvh, Scene* scene, const size_t leafBlockSize, const size_t sahBlockSize, const float intCost, const size_t minLeafSize, const size_t maxLeafSize, const size_t mode)
         : bvh(bvh), scene(scene), mesh(nullptr), sahBlockSize(sahBlockSize), intCost(intCost), minLeafSize(minLeafSize), maxLeafSize(min(maxLeafSize,leafBlockSize*BVH4::maxLeafBlocks)),
-          presplitFactor((mode & MODE_HIGH_QUALITY) ? 1.5f : 1.0f) {}
+          replicationFactor(max(1.0f,float(bvh->device->tri_builder_replication_factor))) {}
 
       BVH4BuilderSpatialSAH (BVH4* bvh, Mesh* mesh, const size_t leafBlockSize, const size_t sahBlockSize, const float intCost, const size_t minLeafSize, const size_t maxLeafSize, const size_t mode)
         : bvh(bvh), scene(nullptr), mesh(mesh), sahBlockSize(sahBlockSize), intCost(intCost), minLeafSize(minLeafSize), maxLeafSize(min(maxLeafSize,leafBlockSize*BVH4::maxLeafBlocks)),
-          presplitFactor((mode & MODE_HIGH_QUALITY) ? 1.5f : 1.0f) {}
+          replicationFactor(max(1.0f,float(bvh->device->tri_builder_replication_factor))) {}
 
       void build(size_t, size_t) 
       {
@@ -288,7 +295,7 @@ namespace embree
           bvh->clear();
           return;
         }
-        const size_t numSplitPrimitives = max(numPrimitives,size_t(presplitFactor*numPrimitives));
+        const size_t numSplitPrimitives = max(numPrimitives,size_t(replicationFactor*numPrimitives));
       
         /* reduction function */
 	auto rotate = [&] (BVH4::Node* node, const size_t* counts, const size_t N) -> size_t
@@ -341,8 +348,8 @@ namespace embree
               return A;
             },std::plus<double>());
 
-            /* calculate number of maximal spatial splits per primitive */
-            float f = 10.0f;
+            /* distribute the replication budget over the primitives proportional to their surface area */
+            const float f = A > 0.0 ? float((replicationFactor-1.0f)*pinfo.size()/A) : 0.0f;
             iter = prims;
             const size_t N = parallel_reduce(size_t(0),threadCount,size_t(0), [&] (const range<size_t>& r) -> size_t
             {
@@ -351,9 +358,8 @@ namespace embree
                 for (size_t i=0; i<block->size(); i++) {
                   PrimRef& prim = block->at(i);
                   assert((prim.lower.a & 0xFF000000) == 0);
-                  const float nf = ceil(f*pinfo.size()*area(prim.bounds())/A);
-                  //const size_t n = 64;
-                  const size_t n = min(ssize_t(127), max(ssize_t(1), ssize_t(nf)));
+                  const float nf = floor(f*area(prim.bounds()));
+                  const size_t n = 1+min(ssize_t(126), ssize_t(nf));
                   N += n;
                   prim.lower.a |= n << 24;
                 }
@@ -435,7 +441,7 @@ namespace embree
     template<typename Primitive>
     struct CreateBVH4LeafMB
     {
-      __forceinline CreateBVH4LeafMB (BVH4* bvh, PrimRef* prims) : bvh(bvh), prims(prims) {}
+      __forceinline CreateBVH4LeafMB (BVH4* bvh, PrimRef* prims, const BBox1f& time_range) : bvh(bvh), prims(prims), time_range(time_range) {}
       
       __forceinline std::pair<BBox3fa,BBox3fa> operator() (const BVHBuilderBinnedSAH::BuildRecord& current, Allocator* alloc)
       {
@@ -446,7 +452,7 @@ namespace embree
 	BBox3fa bounds0 = empty;
 	BBox3fa bounds1 = empty;
         for (size_t i=0; i<items; i++) {
-          auto bounds = accel[i].fill(prims,start,current.prims.end(),bvh->scene,false);
+          auto bounds = accel[i].fill(prims,start,current.prims.end(),bvh->scene,time_range,false);
 	  bounds0.extend(bounds.first);
 	  bounds1.extend(bounds.second);
         }
@@ -456,6 +462,7 @@ namespace embree
 
       BVH4* bvh;
       PrimRef* prims;
+      BBox1f time_range;
     };
 
     template<typename Mesh, typename Primitive>
@@ -469,12 +476,13 @@ namespace embree
       const float intCost;
       const size_t minLeafSize;
       const size_t maxLeafSize;
+      const BBox1f time_range; //!< time range of the motion segment to build for
 
-      BVH4BuilderMblurSAH (BVH4* bvh, Scene* scene, const size_t leafBlockSize, const size_t sahBlockSize, const float intCost, const size_t minLeafSize, const size_t maxLeafSize)
-        : bvh(bvh), scene(scene), mesh(nullptr), prims(scene->device), sahBlockSize(sahBlockSize), intCost(intCost), minLeafSize(minLeafSize), maxLeafSize(min(maxLeafSize,leafBlockSize*BVH4::maxLeafBlocks)) {}
+      BVH4BuilderMblurSAH (BVH4* bvh, Scene* scene, const BBox1f& time_range, const size_t leafBlockSize, const size_t sahBlockSize, const float intCost, const size_t minLeafSize, const size_t maxLeafSize)
+        : bvh(bvh), scene(scene), mesh(nullptr), prims(scene->device), sahBlockSize(sahBlockSize), intCost(intCost), minLeafSize(minLeafSize), maxLeafSize(min(maxLeafSize,leafBlockSize*BVH4::maxLeafBlocks)), time_range(time_range) {}
 
       BVH4BuilderMblurSAH (BVH4* bvh, Mesh* mesh, const size_t leafBlockSize, const size_t sahBlockSize, const float intCost, const size_t minLeafSize, const size_t maxLeafSize)
-        : bvh(bvh), scene(nullptr), mesh(mesh), sahBlockSize(sahBlockSize), intCost(intCost), minLeafSize(minLeafSize), maxLeafSize(min(maxLeafSize,leafBlockSize*BVH4::maxLeafBlocks)) {}
+        : bvh(bvh), scene(nullptr), mesh(mesh), sahBlockSize(sahBlockSize), intCost(intCost), minLeafSize(minLeafSize), maxLeafSize(min(maxLeafSize,leafBlockSize*BVH4::maxLeafBlocks)), time_range(0.0f,1.0f) {}
 
       void build(size_t, size_t) 
       {
@@ -514,10 +522,10 @@ namespace embree
             auto progress = [&] (size_t dn) { bvh->scene->progressMonitor(dn); };
             auto virtualprogress = BuildProgressMonitorFromClosure(progress);
 	    const PrimInfo pinfo = mesh ? createPrimRefArray<Mesh>(mesh,prims,virtualprogress) 
-              : createPrimRefArray<Mesh,2>(scene,prims,virtualprogress);
+              : createPrimRefArrayMBlur<Mesh>(scene,time_range,prims,virtualprogress);
 	    BVH4::NodeRef root;
             BVHBuilderBinnedSAH::build_reduce<BVH4::NodeRef>
-	      (root,BVH4::CreateAlloc(bvh),identity,CreateBVH4NodeMB(bvh),reduce,CreateBVH4LeafMB<Primitive>(bvh,prims.data()),progress,
+	      (root,BVH4::CreateAlloc(bvh),identity,CreateBVH4NodeMB(bvh),reduce,CreateBVH4LeafMB<Primitive>(bvh,prims.data(),time_range),progress,
 	       prims.data(),pinfo,BVH4::N,BVH4::maxBuildDepthLeaf,sahBlockSize,minLeafSize,maxLeafSize,BVH4::travCost,intCost);
 	    bvh->set(root,pinfo.geomBounds,pinfo.size());
             
@@ -540,6 +548,8 @@ namespace embree
       }
     };
 
-    Builder* BVH4Triangle4vMBSceneBuilderSAH  (void* bvh, Scene* scene, size_t mode) { return new BVH4BuilderMblurSAH<TriangleMesh,Triangle4vMB>((BVH4*)bvh,scene,4,4,1.0f,4,inf); }
+    Builder* BVH4Triangle4vMBSceneBuilderSAH  (void* bvh, Scene* scene, const BBox1f& time_range) { return new BVH4BuilderMblurSAH<TriangleMesh,Triangle4vMB>((BVH4*)bvh,scene,time_range,4,4,1.0f,4,inf); }
+    Builder* BVH4Sphere4MBSceneBuilderSAH     (void* bvh, Scene* scene, const BBox1f& time_range) { return new BVH4BuilderMblurSAH<Points,Sphere4MB>((BVH4*)bvh,scene,time_range,4,4,1.0f,4,inf); }
+    Builder* BVH4InstanceMBSceneBuilderSAH    (void* bvh, Scene* scene, const BBox1f& time_range) { return new BVH4BuilderMblurSAH<Instance,InstancePrimitiveMB>((BVH4*)bvh,scene,time_range,1,1,1.0f,1,1); }
   }
 }
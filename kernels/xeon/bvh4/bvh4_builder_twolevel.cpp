@@ -15,6 +15,7 @@
 // ======================================================================== //
 
 #include "bvh4_builder_twolevel.h"
+#include "bvh4_restructure.h"
 #include "bvh4_statistics.h"
 #include "../builders/bvh_builder_sah.h"
 
@@ -26,7 +27,7 @@ namespace embree
   namespace isa
   {
     BVH4BuilderTwoLevel::BVH4BuilderTwoLevel (BVH4* bvh, Scene* scene, const createTriangleMeshAccelTy createTriangleMeshAccel) 
-      : bvh(bvh), objects(bvh->objects), scene(scene), createTriangleMeshAccel(createTriangleMeshAccel), refs(scene->device), prims(scene->device) {}
+      : bvh(bvh), objects(bvh->objects), scene(scene), createTriangleMeshAccel(createTriangleMeshAccel), refs(scene->device), prims(scene->device), topSAH(0.0f) {}
     
     BVH4BuilderTwoLevel::~BVH4BuilderTwoLevel ()
     {
@@ -47,12 +48,11 @@ namespace embree
           });
       }
 
-      /* reset memory allocator */
-      bvh->alloc.reset();
-      
       /* skip build for empty scene */
       const size_t numPrimitives = scene->getNumPrimitives<TriangleMesh,1>();
       if (numPrimitives == 0) {
+        bvh->alloc.reset();
+        topNodes.clear();
         prims.resize(0);
         bvh->set(BVH4::emptyNode,empty,0);
         return;
@@ -70,6 +70,10 @@ namespace embree
       if (builders.size() < N) builders.resize(N);
       if (refs.size()     < N) refs.resize(N);
       nextRef = 0;
+
+      /* objects that got rebuilt and objects that contribute to the toplevel BVH */
+      std::vector<char> modified(N,0);
+      std::vector<char> contributing(N,0);
       
       /* create of acceleration structures */
       parallel_for(size_t(0), N, [&] (const range<size_t>& r) 
@@ -115,14 +119,31 @@ namespace embree
 #if !PROFILE 
           if (mesh->isModified()) 
 #endif
+          {
             builder->build(0,0);
+            modified[objectID] = 1;
+          }
           
           /* create build primitive */
-          if (!object->bounds.empty())
-            refs[nextRef++] = BVH4BuilderTwoLevel::BuildRef(object->bounds,object->root);
+          if (!object->bounds.empty()) {
+            refs[nextRef++] = BVH4BuilderTwoLevel::BuildRef(object->bounds,object->root,objectID);
+            contributing[objectID] = 1;
+          }
         }
       });
       
+      /* only refit and partially rebuild the toplevel BVH if the same objects contribute as in the last build */
+      contributing.resize(max(N,topObjects.size()),0);
+      if (!topNodes.empty() && contributing == topObjects && update_toplevel(numPrimitives,modified)) {
+        bvh->alloc.cleanup();
+        bvh->postBuild(t0);
+        return;
+      }
+
+      /* reset memory allocator */
+      bvh->alloc.reset();
+      topNodes.clear();
+
       /* fast path for single geometry scenes */
       if (nextRef == 1) { 
         bvh->set(refs[0].node,refs[0].bounds(),numPrimitives);
@@ -139,9 +160,45 @@ namespace embree
         return;
       }
 
+      /* build toplevel hierarchy */
+      BBox3fa bounds = empty;
+      const BVH4::NodeRef root = build_toplevel(refs.data(),refs.size(),bounds);
+      bvh->set(root,bounds,root == BVH4::emptyNode ? 0 : numPrimitives);
+
+      /* remember the toplevel layout for incremental updates */
+      if (root != BVH4::emptyNode && !root.isLeaf())
+      {
+        std::unordered_map<size_t,unsigned> leafObjects;
+        for (size_t i=0; i<refs.size(); i++) 
+          leafObjects[refs[i].node] = refs[i].objectID;
+
+        /* optionally optimize the toplevel BVH by treelet restructuring */
+        if (scene->isRestructure()) {
+          set_toplevel_barriers(bvh->root,leafObjects);
+          BVH4Restructure::restructure(bvh);
+          bvh->clearBarrier(bvh->root);
+        }
+
+        collect_toplevel(leafObjects);
+        refit_toplevel();
+        for (size_t i=0; i<topNodes.size(); i++) topNodes[i].sah0 = topNodes[i].sah;
+        topSAH = topNodes[0].sah;
+        topObjects = contributing;
+      }
+
+#if PROFILE
+      }); 
+#endif
+
+      bvh->alloc.cleanup();
+      bvh->postBuild(t0);
+    }
+
+    BVH4::NodeRef BVH4BuilderTwoLevel::build_toplevel(const BuildRef* refs, size_t numRefs, BBox3fa& bounds)
+    {
       /* compute PrimRefs */
-      prims.resize(refs.size());
-      const PrimInfo pinfo = parallel_reduce(size_t(0), refs.size(), size_t(1024), PrimInfo(empty), [&] (const range<size_t>& r) -> PrimInfo
+      prims.resize(numRefs);
+      const PrimInfo pinfo = parallel_reduce(size_t(0), numRefs, size_t(1024), PrimInfo(empty), [&] (const range<size_t>& r) -> PrimInfo
       {
         PrimInfo pinfo(empty);
         for (size_t i=r.begin(); i<r.end(); i++) {
@@ -152,44 +209,173 @@ namespace embree
       }, [] (const PrimInfo& a, const PrimInfo& b) { return PrimInfo::merge(a,b); });
 
       /* skip if all objects where empty */
+      bounds = pinfo.geomBounds;
       if (pinfo.size() == 0)
-        bvh->set(BVH4::emptyNode,empty,0);
+        return BVH4::emptyNode;
 
-      /* otherwise build toplevel hierarchy */
-      else
+      BVH4::NodeRef root;
+      BVHBuilderBinnedSAH::build<BVH4::NodeRef>
+        (root,
+         [&] { return bvh->alloc.threadLocal2(); },
+         [&] (const isa::BVHBuilderBinnedSAH::BuildRecord& current, BVHBuilderBinnedSAH::BuildRecord* children, const size_t N, FastAllocator::ThreadLocal2* alloc) -> int
+         {
+           BVH4::Node* node = (BVH4::Node*) alloc->alloc0.malloc(sizeof(BVH4::Node)); node->clear();
+           for (size_t i=0; i<N; i++) {
+             node->set(i,children[i].pinfo.geomBounds);
+             children[i].parent = (size_t*)&node->child(i);
+           }
+           *current.parent = bvh->encodeNode(node);
+           return 0;
+         },
+         [&] (const BVHBuilderBinnedSAH::BuildRecord& current, FastAllocator::ThreadLocal2* alloc) -> int
+         {
+           assert(current.prims.size() == 1);
+           *current.parent = (BVH4::NodeRef) prims[current.prims.begin()].ID();
+           return 1;
+         },
+         [&] (size_t dn) { bvh->scene->progressMonitor(0); },
+         prims.data(),pinfo,BVH4::N,BVH4::maxBuildDepthLeaf,1,1,1,1.0f,1.0f);
+      return root;
+    }
+
+    void BVH4BuilderTwoLevel::set_toplevel_barriers(BVH4::NodeRef ref, const std::unordered_map<size_t,unsigned>& leafObjects)
+    {
+      BVH4::Node* node = ref.node();
+      for (size_t i=0; i<BVH4::N; i++) 
       {
-        BVH4::NodeRef root;
-        BVHBuilderBinnedSAH::build<BVH4::NodeRef>
-          (root,
-           [&] { return bvh->alloc.threadLocal2(); },
-           [&] (const isa::BVHBuilderBinnedSAH::BuildRecord& current, BVHBuilderBinnedSAH::BuildRecord* children, const size_t N, FastAllocator::ThreadLocal2* alloc) -> int
-           {
-             BVH4::Node* node = (BVH4::Node*) alloc->alloc0.malloc(sizeof(BVH4::Node)); node->clear();
-             for (size_t i=0; i<N; i++) {
-               node->set(i,children[i].pinfo.geomBounds);
-               children[i].parent = (size_t*)&node->child(i);
-             }
-             *current.parent = bvh->encodeNode(node);
-             return 0;
-           },
-           [&] (const BVHBuilderBinnedSAH::BuildRecord& current, FastAllocator::ThreadLocal2* alloc) -> int
-           {
-             assert(current.prims.size() == 1);
-             *current.parent = (BVH4::NodeRef) prims[current.prims.begin()].ID();
-             return 1;
-           },
-           [&] (size_t dn) { bvh->scene->progressMonitor(0); },
-           prims.data(),pinfo,BVH4::N,BVH4::maxBuildDepthLeaf,1,1,1,1.0f,1.0f);
-        
-        bvh->set(root,pinfo.geomBounds,numPrimitives);
+        BVH4::NodeRef& child = node->child(i);
+        if (child == BVH4::emptyNode) continue;
+        if (leafObjects.find(child) != leafObjects.end()) child.setBarrier();
+        else set_toplevel_barriers(child,leafObjects);
       }
+    }
 
-#if PROFILE
-      }); 
-#endif
+    void BVH4BuilderTwoLevel::collect_toplevel(const std::unordered_map<size_t,unsigned>& leafObjects)
+    {
+      topNodes.clear();
+      topLeaves.clear();
+      collect_toplevel(bvh->root,-1,0,leafObjects);
+    }
 
-      bvh->alloc.cleanup();
-      bvh->postBuild(t0);
+    void BVH4BuilderTwoLevel::collect_toplevel(BVH4::NodeRef ref, ssize_t parent, size_t slot, const std::unordered_map<size_t,unsigned>& leafObjects)
+    {
+      const size_t index = topNodes.size();
+      BVH4::Node* node = ref.node();
+      topNodes.push_back(TopLevelNode(node,parent,slot,topLeaves.size()));
+      for (size_t i=0; i<BVH4::N; i++) 
+      {
+        const BVH4::NodeRef child = node->child(i);
+        if (child == BVH4::emptyNode) continue;
+        auto leaf = leafObjects.find(child);
+        if (leaf != leafObjects.end()) topLeaves.push_back(TopLevelLeaf(index,i,leaf->second));
+        else collect_toplevel(child,index,i,leafObjects);
+      }
+      topNodes[index].end = topNodes.size();
+      topNodes[index].leafEnd = topLeaves.size();
+    }
+
+    /*! surface area of some bounds, that are empty for removed leaves */
+    __forceinline float safeArea(const BBox3fa& bounds) {
+      return bounds.empty() ? 0.0f : area(bounds);
+    }
+
+    BBox3fa BVH4BuilderTwoLevel::refit_toplevel()
+    {
+      for (size_t i=0; i<topNodes.size(); i++) 
+        topNodes[i].sah = 0.0f;
+
+      for (size_t i=0; i<topLeaves.size(); i++) {
+        const TopLevelLeaf& leaf = topLeaves[i];
+        topNodes[leaf.parent].sah += safeArea(topNodes[leaf.parent].node->bounds(leaf.slot));
+      }
+
+      /* children are stored after their parent, thus processing nodes in reverse order refits bottom up */
+      BBox3fa bounds = empty;
+      for (ssize_t i=topNodes.size()-1; i>=0; i--)
+      {
+        TopLevelNode& node = topNodes[i];
+        bounds = node.node->bounds();
+        node.sah += safeArea(bounds);
+        if (node.parent < 0) continue;
+        topNodes[node.parent].node->set(node.slot,bounds);
+        topNodes[node.parent].sah += node.sah;
+      }
+      return bounds;
+    }
+
+    bool BVH4BuilderTwoLevel::update_toplevel(size_t numPrimitives, const std::vector<char>& modified)
+    {
+      /* point the first leaf of each modified object to the new object BVH, and remove the other leaves of the object */
+      std::vector<char> updated(modified.size(),0);
+      for (size_t i=0; i<topLeaves.size(); i++)
+      {
+        const TopLevelLeaf& leaf = topLeaves[i];
+        if (!modified[leaf.objectID]) continue;
+        BVH4::Node* node = topNodes[leaf.parent].node;
+        if (updated[leaf.objectID]) { 
+          node->set(leaf.slot,empty,BVH4::emptyNode);
+        } else {
+          BVH4* object = objects[leaf.objectID];
+          node->set(leaf.slot,object->bounds,object->root);
+          updated[leaf.objectID] = 1;
+        }
+      }
+      BBox3fa bounds = refit_toplevel();
+
+      /* fall back to a full rebuild if the toplevel BVH degraded too much */
+      if (topNodes[0].sah > (1.0f+scene->device->twolevel_max_quality_loss)*topSAH)
+        return false;
+
+      /* rebuild the largest subtrees that degraded */
+      bool rebuilt = false;
+      const float threshold = 1.0f+scene->device->twolevel_subtree_quality_loss;
+      for (size_t i=0; i<topNodes.size(); )
+      {
+        const TopLevelNode& node = topNodes[i];
+        if (node.sah <= threshold*node.sah0) { i++; continue; }
+
+        std::vector<BuildRef> subtreeRefs;
+        for (size_t j=node.leafBegin; j<node.leafEnd; j++) {
+          const TopLevelLeaf& leaf = topLeaves[j];
+          BVH4::Node* parent = topNodes[leaf.parent].node;
+          if (parent->child(leaf.slot) == BVH4::emptyNode) continue;
+          subtreeRefs.push_back(BuildRef(parent->bounds(leaf.slot),parent->child(leaf.slot),leaf.objectID));
+        }
+
+        /* the root has to stay an inner node of the toplevel BVH */
+        if (node.parent < 0 && subtreeRefs.size() <= 1)
+          return false;
+
+        BBox3fa subtreeBounds = empty;
+        const BVH4::NodeRef subtree = build_toplevel(subtreeRefs.data(),subtreeRefs.size(),subtreeBounds);
+        if (node.parent < 0) bvh->root = subtree;
+        else topNodes[node.parent].node->child(node.slot) = subtree;
+        rebuilt = true;
+        i = node.end;
+      }
+
+      /* record the new layout, unchanged subtrees keep their original SAH cost */
+      if (rebuilt)
+      {
+        std::unordered_map<size_t,unsigned> leafObjects;
+        std::unordered_map<BVH4::Node*,float> sah0;
+        for (size_t i=0; i<topLeaves.size(); i++) {
+          const TopLevelLeaf& leaf = topLeaves[i];
+          leafObjects[topNodes[leaf.parent].node->child(leaf.slot)] = leaf.objectID;
+        }
+        for (size_t i=0; i<topNodes.size(); i++) 
+          sah0[topNodes[i].node] = topNodes[i].sah0;
+
+        collect_toplevel(leafObjects);
+        bounds = refit_toplevel();
+        for (size_t i=0; i<topNodes.size(); i++) {
+          auto n = sah0.find(topNodes[i].node);
+          topNodes[i].sah0 = n != sah0.end() ? n->second : topNodes[i].sah;
+        }
+      }
+
+      bvh->set(bvh->root,bounds,numPrimitives);
+      return true;
     }
 
     void BVH4BuilderTwoLevel::clear()
@@ -201,6 +387,7 @@ namespace embree
 	if (builders[i]) builders[i]->clear();
 
       refs.clear();
+      topNodes.clear();
     }
 
     void BVH4BuilderTwoLevel::open_sequential(size_t numPrimitives)
@@ -216,13 +403,14 @@ namespace embree
       {
         std::pop_heap (refs.begin(),refs.end()); 
         BVH4::NodeRef ref = refs.back().node;
+        unsigned objectID = refs.back().objectID;
         if (ref.isLeaf()) break;
         refs.pop_back();    
         
         BVH4::Node* node = ref.node();
         for (size_t i=0; i<4; i++) {
           if (node->child(i) == BVH4::emptyNode) continue;
-          refs.push_back(BuildRef(node->bounds(i),node->child(i)));
+          refs.push_back(BuildRef(node->bounds(i),node->child(i),objectID));
           std::push_heap (refs.begin(),refs.end()); 
         }
       }
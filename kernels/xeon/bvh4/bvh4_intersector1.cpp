@@ -22,16 +22,22 @@
 #include "../geometry/triangle4v_mb.h"
 #include "../geometry/triangle4i.h"
 #include "../geometry/triangle8.h"
+#include "../geometry/quad4v.h"
+#include "../geometry/sphere4.h"
+#include "../geometry/sphere4_mb.h"
 #include "../geometry/intersector_iterators.h"
 #include "../geometry/bezier1v_intersector.h"
 #include "../geometry/bezier1i_intersector.h"
 #include "../geometry/triangle_intersector_moeller.h"
 #include "../geometry/triangle_intersector_pluecker.h"
+#include "../geometry/quad_intersector_moeller.h"
+#include "../geometry/sphere_intersector.h"
 #include "../geometry/triangle4i_intersector_pluecker.h"
 #include "../geometry/subdivpatch1_intersector1.h"
 #include "../geometry/subdivpatch1cached_intersector1.h"
 #include "../geometry/grid_aos_intersector1.h"
 #include "../geometry/object_intersector1.h"
+#include "../geometry/instance_intersector1.h"
 
 namespace embree
 { 
@@ -325,6 +331,8 @@ namespace embree
     DEFINE_INTERSECTOR1(BVH4Bezier1iMBIntersector1_OBB,BVH4Intersector1<0x1010 COMMA false COMMA ArrayIntersector1<Bezier1iIntersector1MB> >);
 
     DEFINE_INTERSECTOR1(BVH4Triangle4Intersector1Moeller,BVH4Intersector1<0x1 COMMA false COMMA ArrayIntersector1<TriangleNIntersector1MoellerTrumbore<Triangle4 COMMA true> > >);
+    DEFINE_INTERSECTOR1(BVH4Quad4vIntersector1Moeller,BVH4Intersector1<0x1 COMMA false COMMA ArrayIntersector1<QuadNIntersector1MoellerTrumbore<Quad4v COMMA true> > >);
+    DEFINE_INTERSECTOR1(BVH4Sphere4Intersector1,BVH4Intersector1<0x1 COMMA false COMMA ArrayIntersector1<SphereNIntersector1<Sphere4 COMMA true> > >);
 #if defined(__AVX__)
     DEFINE_INTERSECTOR1(BVH4Triangle8Intersector1Moeller,BVH4Intersector1<0x1 COMMA false COMMA ArrayIntersector1<TriangleNIntersector1MoellerTrumbore<Triangle8 COMMA true> > >);
 #endif
@@ -337,7 +345,10 @@ namespace embree
     DEFINE_INTERSECTOR1(BVH4GridAOSIntersector1,BVH4Intersector1<0x1 COMMA true COMMA GridAOSIntersector1>);
 
     DEFINE_INTERSECTOR1(BVH4VirtualIntersector1,BVH4Intersector1<0x1 COMMA false COMMA ArrayIntersector1<ObjectIntersector1> >);
+    DEFINE_INTERSECTOR1(BVH4InstanceIntersector1,BVH4Intersector1<0x1 COMMA false COMMA ArrayIntersector1<InstanceIntersector1> >);
+    DEFINE_INTERSECTOR1(BVH4InstanceMBIntersector1,BVH4Intersector1<0x10 COMMA false COMMA ArrayIntersector1<InstanceIntersector1MB> >);
 
     DEFINE_INTERSECTOR1(BVH4Triangle4vMBIntersector1Moeller,BVH4Intersector1<0x10 COMMA false COMMA ArrayIntersector1<TriangleNMblurIntersector1MoellerTrumbore<Triangle4vMB COMMA true> > >);
+    DEFINE_INTERSECTOR1(BVH4Sphere4MBIntersector1,BVH4Intersector1<0x10 COMMA false COMMA ArrayIntersector1<SphereNMblurIntersector1<Sphere4MB COMMA true> > >);
   }
 }
@@ -21,14 +21,17 @@
 #include "../geometry/triangle4i.h"
 #include "../geometry/triangle4v.h"
 #include "../geometry/triangle4v_mb.h"
+#include "../geometry/sphere4_mb.h"
 #include "../geometry/triangle8.h"
 #include "../geometry/intersector_iterators.h"
 #include "../geometry/bezier1v_intersector.h"
 #include "../geometry/bezier1i_intersector.h"
 #include "../geometry/triangle_intersector_moeller.h"
 #include "../geometry/triangle_intersector_pluecker.h"
+#include "../geometry/sphere_intersector.h"
 #include "../geometry/triangle4i_intersector_pluecker.h"
 #include "../geometry/object_intersector16.h"
+#include "../geometry/instance_intersector16.h"
 
 namespace embree
 {
@@ -393,6 +396,9 @@ namespace embree
     DEFINE_INTERSECTOR16(BVH4Triangle4vIntersector16ChunkPluecker, BVH4Intersector16Chunk<0x1 COMMA true COMMA ArrayIntersector16<TriangleNvIntersectorMPluecker<Ray16 COMMA Triangle4v COMMA true> > >);
     DEFINE_INTERSECTOR16(BVH4Triangle4iIntersector16ChunkPluecker, BVH4Intersector16Chunk<0x1 COMMA true COMMA ArrayIntersector16<Triangle4iIntersectorMPluecker<Ray16 COMMA true> > >);
     DEFINE_INTERSECTOR16(BVH4VirtualIntersector16Chunk, BVH4Intersector16Chunk<0x1 COMMA false COMMA ArrayIntersector16<ObjectIntersector16> >);
+    DEFINE_INTERSECTOR16(BVH4InstanceIntersector16Chunk, BVH4Intersector16Chunk<0x1 COMMA false COMMA ArrayIntersector16<InstanceIntersector16> >);
+    DEFINE_INTERSECTOR16(BVH4InstanceMBIntersector16Chunk, BVH4Intersector16Chunk<0x10 COMMA false COMMA ArrayIntersector16<InstanceIntersector16MB> >);
     DEFINE_INTERSECTOR16(BVH4Triangle4vMBIntersector16ChunkMoeller, BVH4Intersector16Chunk<0x10 COMMA false COMMA ArrayIntersector16<TriangleNMblurIntersectorMMoellerTrumbore<Ray16 COMMA Triangle4vMB COMMA true> > >);
+    DEFINE_INTERSECTOR16(BVH4Sphere4MBIntersector16Chunk, BVH4Intersector16Chunk<0x10 COMMA false COMMA ArrayIntersector16<SphereNMblurIntersectorM<Ray16 COMMA Sphere4MB COMMA true> > >);
   }
 }
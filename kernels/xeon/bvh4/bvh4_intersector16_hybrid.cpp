@@ -21,9 +21,13 @@
 #include "../geometry/triangle4.h"
 #include "../geometry/triangle4v.h"
 #include "../geometry/triangle8.h"
+#include "../geometry/quad4v.h"
+#include "../geometry/sphere4.h"
 #include "../geometry/intersector_iterators.h"
 #include "../geometry/triangle_intersector_moeller.h"
 #include "../geometry/triangle_intersector_pluecker.h"
+#include "../geometry/quad_intersector_moeller.h"
+#include "../geometry/sphere_intersector.h"
 
 #define SWITCH_THRESHOLD 7
 #define SWITCH_DURING_DOWN_TRAVERSAL 1
@@ -469,6 +473,10 @@ namespace embree
     
     DEFINE_INTERSECTOR16(BVH4Triangle4Intersector16HybridMoeller, BVH4Intersector16Hybrid<0x1 COMMA false COMMA ArrayIntersector16_1<TriangleNIntersectorMMoellerTrumbore<Ray16 COMMA Triangle4 COMMA true> > >);
     DEFINE_INTERSECTOR16(BVH4Triangle4Intersector16HybridMoellerNoFilter, BVH4Intersector16Hybrid<0x1 COMMA false COMMA ArrayIntersector16_1<TriangleNIntersectorMMoellerTrumbore<Ray16 COMMA Triangle4 COMMA false> > >);
+    DEFINE_INTERSECTOR16(BVH4Quad4vIntersector16HybridMoeller, BVH4Intersector16Hybrid<0x1 COMMA false COMMA ArrayIntersector16_1<QuadNIntersectorMMoellerTrumbore<Ray16 COMMA Quad4v COMMA true> > >);
+    DEFINE_INTERSECTOR16(BVH4Quad4vIntersector16HybridMoellerNoFilter, BVH4Intersector16Hybrid<0x1 COMMA false COMMA ArrayIntersector16_1<QuadNIntersectorMMoellerTrumbore<Ray16 COMMA Quad4v COMMA false> > >);
+    DEFINE_INTERSECTOR16(BVH4Sphere4Intersector16Hybrid, BVH4Intersector16Hybrid<0x1 COMMA false COMMA ArrayIntersector16_1<SphereNIntersectorM<Ray16 COMMA Sphere4 COMMA true> > >);
+    DEFINE_INTERSECTOR16(BVH4Sphere4Intersector16HybridNoFilter, BVH4Intersector16Hybrid<0x1 COMMA false COMMA ArrayIntersector16_1<SphereNIntersectorM<Ray16 COMMA Sphere4 COMMA false> > >);
     DEFINE_INTERSECTOR16(BVH4Triangle8Intersector16HybridMoeller, BVH4Intersector16Hybrid<0x1 COMMA false COMMA ArrayIntersector16_1<TriangleNIntersectorMMoellerTrumbore<Ray16 COMMA Triangle8 COMMA true> > >);
     DEFINE_INTERSECTOR16(BVH4Triangle8Intersector16HybridMoellerNoFilter, BVH4Intersector16Hybrid<0x1 COMMA false COMMA ArrayIntersector16_1<TriangleNIntersectorMMoellerTrumbore<Ray16 COMMA Triangle8 COMMA false> > >);
     DEFINE_INTERSECTOR16(BVH4Triangle4vIntersector16HybridPluecker, BVH4Intersector16Hybrid<0x1 COMMA true COMMA ArrayIntersector16_1<TriangleNvIntersectorMPluecker<Ray16 COMMA Triangle4v COMMA true> > >);
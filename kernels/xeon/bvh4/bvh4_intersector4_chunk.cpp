@@ -21,14 +21,20 @@
 #include "../geometry/triangle4i.h"
 #include "../geometry/triangle4v.h"
 #include "../geometry/triangle4v_mb.h"
+#include "../geometry/sphere4_mb.h"
 #include "../geometry/triangle8.h"
+#include "../geometry/quad4v.h"
+#include "../geometry/sphere4.h"
 #include "../geometry/intersector_iterators.h"
 #include "../geometry/bezier1v_intersector.h"
 #include "../geometry/bezier1i_intersector.h"
 #include "../geometry/triangle_intersector_moeller.h"
 #include "../geometry/triangle_intersector_pluecker.h"
+#include "../geometry/sphere_intersector.h"
+#include "../geometry/quad_intersector_moeller.h"
 #include "../geometry/triangle4i_intersector_pluecker.h"
 #include "../geometry/object_intersector4.h"
+#include "../geometry/instance_intersector4.h"
 
 namespace embree
 {
@@ -389,6 +395,10 @@ namespace embree
     DEFINE_INTERSECTOR4(BVH4Bezier1iIntersector4Chunk, BVH4Intersector4Chunk<0x1 COMMA false COMMA ArrayIntersector4<Bezier1iIntersectorN<Ray4> > >);
     DEFINE_INTERSECTOR4(BVH4Triangle4Intersector4ChunkMoeller, BVH4Intersector4Chunk<0x1 COMMA false COMMA ArrayIntersector4<TriangleNIntersectorMMoellerTrumbore<Ray4 COMMA Triangle4 COMMA true> > >);
     DEFINE_INTERSECTOR4(BVH4Triangle4Intersector4ChunkMoellerNoFilter, BVH4Intersector4Chunk<0x1 COMMA false COMMA ArrayIntersector4<TriangleNIntersectorMMoellerTrumbore<Ray4 COMMA Triangle4 COMMA false> > >);
+    DEFINE_INTERSECTOR4(BVH4Quad4vIntersector4ChunkMoeller, BVH4Intersector4Chunk<0x1 COMMA false COMMA ArrayIntersector4<QuadNIntersectorMMoellerTrumbore<Ray4 COMMA Quad4v COMMA true> > >);
+    DEFINE_INTERSECTOR4(BVH4Quad4vIntersector4ChunkMoellerNoFilter, BVH4Intersector4Chunk<0x1 COMMA false COMMA ArrayIntersector4<QuadNIntersectorMMoellerTrumbore<Ray4 COMMA Quad4v COMMA false> > >);
+    DEFINE_INTERSECTOR4(BVH4Sphere4Intersector4Chunk, BVH4Intersector4Chunk<0x1 COMMA false COMMA ArrayIntersector4<SphereNIntersectorM<Ray4 COMMA Sphere4 COMMA true> > >);
+    DEFINE_INTERSECTOR4(BVH4Sphere4Intersector4ChunkNoFilter, BVH4Intersector4Chunk<0x1 COMMA false COMMA ArrayIntersector4<SphereNIntersectorM<Ray4 COMMA Sphere4 COMMA false> > >);
 #if defined (__AVX__)
     DEFINE_INTERSECTOR4(BVH4Triangle8Intersector4ChunkMoeller, BVH4Intersector4Chunk<0x1 COMMA false COMMA ArrayIntersector4<TriangleNIntersectorMMoellerTrumbore<Ray4 COMMA Triangle8 COMMA true> > >);
     DEFINE_INTERSECTOR4(BVH4Triangle8Intersector4ChunkMoellerNoFilter, BVH4Intersector4Chunk<0x1 COMMA false COMMA ArrayIntersector4<TriangleNIntersectorMMoellerTrumbore<Ray4 COMMA Triangle8 COMMA false> > >);
@@ -396,7 +406,10 @@ namespace embree
     DEFINE_INTERSECTOR4(BVH4Triangle4vIntersector4ChunkPluecker, BVH4Intersector4Chunk<0x1 COMMA true COMMA ArrayIntersector4<TriangleNvIntersectorMPluecker<Ray4 COMMA Triangle4v COMMA true> > >);
     DEFINE_INTERSECTOR4(BVH4Triangle4iIntersector4ChunkPluecker, BVH4Intersector4Chunk<0x1 COMMA true COMMA ArrayIntersector4<Triangle4iIntersectorMPluecker<Ray4 COMMA true> > >);
     DEFINE_INTERSECTOR4(BVH4VirtualIntersector4Chunk, BVH4Intersector4Chunk<0x1 COMMA false COMMA ArrayIntersector4<ObjectIntersector4> >);
+    DEFINE_INTERSECTOR4(BVH4InstanceIntersector4Chunk, BVH4Intersector4Chunk<0x1 COMMA false COMMA ArrayIntersector4<InstanceIntersector4> >);
+    DEFINE_INTERSECTOR4(BVH4InstanceMBIntersector4Chunk, BVH4Intersector4Chunk<0x10 COMMA false COMMA ArrayIntersector4<InstanceIntersector4MB> >);
 
     DEFINE_INTERSECTOR4(BVH4Triangle4vMBIntersector4ChunkMoeller, BVH4Intersector4Chunk<0x10 COMMA false COMMA ArrayIntersector4<TriangleNMblurIntersectorMMoellerTrumbore<Ray4 COMMA Triangle4vMB COMMA true> > >);
+    DEFINE_INTERSECTOR4(BVH4Sphere4MBIntersector4Chunk, BVH4Intersector4Chunk<0x10 COMMA false COMMA ArrayIntersector4<SphereNMblurIntersectorM<Ray4 COMMA Sphere4MB COMMA true> > >);
   }
 }
@@ -21,9 +21,13 @@
 #include "../geometry/triangle4.h"
 #include "../geometry/triangle4v.h"
 #include "../geometry/triangle8.h"
+#include "../geometry/quad4v.h"
+#include "../geometry/sphere4.h"
 #include "../geometry/intersector_iterators.h"
 #include "../geometry/triangle_intersector_moeller.h"
 #include "../geometry/triangle_intersector_pluecker.h"
+#include "../geometry/quad_intersector_moeller.h"
+#include "../geometry/sphere_intersector.h"
 
 #define SWITCH_THRESHOLD 3
 #define SWITCH_DURING_DOWN_TRAVERSAL 1
@@ -473,6 +477,10 @@ namespace embree
 
     DEFINE_INTERSECTOR4(BVH4Triangle4Intersector4HybridMoeller, BVH4Intersector4Hybrid<0x1 COMMA false COMMA ArrayIntersector4_1<TriangleNIntersectorMMoellerTrumbore<Ray4 COMMA Triangle4 COMMA true> > >);
     DEFINE_INTERSECTOR4(BVH4Triangle4Intersector4HybridMoellerNoFilter, BVH4Intersector4Hybrid<0x1 COMMA false COMMA ArrayIntersector4_1<TriangleNIntersectorMMoellerTrumbore<Ray4 COMMA Triangle4 COMMA false> > >);
+    DEFINE_INTERSECTOR4(BVH4Quad4vIntersector4HybridMoeller, BVH4Intersector4Hybrid<0x1 COMMA false COMMA ArrayIntersector4_1<QuadNIntersectorMMoellerTrumbore<Ray4 COMMA Quad4v COMMA true> > >);
+    DEFINE_INTERSECTOR4(BVH4Quad4vIntersector4HybridMoellerNoFilter, BVH4Intersector4Hybrid<0x1 COMMA false COMMA ArrayIntersector4_1<QuadNIntersectorMMoellerTrumbore<Ray4 COMMA Quad4v COMMA false> > >);
+    DEFINE_INTERSECTOR4(BVH4Sphere4Intersector4Hybrid, BVH4Intersector4Hybrid<0x1 COMMA false COMMA ArrayIntersector4_1<SphereNIntersectorM<Ray4 COMMA Sphere4 COMMA true> > >);
+    DEFINE_INTERSECTOR4(BVH4Sphere4Intersector4HybridNoFilter, BVH4Intersector4Hybrid<0x1 COMMA false COMMA ArrayIntersector4_1<SphereNIntersectorM<Ray4 COMMA Sphere4 COMMA false> > >);
 #if defined (__AVX__)
     DEFINE_INTERSECTOR4(BVH4Triangle8Intersector4HybridMoeller, BVH4Intersector4Hybrid<0x1 COMMA false COMMA ArrayIntersector4_1<TriangleNIntersectorMMoellerTrumbore<Ray4 COMMA Triangle8 COMMA  true> > >);
     DEFINE_INTERSECTOR4(BVH4Triangle8Intersector4HybridMoellerNoFilter, BVH4Intersector4Hybrid<0x1 COMMA false COMMA ArrayIntersector4_1<TriangleNIntersectorMMoellerTrumbore<Ray4 COMMA Triangle8 COMMA  false> > >);
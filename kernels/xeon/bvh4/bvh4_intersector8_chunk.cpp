@@ -21,14 +21,17 @@
 #include "../geometry/triangle4i.h"
 #include "../geometry/triangle4v.h"
 #include "../geometry/triangle4v_mb.h"
+#include "../geometry/sphere4_mb.h"
 #include "../geometry/triangle8.h"
 #include "../geometry/intersector_iterators.h"
 #include "../geometry/bezier1v_intersector.h"
 #include "../geometry/bezier1i_intersector.h"
 #include "../geometry/triangle_intersector_moeller.h"
 #include "../geometry/triangle_intersector_pluecker.h"
+#include "../geometry/sphere_intersector.h"
 #include "../geometry/triangle4i_intersector_pluecker.h"
 #include "../geometry/object_intersector8.h"
+#include "../geometry/instance_intersector8.h"
 
 namespace embree
 {
@@ -393,7 +396,10 @@ namespace embree
     DEFINE_INTERSECTOR8(BVH4Triangle4vIntersector8ChunkPluecker, BVH4Intersector8Chunk<0x1 COMMA true COMMA ArrayIntersector8<TriangleNvIntersectorMPluecker<Ray8 COMMA Triangle4v COMMA true> > >);
     DEFINE_INTERSECTOR8(BVH4Triangle4iIntersector8ChunkPluecker, BVH4Intersector8Chunk<0x1 COMMA true COMMA ArrayIntersector8<Triangle4iIntersectorMPluecker<Ray8 COMMA true> > >);
     DEFINE_INTERSECTOR8(BVH4VirtualIntersector8Chunk, BVH4Intersector8Chunk<0x1 COMMA false COMMA ArrayIntersector8<ObjectIntersector8> >);
+    DEFINE_INTERSECTOR8(BVH4InstanceIntersector8Chunk, BVH4Intersector8Chunk<0x1 COMMA false COMMA ArrayIntersector8<InstanceIntersector8> >);
+    DEFINE_INTERSECTOR8(BVH4InstanceMBIntersector8Chunk, BVH4Intersector8Chunk<0x10 COMMA false COMMA ArrayIntersector8<InstanceIntersector8MB> >);
 
     DEFINE_INTERSECTOR8(BVH4Triangle4vMBIntersector8ChunkMoeller, BVH4Intersector8Chunk<0x10 COMMA false COMMA ArrayIntersector8<TriangleNMblurIntersectorMMoellerTrumbore<Ray8 COMMA Triangle4vMB COMMA true> > >);
+    DEFINE_INTERSECTOR8(BVH4Sphere4MBIntersector8Chunk, BVH4Intersector8Chunk<0x10 COMMA false COMMA ArrayIntersector8<SphereNMblurIntersectorM<Ray8 COMMA Sphere4MB COMMA true> > >);
   }
 }
@@ -21,9 +21,13 @@
 #include "../geometry/triangle4.h"
 #include "../geometry/triangle4v.h"
 #include "../geometry/triangle8.h"
+#include "../geometry/quad4v.h"
+#include "../geometry/sphere4.h"
 #include "../geometry/intersector_iterators.h"
 #include "../geometry/triangle_intersector_moeller.h"
 #include "../geometry/triangle_intersector_pluecker.h"
+#include "../geometry/quad_intersector_moeller.h"
+#include "../geometry/sphere_intersector.h"
 #include "../geometry/subdivpatch1cached_intersector1.h"
 
 //#define SWITCH_THRESHOLD 16
@@ -475,6 +479,10 @@ namespace embree
     
     DEFINE_INTERSECTOR8(BVH4Triangle4Intersector8HybridMoeller, BVH4Intersector8Hybrid<0x1 COMMA false COMMA ArrayIntersector8_1<TriangleNIntersectorMMoellerTrumbore<Ray8 COMMA Triangle4 COMMA true> > >);
     DEFINE_INTERSECTOR8(BVH4Triangle4Intersector8HybridMoellerNoFilter, BVH4Intersector8Hybrid<0x1 COMMA false COMMA ArrayIntersector8_1<TriangleNIntersectorMMoellerTrumbore<Ray8 COMMA Triangle4 COMMA false> > >);
+    DEFINE_INTERSECTOR8(BVH4Quad4vIntersector8HybridMoeller, BVH4Intersector8Hybrid<0x1 COMMA false COMMA ArrayIntersector8_1<QuadNIntersectorMMoellerTrumbore<Ray8 COMMA Quad4v COMMA true> > >);
+    DEFINE_INTERSECTOR8(BVH4Quad4vIntersector8HybridMoellerNoFilter, BVH4Intersector8Hybrid<0x1 COMMA false COMMA ArrayIntersector8_1<QuadNIntersectorMMoellerTrumbore<Ray8 COMMA Quad4v COMMA false> > >);
+    DEFINE_INTERSECTOR8(BVH4Sphere4Intersector8Hybrid, BVH4Intersector8Hybrid<0x1 COMMA false COMMA ArrayIntersector8_1<SphereNIntersectorM<Ray8 COMMA Sphere4 COMMA true> > >);
+    DEFINE_INTERSECTOR8(BVH4Sphere4Intersector8HybridNoFilter, BVH4Intersector8Hybrid<0x1 COMMA false COMMA ArrayIntersector8_1<SphereNIntersectorM<Ray8 COMMA Sphere4 COMMA false> > >);
     DEFINE_INTERSECTOR8(BVH4Triangle8Intersector8HybridMoeller, BVH4Intersector8Hybrid<0x1 COMMA false COMMA ArrayIntersector8_1<TriangleNIntersectorMMoellerTrumbore<Ray8 COMMA Triangle8 COMMA true> > >);
     DEFINE_INTERSECTOR8(BVH4Triangle8Intersector8HybridMoellerNoFilter, BVH4Intersector8Hybrid<0x1 COMMA false COMMA ArrayIntersector8_1<TriangleNIntersectorMMoellerTrumbore<Ray8 COMMA Triangle8 COMMA false> > >);
     DEFINE_INTERSECTOR8(BVH4Triangle4vIntersector8HybridPluecker, BVH4Intersector8Hybrid<0x1 COMMA true COMMA ArrayIntersector8_1<TriangleNvIntersectorMPluecker<Ray8 COMMA Triangle4v COMMA true> > >);
@@ -0,0 +1,273 @@
+// ======================================================================== //
+// Copyright 2009-2015 Intel Corporation                                    //
+//                                                                          //
+// Licensed under the Apache License, Version 2.0 (the "License");          //
+// you may not use this file except in compliance with the License.         //
+// You may obtain a copy of the License at                                  //
+//                                                                          //
+//     http://www.apache.org/licenses/LICENSE-2.0                           //
+//                                                                          //
+// Unless required by applicable law or agreed to in writing, software      //
+// distributed under the License is distributed on an "AS IS" BASIS,        //
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. //
+// See the License for the specific language governing permissions and      //
+// limitations under the License.                                           //
+// ======================================================================== //
+
+
+#include "bvh4_restructure.h"
+#include "bvh4_statistics.h"
+
+namespace embree
+{
+  namespace isa 
+  {
+    /*! A treelet is formed of a node and its largest descendants. The
+     *  SAH optimal topology of the treelet is found by dynamic
+     *  programming over all subsets of the treelet leaves. The inner
+     *  nodes of the treelet get reused, additional nodes are allocated
+     *  if the optimal topology requires more of them. */
+    struct Treelet
+    {
+      typedef BVH4::Node Node;
+      typedef BVH4::NodeRef NodeRef;
+
+      static const size_t L = BVH4Restructure::maxTreeletLeaves;
+      static const size_t S = 1 << L;
+
+      /*! Forms the treelet rooted at node. The heights of the subtrees of the children are passed in. */
+      Treelet (BVH4* bvh, Node* root, const size_t* childHeights)
+        : bvh(bvh), numNodes(0), numLeaves(0), height(0)
+      {
+        nodes[numNodes++] = root;
+        cost = halfArea(root->bounds());
+        for (size_t c=0; c<BVH4::N; c++) {
+          if (root->child(c) == BVH4::emptyNode) continue;
+          add(root->child(c),root->bounds(c),childHeights[c]);
+          height = max(height,1+childHeights[c]);
+        }
+
+        /* expand the largest treelet leaf as long as the treelet does not get too large */
+        while (numNodes < L-1)
+        {
+          ssize_t best = -1; 
+          float bestArea = neg_inf;
+          for (size_t i=0; i<numLeaves; i++) 
+          {
+            if (refs[i].isBarrier() || !refs[i].isNode()) continue;
+            if (numLeaves-1+numChildren(refs[i].node()) > L) continue;
+            const float A = halfArea(bounds[i]);
+            if (A > bestArea) { best = i; bestArea = A; }
+          }
+          if (best < 0) break;
+          expand(best);
+        }
+      }
+
+      __forceinline size_t numChildren(const Node* node) const 
+      {
+        size_t n = 0;
+        for (size_t c=0; c<BVH4::N; c++) 
+          n += node->child(c) != BVH4::emptyNode;
+        return n;
+      }
+
+      __forceinline void add(NodeRef ref, const BBox3fa& b, size_t h)
+      {
+        refs[numLeaves] = ref;
+        bounds[numLeaves] = b;
+        heights[numLeaves] = ref.isNode() ? h : 0;
+        numLeaves++;
+      }
+
+      /*! Replaces a treelet leaf by its children. Child heights are conservatively estimated from the parent height. */
+      void expand(size_t i)
+      {
+        Node* node = refs[i].node();
+        const size_t h = heights[i];
+        nodes[numNodes++] = node;
+        cost += halfArea(bounds[i]);
+        numLeaves--;
+        refs[i] = refs[numLeaves]; bounds[i] = bounds[numLeaves]; heights[i] = heights[numLeaves];
+        for (size_t c=0; c<BVH4::N; c++) {
+          if (node->child(c) == BVH4::emptyNode) continue;
+          add(node->child(c),node->bounds(c),h > 0 ? h-1 : 0);
+        }
+      }
+
+      /*! Computes the best topology for every subset of treelet leaves. The 
+       *  group containing the lowest leaf of a subset is enumerated
+       *  explicitly, the remaining leaves are split into up to 3 groups. */
+      float optimize()
+      {
+        const size_t full = (size_t(1) << numLeaves)-1;
+        for (size_t s=1; s<=full; s++)
+        {
+          const size_t bit = s & (0-s);
+          const size_t rest = s & (s-1);
+          box[s] = rest ? merge(box[rest],bounds[__bsf(s)]) : bounds[__bsf(s)];
+
+          /* a single treelet leaf requires no node */
+          if (rest == 0) {
+            group[s] = split2[s] = split3[s] = 0.0f;
+            groupT[s] = split2T[s] = split3T[s] = 0;
+            continue;
+          }
+
+          float bestNode = float(inf), best2 = float(inf), best3 = float(inf);
+          size_t bestNodeT = 0, best2T = 0, best3T = 0;
+          for (size_t sub=(rest-1)&rest;; sub=(sub-1)&rest) 
+          {
+            const size_t T = sub | bit;
+            const float cT = group[T];
+            const float cNode = cT + split3[s^T];
+            const float c2 = cT + group[s^T];
+            const float c3 = cT + split2[s^T];
+            if (cNode < bestNode) { bestNode = cNode; bestNodeT = T; }
+            if (c2 < best2) { best2 = c2; best2T = T; }
+            if (c3 < best3) { best3 = c3; best3T = T; }
+            if (sub == 0) break;
+          }
+          group[s] = halfArea(box[s]) + bestNode;
+          groupT[s] = bestNodeT;
+
+          /* a set of leaves can also stay a single group */
+          if (group[s] <= best2) { best2 = group[s]; best2T = 0; }
+          if (best2 <= best3) { best3 = best2; best3T = 0; }
+          split2[s] = best2; split2T[s] = best2T;
+          split3[s] = best3; split3T[s] = best3T;
+        }
+        return group[full];
+      }
+
+      /*! Creates the node of the best topology for the set s of treelet leaves and returns its height. Performs a dry run if node is null. */
+      size_t emitNode(size_t s, Node* node, size_t& next)
+      {
+        size_t slot = 0;
+        const size_t T = groupT[s];
+        const size_t h0 = emitGroup(T,node,slot,next);
+        const size_t h1 = emitSplit(3,s^T,node,slot,next);
+        return 1+max(h0,h1);
+      }
+
+      size_t emitSplit(size_t j, size_t s, Node* node, size_t& slot, size_t& next)
+      {
+        const size_t T = j == 3 ? split3T[s] : j == 2 ? split2T[s] : 0;
+        if (T == 0) return emitGroup(s,node,slot,next);
+        const size_t h0 = emitGroup(T,node,slot,next);
+        const size_t h1 = emitSplit(j-1,s^T,node,slot,next);
+        return max(h0,h1);
+      }
+
+      size_t emitGroup(size_t s, Node* node, size_t& slot, size_t& next)
+      {
+        if ((s & (s-1)) == 0) {
+          const size_t i = __bsf(s);
+          if (node) node->set(slot,bounds[i],refs[i]);
+          slot++;
+          return heights[i];
+        }
+        Node* child = nullptr;
+        if (node) {
+          if (next < numNodes) child = nodes[next];
+          else child = (Node*) bvh->alloc.threadLocal2()->alloc0.malloc(sizeof(Node));
+          child->clear();
+          node->set(slot,box[s],BVH4::encodeNode(child));
+        }
+        next++; slot++;
+        return emitNode(s,child,next);
+      }
+
+      /*! Replaces the treelet by its best topology if this reduces the SAH cost and returns the new height. */
+      size_t restructure(size_t depth)
+      {
+        if (numNodes == 1 || numLeaves < 2) 
+          return height;
+
+        const float bestCost = optimize();
+        if (!(bestCost < (1.0f-1E-5f)*cost))
+          return height;
+
+        /* do not exceed the maximal depth of the tree */
+        const size_t full = (size_t(1) << numLeaves)-1;
+        size_t next = 1;
+        const size_t newHeight = emitNode(full,nullptr,next);
+        if (depth+newHeight > BVH4::maxBuildDepth && newHeight > height) 
+          return height;
+
+        /* the root node stays in place, unused inner nodes get dropped */
+        next = 1; nodes[0]->clear();
+        emitNode(full,nodes[0],next);
+        return newHeight;
+      }
+
+    public:
+      BVH4* bvh;
+      Node* nodes[L-1];             //!< inner nodes of the treelet, the first one is the root
+      size_t numNodes;
+      NodeRef refs[L];              //!< treelet leaves
+      BBox3fa bounds[L];
+      size_t heights[L];            //!< upper bound of the height of each treelet leaf
+      size_t numLeaves;
+      float cost;                   //!< SAH cost of the current treelet topology
+      size_t height;                //!< height of the current treelet
+
+      BBox3fa box[S];               //!< bounds of each subset of treelet leaves
+      float group[S];               //!< best cost of a subset as one child, which requires a node for multiple leaves
+      float split2[S];              //!< best cost of a subset as up to 2 children
+      float split3[S];              //!< best cost of a subset as up to 3 children
+      unsigned short groupT[S], split2T[S], split3T[S];
+    };
+
+    static __noinline size_t restructureTreelet(BVH4* bvh, BVH4::Node* node, const size_t* heights, size_t depth)
+    {
+      Treelet treelet(bvh,node,heights);
+      return treelet.restructure(depth);
+    }
+
+    size_t BVH4Restructure::restructure(BVH4* bvh, NodeRef ref, size_t depth)
+    {
+      /*! leaves and barriers are not entered */
+      if (ref.isBarrier() || !ref.isNode()) return 0;
+      Node* node = ref.node();
+
+      /*! restructure all subtrees first */
+      size_t heights[BVH4::N];
+      if (depth < parallelDepth) 
+      {
+        SPAWN_BEGIN;
+        for (size_t c=0; c<BVH4::N; c++) {
+          SPAWN(([&,c] { heights[c] = restructure(bvh,node->child(c),depth+1); }));
+        }
+        SPAWN_END;
+      }
+      else 
+      {
+        for (size_t c=0; c<BVH4::N; c++) 
+          heights[c] = restructure(bvh,node->child(c),depth+1);
+      }
+      return restructureTreelet(bvh,node,heights,depth);
+    }
+
+    void BVH4Restructure::restructure(BVH4* bvh)
+    {
+      if (bvh->root.isBarrier() || !bvh->root.isNode()) 
+        return;
+
+      float sah0 = 0.0f;
+      double t0 = 0.0;
+      if (bvh->device->verbosity(2)) {
+        sah0 = BVH4Statistics(bvh).sah();
+        t0 = getSeconds();
+      }
+
+      for (size_t i=0; i<numRounds; i++)
+        restructure(bvh,bvh->root,0);
+
+      if (bvh->device->verbosity(2)) {
+        const double dt = getSeconds()-t0;
+        std::cout << "  restructure: sah = " << sah0 << " -> " << BVH4Statistics(bvh).sah() << ", " << 1000.0*dt << "ms" << std::endl;
+      }
+    }
+  }
+}
@@ -0,0 +1,52 @@
+// ======================================================================== //
+// Copyright 2009-2015 Intel Corporation                                    //
+//                                                                          //
+// Licensed under the Apache License, Version 2.0 (the "License");          //
+// you may not use this file except in compliance with the License.         //
+// You may obtain a copy of the License at                                  //
+//                                                                          //
+//     http://www.apache.org/licenses/LICENSE-2.0                           //
+//                                                                          //
+// Unless required by applicable law or agreed to in writing, software      //
+// distributed under the License is distributed on an "AS IS" BASIS,        //
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. //
+// See the License for the specific language governing permissions and      //
+// limitations under the License.                                           //
+// ======================================================================== //
+
+
+#pragma once
+
+#include "bvh4.h"
+
+namespace embree
+{
+  namespace isa 
+  {
+    /* BVH4 Treelet Restructuring. */
+    class BVH4Restructure
+    {
+    public:
+      typedef BVH4::Node Node;
+      typedef BVH4::NodeRef NodeRef;
+
+      /*! Maximal number of subtrees a treelet is made of. */
+      static const size_t maxTreeletLeaves = 7;
+
+      /*! Number of restructuring passes over the tree. */
+      static const size_t numRounds = 2;
+
+      /*! Treelets above this depth are processed in parallel. */
+      static const size_t parallelDepth = 4;
+      
+    public:
+
+      /*! Restructures all treelets of the BVH to reduce its SAH
+       *  cost. Barrier references are not entered. */
+      static void restructure(BVH4* bvh);
+
+    private:
+      static size_t restructure(BVH4* bvh, NodeRef ref, size_t depth);
+    };
+  }
+}
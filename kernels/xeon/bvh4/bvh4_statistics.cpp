@@ -109,6 +109,7 @@ namespace embree
   
   void BVH4Statistics::statistics(NodeRef node, const float A, size_t& depth)
   {
+    node.clearBarrier();
     if (node.isNode())
     {
       numAlignedNodes++;
@@ -20,7 +20,11 @@
 #include "../geometry/triangle8.h"
 #include "../geometry/triangle8v.h"
 #include "../geometry/trianglepairs8.h"
+#include "../geometry/quad4v.h"
+#include "../geometry/bezier1v.h"
+#include "../geometry/object.h"
 #include "../../common/accelinstance.h"
+#include "../../algorithms/parallel_for.h"
 
 namespace embree
 {
@@ -46,18 +50,46 @@ namespace embree
 
   DECLARE_SYMBOL(Accel::Intersector1,BVH8TrianglePairs8Intersector1Moeller);
 
+  DECLARE_SYMBOL(Accel::Intersector1,BVH8Quad4vIntersector1Moeller);
+
+  DECLARE_SYMBOL(Accel::Intersector1,BVH8Bezier1vIntersector1);
+  DECLARE_SYMBOL(Accel::Intersector4,BVH8Bezier1vIntersector4Hybrid);
+  DECLARE_SYMBOL(Accel::Intersector8,BVH8Bezier1vIntersector8Chunk);
+  DECLARE_SYMBOL(Accel::Intersector16,BVH8Bezier1vIntersector16Chunk);
+
+  DECLARE_SYMBOL(Accel::Intersector1,BVH8VirtualIntersector1);
+  DECLARE_SYMBOL(Accel::Intersector4,BVH8VirtualIntersector4Hybrid);
+  DECLARE_SYMBOL(Accel::Intersector8,BVH8VirtualIntersector8Chunk);
+  DECLARE_SYMBOL(Accel::Intersector16,BVH8VirtualIntersector16Chunk);
+
+  DECLARE_SYMBOL(Accel::Intersector1,BVH8Triangle4QuantizedIntersector1Moeller);
+  DECLARE_SYMBOL(Accel::Intersector4,BVH8Triangle4QuantizedIntersector4Moeller);
+  DECLARE_SYMBOL(Accel::Intersector8,BVH8Triangle4QuantizedIntersector8Moeller);
+  DECLARE_SYMBOL(Accel::Intersector16,BVH8Triangle4QuantizedIntersector16Moeller);
+  DECLARE_SYMBOL(Accel::Intersector4,BVH8Quad4vIntersector4HybridMoeller);
+  DECLARE_SYMBOL(Accel::Intersector4,BVH8Quad4vIntersector4HybridMoellerNoFilter);
+  DECLARE_SYMBOL(Accel::Intersector8,BVH8Quad4vIntersector8HybridMoeller);
+  DECLARE_SYMBOL(Accel::Intersector8,BVH8Quad4vIntersector8HybridMoellerNoFilter);
+
   DECLARE_SYMBOL(Accel::Intersector16,BVH8Triangle4Intersector16ChunkMoeller);
   DECLARE_SYMBOL(Accel::Intersector16,BVH8Triangle4Intersector16HybridMoeller);
   DECLARE_SYMBOL(Accel::Intersector16,BVH8Triangle4Intersector16HybridMoellerNoFilter);
   DECLARE_SYMBOL(Accel::Intersector16,BVH8Triangle8Intersector16ChunkMoeller);
   DECLARE_SYMBOL(Accel::Intersector16,BVH8Triangle8Intersector16HybridMoeller);
   DECLARE_SYMBOL(Accel::Intersector16,BVH8Triangle8Intersector16HybridMoellerNoFilter);
+  DECLARE_SYMBOL(Accel::Intersector16,BVH8Quad4vIntersector16HybridMoeller);
+  DECLARE_SYMBOL(Accel::Intersector16,BVH8Quad4vIntersector16HybridMoellerNoFilter);
   //DECLARE_SYMBOL(Accel::Intersector16,BVH8Triangle8vIntersector16HybridPluecker);
   //DECLARE_SYMBOL(Accel::Intersector16,BVH8Triangle8vIntersector16HybridPlueckerNoFilter);
 
   DECLARE_BUILDER(void,Scene,size_t,BVH8Triangle4SceneBuilderSAH);
   DECLARE_BUILDER(void,Scene,size_t,BVH8Triangle8SceneBuilderSAH);
   DECLARE_BUILDER(void,Scene,size_t,BVH8TrianglePairs8SceneBuilderSAH);
+  DECLARE_BUILDER(void,Scene,size_t,BVH8Quad4vSceneBuilderSAH);
+  DECLARE_BUILDER(void,Scene,const createTriangleMeshAccelTy,BVH8BuilderTwoLevelSAH);
+  DECLARE_BUILDER(void,TriangleMesh,size_t,BVH8Triangle4MeshBuilderSAH);
+  DECLARE_BUILDER(void,Scene,size_t,BVH8Bezier1vSceneBuilderSAH);
+  DECLARE_BUILDER(void,Scene,size_t,BVH8VirtualSceneBuilderSAH);
   //DECLARE_BUILDER(void,Scene,size_t,BVH8Triangle8vSceneBuilderSAH);
 
   DECLARE_BUILDER(void,Scene,size_t,BVH8Triangle4SceneBuilderSpatialSAH);
@@ -73,6 +105,11 @@ namespace embree
     SELECT_SYMBOL_AVX(features,BVH8Triangle8SceneBuilderSAH);
     //SELECT_SYMBOL_AVX(features,BVH8Triangle8vSceneBuilderSAH);
     SELECT_SYMBOL_AVX(features,BVH8TrianglePairs8SceneBuilderSAH);
+    SELECT_SYMBOL_AVX(features,BVH8Quad4vSceneBuilderSAH);
+    SELECT_SYMBOL_AVX(features,BVH8BuilderTwoLevelSAH);
+    SELECT_SYMBOL_AVX(features,BVH8Triangle4MeshBuilderSAH);
+    SELECT_SYMBOL_AVX(features,BVH8Bezier1vSceneBuilderSAH);
+    SELECT_SYMBOL_AVX(features,BVH8VirtualSceneBuilderSAH);
     
     SELECT_SYMBOL_AVX(features,BVH8Triangle4SceneBuilderSpatialSAH);
     SELECT_SYMBOL_AVX(features,BVH8Triangle8SceneBuilderSpatialSAH);
@@ -82,6 +119,10 @@ namespace embree
     SELECT_SYMBOL_AVX_AVX2(features,BVH8Triangle4Intersector1Moeller);
     SELECT_SYMBOL_AVX_AVX2(features,BVH8Triangle8Intersector1Moeller);
     SELECT_SYMBOL_AVX_AVX2(features,BVH8TrianglePairs8Intersector1Moeller);
+    SELECT_SYMBOL_AVX_AVX2(features,BVH8Quad4vIntersector1Moeller);
+    SELECT_SYMBOL_AVX_AVX2(features,BVH8Triangle4QuantizedIntersector1Moeller);
+    SELECT_SYMBOL_AVX_AVX2(features,BVH8Bezier1vIntersector1);
+    SELECT_SYMBOL_AVX_AVX2(features,BVH8VirtualIntersector1);
     //SELECT_SYMBOL_AVX_AVX2(features,BVH8Triangle8vIntersector1Pluecker);
 
 #if defined (RTCORE_RAY_PACKETS)
@@ -91,6 +132,11 @@ namespace embree
     SELECT_SYMBOL_AVX_AVX2(features,BVH8Triangle4Intersector4HybridMoellerNoFilter);
     SELECT_SYMBOL_AVX_AVX2(features,BVH8Triangle8Intersector4HybridMoeller);
     SELECT_SYMBOL_AVX_AVX2(features,BVH8Triangle8Intersector4HybridMoellerNoFilter);
+    SELECT_SYMBOL_AVX_AVX2(features,BVH8Quad4vIntersector4HybridMoeller);
+    SELECT_SYMBOL_AVX_AVX2(features,BVH8Quad4vIntersector4HybridMoellerNoFilter);
+    SELECT_SYMBOL_AVX_AVX2(features,BVH8Triangle4QuantizedIntersector4Moeller);
+    SELECT_SYMBOL_AVX_AVX2(features,BVH8Bezier1vIntersector4Hybrid);
+    SELECT_SYMBOL_AVX_AVX2(features,BVH8VirtualIntersector4Hybrid);
     //SELECT_SYMBOL_AVX_AVX2(features,BVH8Triangle8vIntersector4HybridPluecker);
     //SELECT_SYMBOL_AVX_AVX2(features,BVH8Triangle8vIntersector4HybridPlueckerNoFilter);
 
@@ -101,6 +147,11 @@ namespace embree
     SELECT_SYMBOL_AVX_AVX2(features,BVH8Triangle8Intersector8ChunkMoeller);
     SELECT_SYMBOL_AVX_AVX2(features,BVH8Triangle8Intersector8HybridMoeller);
     SELECT_SYMBOL_AVX_AVX2(features,BVH8Triangle8Intersector8HybridMoellerNoFilter);
+    SELECT_SYMBOL_AVX_AVX2(features,BVH8Quad4vIntersector8HybridMoeller);
+    SELECT_SYMBOL_AVX_AVX2(features,BVH8Quad4vIntersector8HybridMoellerNoFilter);
+    SELECT_SYMBOL_AVX_AVX2(features,BVH8Triangle4QuantizedIntersector8Moeller);
+    SELECT_SYMBOL_AVX_AVX2(features,BVH8Bezier1vIntersector8Chunk);
+    SELECT_SYMBOL_AVX_AVX2(features,BVH8VirtualIntersector8Chunk);
     //SELECT_SYMBOL_AVX_AVX2(features,BVH8Triangle8vIntersector8HybridPluecker);
     //SELECT_SYMBOL_AVX_AVX2(features,BVH8Triangle8vIntersector8HybridPlueckerNoFilter);
 
@@ -112,14 +163,19 @@ namespace embree
     SELECT_SYMBOL_AVX512(features,BVH8Triangle8Intersector16ChunkMoeller);
     SELECT_SYMBOL_AVX512(features,BVH8Triangle8Intersector16HybridMoeller);
     SELECT_SYMBOL_AVX512(features,BVH8Triangle8Intersector16HybridMoellerNoFilter);
+    SELECT_SYMBOL_AVX512(features,BVH8Quad4vIntersector16HybridMoeller);
+    SELECT_SYMBOL_AVX512(features,BVH8Quad4vIntersector16HybridMoellerNoFilter);
+    SELECT_SYMBOL_AVX512(features,BVH8Triangle4QuantizedIntersector16Moeller);
+    SELECT_SYMBOL_AVX512(features,BVH8Bezier1vIntersector16Chunk);
+    SELECT_SYMBOL_AVX512(features,BVH8VirtualIntersector16Chunk);
     //SELECT_SYMBOL_AVX512(features,BVH8Triangle8vIntersector16HybridPluecker);
     //SELECT_SYMBOL_AVX512(features,BVH8Triangle8vIntersector16HybridPlueckerNoFilter);
 #endif
   }
 
   BVH8::BVH8 (const PrimitiveType& primTy, Scene* scene)
-    : AccelData(AccelData::TY_BVH8), alloc2(scene->device), primTy(primTy), device(scene->device), scene(scene), root(emptyNode),
-      numPrimitives(0), numVertices(0) {}
+    : AccelData(AccelData::TY_BVH8), alloc2(scene->device,scene->device->numa), primTy(primTy), device(scene->device), scene(scene), root(emptyNode),
+      numPrimitives(0), numVertices(0), quantized(false) {}
 
   BVH8::~BVH8 () {
     for (size_t i=0; i<objects.size(); i++) 
@@ -145,6 +201,43 @@ namespace embree
      std::cout << "  "; alloc2.print_statistics();
    }	
   
+  double BVH8::preBuild(const char* builderName)
+  {
+    if (builderName == nullptr) 
+      return inf;
+
+    if (device->verbosity(1))
+      std::cout << "building BVH8<" << primTy.name << "> using " << builderName << " ..." << std::flush;
+
+    double t0 = 0.0;
+    if (device->benchmark || device->verbosity(1)) t0 = getSeconds();
+    return t0;
+  }  
+
+  void BVH8::postBuild(double t0)
+  {
+    if (t0 == double(inf))
+      return;
+    
+    double dt = 0.0;
+    if (device->benchmark || device->verbosity(1)) 
+      dt = getSeconds()-t0;
+
+    /* print statistics */
+    if (device->verbosity(1)) {
+      std::cout << " [DONE]" << "  " << 1000.0f*dt << "ms (" << 1E-6*double(numPrimitives)/dt << " Mprim/s)" << std::endl;
+    }
+    
+    if (device->verbosity(2))
+      printStatistics();
+
+    /* benchmark mode */
+    if (device->benchmark) {
+      BVH8Statistics stat(this);
+      std::cout << "BENCHMARK_BUILD " << dt << " " << double(numPrimitives)/dt << " " << stat.sah() << " " << stat.bytesUsed() << std::endl;
+    }
+  }
+
   void BVH8::clearBarrier(NodeRef& node)
   {
     if (node.isBarrier())
@@ -213,6 +306,268 @@ namespace embree
     else return node;
   }
 
+  /*! leaves are padded to the alignment required for the leaf encoding */
+  static __forceinline size_t leafBytes(size_t bytes) {
+    return (bytes+BVH8::align_mask) & ~BVH8::align_mask;
+  }
+
+  void BVH8::saveBytes(NodeRef node, size_t& nodeBytes, size_t& leafBytes) const
+  {
+    if (node == emptyNode) 
+      return;
+
+    if (node.isLeaf()) {
+      size_t num; node.leaf(num);
+      leafBytes += embree::leafBytes(num*primTy.bytes);
+      return;
+    }
+
+    nodeBytes += quantized ? sizeof(QuantizedNode) : sizeof(Node);
+    const NodeRef* children = quantized ? node.quantizedNode()->children : node.node()->children;
+    for (size_t i=0; i<N; i++)
+      saveBytes(children[i],nodeBytes,leafBytes);
+  }
+
+  BVH8::NodeRef BVH8::saveRecursion(NodeRef node, char* data, size_t& nodeOfs, size_t& leafOfs) const
+  {
+    if (node == emptyNode)
+      return node;
+
+    if (node.isLeaf()) 
+    {
+      size_t num; char* prims = node.leaf(num);
+      const size_t bytes = num*primTy.bytes;
+      memcpy(data+leafOfs,prims,bytes);
+      NodeRef ref = NodeRef(leafOfs | (1+num));
+      leafOfs += embree::leafBytes(bytes);
+      return ref;
+    }
+
+    const size_t bytes = quantized ? sizeof(QuantizedNode) : sizeof(Node);
+    const size_t ofs = nodeOfs; nodeOfs += bytes;
+    char* n = data+ofs;
+    memcpy(n,(void*)(size_t)node,bytes);
+    NodeRef* children = quantized ? ((QuantizedNode*)n)->children : ((Node*)n)->children;
+    for (size_t i=0; i<N; i++)
+      children[i] = saveRecursion(children[i],data,nodeOfs,leafOfs);
+    return NodeRef(ofs);
+  }
+
+  void BVH8::relocate(NodeRef& node, size_t base)
+  {
+    if (node == emptyNode)
+      return;
+
+    node = NodeRef(node + base);
+    if (node.isLeaf()) 
+      return;
+
+    NodeRef* children = quantized ? node.quantizedNode()->children : node.node()->children;
+    for (size_t i=0; i<N; i++)
+      relocate(children[i],base);
+  }
+
+  bool BVH8::save(std::ostream& stream)
+  {
+    /* leaves have to be free of pointers to get stored */
+    if (root != emptyNode && (!primTy.relocatable || objects.size()))
+      return false;
+
+    /* all nodes are stored in front of the leaves, thus relocation only touches node pages */
+    size_t nodeBytes = 0, leafBytes = 0;
+    saveBytes(root,nodeBytes,leafBytes);
+    std::vector<char> data(nodeBytes+leafBytes);
+    size_t nodeOfs = 0, leafOfs = nodeBytes;
+    NodeRef ref = saveRecursion(root,data.data(),nodeOfs,leafOfs);
+    assert(nodeOfs == nodeBytes && leafOfs == nodeBytes+leafBytes);
+
+    FileHeader header(primTy.name,N,quantized);
+    header.root = ref;
+    header.numPrimitives = numPrimitives;
+    header.numVertices = numVertices;
+    header.bytes = data.size();
+    header.bounds = bounds;
+
+    const char zeros[64] = { 0 };
+    stream.write((char*)&header,sizeof(header));
+    stream.write(zeros,FileHeader::headerBytes()-sizeof(header));
+    stream.write(data.data(),data.size());
+    return stream.good();
+  }
+
+  bool BVH8::load(char* ptr, size_t bytes)
+  {
+    const FileHeader& header = *(FileHeader*) ptr;
+    if (bytes < FileHeader::headerBytes() || !header.matches(FileHeader(primTy.name,N,quantized)))
+      return false;
+    if (header.bytes > bytes-FileHeader::headerBytes() || (!primTy.relocatable && header.root != emptyNode))
+      return false;
+
+    clear();
+    NodeRef ref = header.root;
+    relocate(ref,(size_t)ptr+FileHeader::headerBytes());
+    set(ref,header.bounds,header.numPrimitives);
+    numVertices = header.numVertices;
+    return true;
+  }
+
+  /*! nodes and leaves of the relayouted hierarchy start at cache line boundaries */
+  static __forceinline size_t cacheLineBytes(size_t bytes) {
+    return (bytes+63) & ~size_t(63);
+  }
+
+  size_t BVH8::relayoutBytes(NodeRef node) const
+  {
+    size_t bytes = cacheLineBytes(quantized ? sizeof(QuantizedNode) : sizeof(Node));
+    const NodeRef* children = quantized ? node.quantizedNode()->children : node.node()->children;
+    for (size_t i=0; i<N; i++)
+    {
+      if (children[i] == emptyNode) continue;
+      if (children[i].isLeaf()) { size_t num; children[i].leaf(num); bytes += cacheLineBytes(num*primTy.bytes); }
+      else bytes += relayoutBytes(children[i]);
+    }
+    return bytes;
+  }
+
+  BVH8::NodeRef BVH8::relayoutRecursion(NodeRef node, char* data, size_t& ofs) const
+  {
+    const size_t bytes = quantized ? sizeof(QuantizedNode) : sizeof(Node);
+    const size_t nodeOfs = ofs; ofs += cacheLineBytes(bytes);
+    char* n = data+nodeOfs;
+    memcpy(n,(void*)(size_t)node,bytes);
+    NodeRef* children = quantized ? ((QuantizedNode*)n)->children : ((Node*)n)->children;
+
+    /* the leaves are stored directly behind their parent node */
+    for (size_t i=0; i<N; i++)
+    {
+      if (children[i] == emptyNode || !children[i].isLeaf()) continue;
+      size_t num; char* prims = children[i].leaf(num);
+      memcpy(data+ofs,prims,num*primTy.bytes);
+      children[i] = NodeRef(ofs | (1+num));
+      ofs += cacheLineBytes(num*primTy.bytes);
+    }
+
+    /* followed by the child subtrees in depth first order */
+    for (size_t i=0; i<N; i++)
+    {
+      if (children[i] == emptyNode || children[i].isLeaf()) continue;
+      children[i] = relayoutRecursion(children[i],data,ofs);
+    }
+    return NodeRef(nodeOfs);
+  }
+
+  bool BVH8::relayoutable() const {
+    return root != emptyNode && !root.isLeaf() && primTy.relocatable && !objects.size();
+  }
+
+  template<typename Allocate>
+  BVH8::NodeRef BVH8::relayoutCopy(const Allocate& allocate) const
+  {
+    const size_t nodeBytes = quantized ? sizeof(QuantizedNode) : sizeof(Node);
+    auto getChildren = [&] (NodeRef node) -> NodeRef* {
+      return quantized ? node.quantizedNode()->children : node.node()->children;
+    };
+
+    /* the top nodes are stored first in breadth first order */
+    std::vector<NodeRef> top; top.push_back(root);
+    for (size_t i=0; i<top.size() && top.size() < maxRelayoutTopNodes; i++) {
+      const NodeRef* children = getChildren(top[i]);
+      for (size_t c=0; c<N && top.size() < maxRelayoutTopNodes; c++)
+        if (children[c] != emptyNode && !children[c].isLeaf()) top.push_back(children[c]);
+    }
+
+    /* followed by the leaves of the top nodes and the remaining subtrees in the order they are referenced */
+    size_t topBytes = top.size()*nodeBytes;
+    std::vector<NodeRef> subtrees;
+    for (size_t i=0, next=1; i<top.size(); i++)
+    {
+      const NodeRef* children = getChildren(top[i]);
+      for (size_t c=0; c<N; c++)
+      {
+        if (children[c] == emptyNode) continue;
+        if (children[c].isLeaf()) { size_t num; children[c].leaf(num); topBytes += cacheLineBytes(num*primTy.bytes); }
+        else if (next < top.size() && top[next] == children[c]) next++;
+        else subtrees.push_back(children[c]);
+      }
+    }
+
+    /* the subtrees are copied in parallel */
+    std::vector<size_t> subtreeOfs(subtrees.size()+1);
+    parallel_for(size_t(0), subtrees.size(), [&] (const range<size_t>& r) {
+        for (size_t i=r.begin(); i<r.end(); i++) subtreeOfs[i+1] = relayoutBytes(subtrees[i]);
+      });
+    subtreeOfs[0] = topBytes;
+    for (size_t i=0; i<subtrees.size(); i++) subtreeOfs[i+1] += subtreeOfs[i];
+    const size_t bytes = subtreeOfs[subtrees.size()];
+
+    char* data = allocate(bytes);
+    parallel_for(size_t(0), subtrees.size(), [&] (const range<size_t>& r) {
+        for (size_t i=r.begin(); i<r.end(); i++) {
+          size_t ofs = subtreeOfs[i];
+          subtrees[i] = relayoutRecursion(subtrees[i],data,ofs);
+        }
+      });
+
+    size_t leafOfs = top.size()*nodeBytes;
+    for (size_t i=0, next=1, s=0; i<top.size(); i++)
+    {
+      char* n = data+i*nodeBytes;
+      memcpy(n,(void*)(size_t)top[i],nodeBytes);
+      NodeRef* children = quantized ? ((QuantizedNode*)n)->children : ((Node*)n)->children;
+      for (size_t c=0; c<N; c++)
+      {
+        if (children[c] == emptyNode) continue;
+        if (children[c].isLeaf()) {
+          size_t num; char* prims = children[c].leaf(num);
+          memcpy(data+leafOfs,prims,num*primTy.bytes);
+          children[c] = NodeRef(leafOfs | (1+num));
+          leafOfs += cacheLineBytes(num*primTy.bytes);
+        }
+        else if (next < top.size() && top[next] == children[c])
+          children[c] = NodeRef(nodeBytes*next++);
+        else
+          children[c] = subtrees[s++];
+      }
+    }
+    assert(leafOfs == topBytes);
+    return NodeRef(0);
+  }
+
+  void BVH8::relayout()
+  {
+    /* leaves get copied, thus they must not be referenced from elsewhere */
+    if (!relayoutable())
+      return;
+
+    size_t bytes = 0;
+    char* data = nullptr;
+    NodeRef ref = relayoutCopy([&] (size_t n) { bytes = n; return data = (char*) alignedMalloc(n,64); });
+
+    /* replace the old nodes and leaves by a single block */
+    alloc2.clear();
+    char* ptr = (char*) alloc2.malloc_block(bytes);
+    memcpy(ptr,data,bytes);
+    alignedFree(data);
+    relocate(ref,(size_t)ptr);
+    root = ref;
+  }
+
+  AccelData* BVH8::clone(size_t node)
+  {
+    if (!relayoutable())
+      return nullptr;
+
+    /* the copy is written directly into a block placed on the NUMA node */
+    BVH8* bvh = new BVH8(primTy,scene);
+    bvh->quantized = quantized;
+    char* ptr = nullptr;
+    NodeRef ref = relayoutCopy([&] (size_t bytes) { return ptr = (char*) bvh->alloc2.malloc_block(bytes,node); });
+    bvh->relocate(ref,(size_t)ptr);
+    bvh->set(ref,bounds,numPrimitives);
+    bvh->numVertices = numVertices;
+    return bvh;
+  }
+
   Accel::Intersectors BVH8Triangle4Intersectors(BVH8* bvh)
   {
     Accel::Intersectors intersectors;
@@ -269,6 +624,56 @@ namespace embree
     return intersectors;
   }
 
+  Accel::Intersectors BVH8Quad4vIntersectors(BVH8* bvh)
+  {
+    Accel::Intersectors intersectors;
+    intersectors.ptr = bvh;
+    intersectors.intersector1           = BVH8Quad4vIntersector1Moeller;
+    intersectors.intersector4_filter    = BVH8Quad4vIntersector4HybridMoeller;
+    intersectors.intersector4_nofilter  = BVH8Quad4vIntersector4HybridMoellerNoFilter;
+    intersectors.intersector8_filter    = BVH8Quad4vIntersector8HybridMoeller;
+    intersectors.intersector8_nofilter  = BVH8Quad4vIntersector8HybridMoellerNoFilter;
+    intersectors.intersector16_filter   = BVH8Quad4vIntersector16HybridMoeller;
+    intersectors.intersector16_nofilter = BVH8Quad4vIntersector16HybridMoellerNoFilter;
+    return intersectors;
+  }
+
+  Accel::Intersectors BVH8Triangle4QuantizedIntersectors(BVH8* bvh)
+  {
+    Accel::Intersectors intersectors;
+    intersectors.ptr = bvh;
+    intersectors.intersector1           = BVH8Triangle4QuantizedIntersector1Moeller;
+    intersectors.intersector4_filter    = BVH8Triangle4QuantizedIntersector4Moeller;
+    intersectors.intersector4_nofilter  = BVH8Triangle4QuantizedIntersector4Moeller;
+    intersectors.intersector8_filter    = BVH8Triangle4QuantizedIntersector8Moeller;
+    intersectors.intersector8_nofilter  = BVH8Triangle4QuantizedIntersector8Moeller;
+    intersectors.intersector16_filter   = BVH8Triangle4QuantizedIntersector16Moeller;
+    intersectors.intersector16_nofilter = BVH8Triangle4QuantizedIntersector16Moeller;
+    return intersectors;
+  }
+
+  Accel::Intersectors BVH8Bezier1vIntersectors(BVH8* bvh)
+  {
+    Accel::Intersectors intersectors;
+    intersectors.ptr = bvh;
+    intersectors.intersector1  = BVH8Bezier1vIntersector1;
+    intersectors.intersector4  = BVH8Bezier1vIntersector4Hybrid;
+    intersectors.intersector8  = BVH8Bezier1vIntersector8Chunk;
+    intersectors.intersector16 = BVH8Bezier1vIntersector16Chunk;
+    return intersectors;
+  }
+
+  Accel::Intersectors BVH8VirtualIntersectors(BVH8* bvh)
+  {
+    Accel::Intersectors intersectors;
+    intersectors.ptr = bvh;
+    intersectors.intersector1  = BVH8VirtualIntersector1;
+    intersectors.intersector4  = BVH8VirtualIntersector4Hybrid;
+    intersectors.intersector8  = BVH8VirtualIntersector8Chunk;
+    intersectors.intersector16 = BVH8VirtualIntersector16Chunk;
+    return intersectors;
+  }
+
   Accel* BVH8::BVH8Triangle4(Scene* scene)
   { 
     BVH8* accel = new BVH8(Triangle4::type,scene);
@@ -284,6 +689,21 @@ namespace embree
     return new AccelInstance(accel,builder,intersectors);
   }
 
+  void createTriangleMeshTriangle4BVH8(TriangleMesh* mesh, AccelData*& accel, Builder*& builder)
+  {
+    if (mesh->numTimeSteps != 1) THROW_RUNTIME_ERROR("internal error");
+    accel = new BVH8(Triangle4::type,mesh->parent);
+    builder = BVH8Triangle4MeshBuilderSAH(accel,mesh,0);
+  } 
+
+  Accel* BVH8::BVH8BVH8Triangle4ObjectSplit(Scene* scene)
+  {
+    BVH8* accel = new BVH8(Triangle4::type,scene);
+    Accel::Intersectors intersectors = BVH8Triangle4Intersectors(accel);
+    Builder* builder = BVH8BuilderTwoLevelSAH(accel,scene,&createTriangleMeshTriangle4BVH8);
+    return new AccelInstance(accel,builder,intersectors);
+  }
+
   Accel* BVH8::BVH8Triangle4ObjectSplit(Scene* scene)
   {
     BVH8* accel = new BVH8(Triangle4::type,scene);
@@ -358,6 +778,39 @@ namespace embree
     return new AccelInstance(accel,builder,intersectors);
   }
 
+  Accel* BVH8::BVH8Quad4v(Scene* scene)
+  {
+    BVH8* accel = new BVH8(Quad4v::type,scene);
+    Accel::Intersectors intersectors = BVH8Quad4vIntersectors(accel);
+    Builder* builder = BVH8Quad4vSceneBuilderSAH(accel,scene,0);
+    return new AccelInstance(accel,builder,intersectors);
+  }
+
+  Accel* BVH8::BVH8Bezier1v(Scene* scene)
+  {
+    BVH8* accel = new BVH8(Bezier1v::type,scene);
+    Accel::Intersectors intersectors = BVH8Bezier1vIntersectors(accel);
+    Builder* builder = BVH8Bezier1vSceneBuilderSAH(accel,scene,0);
+    return new AccelInstance(accel,builder,intersectors);
+  }
+
+  Accel* BVH8::BVH8UserGeometry(Scene* scene)
+  {
+    BVH8* accel = new BVH8(Object::type,scene);
+    Accel::Intersectors intersectors = BVH8VirtualIntersectors(accel);
+    Builder* builder = BVH8VirtualSceneBuilderSAH(accel,scene,0);
+    return new AccelInstance(accel,builder,intersectors);
+  }
+
+  Accel* BVH8::BVH8Triangle4Quantized(Scene* scene)
+  {
+    BVH8* accel = new BVH8(Triangle4::type,scene);
+    accel->quantized = true;
+    Accel::Intersectors intersectors = BVH8Triangle4QuantizedIntersectors(accel);
+    Builder* builder = BVH8Triangle4SceneBuilderSAH(accel,scene,0);
+    return new AccelInstance(accel,builder,intersectors);
+  }
+
   /*Accel* BVH8::BVH8Triangle8vObjectSplit(Scene* scene)
   {
     BVH8* accel = new BVH8(Triangle8v::type,scene);
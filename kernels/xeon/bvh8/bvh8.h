@@ -34,6 +34,7 @@ namespace embree
     
     /*! forward declaration of node type */
     struct Node;
+    struct QuantizedNode;
 
     /*! branching width of the tree */
     static const size_t N = 8;
@@ -61,6 +62,9 @@ namespace embree
     /*! Maximal number of primitive blocks in a leaf. */
     static const size_t maxLeafBlocks = 6; //items_mask-1;
 
+    /*! Number of top nodes that relayout stores first in breadth first order (64 KB of nodes). */
+    static const size_t maxRelayoutTopNodes = 256;
+
     /*! Cost of one traversal step. */
     static const int travCost = 1;
     static const int intCost = 1;
@@ -110,6 +114,10 @@ namespace embree
       /*! returns node pointer */
       __forceinline       Node* node()       { assert(isNode()); return (      Node*)ptr; }
       __forceinline const Node* node() const { assert(isNode()); return (const Node*)ptr; }
+
+      /*! returns quantized node pointer */
+      __forceinline       QuantizedNode* quantizedNode()       { assert(isNode()); return (      QuantizedNode*)ptr; }
+      __forceinline const QuantizedNode* quantizedNode() const { assert(isNode()); return (const QuantizedNode*)ptr; }
       
       /*! returns leaf pointer */
       __forceinline char* leaf(size_t& num) const {
@@ -184,6 +192,111 @@ namespace embree
       NodeRef children[N];    //!< Pointer to the 4 children (can be a node or leaf)
     };
 
+    /*! BVH8 Node that stores the bounds of its children as 8 bit
+     *  offsets on a grid spanning the bounds of the node. The grid
+     *  spacing is a power of two per dimension and the bounds are
+     *  rounded outwards, thus the quantized bounds are conservative
+     *  and the node fits into two cache lines. */
+    struct QuantizedNode
+    {
+      /*! Clears the node. Empty children get an inverted box that no ray can hit. */
+      __forceinline void clear() 
+      {
+        for (size_t i=0; i<N; i++) {
+          children[i] = emptyNode;
+          lower_x[i] = lower_y[i] = lower_z[i] = 255;
+          upper_x[i] = upper_y[i] = upper_z[i] = 0;
+        }
+        start = Vec3f(zero);
+        exponent[0] = exponent[1] = exponent[2] = 0;
+      }
+
+      /*! Sets the quantization grid to span the specified bounds. The grid
+       *  spacing is kept non-zero, such that empty children stay inverted. */
+      __forceinline void setGrid(const BBox3fa& bounds)
+      {
+        const Vec3fa minExtent = 4.0f*float(ulp)*max(abs(bounds.lower),abs(bounds.upper)) + Vec3fa(1E-18f);
+        const Vec3fa extent = max(bounds.upper-bounds.lower,minExtent)*(1.0f+4.0f*float(ulp));
+        start = Vec3f(bounds.lower.x,bounds.lower.y,bounds.lower.z);
+        for (size_t dim=0; dim<3; dim++) {
+          int e; frexpf(extent[dim]*(1.0f/255.0f),&e); // 2^e > extent/255
+          exponent[dim] = (signed char) e;
+        }
+      }
+
+      /*! Returns the grid spacing. */
+      __forceinline Vec3fa scale() const {
+        return Vec3fa(cast_i2f((exponent[0]+127) << 23),cast_i2f((exponent[1]+127) << 23),cast_i2f((exponent[2]+127) << 23));
+      }
+
+      /*! Sets bounding box of child. The grid has to be set before. */
+      __forceinline void set(size_t i, const BBox3fa& bounds) 
+      {
+        assert(i < N);
+        const Vec3fa s = scale();
+        lower_x[i] = quantizeLower(bounds.lower.x,start.x,s.x); upper_x[i] = quantizeUpper(bounds.upper.x,start.x,s.x);
+        lower_y[i] = quantizeLower(bounds.lower.y,start.y,s.y); upper_y[i] = quantizeUpper(bounds.upper.y,start.y,s.y);
+        lower_z[i] = quantizeLower(bounds.lower.z,start.z,s.z); upper_z[i] = quantizeUpper(bounds.upper.z,start.z,s.z);
+      }
+
+      /*! Sets bounding box and ID of child. */
+      __forceinline void set(size_t i, const BBox3fa& bounds, const NodeRef& childID) {
+        set(i,bounds);
+        children[i] = childID;
+      }
+
+      /*! Returns bounds of node. */
+      __forceinline BBox3fa bounds() const 
+      {
+        BBox3fa b = empty;
+        for (size_t i=0; i<N; i++)
+          if (children[i] != emptyNode) b.extend(bounds(i));
+        return b;
+      }
+
+      /*! Returns the dequantized bounds of specified child. */
+      __forceinline BBox3fa bounds(size_t i) const 
+      {
+        assert(i < N);
+        const Vec3fa s = scale();
+        const Vec3fa lower(start.x+float(lower_x[i])*s.x,start.y+float(lower_y[i])*s.y,start.z+float(lower_z[i])*s.z);
+        const Vec3fa upper(start.x+float(upper_x[i])*s.x,start.y+float(upper_y[i])*s.y,start.z+float(upper_z[i])*s.z);
+        return BBox3fa(lower,upper);
+      }
+
+      /*! Returns reference to specified child */
+      __forceinline       NodeRef& child(size_t i)       { assert(i<N); return children[i]; }
+      __forceinline const NodeRef& child(size_t i) const { assert(i<N); return children[i]; }
+
+    private:
+      static __forceinline unsigned char quantizeLower(float x, float start, float scale) 
+      {
+        int q = clamp(int(floor((x-start)/scale)),0,255);
+        while (q > 0 && start+float(q)*scale > x) q--;
+        return (unsigned char) q;
+      }
+
+      static __forceinline unsigned char quantizeUpper(float x, float start, float scale) 
+      {
+        int q = clamp(int(ceil((x-start)/scale)),0,255);
+        while (q < 255 && start+float(q)*scale < x) q++;
+        assert(start+float(q)*scale >= x);
+        return (unsigned char) q;
+      }
+
+    public:
+      NodeRef children[N];      //!< Pointer to the 8 children (can be a node or leaf)
+      unsigned char lower_x[N]; //!< X dimension of quantized lower bounds of all 8 children.
+      unsigned char upper_x[N]; //!< X dimension of quantized upper bounds of all 8 children.
+      unsigned char lower_y[N]; //!< Y dimension of quantized lower bounds of all 8 children.
+      unsigned char upper_y[N]; //!< Y dimension of quantized upper bounds of all 8 children.
+      unsigned char lower_z[N]; //!< Z dimension of quantized lower bounds of all 8 children.
+      unsigned char upper_z[N]; //!< Z dimension of quantized upper bounds of all 8 children.
+      Vec3f start;              //!< origin of the quantization grid
+      signed char exponent[3];  //!< grid spacing is 2^exponent per dimension
+      char align[1];
+    };
+
 
 
     /*! swap the children of two nodes */
@@ -232,12 +345,20 @@ namespace embree
     static Accel* BVH8Triangle4(Scene* scene);
     static Accel* BVH8Triangle4ObjectSplit(Scene* scene);
     static Accel* BVH8Triangle4SpatialSplit(Scene* scene);
+    static Accel* BVH8BVH8Triangle4ObjectSplit(Scene* scene);
 
     static Accel* BVH8Triangle8(Scene* scene);
     //static Accel* BVH8Triangle8v(Scene* scene);
     static Accel* BVH8TrianglePairs8(Scene* scene);
     static Accel* BVH8Triangle8ObjectSplit(Scene* scene);
     static Accel* BVH8Triangle8SpatialSplit(Scene* scene);
+
+    static Accel* BVH8Quad4v(Scene* scene);
+
+    static Accel* BVH8Triangle4Quantized(Scene* scene);
+
+    static Accel* BVH8Bezier1v(Scene* scene);
+    static Accel* BVH8UserGeometry(Scene* scene);
     //static Accel* BVH8Triangle8vObjectSplit(Scene* scene);
     //static Accel* BVH8Triangle8vSpatialSplit(Scene* scene);
 
@@ -249,12 +370,41 @@ namespace embree
 
     void printStatistics();
 
+    /*! called by all builders before build starts */
+    double preBuild(const char* builderName);
+
+    /*! called by all builders after build ended */
+    void postBuild(double t0);
+
     /*! Clears the barrier bits of a subtree. */
     void clearBarrier(NodeRef& node);
 
     void layoutLargeNodes(size_t N);
     NodeRef layoutLargeNodesRecursion(NodeRef& node);
 
+    /*! stores nodes and leaves into a stream, with all references relative to the stored data */
+    bool save(std::ostream& stream);
+
+    /*! uses a hierarchy stored by save in place, only the references inside the nodes get relocated */
+    bool load(char* ptr, size_t bytes);
+
+    /*! helper functions for save and load */
+    void saveBytes(NodeRef node, size_t& nodeBytes, size_t& leafBytes) const;
+    NodeRef saveRecursion(NodeRef node, char* data, size_t& nodeOfs, size_t& leafOfs) const;
+    void relocate(NodeRef& node, size_t base);
+
+    /*! stores the top nodes first and each subtree in depth first order with the leaves behind their parent into a single block */
+    void relayout();
+
+    /*! creates a relayouted copy of the hierarchy placed on the specified NUMA node */
+    AccelData* clone(size_t node);
+
+    /*! helper functions for relayout */
+    bool relayoutable() const;
+    template<typename Allocate> NodeRef relayoutCopy(const Allocate& allocate) const;
+    size_t relayoutBytes(NodeRef node) const;
+    NodeRef relayoutRecursion(NodeRef node, char* data, size_t& ofs) const;
+
     FastAllocator alloc2;
 
 #if defined (__AVX__)
@@ -263,6 +413,11 @@ namespace embree
     __forceinline NodeRef encodeNode(Node* node) { 
       return NodeRef((size_t) node);
     }
+
+    /*! Encodes a quantized node */
+    __forceinline NodeRef encodeNode(QuantizedNode* node) { 
+      return NodeRef((size_t) node);
+    }
     
     /*! Encodes a leaf */
     __forceinline NodeRef encodeLeaf(void* tri, size_t num) {
@@ -285,6 +440,7 @@ namespace embree
     NodeRef root;                      //!< Root node
     size_t numPrimitives;
     size_t numVertices;
+    bool quantized;                    //!< inner nodes are of type QuantizedNode
 
     /*! data arrays for fast builders */
   public:
@@ -25,6 +25,9 @@
 #include "../geometry/triangle8.h"
 #include "../geometry/triangle8v.h"
 #include "../geometry/trianglepairs8.h"
+#include "../geometry/quad4v.h"
+#include "../geometry/bezier1v.h"
+#include "../geometry/object.h"
 
 #define PROFILE 0
 
@@ -64,6 +67,29 @@ namespace embree
       BVH8* bvh;
     };
 
+    struct CreateBVH8QuantizedNode
+    {
+      __forceinline CreateBVH8QuantizedNode (BVH8* bvh) : bvh(bvh) {}
+      
+      __forceinline int operator() (const isa::BVHBuilderBinnedSAH::BuildRecord& current, BVHBuilderBinnedSAH::BuildRecord* children, const size_t N, Allocator* alloc) 
+      {
+        BVH8::QuantizedNode* node = (BVH8::QuantizedNode*) alloc->alloc0.malloc(sizeof(BVH8::QuantizedNode), 1 << BVH8::alignment); 
+        node->clear();
+        BBox3fa bounds = empty;
+        for (size_t i=0; i<N; i++) 
+          bounds.extend(children[i].pinfo.geomBounds);
+        node->setGrid(bounds);
+        for (size_t i=0; i<N; i++) {
+          node->set(i,children[i].pinfo.geomBounds);
+          children[i].parent = (size_t*) &node->child(i);
+        }
+        *current.parent = bvh->encodeNode(node);
+	return 0;
+      }
+
+      BVH8* bvh;
+    };
+
     template<typename Primitive>
     struct CreateBVH8Leaf
     {
@@ -144,12 +170,21 @@ namespace embree
             if (presplitFactor > 1.0f)
               pinfo = presplit<Mesh>(scene, pinfo, prims);
 	    BVH8::NodeRef root; 
-            BVHBuilderBinnedSAH::build<BVH8::NodeRef>
-              (root,CreateBVH8Alloc(bvh),CreateBVH8Node(bvh),CreateBVH8Leaf<Primitive>(bvh,prims.data()), progress,
-               prims.data(),pinfo,BVH8::N,BVH8::maxBuildDepthLeaf,sahBlockSize,minLeafSize,maxLeafSize,BVH8::travCost,intCost);
-
-            bvh->set(root,pinfo.geomBounds,pinfo.size());
-            bvh->layoutLargeNodes(numSplitPrimitives*0.005f);
+            if (bvh->quantized) 
+            {
+              BVHBuilderBinnedSAH::build<BVH8::NodeRef>
+                (root,CreateBVH8Alloc(bvh),CreateBVH8QuantizedNode(bvh),CreateBVH8Leaf<Primitive>(bvh,prims.data()), progress,
+                 prims.data(),pinfo,BVH8::N,BVH8::maxBuildDepthLeaf,sahBlockSize,minLeafSize,maxLeafSize,BVH8::travCost,intCost);
+              bvh->set(root,pinfo.geomBounds,pinfo.size());
+            }
+            else
+            {
+              BVHBuilderBinnedSAH::build<BVH8::NodeRef>
+                (root,CreateBVH8Alloc(bvh),CreateBVH8Node(bvh),CreateBVH8Leaf<Primitive>(bvh,prims.data()), progress,
+                 prims.data(),pinfo,BVH8::N,BVH8::maxBuildDepthLeaf,sahBlockSize,minLeafSize,maxLeafSize,BVH8::travCost,intCost);
+              bvh->set(root,pinfo.geomBounds,pinfo.size());
+              bvh->layoutLargeNodes(numSplitPrimitives*0.005f);
+            }
 
 	    if ((bvh->device->benchmark || bvh->device->verbosity(1)) && mesh == nullptr) dt = getSeconds()-t0;
 
@@ -187,6 +222,10 @@ namespace embree
     /* entry functions for the scene builder */
     Builder* BVH8Triangle4SceneBuilderSAH  (void* bvh, Scene* scene, size_t mode) { return new BVH8BuilderSAH<TriangleMesh,Triangle4>((BVH8*)bvh,scene,4,4,1.0f,4,inf,mode); }
     Builder* BVH8Triangle8SceneBuilderSAH  (void* bvh, Scene* scene, size_t mode) { return new BVH8BuilderSAH<TriangleMesh,Triangle8>((BVH8*)bvh,scene,8,4,1.0f,8,inf,mode); }
+    Builder* BVH8Triangle4MeshBuilderSAH   (void* bvh, TriangleMesh* mesh, size_t mode) { return new BVH8BuilderSAH<TriangleMesh,Triangle4>((BVH8*)bvh,mesh,4,4,1.0f,4,inf,mode); }
+    Builder* BVH8Quad4vSceneBuilderSAH     (void* bvh, Scene* scene, size_t mode) { return new BVH8BuilderSAH<QuadMesh,Quad4v>((BVH8*)bvh,scene,4,4,1.0f,4,inf,mode); }
+    Builder* BVH8Bezier1vSceneBuilderSAH   (void* bvh, Scene* scene, size_t mode) { return new BVH8BuilderSAH<BezierCurves,Bezier1v>((BVH8*)bvh,scene,1,1,1.0f,1,1,mode); }
+    Builder* BVH8VirtualSceneBuilderSAH    (void* bvh, Scene* scene, size_t mode) { return new BVH8BuilderSAH<AccelSet,Object>((BVH8*)bvh,scene,1,1,1.0f,1,1,mode); }
 
     //Builder* BVH8Triangle8vSceneBuilderSAH  (void* bvh, Scene* scene, size_t mode) { return new BVH8BuilderSAH<TriangleMesh,Triangle8v>((BVH8*)bvh,scene,8,4,1.0f,8,inf,mode); }
 
@@ -267,15 +306,15 @@ namespace embree
       const float intCost;
       const size_t minLeafSize;
       const size_t maxLeafSize;
-      const float presplitFactor;
+      const float replicationFactor;
 
       BVH8BuilderSpatialSAH (BVH8* bvh, Scene* scene, const size_t leafBlockSize, const size_t sahBlockSize, const float intCost, const size_t minLeafSize, const size_t maxLeafSize, const size_t mode)
         : bvh(bvh), scene(scene), mesh(nullptr), sahBlockSize(sahBlockSize), intCost(intCost), minLeafSize(minLeafSize), maxLeafSize(min(maxLeafSize,leafBlockSize*BVH8::maxLeafBlocks)),
-          presplitFactor((mode & MODE_HIGH_QUALITY) ? 1.5f : 1.0f) {}
+          replicationFactor(max(1.0f,float(bvh->device->tri_builder_replication_factor))) {}
 
       BVH8BuilderSpatialSAH (BVH8* bvh, Mesh* mesh, const size_t leafBlockSize, const size_t sahBlockSize, const float intCost, const size_t minLeafSize, const size_t maxLeafSize, const size_t mode)
         : bvh(bvh), scene(nullptr), mesh(mesh), sahBlockSize(sahBlockSize), intCost(intCost), minLeafSize(minLeafSize), maxLeafSize(min(maxLeafSize,leafBlockSize*BVH8::maxLeafBlocks)),
-          presplitFactor((mode & MODE_HIGH_QUALITY) ? 1.5f : 1.0f) {}
+          replicationFactor(max(1.0f,float(bvh->device->tri_builder_replication_factor))) {}
 
       void build(size_t, size_t) 
       {
@@ -286,7 +325,7 @@ namespace embree
           bvh->set(BVH8::emptyNode,empty,0);
           return;
         }
-        const size_t numSplitPrimitives = max(numPrimitives,size_t(presplitFactor*numPrimitives));
+        const size_t numSplitPrimitives = max(numPrimitives,size_t(replicationFactor*numPrimitives));
       
         /* reduction function */
 	auto rotate = [&] (BVH8::Node* node, const size_t* counts, const size_t N) -> size_t
@@ -311,7 +350,7 @@ namespace embree
 
         /* verbose mode */
         if (bvh->device->verbosity(1) && mesh == nullptr)
-	  std::cout << "building BVH8<" << bvh->primTy.name << "> with " << TOSTRING(isa) "::BVH8BuilderSAH (spatial)" << (presplitFactor != 1.0f ? "presplit" : "") << " ... " << std::flush;
+	  std::cout << "building BVH8<" << bvh->primTy.name << "> with " << TOSTRING(isa) "::BVH8BuilderSAH (spatial) ... " << std::flush;
 
 	double t0 = 0.0f, dt = 0.0f;
 #if PROFILE
@@ -347,8 +386,8 @@ namespace embree
               return A;
             },std::plus<double>());
 
-            /* calculate number of maximal spatial splits per primitive */
-            float f = 10.0f;
+            /* distribute the replication budget over the primitives proportional to their surface area */
+            const float f = A > 0.0 ? float((replicationFactor-1.0f)*pinfo.size()/A) : 0.0f;
             iter = prims;
             const size_t N = parallel_reduce(size_t(0),threadCount,size_t(0), [&] (const range<size_t>& r) -> size_t
             {
@@ -357,9 +396,8 @@ namespace embree
                 for (size_t i=0; i<block->size(); i++) {
                   PrimRef& prim = block->at(i);
                   assert((prim.lower.a & 0xFF000000) == 0);
-                  const float nf = ceil(f*pinfo.size()*area(prim.bounds())/A);
-                  //const size_t n = 16;
-                  const size_t n = 4+min(ssize_t(127-4), max(ssize_t(1), ssize_t(nf)));
+                  const float nf = floor(f*area(prim.bounds()));
+                  const size_t n = 1+min(ssize_t(126), ssize_t(nf));
                   N += n;
                   prim.lower.a |= n << 24;
                 }
@@ -0,0 +1,402 @@
+// ======================================================================== //
+// Copyright 2009-2015 Intel Corporation                                    //
+//                                                                          //
+// Licensed under the Apache License, Version 2.0 (the "License");          //
+// you may not use this file except in compliance with the License.         //
+// You may obtain a copy of the License at                                  //
+//                                                                          //
+//     http://www.apache.org/licenses/LICENSE-2.0                           //
+//                                                                          //
+// Unless required by applicable law or agreed to in writing, software      //
+// distributed under the License is distributed on an "AS IS" BASIS,        //
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. //
+// See the License for the specific language governing permissions and      //
+// limitations under the License.                                           //
+// ======================================================================== //
+
+#include "bvh8_builder_twolevel.h"
+#include "bvh8_statistics.h"
+#include "../builders/bvh_builder_sah.h"
+
+#define PROFILE 0
+#define MAX_OPEN_SIZE 10000
+
+namespace embree
+{
+  namespace isa
+  {
+    BVH8BuilderTwoLevel::BVH8BuilderTwoLevel (BVH8* bvh, Scene* scene, const createTriangleMeshAccelTy createTriangleMeshAccel) 
+      : bvh(bvh), objects(bvh->objects), scene(scene), createTriangleMeshAccel(createTriangleMeshAccel), refs(scene->device), prims(scene->device), topSAH(0.0f) {}
+    
+    BVH8BuilderTwoLevel::~BVH8BuilderTwoLevel ()
+    {
+      for (size_t i=0; i<builders.size(); i++) 
+	delete builders[i];
+    }
+
+    void BVH8BuilderTwoLevel::build(size_t threadIndex, size_t threadCount) 
+    {
+      /* delete some objects */
+      size_t N = scene->size();
+      if (N < objects.size()) {
+        parallel_for(N, objects.size(), [&] (const range<size_t>& r) {
+            for (size_t i=r.begin(); i<r.end(); i++) {
+              delete builders[i]; builders[i] = nullptr;
+              delete objects[i]; objects[i] = nullptr;
+            }
+          });
+      }
+
+      /* skip build for empty scene */
+      const size_t numPrimitives = scene->getNumPrimitives<TriangleMesh,1>();
+      if (numPrimitives == 0) {
+        bvh->alloc2.reset();
+        topNodes.clear();
+        prims.resize(0);
+        bvh->set(BVH8::emptyNode,empty,0);
+        return;
+      }
+
+      double t0 = bvh->preBuild(TOSTRING(isa) "::BVH8BuilderTwoLevel");
+
+#if PROFILE
+	profile(2,20,numPrimitives,[&] (ProfileTimer& timer)
+        {
+#endif
+          
+      /* resize object array if scene got larger */
+      if (objects.size()  < N) objects.resize(N);
+      if (builders.size() < N) builders.resize(N);
+      if (refs.size()     < N) refs.resize(N);
+      nextRef = 0;
+
+      /* objects that got rebuilt and objects that contribute to the toplevel BVH */
+      std::vector<char> modified(N,0);
+      std::vector<char> contributing(N,0);
+      
+      /* create of acceleration structures */
+      parallel_for(size_t(0), N, [&] (const range<size_t>& r) 
+      {
+        for (size_t objectID=r.begin(); objectID<r.end(); objectID++)
+        {
+          TriangleMesh* mesh = scene->getTriangleMeshSafe(objectID);
+          
+          /* verify meshes got deleted properly */
+          if (mesh == nullptr || mesh->numTimeSteps != 1) {
+            assert(objectID < objects.size () && objects[objectID] == nullptr);
+            assert(objectID < builders.size() && builders[objectID] == nullptr);
+            continue;
+          }
+          
+          /* delete BVH and builder for meshes that are scheduled for deletion */
+          if (mesh->isErasing()) {
+            delete builders[objectID]; builders[objectID] = nullptr;
+            delete objects [objectID]; objects [objectID] = nullptr;
+            continue;
+          }
+          
+          /* create BVH and builder for new meshes */
+          if (objects[objectID] == nullptr)
+            createTriangleMeshAccel(mesh,(AccelData*&)objects[objectID],builders[objectID]);
+        }
+      });
+
+      /* parallel build of acceleration structures */
+      parallel_for(size_t(0), N, [&] (const range<size_t>& r) 
+      {
+        for (size_t objectID=r.begin(); objectID<r.end(); objectID++)
+        {
+          /* ignore if no triangle mesh or not enabled */
+          TriangleMesh* mesh = scene->getTriangleMeshSafe(objectID);
+          if (mesh == nullptr || !mesh->isEnabled() || mesh->numTimeSteps != 1) 
+            continue;
+        
+          BVH8*    object  = objects [objectID]; assert(object);
+          Builder* builder = builders[objectID]; assert(builder);
+          
+          /* build object if it got modified */
+#if !PROFILE 
+          if (mesh->isModified()) 
+#endif
+          {
+            builder->build(0,0);
+            modified[objectID] = 1;
+          }
+          
+          /* create build primitive */
+          if (!object->bounds.empty()) {
+            refs[nextRef++] = BVH8BuilderTwoLevel::BuildRef(object->bounds,object->root,objectID);
+            contributing[objectID] = 1;
+          }
+        }
+      });
+      
+      /* only refit and partially rebuild the toplevel BVH if the same objects contribute as in the last build */
+      contributing.resize(max(N,topObjects.size()),0);
+      if (!topNodes.empty() && contributing == topObjects && update_toplevel(numPrimitives,modified)) {
+        bvh->alloc2.cleanup();
+        bvh->postBuild(t0);
+        return;
+      }
+
+      /* reset memory allocator */
+      bvh->alloc2.reset();
+      topNodes.clear();
+
+      /* fast path for single geometry scenes */
+      if (nextRef == 1) { 
+        bvh->set(refs[0].node,refs[0].bounds(),numPrimitives);
+        return;
+      }
+
+      /* open all large nodes */
+      refs.resize(nextRef);
+      open_sequential(numPrimitives); 
+      
+      /* fast path for small geometries */
+      if (refs.size() == 1) { 
+        bvh->set(refs[0].node,refs[0].bounds(),numPrimitives);
+        return;
+      }
+
+      /* build toplevel hierarchy */
+      BBox3fa bounds = empty;
+      const BVH8::NodeRef root = build_toplevel(refs.data(),refs.size(),bounds);
+      bvh->set(root,bounds,root == BVH8::emptyNode ? 0 : numPrimitives);
+
+      /* remember the toplevel layout for incremental updates */
+      if (root != BVH8::emptyNode && !root.isLeaf())
+      {
+        std::unordered_map<size_t,unsigned> leafObjects;
+        for (size_t i=0; i<refs.size(); i++) 
+          leafObjects[refs[i].node] = refs[i].objectID;
+        collect_toplevel(leafObjects);
+        refit_toplevel();
+        for (size_t i=0; i<topNodes.size(); i++) topNodes[i].sah0 = topNodes[i].sah;
+        topSAH = topNodes[0].sah;
+        topObjects = contributing;
+      }
+
+#if PROFILE
+      }); 
+#endif
+
+      bvh->alloc2.cleanup();
+      bvh->postBuild(t0);
+    }
+
+    BVH8::NodeRef BVH8BuilderTwoLevel::build_toplevel(const BuildRef* refs, size_t numRefs, BBox3fa& bounds)
+    {
+      /* compute PrimRefs */
+      prims.resize(numRefs);
+      const PrimInfo pinfo = parallel_reduce(size_t(0), numRefs, size_t(1024), PrimInfo(empty), [&] (const range<size_t>& r) -> PrimInfo
+      {
+        PrimInfo pinfo(empty);
+        for (size_t i=r.begin(); i<r.end(); i++) {
+          pinfo.add(refs[i].bounds());
+          prims[i] = PrimRef(refs[i].bounds(),(size_t)refs[i].node);
+        }
+        return pinfo;
+      }, [] (const PrimInfo& a, const PrimInfo& b) { return PrimInfo::merge(a,b); });
+
+      /* skip if all objects where empty */
+      bounds = pinfo.geomBounds;
+      if (pinfo.size() == 0)
+        return BVH8::emptyNode;
+
+      BVH8::NodeRef root;
+      BVHBuilderBinnedSAH::build<BVH8::NodeRef>
+        (root,
+         [&] { return bvh->alloc2.threadLocal2(); },
+         [&] (const isa::BVHBuilderBinnedSAH::BuildRecord& current, BVHBuilderBinnedSAH::BuildRecord* children, const size_t N, FastAllocator::ThreadLocal2* alloc) -> int
+         {
+           BVH8::Node* node = (BVH8::Node*) alloc->alloc0.malloc(sizeof(BVH8::Node),1 << BVH8::alignment); node->clear();
+           for (size_t i=0; i<N; i++) {
+             node->set(i,children[i].pinfo.geomBounds);
+             children[i].parent = (size_t*)&node->child(i);
+           }
+           *current.parent = bvh->encodeNode(node);
+           return 0;
+         },
+         [&] (const BVHBuilderBinnedSAH::BuildRecord& current, FastAllocator::ThreadLocal2* alloc) -> int
+         {
+           assert(current.prims.size() == 1);
+           *current.parent = (BVH8::NodeRef) prims[current.prims.begin()].ID();
+           return 1;
+         },
+         [&] (size_t dn) { bvh->scene->progressMonitor(0); },
+         prims.data(),pinfo,BVH8::N,BVH8::maxBuildDepthLeaf,1,1,1,1.0f,1.0f);
+      return root;
+    }
+
+    void BVH8BuilderTwoLevel::collect_toplevel(const std::unordered_map<size_t,unsigned>& leafObjects)
+    {
+      topNodes.clear();
+      topLeaves.clear();
+      collect_toplevel(bvh->root,-1,0,leafObjects);
+    }
+
+    void BVH8BuilderTwoLevel::collect_toplevel(BVH8::NodeRef ref, ssize_t parent, size_t slot, const std::unordered_map<size_t,unsigned>& leafObjects)
+    {
+      const size_t index = topNodes.size();
+      BVH8::Node* node = ref.node();
+      topNodes.push_back(TopLevelNode(node,parent,slot,topLeaves.size()));
+      for (size_t i=0; i<BVH8::N; i++) 
+      {
+        const BVH8::NodeRef child = node->child(i);
+        if (child == BVH8::emptyNode) continue;
+        auto leaf = leafObjects.find(child);
+        if (leaf != leafObjects.end()) topLeaves.push_back(TopLevelLeaf(index,i,leaf->second));
+        else collect_toplevel(child,index,i,leafObjects);
+      }
+      topNodes[index].end = topNodes.size();
+      topNodes[index].leafEnd = topLeaves.size();
+    }
+
+    /*! surface area of some bounds, that are empty for removed leaves */
+    __forceinline float safeArea(const BBox3fa& bounds) {
+      return bounds.empty() ? 0.0f : area(bounds);
+    }
+
+    BBox3fa BVH8BuilderTwoLevel::refit_toplevel()
+    {
+      for (size_t i=0; i<topNodes.size(); i++) 
+        topNodes[i].sah = 0.0f;
+
+      for (size_t i=0; i<topLeaves.size(); i++) {
+        const TopLevelLeaf& leaf = topLeaves[i];
+        topNodes[leaf.parent].sah += safeArea(topNodes[leaf.parent].node->bounds(leaf.slot));
+      }
+
+      /* children are stored after their parent, thus processing nodes in reverse order refits bottom up */
+      BBox3fa bounds = empty;
+      for (ssize_t i=topNodes.size()-1; i>=0; i--)
+      {
+        TopLevelNode& node = topNodes[i];
+        bounds = node.node->bounds();
+        node.sah += safeArea(bounds);
+        if (node.parent < 0) continue;
+        topNodes[node.parent].node->set(node.slot,bounds);
+        topNodes[node.parent].sah += node.sah;
+      }
+      return bounds;
+    }
+
+    bool BVH8BuilderTwoLevel::update_toplevel(size_t numPrimitives, const std::vector<char>& modified)
+    {
+      /* point the first leaf of each modified object to the new object BVH, and remove the other leaves of the object */
+      std::vector<char> updated(modified.size(),0);
+      for (size_t i=0; i<topLeaves.size(); i++)
+      {
+        const TopLevelLeaf& leaf = topLeaves[i];
+        if (!modified[leaf.objectID]) continue;
+        BVH8::Node* node = topNodes[leaf.parent].node;
+        if (updated[leaf.objectID]) { 
+          node->set(leaf.slot,empty,BVH8::emptyNode);
+        } else {
+          BVH8* object = objects[leaf.objectID];
+          node->set(leaf.slot,object->bounds,object->root);
+          updated[leaf.objectID] = 1;
+        }
+      }
+      BBox3fa bounds = refit_toplevel();
+
+      /* fall back to a full rebuild if the toplevel BVH degraded too much */
+      if (topNodes[0].sah > (1.0f+scene->device->twolevel_max_quality_loss)*topSAH)
+        return false;
+
+      /* rebuild the largest subtrees that degraded */
+      bool rebuilt = false;
+      const float threshold = 1.0f+scene->device->twolevel_subtree_quality_loss;
+      for (size_t i=0; i<topNodes.size(); )
+      {
+        const TopLevelNode& node = topNodes[i];
+        if (node.sah <= threshold*node.sah0) { i++; continue; }
+
+        std::vector<BuildRef> subtreeRefs;
+        for (size_t j=node.leafBegin; j<node.leafEnd; j++) {
+          const TopLevelLeaf& leaf = topLeaves[j];
+          BVH8::Node* parent = topNodes[leaf.parent].node;
+          if (parent->child(leaf.slot) == BVH8::emptyNode) continue;
+          subtreeRefs.push_back(BuildRef(parent->bounds(leaf.slot),parent->child(leaf.slot),leaf.objectID));
+        }
+
+        /* the root has to stay an inner node of the toplevel BVH */
+        if (node.parent < 0 && subtreeRefs.size() <= 1)
+          return false;
+
+        BBox3fa subtreeBounds = empty;
+        const BVH8::NodeRef subtree = build_toplevel(subtreeRefs.data(),subtreeRefs.size(),subtreeBounds);
+        if (node.parent < 0) bvh->root = subtree;
+        else topNodes[node.parent].node->child(node.slot) = subtree;
+        rebuilt = true;
+        i = node.end;
+      }
+
+      /* record the new layout, unchanged subtrees keep their original SAH cost */
+      if (rebuilt)
+      {
+        std::unordered_map<size_t,unsigned> leafObjects;
+        std::unordered_map<BVH8::Node*,float> sah0;
+        for (size_t i=0; i<topLeaves.size(); i++) {
+          const TopLevelLeaf& leaf = topLeaves[i];
+          leafObjects[topNodes[leaf.parent].node->child(leaf.slot)] = leaf.objectID;
+        }
+        for (size_t i=0; i<topNodes.size(); i++) 
+          sah0[topNodes[i].node] = topNodes[i].sah0;
+
+        collect_toplevel(leafObjects);
+        bounds = refit_toplevel();
+        for (size_t i=0; i<topNodes.size(); i++) {
+          auto n = sah0.find(topNodes[i].node);
+          topNodes[i].sah0 = n != sah0.end() ? n->second : topNodes[i].sah;
+        }
+      }
+
+      bvh->set(bvh->root,bounds,numPrimitives);
+      return true;
+    }
+
+    void BVH8BuilderTwoLevel::clear()
+    {
+      for (size_t i=0; i<objects.size(); i++) 
+        if (objects[i]) objects[i]->clear();
+
+      for (size_t i=0; i<builders.size(); i++) 
+	if (builders[i]) builders[i]->clear();
+
+      refs.clear();
+      topNodes.clear();
+    }
+
+    void BVH8BuilderTwoLevel::open_sequential(size_t numPrimitives)
+    {
+      if (refs.size() == 0)
+	return;
+
+      size_t N = min(numPrimitives/200,size_t(MAX_OPEN_SIZE));
+      refs.reserve(N);
+      
+      std::make_heap(refs.begin(),refs.end());
+      while (refs.size()+BVH8::N-1 <= N)
+      {
+        std::pop_heap (refs.begin(),refs.end()); 
+        BVH8::NodeRef ref = refs.back().node;
+        unsigned objectID = refs.back().objectID;
+        if (ref.isLeaf()) break;
+        refs.pop_back();    
+        
+        BVH8::Node* node = ref.node();
+        for (size_t i=0; i<BVH8::N; i++) {
+          if (node->child(i) == BVH8::emptyNode) continue;
+          refs.push_back(BuildRef(node->bounds(i),node->child(i),objectID));
+          std::push_heap (refs.begin(),refs.end()); 
+        }
+      }
+    }
+    
+    Builder* BVH8BuilderTwoLevelSAH (void* bvh, Scene* scene, const createTriangleMeshAccelTy createTriangleMeshAccel) {
+      return new BVH8BuilderTwoLevel((BVH8*)bvh,scene,createTriangleMeshAccel);
+    }
+  }
+}
@@ -0,0 +1,139 @@
+// ======================================================================== //
+// Copyright 2009-2015 Intel Corporation                                    //
+//                                                                          //
+// Licensed under the Apache License, Version 2.0 (the "License");          //
+// you may not use this file except in compliance with the License.         //
+// You may obtain a copy of the License at                                  //
+//                                                                          //
+//     http://www.apache.org/licenses/LICENSE-2.0                           //
+//                                                                          //
+// Unless required by applicable law or agreed to in writing, software      //
+// distributed under the License is distributed on an "AS IS" BASIS,        //
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. //
+// See the License for the specific language governing permissions and      //
+// limitations under the License.                                           //
+// ======================================================================== //
+
+#pragma once
+
+#include "bvh8.h"
+#include "../../common/scene_triangle_mesh.h"
+
+#include <unordered_map>
+
+namespace embree
+{
+  namespace isa
+  {
+    class BVH8BuilderTwoLevel : public Builder
+    {
+      ALIGNED_CLASS;
+    public:
+
+      struct BuildRef
+    {
+    public:
+      __forceinline BuildRef () {}
+      
+      __forceinline BuildRef (const BBox3fa& bounds, BVH8::NodeRef node, unsigned objectID) 
+        : lower(bounds.lower), upper(bounds.upper), node(node), objectID(objectID)
+      {
+        if (node.isLeaf())
+          lower.w = 0.0f;
+        else
+          lower.w = area(this->bounds());
+      }
+      
+      __forceinline BBox3fa bounds () const {
+        return BBox3fa(lower,upper);
+      }
+      
+      friend bool operator< (const BuildRef& a, const BuildRef& b) {
+        return a.lower.w < b.lower.w;
+      }
+      
+    public:
+      Vec3fa lower;
+      Vec3fa upper;
+      BVH8::NodeRef node;
+      unsigned objectID;
+    };
+
+      /*! inner node of the toplevel BVH, stored in depth first order */
+      struct TopLevelNode
+      {
+        __forceinline TopLevelNode (BVH8::Node* node, ssize_t parent, size_t slot, size_t leafBegin) 
+          : node(node), parent(parent), slot(slot), end(0), leafBegin(leafBegin), leafEnd(0), sah(0.0f), sah0(0.0f) {}
+
+      public:
+        BVH8::Node* node;  //!< the node itself
+        ssize_t parent;    //!< index of the parent node, or -1 for the root
+        size_t slot;       //!< child slot of this node inside the parent
+        size_t end;        //!< end of the range of nodes of this subtree
+        size_t leafBegin;  //!< begin of the range of leaves of this subtree
+        size_t leafEnd;    //!< end of the range of leaves of this subtree
+        float sah;         //!< current SAH cost of the subtree
+        float sah0;        //!< SAH cost of the subtree when it got built
+      };
+
+      /*! leaf of the toplevel BVH, references the BVH of some object or one of its subtrees */
+      struct TopLevelLeaf
+      {
+        __forceinline TopLevelLeaf (size_t parent, size_t slot, unsigned objectID) 
+          : parent(parent), slot(slot), objectID(objectID) {}
+
+      public:
+        size_t parent;     //!< index of the node containing this leaf
+        size_t slot;       //!< child slot of this leaf inside the node
+        unsigned objectID; //!< object this leaf belongs to
+      };
+      
+      /*! Constructor. */
+      BVH8BuilderTwoLevel (BVH8* bvh, Scene* scene, const createTriangleMeshAccelTy createTriangleMeshAccel);
+      
+      /*! Destructor */
+      ~BVH8BuilderTwoLevel ();
+      
+      /*! builder entry point */
+      void build(size_t threadIndex, size_t threadCount);
+
+      void clear();
+
+      void open_sequential(size_t numPrimitives);
+
+    private:
+
+      /*! builds the toplevel BVH over some references */
+      BVH8::NodeRef build_toplevel(const BuildRef* refs, size_t numRefs, BBox3fa& bounds);
+
+      /*! records the layout of the toplevel BVH for later incremental updates */
+      void collect_toplevel(const std::unordered_map<size_t,unsigned>& leafObjects);
+      void collect_toplevel(BVH8::NodeRef ref, ssize_t parent, size_t slot, const std::unordered_map<size_t,unsigned>& leafObjects);
+
+      /*! refits the toplevel BVH and calculates the SAH cost of all its subtrees */
+      BBox3fa refit_toplevel();
+
+      /*! updates the toplevel BVH for modified objects, returns false if a full rebuild is required */
+      bool update_toplevel(size_t numPrimitives, const std::vector<char>& modified);
+      
+    public:
+      BVH8* bvh;
+      std::vector<BVH8*>& objects;
+      std::vector<Builder*> builders;
+      
+    public:
+      Scene* scene;
+      createTriangleMeshAccelTy createTriangleMeshAccel;
+      
+      mvector<BuildRef> refs;
+      mvector<PrimRef> prims;
+      AlignedAtomicCounter32 nextRef;
+
+    public:
+      std::vector<TopLevelNode> topNodes;   //!< inner nodes of the toplevel BVH, empty if it cannot get updated incrementally
+      std::vector<TopLevelLeaf> topLeaves;  //!< leaves of the toplevel BVH
+      std::vector<char> topObjects;         //!< objects referenced by the toplevel BVH
+      float topSAH;                         //!< SAH cost of the toplevel BVH after the last full rebuild
+    };
+  }
+}
@@ -15,13 +15,18 @@
 // ======================================================================== //
 
 #include "bvh8_intersector1.h"
+#include "bvh8_intersector_quantized.h"
 #include "../geometry/triangle4.h"
 #include "../geometry/triangle8.h"
 #include "../geometry/triangle8v.h"
+#include "../geometry/quad4v.h"
 #include "../geometry/trianglepairs8.h"
 #include "../geometry/intersector_iterators.h"
+#include "../geometry/bezier1v_intersector.h"
+#include "../geometry/object_intersector1.h"
 #include "../geometry/triangle_intersector_moeller.h"
 #include "../geometry/triangle_intersector_pluecker.h"
+#include "../geometry/quad_intersector_moeller.h"
 //#include "../geometry/triangle_intersector_pluecker2.h"
 
 namespace embree
@@ -343,8 +348,13 @@ namespace embree
     }
 
     DEFINE_INTERSECTOR1(BVH8Triangle4Intersector1Moeller,BVH8Intersector1<false COMMA ArrayIntersector1<TriangleNIntersector1MoellerTrumbore<Triangle4 COMMA true> > >);
+    DEFINE_INTERSECTOR1(BVH8Quad4vIntersector1Moeller,BVH8Intersector1<false COMMA ArrayIntersector1<QuadNIntersector1MoellerTrumbore<Quad4v COMMA true> > >);
     DEFINE_INTERSECTOR1(BVH8Triangle8Intersector1Moeller,BVH8Intersector1<false COMMA ArrayIntersector1<TriangleNIntersector1MoellerTrumbore<Triangle8 COMMA true> > >);
     DEFINE_INTERSECTOR1(BVH8TrianglePairs8Intersector1Moeller,BVH8Intersector1<false COMMA ArrayIntersector1<TrianglePairsNIntersector1MoellerTrumbore<TrianglePairs8 COMMA true> > >);
+    DEFINE_INTERSECTOR1(BVH8Bezier1vIntersector1,BVH8Intersector1<false COMMA ArrayIntersector1<Bezier1vIntersector1> >);
+    DEFINE_INTERSECTOR1(BVH8VirtualIntersector1,BVH8Intersector1<false COMMA ArrayIntersector1<ObjectIntersector1> >);
+
+    DEFINE_INTERSECTOR1(BVH8Triangle4QuantizedIntersector1Moeller,BVH8QuantizedIntersector1<ArrayIntersector1<TriangleNIntersector1MoellerTrumbore<Triangle4 COMMA true> > >);
     
     //DEFINE_INTERSECTOR1(BVH8Triangle8vIntersector1Pluecker,BVH8Intersector1<true COMMA ArrayIntersector1<TriangleNvIntersector1Pluecker2<Triangle8v COMMA true> > >);
   }
@@ -18,6 +18,8 @@
 #include "../geometry/triangle4.h"
 #include "../geometry/triangle8.h"
 #include "../geometry/intersector_iterators.h"
+#include "../geometry/bezier1v_intersector.h"
+#include "../geometry/object_intersector16.h"
 #include "../geometry/triangle_intersector_moeller.h"
 
 #define DBG(x) 
@@ -287,5 +289,7 @@ namespace embree
     
     DEFINE_INTERSECTOR8(BVH8Triangle4Intersector16ChunkMoeller,BVH8Intersector16Chunk<ArrayIntersector16<TriangleNIntersectorMMoellerTrumbore<Ray16 COMMA Triangle4 COMMA true> > >);
     DEFINE_INTERSECTOR8(BVH8Triangle8Intersector16ChunkMoeller,BVH8Intersector16Chunk<ArrayIntersector16<TriangleNIntersectorMMoellerTrumbore<Ray16 COMMA Triangle8 COMMA true> > >);
+    DEFINE_INTERSECTOR16(BVH8Bezier1vIntersector16Chunk,BVH8Intersector16Chunk<ArrayIntersector16<Bezier1vIntersectorN<Ray16> > >);
+    DEFINE_INTERSECTOR16(BVH8VirtualIntersector16Chunk,BVH8Intersector16Chunk<ArrayIntersector16<ObjectIntersector16> >);
   }
 }  
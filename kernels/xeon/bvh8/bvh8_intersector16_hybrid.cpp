@@ -15,12 +15,15 @@
 // ======================================================================== //
 
 #include "bvh8_intersector16_hybrid.h"
+#include "bvh8_intersector_quantized.h"
 #include "../geometry/triangle4.h"
 #include "../geometry/triangle8.h"
 #include "../geometry/triangle8v.h"
+#include "../geometry/quad4v.h"
 #include "../geometry/intersector_iterators.h"
 #include "../geometry/triangle_intersector_moeller.h"
 #include "../geometry/triangle_intersector_pluecker.h"
+#include "../geometry/quad_intersector_moeller.h"
 //#include "../geometry/triangle_intersector_pluecker2.h"
 
 #define DBG(x) 
@@ -631,11 +634,15 @@ namespace embree
     DEFINE_INTERSECTOR8(BVH8Triangle4Intersector16HybridMoeller,BVH8Intersector16Hybrid<false COMMA ArrayIntersector16<TriangleNIntersectorMMoellerTrumbore<Ray16 COMMA Triangle4 COMMA true> > >);
 
     DEFINE_INTERSECTOR8(BVH8Triangle4Intersector16HybridMoellerNoFilter,BVH8Intersector16Hybrid<false COMMA ArrayIntersector16<TriangleNIntersectorMMoellerTrumbore<Ray16 COMMA Triangle4 COMMA false> > >);
+    DEFINE_INTERSECTOR16(BVH8Quad4vIntersector16HybridMoeller,BVH8Intersector16Hybrid<false COMMA ArrayIntersector16<QuadNIntersectorMMoellerTrumbore<Ray16 COMMA Quad4v COMMA true> > >);
+    DEFINE_INTERSECTOR16(BVH8Quad4vIntersector16HybridMoellerNoFilter,BVH8Intersector16Hybrid<false COMMA ArrayIntersector16<QuadNIntersectorMMoellerTrumbore<Ray16 COMMA Quad4v COMMA false> > >);
 
     DEFINE_INTERSECTOR8(BVH8Triangle8Intersector16HybridMoeller,BVH8Intersector16Hybrid<false COMMA ArrayIntersector16<TriangleNIntersectorMMoellerTrumbore<Ray16 COMMA Triangle8 COMMA true> > >);
 
     DEFINE_INTERSECTOR8(BVH8Triangle8Intersector16HybridMoellerNoFilter,BVH8Intersector16Hybrid<false COMMA ArrayIntersector16<TriangleNIntersectorMMoellerTrumbore<Ray16 COMMA Triangle8 COMMA false> > >);
 
+    DEFINE_INTERSECTOR16(BVH8Triangle4QuantizedIntersector16Moeller,BVH8QuantizedIntersector16<ArrayIntersector16<TriangleNIntersectorMMoellerTrumbore<Ray16 COMMA Triangle4 COMMA true> > >);
+
     //DEFINE_INTERSECTOR8(BVH8Triangle8vIntersector16HybridPluecker, BVH8Intersector16Hybrid<true COMMA ArrayIntersector16_1<TriangleNvIntersectorMPluecker2<Ray16 COMMA Triangle8v COMMA true> > >);
     //DEFINE_INTERSECTOR8(BVH8Triangle8vIntersector16HybridPlueckerNoFilter, BVH8Intersector16Hybrid<true COMMA ArrayIntersector16_1<TriangleNvIntersectorMPluecker2<Ray16 COMMA Triangle8v COMMA false> > >);
 
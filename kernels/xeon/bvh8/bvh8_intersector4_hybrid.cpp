@@ -15,12 +15,17 @@
 // ======================================================================== //
 
 #include "bvh8_intersector4_hybrid.h"
+#include "bvh8_intersector_quantized.h"
 #include "../geometry/triangle4.h"
 #include "../geometry/triangle8.h"
 #include "../geometry/triangle8v.h"
+#include "../geometry/quad4v.h"
 #include "../geometry/intersector_iterators.h"
+#include "../geometry/bezier1v_intersector.h"
+#include "../geometry/object_intersector4.h"
 #include "../geometry/triangle_intersector_moeller.h"
 #include "../geometry/triangle_intersector_pluecker.h"
+#include "../geometry/quad_intersector_moeller.h"
 //#include "../geometry/triangle_intersector_pluecker2.h"
 
 #define SWITCH_THRESHOLD 3
@@ -641,10 +646,17 @@ namespace embree
     
     DEFINE_INTERSECTOR4(BVH8Triangle4Intersector4HybridMoeller, BVH8Intersector4Hybrid<ArrayIntersector4_1<TriangleNIntersectorMMoellerTrumbore<Ray4 COMMA Triangle4 COMMA true> > >);
     DEFINE_INTERSECTOR4(BVH8Triangle4Intersector4HybridMoellerNoFilter, BVH8Intersector4Hybrid<ArrayIntersector4_1<TriangleNIntersectorMMoellerTrumbore<Ray4 COMMA Triangle4 COMMA false> > >);
+    DEFINE_INTERSECTOR4(BVH8Quad4vIntersector4HybridMoeller, BVH8Intersector4Hybrid<ArrayIntersector4_1<QuadNIntersectorMMoellerTrumbore<Ray4 COMMA Quad4v COMMA true> > >);
+    DEFINE_INTERSECTOR4(BVH8Quad4vIntersector4HybridMoellerNoFilter, BVH8Intersector4Hybrid<ArrayIntersector4_1<QuadNIntersectorMMoellerTrumbore<Ray4 COMMA Quad4v COMMA false> > >);
 
     DEFINE_INTERSECTOR4(BVH8Triangle8Intersector4HybridMoeller, BVH8Intersector4Hybrid<ArrayIntersector4_1<TriangleNIntersectorMMoellerTrumbore<Ray4 COMMA Triangle8 COMMA true> > >);
     DEFINE_INTERSECTOR4(BVH8Triangle8Intersector4HybridMoellerNoFilter, BVH8Intersector4Hybrid<ArrayIntersector4_1<TriangleNIntersectorMMoellerTrumbore<Ray4 COMMA Triangle8 COMMA false> > >);
 
+    DEFINE_INTERSECTOR4(BVH8Bezier1vIntersector4Hybrid, BVH8Intersector4Hybrid<ArrayIntersector4_1<Bezier1vIntersectorN<Ray4> > >);
+    DEFINE_INTERSECTOR4(BVH8VirtualIntersector4Hybrid, BVH8Intersector4Hybrid<ArrayIntersector4_1<ObjectIntersector4> >);
+
+    DEFINE_INTERSECTOR4(BVH8Triangle4QuantizedIntersector4Moeller, BVH8QuantizedIntersector4<ArrayIntersector4_1<TriangleNIntersectorMMoellerTrumbore<Ray4 COMMA Triangle4 COMMA true> > >);
+
     //DEFINE_INTERSECTOR4(BVH8Triangle8vIntersector4HybridPluecker, BVH8Intersector4Hybrid<ArrayIntersector4_1<TriangleNvIntersectorMPluecker2<Ray4 COMMA Triangle8v COMMA true> > >);
     //DEFINE_INTERSECTOR4(BVH8Triangle8vIntersector4HybridPlueckerNoFilter, BVH8Intersector4Hybrid<ArrayIntersector4_1<TriangleNvIntersectorMPluecker2<Ray4 COMMA Triangle8v COMMA false> > >);
 
@@ -18,6 +18,8 @@
 #include "../geometry/triangle4.h"
 #include "../geometry/triangle8.h"
 #include "../geometry/intersector_iterators.h"
+#include "../geometry/bezier1v_intersector.h"
+#include "../geometry/object_intersector8.h"
 #include "../geometry/triangle_intersector_moeller.h"
 
 #define DBG(x) 
@@ -307,5 +309,7 @@ namespace embree
     
     DEFINE_INTERSECTOR8(BVH8Triangle4Intersector8ChunkMoeller,BVH8Intersector8Chunk<ArrayIntersector8<TriangleNIntersectorMMoellerTrumbore<Ray8 COMMA Triangle4 COMMA true> > >);
     DEFINE_INTERSECTOR8(BVH8Triangle8Intersector8ChunkMoeller,BVH8Intersector8Chunk<ArrayIntersector8<TriangleNIntersectorMMoellerTrumbore<Ray8 COMMA Triangle8 COMMA true> > >);
+    DEFINE_INTERSECTOR8(BVH8Bezier1vIntersector8Chunk,BVH8Intersector8Chunk<ArrayIntersector8<Bezier1vIntersectorN<Ray8> > >);
+    DEFINE_INTERSECTOR8(BVH8VirtualIntersector8Chunk,BVH8Intersector8Chunk<ArrayIntersector8<ObjectIntersector8> >);
   }
 }  
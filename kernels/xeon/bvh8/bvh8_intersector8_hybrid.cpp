@@ -15,12 +15,15 @@
 // ======================================================================== //
 
 #include "bvh8_intersector8_hybrid.h"
+#include "bvh8_intersector_quantized.h"
 #include "../geometry/triangle4.h"
 #include "../geometry/triangle8.h"
 #include "../geometry/triangle8v.h"
+#include "../geometry/quad4v.h"
 #include "../geometry/intersector_iterators.h"
 #include "../geometry/triangle_intersector_moeller.h"
 #include "../geometry/triangle_intersector_pluecker.h"
+#include "../geometry/quad_intersector_moeller.h"
 //#include "../geometry/triangle_intersector_pluecker2.h"
 
 #define DBG(x) 
@@ -705,10 +708,14 @@ namespace embree
 
     DEFINE_INTERSECTOR8(BVH8Triangle4Intersector8HybridMoeller,BVH8Intersector8Hybrid<ArrayIntersector8_1<TriangleNIntersectorMMoellerTrumbore<Ray8 COMMA Triangle4 COMMA true> > >);
     DEFINE_INTERSECTOR8(BVH8Triangle4Intersector8HybridMoellerNoFilter,BVH8Intersector8Hybrid<ArrayIntersector8_1<TriangleNIntersectorMMoellerTrumbore<Ray8 COMMA Triangle4 COMMA false> > >);
+    DEFINE_INTERSECTOR8(BVH8Quad4vIntersector8HybridMoeller,BVH8Intersector8Hybrid<ArrayIntersector8_1<QuadNIntersectorMMoellerTrumbore<Ray8 COMMA Quad4v COMMA true> > >);
+    DEFINE_INTERSECTOR8(BVH8Quad4vIntersector8HybridMoellerNoFilter,BVH8Intersector8Hybrid<ArrayIntersector8_1<QuadNIntersectorMMoellerTrumbore<Ray8 COMMA Quad4v COMMA false> > >);
     
     DEFINE_INTERSECTOR8(BVH8Triangle8Intersector8HybridMoeller,BVH8Intersector8Hybrid<ArrayIntersector8_1<TriangleNIntersectorMMoellerTrumbore<Ray8 COMMA Triangle8 COMMA true> > >);
     DEFINE_INTERSECTOR8(BVH8Triangle8Intersector8HybridMoellerNoFilter,BVH8Intersector8Hybrid<ArrayIntersector8_1<TriangleNIntersectorMMoellerTrumbore<Ray8 COMMA Triangle8 COMMA false> > >);
 
+    DEFINE_INTERSECTOR8(BVH8Triangle4QuantizedIntersector8Moeller,BVH8QuantizedIntersector8<ArrayIntersector8_1<TriangleNIntersectorMMoellerTrumbore<Ray8 COMMA Triangle4 COMMA true> > >);
+
     //DEFINE_INTERSECTOR8(BVH8Triangle8vIntersector8HybridPluecker, BVH8Intersector8Hybrid<ArrayIntersector8_1<TriangleNvIntersectorMPluecker2<Ray8 COMMA Triangle8v COMMA true> > >);
     //DEFINE_INTERSECTOR8(BVH8Triangle8vIntersector8HybridPlueckerNoFilter, BVH8Intersector8Hybrid<ArrayIntersector8_1<TriangleNvIntersectorMPluecker2<Ray8 COMMA Triangle8v COMMA false> > >);
   }
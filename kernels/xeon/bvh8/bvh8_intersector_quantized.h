@@ -0,0 +1,459 @@
+// ======================================================================== //
+// Copyright 2009-2015 Intel Corporation                                    //
+//                                                                          //
+// Licensed under the Apache License, Version 2.0 (the "License");          //
+// you may not use this file except in compliance with the License.         //
+// You may obtain a copy of the License at                                  //
+//                                                                          //
+//     http://www.apache.org/licenses/LICENSE-2.0                           //
+//                                                                          //
+// Unless required by applicable law or agreed to in writing, software      //
+// distributed under the License is distributed on an "AS IS" BASIS,        //
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. //
+// See the License for the specific language governing permissions and      //
+// limitations under the License.                                           //
+// ======================================================================== //
+
+#pragma once
+
+#include "bvh8.h"
+#include "../../common/ray.h"
+#include "../../common/stack_item.h"
+
+#if defined(__SSE__)
+#include "../../common/ray4.h"
+#endif
+
+#if defined(__AVX__)
+#include "../../common/ray8.h"
+#endif
+
+#if defined(__AVX512F__)
+#include "../../common/ray16.h"
+#endif
+
+namespace embree
+{
+  namespace isa
+  {
+    /*! Single ray traversal of a BVH8 with quantized nodes. The
+     *  primitives of a leaf are intersected by the passed closure. */
+    class BVH8QuantizedTraverser1
+    {
+      /* shortcuts for frequently used types */
+      typedef BVH8::NodeRef NodeRef;
+      typedef BVH8::QuantizedNode QuantizedNode;
+      static const size_t stackSize = 1+3*BVH8::maxDepth;
+
+    public:
+
+      /*! Intersects a ray with the 8 children of a quantized node. The
+       *  child bounds are dequantized directly into ray distances. */
+      static __forceinline size_t intersect_node(const QuantizedNode* node, const size_t nearX, const size_t nearY, const size_t nearZ,
+                                                 const Vec3fa& org, const Vec3fa& rdir, const float8& ray_near, const float8& ray_far, float8& dist)
+      {
+        const Vec3fa start(node->start.x,node->start.y,node->start.z);
+        const Vec3fa scale_rdir = node->scale()*rdir;
+        const Vec3fa start_rdir = (start-org)*rdir;
+        const size_t farX  = nearX ^ BVH8::N, farY  = nearY ^ BVH8::N, farZ  = nearZ ^ BVH8::N;
+        const unsigned char* ptr = node->lower_x;
+        const float8 tNearX = madd(float8::load(ptr+nearX), float8(scale_rdir.x), float8(start_rdir.x));
+        const float8 tNearY = madd(float8::load(ptr+nearY), float8(scale_rdir.y), float8(start_rdir.y));
+        const float8 tNearZ = madd(float8::load(ptr+nearZ), float8(scale_rdir.z), float8(start_rdir.z));
+        const float8 tFarX  = madd(float8::load(ptr+farX ), float8(scale_rdir.x), float8(start_rdir.x));
+        const float8 tFarY  = madd(float8::load(ptr+farY ), float8(scale_rdir.y), float8(start_rdir.y));
+        const float8 tFarZ  = madd(float8::load(ptr+farZ ), float8(scale_rdir.z), float8(start_rdir.z));
+
+#if defined(__AVX2__)
+        const float8 tNear = maxi(maxi(tNearX,tNearY),maxi(tNearZ,ray_near));
+        const float8 tFar  = mini(mini(tFarX ,tFarY ),mini(tFarZ ,ray_far ));
+        const bool8 vmask = cast(tNear) > cast(tFar);
+        dist = tNear;
+        return movemask(vmask)^0xff;
+#else
+        const float8 tNear = max(tNearX,tNearY,tNearZ,ray_near);
+        const float8 tFar  = min(tFarX ,tFarY ,tFarZ ,ray_far);
+        const bool8 vmask = tNear <= tFar;
+        dist = tNear;
+        return movemask(vmask);
+#endif
+      }
+
+      template<typename IntersectLeaf>
+      static __forceinline void intersect(const BVH8* bvh, const Vec3fa& org, const Vec3fa& dir, const float tnear, float& tfar, const IntersectLeaf& intersectLeaf)
+      {
+        /*! stack state */
+        StackItemT<NodeRef> stack[stackSize];  //!< stack of nodes
+        StackItemT<NodeRef>* stackPtr = stack+1;        //!< current stack pointer
+        StackItemT<NodeRef>* stackEnd = stack+stackSize;
+        stack[0].ptr = bvh->root;
+        stack[0].dist = neg_inf;
+
+        /*! load the ray into SIMD registers */
+        const Vec3fa rdir = rcp_safe(dir);
+        const float8 ray_near(tnear);
+        float8 ray_far(tfar);
+
+        /*! offsets to select the side that becomes the lower or upper bound */
+        const size_t nearX = rdir.x >= 0.0f ? 0*BVH8::N : 1*BVH8::N;
+        const size_t nearY = rdir.y >= 0.0f ? 2*BVH8::N : 3*BVH8::N;
+        const size_t nearZ = rdir.z >= 0.0f ? 4*BVH8::N : 5*BVH8::N;
+
+        /* pop loop */
+        while (true) pop:
+        {
+          /*! pop next node */
+          if (unlikely(stackPtr == stack)) break;
+          stackPtr--;
+          NodeRef cur = NodeRef(stackPtr->ptr);
+
+          /*! if popped node is too far, pop next one */
+          if (unlikely(*(float*)&stackPtr->dist > tfar))
+            continue;
+
+          /* downtraversal loop */
+          while (true)
+          {
+            /*! stop if we found a leaf */
+            if (unlikely(cur.isLeaf())) break;
+            STAT3(normal.trav_nodes,1,1,1);
+
+            /*! single ray intersection with 8 boxes */
+            const QuantizedNode* node = cur.quantizedNode();
+            float8 tNear;
+            size_t mask = intersect_node(node,nearX,nearY,nearZ,org,rdir,ray_near,ray_far,tNear);
+
+            /*! if no child is hit, pop next node */
+            if (unlikely(mask == 0))
+              goto pop;
+
+            /*! one child is hit, continue with that child */
+            size_t r = __bscf(mask);
+            if (likely(mask == 0)) {
+              cur = node->child(r); cur.prefetch();
+              assert(cur != BVH8::emptyNode);
+              continue;
+            }
+
+            /*! two children are hit, push far child, and continue with closer child */
+            NodeRef c0 = node->child(r); c0.prefetch(); const unsigned int d0 = ((unsigned int*)&tNear)[r];
+            r = __bscf(mask);
+            NodeRef c1 = node->child(r); c1.prefetch(); const unsigned int d1 = ((unsigned int*)&tNear)[r];
+            assert(c0 != BVH8::emptyNode);
+            assert(c1 != BVH8::emptyNode);
+            if (likely(mask == 0)) {
+              assert(stackPtr < stackEnd);
+              if (d0 < d1) { stackPtr->ptr = c1; stackPtr->dist = d1; stackPtr++; cur = c0; continue; }
+              else         { stackPtr->ptr = c0; stackPtr->dist = d0; stackPtr++; cur = c1; continue; }
+            }
+
+            /*! Here starts the slow path for 3 or more hit children. We push
+             *  all nodes onto the stack to sort them there. */
+            assert(stackPtr < stackEnd);
+            stackPtr->ptr = c0; stackPtr->dist = d0; stackPtr++;
+            assert(stackPtr < stackEnd);
+            stackPtr->ptr = c1; stackPtr->dist = d1; stackPtr++;
+
+            /*! three children are hit, push all onto stack and sort 3 stack items, continue with closest child */
+            assert(stackPtr < stackEnd);
+            r = __bscf(mask);
+            NodeRef c = node->child(r); c.prefetch(); unsigned int d = ((unsigned int*)&tNear)[r]; stackPtr->ptr = c; stackPtr->dist = d; stackPtr++;
+            assert(c != BVH8::emptyNode);
+            if (likely(mask == 0)) {
+              sort(stackPtr[-1],stackPtr[-2],stackPtr[-3]);
+              cur = (NodeRef) stackPtr[-1].ptr; stackPtr--;
+              continue;
+            }
+
+            /*! four children are hit, push all onto stack and sort 4 stack items, continue with closest child */
+            r = __bscf(mask);
+            c = node->child(r); c.prefetch(); d = ((unsigned int*)&tNear)[r]; stackPtr->ptr = c; stackPtr->dist = d; stackPtr++;
+            if (likely(mask == 0)) {
+              sort(stackPtr[-1],stackPtr[-2],stackPtr[-3],stackPtr[-4]);
+              cur = (NodeRef) stackPtr[-1].ptr; stackPtr--;
+              continue;
+            }
+
+            /*! fallback case if more than 4 children are hit */
+            while (1)
+            {
+              r = __bscf(mask);
+              assert(stackPtr < stackEnd);
+              c = node->child(r); c.prefetch(); d = ((unsigned int*)&tNear)[r]; stackPtr->ptr = c; stackPtr->dist = d; stackPtr++;
+              if (unlikely(mask == 0)) break;
+            }
+            cur = (NodeRef) stackPtr[-1].ptr; stackPtr--;
+          }
+
+          /*! this is a leaf node */
+          assert(cur != BVH8::emptyNode);
+          STAT3(normal.trav_leaves,1,1,1);
+          size_t num; char* prim = cur.leaf(num);
+          size_t lazy_node = 0;
+          intersectLeaf(prim,num,lazy_node);
+          ray_far = tfar;
+          if (unlikely(lazy_node)) {
+            stackPtr->ptr = lazy_node;
+            stackPtr->dist = inf;
+            stackPtr++;
+          }
+        }
+      }
+
+      template<typename OccludedLeaf>
+      static __forceinline bool occluded(const BVH8* bvh, const Vec3fa& org, const Vec3fa& dir, const float tnear, const float tfar, const OccludedLeaf& occludedLeaf)
+      {
+        /*! stack state */
+        NodeRef stack[stackSize];  //!< stack of nodes that still need to get traversed
+        NodeRef* stackPtr = stack+1;        //!< current stack pointer
+        NodeRef* stackEnd = stack+stackSize;
+        stack[0] = bvh->root;
+
+        /*! load the ray into SIMD registers */
+        const Vec3fa rdir = rcp_safe(dir);
+        const float8 ray_near(tnear);
+        const float8 ray_far(tfar);
+
+        /*! offsets to select the side that becomes the lower or upper bound */
+        const size_t nearX = rdir.x >= 0.0f ? 0*BVH8::N : 1*BVH8::N;
+        const size_t nearY = rdir.y >= 0.0f ? 2*BVH8::N : 3*BVH8::N;
+        const size_t nearZ = rdir.z >= 0.0f ? 4*BVH8::N : 5*BVH8::N;
+
+        /* pop loop */
+        while (true) pop:
+        {
+          /*! pop next node */
+          if (unlikely(stackPtr == stack)) break;
+          stackPtr--;
+          NodeRef cur = (NodeRef) *stackPtr;
+
+          /* downtraversal loop */
+          while (true)
+          {
+            /*! stop if we found a leaf */
+            if (unlikely(cur.isLeaf())) break;
+            STAT3(shadow.trav_nodes,1,1,1);
+
+            /*! single ray intersection with 8 boxes */
+            const QuantizedNode* node = cur.quantizedNode();
+            float8 tNear;
+            size_t mask = intersect_node(node,nearX,nearY,nearZ,org,rdir,ray_near,ray_far,tNear);
+
+            /*! if no child is hit, pop next node */
+            if (unlikely(mask == 0))
+              goto pop;
+
+            /*! one child is hit, continue with that child */
+            size_t r = __bscf(mask);
+            if (likely(mask == 0)) {
+              cur = node->child(r); cur.prefetch();
+              assert(cur != BVH8::emptyNode);
+              continue;
+            }
+
+            /*! two children are hit, push far child, and continue with closer child */
+            NodeRef c0 = node->child(r); c0.prefetch(); const unsigned int d0 = ((unsigned int*)&tNear)[r];
+            r = __bscf(mask);
+            NodeRef c1 = node->child(r); c1.prefetch(); const unsigned int d1 = ((unsigned int*)&tNear)[r];
+            assert(c0 != BVH8::emptyNode);
+            assert(c1 != BVH8::emptyNode);
+            if (likely(mask == 0)) {
+              assert(stackPtr < stackEnd);
+              if (d0 < d1) { *stackPtr = c1; stackPtr++; cur = c0; continue; }
+              else         { *stackPtr = c0; stackPtr++; cur = c1; continue; }
+            }
+            assert(stackPtr < stackEnd);
+            *stackPtr = c0; stackPtr++;
+            assert(stackPtr < stackEnd);
+            *stackPtr = c1; stackPtr++;
+
+            /*! push all remaining hit children and continue with the last one */
+            while (1)
+            {
+              r = __bscf(mask);
+              assert(stackPtr < stackEnd);
+              NodeRef c = node->child(r); c.prefetch(); *stackPtr = c; stackPtr++;
+              if (unlikely(mask == 0)) break;
+            }
+            cur = (NodeRef) stackPtr[-1]; stackPtr--;
+          }
+
+          /*! this is a leaf node */
+          assert(cur != BVH8::emptyNode);
+          STAT3(shadow.trav_leaves,1,1,1);
+          size_t num; char* prim = cur.leaf(num);
+          size_t lazy_node = 0;
+          if (occludedLeaf(prim,num,lazy_node))
+            return true;
+
+          if (unlikely(lazy_node)) {
+            *stackPtr = (NodeRef)lazy_node;
+            stackPtr++;
+          }
+        }
+        return false;
+      }
+    };
+
+    /*! BVH8 single ray traversal implementation for quantized nodes. */
+    template<typename PrimitiveIntersector>
+      class BVH8QuantizedIntersector1
+    {
+      typedef typename PrimitiveIntersector::Precalculations Precalculations;
+      typedef typename PrimitiveIntersector::Primitive Primitive;
+
+    public:
+      static void intersect(const BVH8* bvh, Ray& ray)
+      {
+        /* filter out invalid rays */
+#if defined(RTCORE_IGNORE_INVALID_RAYS)
+        if (!ray.valid()) return;
+#endif
+        assert(ray.tnear > -FLT_MIN);
+        Precalculations pre(ray,bvh);
+        BVH8QuantizedTraverser1::intersect(bvh,ray.org,ray.dir,ray.tnear,ray.tfar,[&] (char* prim, size_t num, size_t& lazy_node) {
+            PrimitiveIntersector::intersect(pre,ray,(Primitive*)prim,num,bvh->scene,lazy_node);
+          });
+        AVX_ZERO_UPPER();
+      }
+
+      static void occluded(const BVH8* bvh, Ray& ray)
+      {
+        /* filter out invalid rays */
+#if defined(RTCORE_IGNORE_INVALID_RAYS)
+        if (!ray.valid()) return;
+#endif
+        assert(ray.tnear > -FLT_MIN);
+        Precalculations pre(ray,bvh);
+        if (BVH8QuantizedTraverser1::occluded(bvh,ray.org,ray.dir,ray.tnear,ray.tfar,[&] (char* prim, size_t num, size_t& lazy_node) {
+              return PrimitiveIntersector::occluded(pre,ray,(Primitive*)prim,num,bvh->scene,lazy_node);
+            }))
+          ray.geomID = 0;
+        AVX_ZERO_UPPER();
+      }
+    };
+
+    /*! Traces the active rays of a packet one after the other through a BVH8 with quantized nodes. */
+    template<typename vbool, typename RayK, typename PrimitiveIntersectorK>
+      static __forceinline void intersectQuantizedK(const vbool& valid, const BVH8* bvh, RayK& ray)
+    {
+      typedef typename PrimitiveIntersectorK::Primitive Primitive;
+      typename PrimitiveIntersectorK::Precalculations pre(valid,ray);
+      size_t bits = movemask(valid);
+      for (size_t k=__bsf(bits); bits!=0; bits=__btc(bits,k), k=__bsf(bits))
+      {
+        const Vec3fa org(ray.org.x[k],ray.org.y[k],ray.org.z[k]);
+        const Vec3fa dir(ray.dir.x[k],ray.dir.y[k],ray.dir.z[k]);
+        BVH8QuantizedTraverser1::intersect(bvh,org,dir,ray.tnear[k],ray.tfar[k],[&] (char* prim, size_t num, size_t& lazy_node) {
+            PrimitiveIntersectorK::intersect(pre,ray,k,(Primitive*)prim,num,bvh->scene,lazy_node);
+          });
+      }
+      AVX_ZERO_UPPER();
+    }
+
+    template<typename vbool, typename RayK, typename PrimitiveIntersectorK>
+      static __forceinline void occludedQuantizedK(const vbool& valid, const BVH8* bvh, RayK& ray)
+    {
+      typedef typename PrimitiveIntersectorK::Primitive Primitive;
+      typename PrimitiveIntersectorK::Precalculations pre(valid,ray);
+      size_t bits = movemask(valid);
+      for (size_t k=__bsf(bits); bits!=0; bits=__btc(bits,k), k=__bsf(bits))
+      {
+        const Vec3fa org(ray.org.x[k],ray.org.y[k],ray.org.z[k]);
+        const Vec3fa dir(ray.dir.x[k],ray.dir.y[k],ray.dir.z[k]);
+        if (BVH8QuantizedTraverser1::occluded(bvh,org,dir,ray.tnear[k],ray.tfar[k],[&] (char* prim, size_t num, size_t& lazy_node) {
+              return PrimitiveIntersectorK::occluded(pre,ray,k,(Primitive*)prim,num,bvh->scene,lazy_node);
+            }))
+          ray.geomID[k] = 0;
+      }
+      AVX_ZERO_UPPER();
+    }
+
+#if defined(__SSE__)
+
+    /*! BVH8 ray packet traversal implementation for quantized nodes. */
+    template<typename PrimitiveIntersector4>
+      class BVH8QuantizedIntersector4
+    {
+    public:
+      static void intersect(bool4* valid_i, BVH8* bvh, Ray4& ray)
+      {
+        bool4 valid = *valid_i;
+#if defined(RTCORE_IGNORE_INVALID_RAYS)
+        valid &= ray.valid();
+#endif
+        assert(all(valid,ray.tnear > -FLT_MIN));
+        intersectQuantizedK<bool4,Ray4,PrimitiveIntersector4>(valid,bvh,ray);
+      }
+
+      static void occluded(bool4* valid_i, BVH8* bvh, Ray4& ray)
+      {
+        bool4 valid = *valid_i;
+#if defined(RTCORE_IGNORE_INVALID_RAYS)
+        valid &= ray.valid();
+#endif
+        assert(all(valid,ray.tnear > -FLT_MIN));
+        occludedQuantizedK<bool4,Ray4,PrimitiveIntersector4>(valid,bvh,ray);
+      }
+    };
+#endif
+
+#if defined(__AVX__)
+
+    /*! BVH8 ray packet traversal implementation for quantized nodes. */
+    template<typename PrimitiveIntersector8>
+      class BVH8QuantizedIntersector8
+    {
+    public:
+      static void intersect(bool8* valid_i, BVH8* bvh, Ray8& ray)
+      {
+        bool8 valid = *valid_i;
+#if defined(RTCORE_IGNORE_INVALID_RAYS)
+        valid &= ray.valid();
+#endif
+        assert(all(valid,ray.tnear > -FLT_MIN));
+        intersectQuantizedK<bool8,Ray8,PrimitiveIntersector8>(valid,bvh,ray);
+      }
+
+      static void occluded(bool8* valid_i, BVH8* bvh, Ray8& ray)
+      {
+        bool8 valid = *valid_i;
+#if defined(RTCORE_IGNORE_INVALID_RAYS)
+        valid &= ray.valid();
+#endif
+        assert(all(valid,ray.tnear > -FLT_MIN));
+        occludedQuantizedK<bool8,Ray8,PrimitiveIntersector8>(valid,bvh,ray);
+      }
+    };
+#endif
+
+#if defined(__AVX512F__)
+
+    /*! BVH8 ray packet traversal implementation for quantized nodes. */
+    template<typename PrimitiveIntersector16>
+      class BVH8QuantizedIntersector16
+    {
+    public:
+      static void intersect(int16* valid_i, BVH8* bvh, Ray16& ray)
+      {
+        bool16 valid = *valid_i == -1;
+#if defined(RTCORE_IGNORE_INVALID_RAYS)
+        valid &= ray.valid();
+#endif
+        assert(all(valid,ray.tnear > -FLT_MIN));
+        intersectQuantizedK<bool16,Ray16,PrimitiveIntersector16>(valid,bvh,ray);
+      }
+
+      static void occluded(int16* valid_i, BVH8* bvh, Ray16& ray)
+      {
+        bool16 valid = *valid_i == -1;
+#if defined(RTCORE_IGNORE_INVALID_RAYS)
+        valid &= ray.valid();
+#endif
+        assert(all(valid,ray.tnear > -FLT_MIN));
+        occludedQuantizedK<bool16,Ray16,PrimitiveIntersector16>(valid,bvh,ray);
+      }
+    };
+#endif
+  }
+}
@@ -31,7 +31,7 @@ namespace embree
 
   size_t BVH8Statistics::bytesUsed()
   {
-    size_t bytesNodes = numNodes*sizeof(Node);
+    size_t bytesNodes = numNodes*(bvh->quantized ? sizeof(QuantizedNode) : sizeof(Node));
     size_t bytesTris  = numPrimBlocks*bvh->primTy.bytes;
     size_t numVertices = bvh->numVertices;
     size_t bytesVertices = numVertices*sizeof(Vec3fa); 
@@ -41,7 +41,7 @@ namespace embree
   std::string BVH8Statistics::str()  
   {
     std::ostringstream stream;
-    size_t bytesNodes = numNodes*sizeof(Node);
+    size_t bytesNodes = numNodes*(bvh->quantized ? sizeof(QuantizedNode) : sizeof(Node));
     size_t bytesTris  = numPrimBlocks*bvh->primTy.bytes;
     size_t numVertices = bvh->numVertices;
     size_t bytesVertices = numVertices*sizeof(Vec3fa); 
@@ -84,16 +84,17 @@ namespace embree
       numNodes++;
       depth = 0;
       size_t cdepth = 0;
-      Node* n = node.node();
+      const NodeRef* children = bvh->quantized ? node.quantizedNode()->children : node.node()->children;
       bvhSAH += A*BVH8::travCost;
       for (size_t i=0; i<BVH8::N; i++) {
-        statistics(n->child(i),n->bounds(i),cdepth); 
+        const BBox3fa cbounds = bvh->quantized ? node.quantizedNode()->bounds(i) : node.node()->bounds(i);
+        statistics(children[i],cbounds,cdepth); 
         depth=max(depth,cdepth);
       }
       for (size_t i=0; i<BVH8::N; i++) {
-        if (n->child(i) == BVH8::emptyNode) {
+        if (children[i] == BVH8::emptyNode) {
           for (; i<BVH8::N; i++) {
-            if (n->child(i) != BVH8::emptyNode)
+            if (children[i] != BVH8::emptyNode)
 	      THROW_RUNTIME_ERROR("invalid node");
           }
           break;
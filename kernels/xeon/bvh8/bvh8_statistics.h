@@ -23,6 +23,7 @@ namespace embree
   class BVH8Statistics 
   {
     typedef BVH8::Node Node;
+    typedef BVH8::QuantizedNode QuantizedNode;
     typedef BVH8::NodeRef NodeRef;
 
   public:
@@ -111,38 +111,20 @@ namespace embree
       static __forceinline void intersect(Precalculations& pre, Ray& ray, const Primitive& curve, Scene* scene)
       {
         const BezierCurves* in = (BezierCurves*) scene->get(curve.geomID());
-        const Vec3fa a0 = in->vertex(curve.vertexID+0,0);
-        const Vec3fa a1 = in->vertex(curve.vertexID+1,0);
-        const Vec3fa a2 = in->vertex(curve.vertexID+2,0);
-        const Vec3fa a3 = in->vertex(curve.vertexID+3,0);
-        const Vec3fa b0 = in->vertex(curve.vertexID+0,1);
-        const Vec3fa b1 = in->vertex(curve.vertexID+1,1);
-        const Vec3fa b2 = in->vertex(curve.vertexID+2,1);
-        const Vec3fa b3 = in->vertex(curve.vertexID+3,1);
-        const float t0 = 1.0f-ray.time, t1 = ray.time;
-        const Vec3fa p0 = t0*a0 + t1*b0;
-        const Vec3fa p1 = t0*a1 + t1*b1;
-        const Vec3fa p2 = t0*a2 + t1*b2;
-        const Vec3fa p3 = t0*a3 + t1*b3;
+        const Vec3fa p0 = in->interpolateVertex(curve.vertexID+0,ray.time);
+        const Vec3fa p1 = in->interpolateVertex(curve.vertexID+1,ray.time);
+        const Vec3fa p2 = in->interpolateVertex(curve.vertexID+2,ray.time);
+        const Vec3fa p3 = in->interpolateVertex(curve.vertexID+3,ray.time);
         Bezier1Intersector1::intersect(ray,pre,p0,p1,p2,p3,curve.geomID(),curve.primID(),scene);
       }
       
       static __forceinline bool occluded(Precalculations& pre, Ray& ray, const Primitive& curve, Scene* scene) 
       {
         const BezierCurves* in = (BezierCurves*) scene->get(curve.geomID());
-        const Vec3fa a0 = in->vertex(curve.vertexID+0,0);
-        const Vec3fa a1 = in->vertex(curve.vertexID+1,0);
-        const Vec3fa a2 = in->vertex(curve.vertexID+2,0);
-        const Vec3fa a3 = in->vertex(curve.vertexID+3,0);
-        const Vec3fa b0 = in->vertex(curve.vertexID+0,1);
-        const Vec3fa b1 = in->vertex(curve.vertexID+1,1);
-        const Vec3fa b2 = in->vertex(curve.vertexID+2,1);
-        const Vec3fa b3 = in->vertex(curve.vertexID+3,1);
-        const float t0 = 1.0f-ray.time, t1 = ray.time;
-        const Vec3fa p0 = t0*a0 + t1*b0;
-        const Vec3fa p1 = t0*a1 + t1*b1;
-        const Vec3fa p2 = t0*a2 + t1*b2;
-        const Vec3fa p3 = t0*a3 + t1*b3;
+        const Vec3fa p0 = in->interpolateVertex(curve.vertexID+0,ray.time);
+        const Vec3fa p1 = in->interpolateVertex(curve.vertexID+1,ray.time);
+        const Vec3fa p2 = in->interpolateVertex(curve.vertexID+2,ray.time);
+        const Vec3fa p3 = in->interpolateVertex(curve.vertexID+3,ray.time);
         return Bezier1Intersector1::occluded(ray,pre,p0,p1,p2,p3,curve.geomID(),curve.primID(),scene);
       }
     };
@@ -156,38 +138,20 @@ namespace embree
       static __forceinline void intersect(Precalculations& pre, RayN& ray, const size_t k, const Primitive& curve, Scene* scene)
       {
         const BezierCurves* in = (BezierCurves*) scene->get(curve.geomID());
-        const Vec3fa a0 = in->vertex(curve.vertexID+0,0);
-        const Vec3fa a1 = in->vertex(curve.vertexID+1,0);
-        const Vec3fa a2 = in->vertex(curve.vertexID+2,0);
-        const Vec3fa a3 = in->vertex(curve.vertexID+3,0);
-        const Vec3fa b0 = in->vertex(curve.vertexID+0,1);
-        const Vec3fa b1 = in->vertex(curve.vertexID+1,1);
-        const Vec3fa b2 = in->vertex(curve.vertexID+2,1);
-        const Vec3fa b3 = in->vertex(curve.vertexID+3,1);
-        const float t0 = 1.0f-ray.time[k], t1 = ray.time[k];
-        const Vec3fa p0 = t0*a0 + t1*b0;
-        const Vec3fa p1 = t0*a1 + t1*b1;
-        const Vec3fa p2 = t0*a2 + t1*b2;
-        const Vec3fa p3 = t0*a3 + t1*b3;
+        const Vec3fa p0 = in->interpolateVertex(curve.vertexID+0,ray.time[k]);
+        const Vec3fa p1 = in->interpolateVertex(curve.vertexID+1,ray.time[k]);
+        const Vec3fa p2 = in->interpolateVertex(curve.vertexID+2,ray.time[k]);
+        const Vec3fa p3 = in->interpolateVertex(curve.vertexID+3,ray.time[k]);
         Bezier1IntersectorN<RayN>::intersect(pre,ray,k,p0,p1,p2,p3,curve.geomID(),curve.primID(),scene);
       }
       
       static __forceinline bool occluded(Precalculations& pre, RayN& ray, const size_t k, const Primitive& curve, Scene* scene) 
       {
         const BezierCurves* in = (BezierCurves*) scene->get(curve.geomID());
-        const Vec3fa a0 = in->vertex(curve.vertexID+0,0);
-        const Vec3fa a1 = in->vertex(curve.vertexID+1,0);
-        const Vec3fa a2 = in->vertex(curve.vertexID+2,0);
-        const Vec3fa a3 = in->vertex(curve.vertexID+3,0);
-        const Vec3fa b0 = in->vertex(curve.vertexID+0,1);
-        const Vec3fa b1 = in->vertex(curve.vertexID+1,1);
-        const Vec3fa b2 = in->vertex(curve.vertexID+2,1);
-        const Vec3fa b3 = in->vertex(curve.vertexID+3,1);
-        const float t0 = 1.0f-ray.time[k], t1 = ray.time[k];
-        const Vec3fa p0 = t0*a0 + t1*b0;
-        const Vec3fa p1 = t0*a1 + t1*b1;
-        const Vec3fa p2 = t0*a2 + t1*b2;
-        const Vec3fa p3 = t0*a3 + t1*b3;
+        const Vec3fa p0 = in->interpolateVertex(curve.vertexID+0,ray.time[k]);
+        const Vec3fa p1 = in->interpolateVertex(curve.vertexID+1,ray.time[k]);
+        const Vec3fa p2 = in->interpolateVertex(curve.vertexID+2,ray.time[k]);
+        const Vec3fa p3 = in->interpolateVertex(curve.vertexID+3,ray.time[k]);
         return Bezier1IntersectorN<RayN>::occluded(pre,ray,k,p0,p1,p2,p3,curve.geomID(),curve.primID(),scene);
       }
     };
@@ -0,0 +1,129 @@
+// ======================================================================== //
+// Copyright 2009-2015 Intel Corporation                                    //
+//                                                                          //
+// Licensed under the Apache License, Version 2.0 (the "License");          //
+// you may not use this file except in compliance with the License.         //
+// You may obtain a copy of the License at                                  //
+//                                                                          //
+//     http://www.apache.org/licenses/LICENSE-2.0                           //
+//                                                                          //
+// Unless required by applicable law or agreed to in writing, software      //
+// distributed under the License is distributed on an "AS IS" BASIS,        //
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. //
+// See the License for the specific language governing permissions and      //
+// limitations under the License.                                           //
+// ======================================================================== //
+
+#pragma once
+
+#include "primitive.h"
+
+namespace embree
+{
+  /*! Instance leaf that stores the world to local transformation
+   *  inline, such that the ray can get transformed without touching
+   *  the instance geometry. */
+  struct InstancePrimitive
+  {
+    struct Type : public PrimitiveType 
+    {
+      Type ();
+      size_t size(const char* This) const;
+    };
+    static Type type;
+
+  public:
+
+    /*! returns required number of primitive blocks for N primitives */
+    static __forceinline size_t blocks(size_t N) { return N; }
+
+    /*! fill instance from instance list */
+    __forceinline void fill(const PrimRef* prims, size_t& i, size_t end, Scene* scene, const bool list)
+    {
+      const PrimRef& prim = prims[i]; i++;
+      Instance* instance = (Instance*) scene->get(prim.geomID());
+      world2local = instance->getWorld2Local(prim.primID());
+      object = instance->object;
+      instID = instance->getInstID(prim.primID());
+      mask = instance->getMask(prim.primID());
+    }
+
+  public:
+    AffineSpace3fa world2local; //!< transforms from world space to local space
+    Accel* object;              //!< pointer to instanced acceleration structure
+    unsigned instID;            //!< ID of the instance
+    unsigned mask;              //!< ray mask of the instance
+  };
+
+  /*! Motion blurred instance leaf that stores the local to world
+   *  transformations at the start and end of the time range the BVH
+   *  got built for, such that the transformation is linear over the
+   *  ray time. */
+  struct InstancePrimitiveMB
+  {
+    struct Type : public PrimitiveType 
+    {
+      Type ();
+      size_t size(const char* This) const;
+    };
+    static Type type;
+
+  public:
+
+    /*! returns required number of primitive blocks for N primitives */
+    static __forceinline size_t blocks(size_t N) { return N; }
+
+    /*! fill instance from instance list, returns the bounds at the start and end of the time range */
+    __forceinline std::pair<BBox3fa,BBox3fa> fill(const PrimRef* prims, size_t& i, size_t end, Scene* scene, const BBox1f& time_range, const bool list)
+    {
+      const PrimRef& prim = prims[i]; i++;
+      Instance* instance = (Instance*) scene->get(prim.geomID());
+      local2world0 = instance->getLocal2World(prim.primID(),time_range.lower);
+      local2world1 = instance->getLocal2World(prim.primID(),time_range.upper);
+      object = instance->object;
+      instID = instance->getInstID(prim.primID());
+      mask = instance->getMask(prim.primID());
+      return std::make_pair(xfmBounds(local2world0,object->bounds),xfmBounds(local2world1,object->bounds));
+    }
+
+    /*! returns the world to local transformation for some time */
+    __forceinline AffineSpace3fa getWorld2Local(float time) const {
+      return rcp((1.0f-time)*local2world0 + time*local2world1);
+    }
+
+    /*! returns the world to local transformations for a packet of times */
+    template<typename AffineSpaceK, typename floatK>
+      __forceinline AffineSpaceK getWorld2Local(const floatK& time) const {
+      return rcp((floatK(1.0f)-time)*AffineSpaceK(local2world0) + time*AffineSpaceK(local2world1));
+    }
+
+  public:
+    AffineSpace3fa local2world0; //!< transforms from local space to world space at the start of the time range
+    AffineSpace3fa local2world1; //!< transforms from local space to world space at the end of the time range
+    Accel* object;               //!< pointer to instanced acceleration structure
+    unsigned instID;             //!< ID of the instance
+    unsigned mask;               //!< ray mask of the instance
+  };
+
+  /*! gathers the world to local transformation of some instance for
+   *  the time of each active ray of a packet */
+  template<typename AffineSpaceK, typename boolK, typename floatK>
+    __forceinline AffineSpaceK getWorld2LocalK(const boolK& valid, const Instance* instance, size_t item, const floatK& time)
+  {
+    if (instance->numTimeSteps == 1) 
+      return AffineSpaceK(instance->getWorld2Local(item));
+
+    AffineSpaceK local2world(one);
+    const size_t m = movemask(valid);
+    for (size_t k=0; k<floatK::size; k++) 
+    {
+      if (((m >> k) & 1) == 0) continue;
+      const AffineSpace3fa xfm = instance->getLocal2World(item,time[k]);
+      local2world.l.vx.x[k] = xfm.l.vx.x; local2world.l.vx.y[k] = xfm.l.vx.y; local2world.l.vx.z[k] = xfm.l.vx.z;
+      local2world.l.vy.x[k] = xfm.l.vy.x; local2world.l.vy.y[k] = xfm.l.vy.y; local2world.l.vy.z[k] = xfm.l.vy.z;
+      local2world.l.vz.x[k] = xfm.l.vz.x; local2world.l.vz.y[k] = xfm.l.vz.y; local2world.l.vz.z[k] = xfm.l.vz.z;
+      local2world.p   .x[k] = xfm.p   .x; local2world.p   .y[k] = xfm.p   .y; local2world.p   .z[k] = xfm.p   .z;
+    }
+    return rcp(local2world);
+  }
+}
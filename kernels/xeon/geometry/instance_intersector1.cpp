@@ -20,54 +20,31 @@ namespace embree
 {
   namespace isa
   {
-    void InstanceBoundsFunction(const Instance* instance, size_t item, BBox3fa& bounds_o)
+    void InstanceBoundsFunction(Instance* instance, size_t item, BBox3fa& bounds_o)
     {
-      Vec3fa lower = instance->object->bounds.lower;
-      Vec3fa upper = instance->object->bounds.upper;
-      AffineSpace3fa local2world = instance->local2world;
-      Vec3fa p000 = xfmPoint(local2world,Vec3fa(lower.x,lower.y,lower.z));
-      Vec3fa p001 = xfmPoint(local2world,Vec3fa(lower.x,lower.y,upper.z));
-      Vec3fa p010 = xfmPoint(local2world,Vec3fa(lower.x,upper.y,lower.z));
-      Vec3fa p011 = xfmPoint(local2world,Vec3fa(lower.x,upper.y,upper.z));
-      Vec3fa p100 = xfmPoint(local2world,Vec3fa(upper.x,lower.y,lower.z));
-      Vec3fa p101 = xfmPoint(local2world,Vec3fa(upper.x,lower.y,upper.z));
-      Vec3fa p110 = xfmPoint(local2world,Vec3fa(upper.x,upper.y,lower.z));
-      Vec3fa p111 = xfmPoint(local2world,Vec3fa(upper.x,upper.y,upper.z));
-      bounds_o.lower = min(min(min(p000,p001),min(p010,p011)),min(min(p100,p101),min(p110,p111)));
-      bounds_o.upper = max(max(max(p000,p001),max(p010,p011)),max(max(p100,p101),max(p110,p111)));
+      /* instances of an array without transformations are invalid */
+      if (instance->isArray && !instance->transforms) {
+        bounds_o = empty;
+        return;
+      }
+      if (instance->numTimeSteps == 1) {
+        bounds_o = xfmBounds(instance->getLocal2World(item),instance->object->bounds);
+        return;
+      }
+      /* motion blurred instances get bounded over all timesteps */
+      bounds_o = empty;
+      for (size_t t=0; t<instance->numTimeSteps; t++)
+        bounds_o.extend(xfmBounds(instance->local2worldMB[t],instance->object->bounds));
     }
 
     RTCBoundsFunc InstanceBoundsFunc = (RTCBoundsFunc) InstanceBoundsFunction;
 
-    void FastInstanceIntersector1::intersect(const Instance* instance, Ray& ray, size_t item)
-    {
-      const Vec3fa ray_org = ray.org;
-      const Vec3fa ray_dir = ray.dir;
-      const int ray_geomID = ray.geomID;
-      const int ray_instID = ray.instID;
-      ray.org = xfmPoint (instance->world2local,ray_org);
-      ray.dir = xfmVector(instance->world2local,ray_dir);
-      ray.geomID = -1;
-      ray.instID = instance->id;
-      instance->object->intersect((RTCRay&)ray);
-      ray.org = ray_org;
-      ray.dir = ray_dir;
-      if (ray.geomID == -1) {
-        ray.geomID = ray_geomID;
-        ray.instID = ray_instID;
-      }
+    void FastInstanceIntersector1::intersect(Instance* instance, Ray& ray, size_t item) {
+      InstanceIntersector1::intersect(ray,instance->getWorld2Local(item,ray.time),instance->object,instance->getInstID(item),instance->getMask(item));
     }
     
-    void FastInstanceIntersector1::occluded (const Instance* instance, Ray& ray, size_t item)
-    {
-      const Vec3fa ray_org = ray.org;
-      const Vec3fa ray_dir = ray.dir;
-      ray.org = xfmPoint (instance->world2local,ray_org);
-      ray.dir = xfmVector(instance->world2local,ray_dir);
-      ray.instID = instance->id;
-      instance->object->occluded((RTCRay&)ray);
-      ray.org = ray_org;
-      ray.dir = ray_dir;
+    void FastInstanceIntersector1::occluded (Instance* instance, Ray& ray, size_t item) {
+      InstanceIntersector1::occluded(ray,instance->getWorld2Local(item,ray.time),instance->object,instance->getInstID(item),instance->getMask(item));
     }
     
     DEFINE_SET_INTERSECTOR1(InstanceIntersector1,FastInstanceIntersector1);
@@ -16,6 +16,7 @@
 
 #pragma once
 
+#include "instance.h"
 #include "../../common/scene_instance.h"
 #include "../../common/ray.h"
 
@@ -23,10 +24,106 @@ namespace embree
 {
   namespace isa
   {
+    /*! intersects single rays with instance leaves of the instance BVH */
+    struct InstanceIntersector1
+    {
+      typedef InstancePrimitive Primitive;
+
+      struct Precalculations {
+        __forceinline Precalculations (const Ray& ray, const void *ptr) {}
+      };
+
+      static __forceinline void intersect(Ray& ray, const AffineSpace3fa& world2local, Accel* object, const int instID, const unsigned mask)
+      {
+#if defined(RTCORE_RAY_MASK)
+        if ((mask & ray.mask) == 0) return;
+#endif
+
+        /* ignore instances nested deeper than supported */
+        const size_t depth = Instance::depth;
+        if (unlikely(depth >= RTC_MAX_INSTANCE_DEPTH)) return;
+
+        const Vec3fa ray_org = ray.org;
+        const Vec3fa ray_dir = ray.dir;
+        const int ray_geomID = ray.geomID;
+        int ray_instID[RTC_MAX_INSTANCE_DEPTH];
+        for (size_t l=depth; l<RTC_MAX_INSTANCE_DEPTH; l++) {
+          ray_instID[l] = ray.instIDLevel(l);
+          ray.instIDLevel(l) = -1;
+        }
+        ray.org = xfmPoint (world2local,ray_org);
+        ray.dir = xfmVector(world2local,ray_dir);
+        ray.geomID = -1;
+        ray.instIDLevel(depth) = instID;
+        Instance::depth = depth+1;
+        object->intersect((RTCRay&)ray);
+        Instance::depth = depth;
+        ray.org = ray_org;
+        ray.dir = ray_dir;
+        if (ray.geomID == -1) {
+          ray.geomID = ray_geomID;
+          for (size_t l=depth; l<RTC_MAX_INSTANCE_DEPTH; l++)
+            ray.instIDLevel(l) = ray_instID[l];
+        }
+      }
+
+      static __forceinline void occluded(Ray& ray, const AffineSpace3fa& world2local, Accel* object, const int instID, const unsigned mask)
+      {
+#if defined(RTCORE_RAY_MASK)
+        if ((mask & ray.mask) == 0) return;
+#endif
+
+        /* ignore instances nested deeper than supported */
+        const size_t depth = Instance::depth;
+        if (unlikely(depth >= RTC_MAX_INSTANCE_DEPTH)) return;
+
+        const Vec3fa ray_org = ray.org;
+        const Vec3fa ray_dir = ray.dir;
+        ray.org = xfmPoint (world2local,ray_org);
+        ray.dir = xfmVector(world2local,ray_dir);
+        ray.instIDLevel(depth) = instID;
+        Instance::depth = depth+1;
+        object->occluded((RTCRay&)ray);
+        Instance::depth = depth;
+        ray.org = ray_org;
+        ray.dir = ray_dir;
+      }
+
+      static __forceinline void intersect(const Precalculations& pre, Ray& ray, const Primitive& prim, Scene* scene) {
+        intersect(ray,prim.world2local,prim.object,prim.instID,prim.mask);
+      }
+
+      static __forceinline bool occluded(const Precalculations& pre, Ray& ray, const Primitive& prim, Scene* scene) 
+      {
+        occluded(ray,prim.world2local,prim.object,prim.instID,prim.mask);
+        return ray.geomID == 0;
+      }
+    };
+
+    /*! intersects single rays with motion blurred instance leaves of the instance BVH */
+    struct InstanceIntersector1MB
+    {
+      typedef InstancePrimitiveMB Primitive;
+
+      struct Precalculations {
+        __forceinline Precalculations (const Ray& ray, const void *ptr) {}
+      };
+
+      static __forceinline void intersect(const Precalculations& pre, Ray& ray, const Primitive& prim, Scene* scene) {
+        InstanceIntersector1::intersect(ray,prim.getWorld2Local(ray.time),prim.object,prim.instID,prim.mask);
+      }
+
+      static __forceinline bool occluded(const Precalculations& pre, Ray& ray, const Primitive& prim, Scene* scene) 
+      {
+        InstanceIntersector1::occluded(ray,prim.getWorld2Local(ray.time),prim.object,prim.instID,prim.mask);
+        return ray.geomID == 0;
+      }
+    };
+
     struct FastInstanceIntersector1
     {
-      static void intersect(const Instance* instance, Ray& ray, size_t item);
-      static void occluded (const Instance* instance, Ray& ray, size_t item);
+      static void intersect(Instance* instance, Ray& ray, size_t item);
+      static void occluded (Instance* instance, Ray& ray, size_t item);
     };
   }
 }
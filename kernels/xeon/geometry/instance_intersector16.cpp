@@ -20,39 +20,12 @@ namespace embree
 {
   namespace isa
   {
-    typedef AffineSpaceT<LinearSpace3<Vec3f16> > AffineSpace3faAVX;
-    
-    void FastInstanceIntersector16::intersect(bool16* valid, const Instance* instance, Ray16& ray, size_t item)
-    {
-      const Vec3f16 ray_org = ray.org;
-      const Vec3f16 ray_dir = ray.dir;
-      const int16 ray_geomID = ray.geomID;
-      const int16 ray_instID = ray.instID;
-      const AffineSpace3faAVX world2local(instance->world2local);
-      ray.org = xfmPoint (world2local,ray_org);
-      ray.dir = xfmVector(world2local,ray_dir);
-      ray.geomID = -1;
-      ray.instID = instance->id;
-      instance->object->intersect16(valid,(RTCRay16&)ray);
-      ray.org = ray_org;
-      ray.dir = ray_dir;
-      bool16 nohit = ray.geomID == int16(-1);
-      ray.geomID = select(nohit,ray_geomID,ray.geomID);
-      ray.instID = select(nohit,ray_instID,ray.instID);
+    void FastInstanceIntersector16::intersect(bool16* valid, Instance* instance, Ray16& ray, size_t item) {
+      InstanceIntersector16::intersect(*valid,ray,getWorld2LocalK<AffineSpace3faAVX512>(*valid,instance,item,ray.time),instance->object,instance->getInstID(item),instance->getMask(item));
     }
     
-    void FastInstanceIntersector16::occluded (bool16* valid, const Instance* instance, Ray16& ray, size_t item)
-    {
-      const Vec3f16 ray_org = ray.org;
-      const Vec3f16 ray_dir = ray.dir;
-      const int16 ray_geomID = ray.geomID;
-      const AffineSpace3faAVX world2local(instance->world2local);
-      ray.org = xfmPoint (world2local,ray_org);
-      ray.dir = xfmVector(world2local,ray_dir);
-      ray.instID = instance->id;
-      instance->object->occluded16(valid,(RTCRay16&)ray);
-      ray.org = ray_org;
-      ray.dir = ray_dir;
+    void FastInstanceIntersector16::occluded (bool16* valid, Instance* instance, Ray16& ray, size_t item) {
+      InstanceIntersector16::occluded(*valid,ray,getWorld2LocalK<AffineSpace3faAVX512>(*valid,instance,item,ray.time),instance->object,instance->getInstID(item),instance->getMask(item));
     }
 
     DEFINE_SET_INTERSECTOR16(InstanceIntersector16,FastInstanceIntersector16);
@@ -16,6 +16,7 @@
 
 #pragma once
 
+#include "instance.h"
 #include "../../common/scene_instance.h"
 #include "../../common/ray16.h"
 
@@ -23,10 +24,111 @@ namespace embree
 {
   namespace isa
   {
+    typedef AffineSpaceT<LinearSpace3<Vec3f16> > AffineSpace3faAVX512;
+
+    /*! intersects ray packets with instance leaves of the instance BVH */
+    struct InstanceIntersector16
+    {
+      typedef InstancePrimitive Primitive;
+
+      struct Precalculations {
+        __forceinline Precalculations (const bool16& valid, const Ray16& ray) {}
+      };
+
+      static __forceinline void intersect(const bool16& valid_i, Ray16& ray, const AffineSpace3faAVX512& world2local, Accel* object, const int instID, const unsigned mask)
+      {
+        bool16 valid = valid_i;
+#if defined(RTCORE_RAY_MASK)
+        valid &= (mask & ray.mask) != 0;
+        if (unlikely(none(valid))) return;
+#endif
+
+        /* ignore instances nested deeper than supported */
+        const size_t depth = Instance::depth;
+        if (unlikely(depth >= RTC_MAX_INSTANCE_DEPTH)) return;
+
+        const Vec3f16 ray_org = ray.org;
+        const Vec3f16 ray_dir = ray.dir;
+        const int16 ray_geomID = ray.geomID;
+        int16 ray_instID[RTC_MAX_INSTANCE_DEPTH];
+        for (size_t l=depth; l<RTC_MAX_INSTANCE_DEPTH; l++) {
+          ray_instID[l] = ray.instIDLevel(l);
+          ray.instIDLevel(l) = -1;
+        }
+        ray.org = xfmPoint (world2local,ray_org);
+        ray.dir = xfmVector(world2local,ray_dir);
+        ray.geomID = -1;
+        ray.instIDLevel(depth) = instID;
+        Instance::depth = depth+1;
+        object->intersect16(&valid,(RTCRay16&)ray);
+        Instance::depth = depth;
+        ray.org = ray_org;
+        ray.dir = ray_dir;
+        bool16 nohit = ray.geomID == int16(-1);
+        ray.geomID = select(nohit,ray_geomID,ray.geomID);
+        for (size_t l=depth; l<RTC_MAX_INSTANCE_DEPTH; l++)
+          ray.instIDLevel(l) = select(nohit,ray_instID[l],ray.instIDLevel(l));
+      }
+
+      static __forceinline void occluded(const bool16& valid_i, Ray16& ray, const AffineSpace3faAVX512& world2local, Accel* object, const int instID, const unsigned mask)
+      {
+        bool16 valid = valid_i;
+#if defined(RTCORE_RAY_MASK)
+        valid &= (mask & ray.mask) != 0;
+        if (unlikely(none(valid))) return;
+#endif
+
+        /* ignore instances nested deeper than supported */
+        const size_t depth = Instance::depth;
+        if (unlikely(depth >= RTC_MAX_INSTANCE_DEPTH)) return;
+
+        const Vec3f16 ray_org = ray.org;
+        const Vec3f16 ray_dir = ray.dir;
+        ray.org = xfmPoint (world2local,ray_org);
+        ray.dir = xfmVector(world2local,ray_dir);
+        ray.instIDLevel(depth) = instID;
+        Instance::depth = depth+1;
+        object->occluded16(&valid,(RTCRay16&)ray);
+        Instance::depth = depth;
+        ray.org = ray_org;
+        ray.dir = ray_dir;
+      }
+
+      static __forceinline void intersect(const bool16& valid, const Precalculations& pre, Ray16& ray, const Primitive& prim, Scene* scene) {
+        intersect(valid,ray,AffineSpace3faAVX512(prim.world2local),prim.object,prim.instID,prim.mask);
+      }
+
+      static __forceinline bool16 occluded(const bool16& valid, const Precalculations& pre, Ray16& ray, const Primitive& prim, Scene* scene) 
+      {
+        occluded(valid,ray,AffineSpace3faAVX512(prim.world2local),prim.object,prim.instID,prim.mask);
+        return ray.geomID == 0;
+      }
+    };
+
+    /*! intersects ray packets with motion blurred instance leaves of the instance BVH */
+    struct InstanceIntersector16MB
+    {
+      typedef InstancePrimitiveMB Primitive;
+
+      struct Precalculations {
+        __forceinline Precalculations (const bool16& valid, const Ray16& ray) {}
+      };
+
+      static __forceinline void intersect(const bool16& valid, const Precalculations& pre, Ray16& ray, const Primitive& prim, Scene* scene) {
+        InstanceIntersector16::intersect(valid,ray,prim.getWorld2Local<AffineSpace3faAVX512>(ray.time),prim.object,prim.instID,prim.mask);
+      }
+
+      static __forceinline bool16 occluded(const bool16& valid, const Precalculations& pre, Ray16& ray, const Primitive& prim, Scene* scene) 
+      {
+        InstanceIntersector16::occluded(valid,ray,prim.getWorld2Local<AffineSpace3faAVX512>(ray.time),prim.object,prim.instID,prim.mask);
+        return ray.geomID == 0;
+      }
+    };
+
     struct FastInstanceIntersector16
     {
-      static void intersect(bool16* valid, const Instance* instance, Ray16& ray, size_t item);
-      static void occluded (bool16* valid, const Instance* instance, Ray16& ray, size_t item);
+      static void intersect(bool16* valid, Instance* instance, Ray16& ray, size_t item);
+      static void occluded (bool16* valid, Instance* instance, Ray16& ray, size_t item);
     };
   }
 }
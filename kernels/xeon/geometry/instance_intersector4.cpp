@@ -20,39 +20,12 @@ namespace embree
 {
   namespace isa
   {
-    typedef AffineSpaceT<LinearSpace3<Vec3f4> > AffineSpace3faSSE;
-    
-    void FastInstanceIntersector4::intersect(bool4* valid, const Instance* instance, Ray4& ray, size_t item)
-    {
-      const Vec3f4 ray_org = ray.org;
-      const Vec3f4 ray_dir = ray.dir;
-      const int4 ray_geomID = ray.geomID;
-      const int4 ray_instID = ray.instID;
-      const AffineSpace3faSSE world2local(instance->world2local);
-      ray.org = xfmPoint (world2local,ray_org);
-      ray.dir = xfmVector(world2local,ray_dir);
-      ray.geomID = -1;
-      ray.instID = instance->id;
-      instance->object->intersect4(valid,(RTCRay4&)ray);
-      ray.org = ray_org;
-      ray.dir = ray_dir;
-      bool4 nohit = ray.geomID == int4(-1);
-      ray.geomID = select(nohit,ray_geomID,ray.geomID);
-      ray.instID = select(nohit,ray_instID,ray.instID);
+    void FastInstanceIntersector4::intersect(bool4* valid, Instance* instance, Ray4& ray, size_t item) {
+      InstanceIntersector4::intersect(*valid,ray,getWorld2LocalK<AffineSpace3faSSE>(*valid,instance,item,ray.time),instance->object,instance->getInstID(item),instance->getMask(item));
     }
     
-    void FastInstanceIntersector4::occluded (bool4* valid, const Instance* instance, Ray4& ray, size_t item)
-    {
-      const Vec3f4 ray_org = ray.org;
-      const Vec3f4 ray_dir = ray.dir;
-      const int4 ray_geomID = ray.geomID;
-      const AffineSpace3faSSE world2local(instance->world2local);
-      ray.org = xfmPoint (world2local,ray_org);
-      ray.dir = xfmVector(world2local,ray_dir);
-      ray.instID = instance->id;
-      instance->object->occluded4(valid,(RTCRay4&)ray);
-      ray.org = ray_org;
-      ray.dir = ray_dir;
+    void FastInstanceIntersector4::occluded (bool4* valid, Instance* instance, Ray4& ray, size_t item) {
+      InstanceIntersector4::occluded(*valid,ray,getWorld2LocalK<AffineSpace3faSSE>(*valid,instance,item,ray.time),instance->object,instance->getInstID(item),instance->getMask(item));
     }
 
     DEFINE_SET_INTERSECTOR4(InstanceIntersector4,FastInstanceIntersector4);
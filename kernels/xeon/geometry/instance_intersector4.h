@@ -16,6 +16,7 @@
 
 #pragma once
 
+#include "instance.h"
 #include "../../common/scene_instance.h"
 #include "../../common/ray4.h"
 
@@ -23,10 +24,111 @@ namespace embree
 {
   namespace isa
   {
+    typedef AffineSpaceT<LinearSpace3<Vec3f4> > AffineSpace3faSSE;
+
+    /*! intersects ray packets with instance leaves of the instance BVH */
+    struct InstanceIntersector4
+    {
+      typedef InstancePrimitive Primitive;
+
+      struct Precalculations {
+        __forceinline Precalculations (const bool4& valid, const Ray4& ray) {}
+      };
+
+      static __forceinline void intersect(const bool4& valid_i, Ray4& ray, const AffineSpace3faSSE& world2local, Accel* object, const int instID, const unsigned mask)
+      {
+        bool4 valid = valid_i;
+#if defined(RTCORE_RAY_MASK)
+        valid &= (mask & ray.mask) != 0;
+        if (unlikely(none(valid))) return;
+#endif
+
+        /* ignore instances nested deeper than supported */
+        const size_t depth = Instance::depth;
+        if (unlikely(depth >= RTC_MAX_INSTANCE_DEPTH)) return;
+
+        const Vec3f4 ray_org = ray.org;
+        const Vec3f4 ray_dir = ray.dir;
+        const int4 ray_geomID = ray.geomID;
+        int4 ray_instID[RTC_MAX_INSTANCE_DEPTH];
+        for (size_t l=depth; l<RTC_MAX_INSTANCE_DEPTH; l++) {
+          ray_instID[l] = ray.instIDLevel(l);
+          ray.instIDLevel(l) = -1;
+        }
+        ray.org = xfmPoint (world2local,ray_org);
+        ray.dir = xfmVector(world2local,ray_dir);
+        ray.geomID = -1;
+        ray.instIDLevel(depth) = instID;
+        Instance::depth = depth+1;
+        object->intersect4(&valid,(RTCRay4&)ray);
+        Instance::depth = depth;
+        ray.org = ray_org;
+        ray.dir = ray_dir;
+        bool4 nohit = ray.geomID == int4(-1);
+        ray.geomID = select(nohit,ray_geomID,ray.geomID);
+        for (size_t l=depth; l<RTC_MAX_INSTANCE_DEPTH; l++)
+          ray.instIDLevel(l) = select(nohit,ray_instID[l],ray.instIDLevel(l));
+      }
+
+      static __forceinline void occluded(const bool4& valid_i, Ray4& ray, const AffineSpace3faSSE& world2local, Accel* object, const int instID, const unsigned mask)
+      {
+        bool4 valid = valid_i;
+#if defined(RTCORE_RAY_MASK)
+        valid &= (mask & ray.mask) != 0;
+        if (unlikely(none(valid))) return;
+#endif
+
+        /* ignore instances nested deeper than supported */
+        const size_t depth = Instance::depth;
+        if (unlikely(depth >= RTC_MAX_INSTANCE_DEPTH)) return;
+
+        const Vec3f4 ray_org = ray.org;
+        const Vec3f4 ray_dir = ray.dir;
+        ray.org = xfmPoint (world2local,ray_org);
+        ray.dir = xfmVector(world2local,ray_dir);
+        ray.instIDLevel(depth) = instID;
+        Instance::depth = depth+1;
+        object->occluded4(&valid,(RTCRay4&)ray);
+        Instance::depth = depth;
+        ray.org = ray_org;
+        ray.dir = ray_dir;
+      }
+
+      static __forceinline void intersect(const bool4& valid, const Precalculations& pre, Ray4& ray, const Primitive& prim, Scene* scene) {
+        intersect(valid,ray,AffineSpace3faSSE(prim.world2local),prim.object,prim.instID,prim.mask);
+      }
+
+      static __forceinline bool4 occluded(const bool4& valid, const Precalculations& pre, Ray4& ray, const Primitive& prim, Scene* scene) 
+      {
+        occluded(valid,ray,AffineSpace3faSSE(prim.world2local),prim.object,prim.instID,prim.mask);
+        return ray.geomID == 0;
+      }
+    };
+
+    /*! intersects ray packets with motion blurred instance leaves of the instance BVH */
+    struct InstanceIntersector4MB
+    {
+      typedef InstancePrimitiveMB Primitive;
+
+      struct Precalculations {
+        __forceinline Precalculations (const bool4& valid, const Ray4& ray) {}
+      };
+
+      static __forceinline void intersect(const bool4& valid, const Precalculations& pre, Ray4& ray, const Primitive& prim, Scene* scene) {
+        InstanceIntersector4::intersect(valid,ray,prim.getWorld2Local<AffineSpace3faSSE>(ray.time),prim.object,prim.instID,prim.mask);
+      }
+
+      static __forceinline bool4 occluded(const bool4& valid, const Precalculations& pre, Ray4& ray, const Primitive& prim, Scene* scene) 
+      {
+        InstanceIntersector4::occluded(valid,ray,prim.getWorld2Local<AffineSpace3faSSE>(ray.time),prim.object,prim.instID,prim.mask);
+        return ray.geomID == 0;
+      }
+    };
+
     struct FastInstanceIntersector4
     {
-      static void intersect(bool4* valid, const Instance* instance, Ray4& ray, size_t item);
-      static void occluded (bool4* valid, const Instance* instance, Ray4& ray, size_t item);
+      static void intersect(bool4* valid, Instance* instance, Ray4& ray, size_t item);
+      static void occluded (bool4* valid, Instance* instance, Ray4& ray, size_t item);
     };
   }
 }
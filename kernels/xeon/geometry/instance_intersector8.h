@@ -16,6 +16,7 @@
 
 #pragma once
 
+#include "instance.h"
 #include "../../common/scene_instance.h"
 #include "../../common/ray8.h"
 
@@ -23,10 +24,111 @@ namespace embree
 {
   namespace isa
   {
+    typedef AffineSpaceT<LinearSpace3<Vec3f8> > AffineSpace3faAVX;
+
+    /*! intersects ray packets with instance leaves of the instance BVH */
+    struct InstanceIntersector8
+    {
+      typedef InstancePrimitive Primitive;
+
+      struct Precalculations {
+        __forceinline Precalculations (const bool8& valid, const Ray8& ray) {}
+      };
+
+      static __forceinline void intersect(const bool8& valid_i, Ray8& ray, const AffineSpace3faAVX& world2local, Accel* object, const int instID, const unsigned mask)
+      {
+        bool8 valid = valid_i;
+#if defined(RTCORE_RAY_MASK)
+        valid &= (mask & ray.mask) != 0;
+        if (unlikely(none(valid))) return;
+#endif
+
+        /* ignore instances nested deeper than supported */
+        const size_t depth = Instance::depth;
+        if (unlikely(depth >= RTC_MAX_INSTANCE_DEPTH)) return;
+
+        const Vec3f8 ray_org = ray.org;
+        const Vec3f8 ray_dir = ray.dir;
+        const int8 ray_geomID = ray.geomID;
+        int8 ray_instID[RTC_MAX_INSTANCE_DEPTH];
+        for (size_t l=depth; l<RTC_MAX_INSTANCE_DEPTH; l++) {
+          ray_instID[l] = ray.instIDLevel(l);
+          ray.instIDLevel(l) = -1;
+        }
+        ray.org = xfmPoint (world2local,ray_org);
+        ray.dir = xfmVector(world2local,ray_dir);
+        ray.geomID = -1;
+        ray.instIDLevel(depth) = instID;
+        Instance::depth = depth+1;
+        object->intersect8(&valid,(RTCRay8&)ray);
+        Instance::depth = depth;
+        ray.org = ray_org;
+        ray.dir = ray_dir;
+        bool8 nohit = ray.geomID == int8(-1);
+        ray.geomID = select(nohit,ray_geomID,ray.geomID);
+        for (size_t l=depth; l<RTC_MAX_INSTANCE_DEPTH; l++)
+          ray.instIDLevel(l) = select(nohit,ray_instID[l],ray.instIDLevel(l));
+      }
+
+      static __forceinline void occluded(const bool8& valid_i, Ray8& ray, const AffineSpace3faAVX& world2local, Accel* object, const int instID, const unsigned mask)
+      {
+        bool8 valid = valid_i;
+#if defined(RTCORE_RAY_MASK)
+        valid &= (mask & ray.mask) != 0;
+        if (unlikely(none(valid))) return;
+#endif
+
+        /* ignore instances nested deeper than supported */
+        const size_t depth = Instance::depth;
+        if (unlikely(depth >= RTC_MAX_INSTANCE_DEPTH)) return;
+
+        const Vec3f8 ray_org = ray.org;
+        const Vec3f8 ray_dir = ray.dir;
+        ray.org = xfmPoint (world2local,ray_org);
+        ray.dir = xfmVector(world2local,ray_dir);
+        ray.instIDLevel(depth) = instID;
+        Instance::depth = depth+1;
+        object->occluded8(&valid,(RTCRay8&)ray);
+        Instance::depth = depth;
+        ray.org = ray_org;
+        ray.dir = ray_dir;
+      }
+
+      static __forceinline void intersect(const bool8& valid, const Precalculations& pre, Ray8& ray, const Primitive& prim, Scene* scene) {
+        intersect(valid,ray,AffineSpace3faAVX(prim.world2local),prim.object,prim.instID,prim.mask);
+      }
+
+      static __forceinline bool8 occluded(const bool8& valid, const Precalculations& pre, Ray8& ray, const Primitive& prim, Scene* scene) 
+      {
+        occluded(valid,ray,AffineSpace3faAVX(prim.world2local),prim.object,prim.instID,prim.mask);
+        return ray.geomID == 0;
+      }
+    };
+
+    /*! intersects ray packets with motion blurred instance leaves of the instance BVH */
+    struct InstanceIntersector8MB
+    {
+      typedef InstancePrimitiveMB Primitive;
+
+      struct Precalculations {
+        __forceinline Precalculations (const bool8& valid, const Ray8& ray) {}
+      };
+
+      static __forceinline void intersect(const bool8& valid, const Precalculations& pre, Ray8& ray, const Primitive& prim, Scene* scene) {
+        InstanceIntersector8::intersect(valid,ray,prim.getWorld2Local<AffineSpace3faAVX>(ray.time),prim.object,prim.instID,prim.mask);
+      }
+
+      static __forceinline bool8 occluded(const bool8& valid, const Precalculations& pre, Ray8& ray, const Primitive& prim, Scene* scene) 
+      {
+        InstanceIntersector8::occluded(valid,ray,prim.getWorld2Local<AffineSpace3faAVX>(ray.time),prim.object,prim.instID,prim.mask);
+        return ray.geomID == 0;
+      }
+    };
+
     struct FastInstanceIntersector8
     {
-      static void intersect(bool8* valid, const Instance* instance, Ray8& ray, size_t item);
-      static void occluded (bool8* valid, const Instance* instance, Ray8& ray, size_t item);
+      static void intersect(bool8* valid, Instance* instance, Ray8& ray, size_t item);
+      static void occluded (bool8* valid, Instance* instance, Ray8& ray, size_t item);
     };
   }
 }
@@ -45,6 +45,15 @@ namespace embree
         prim.accel->occluded4(&valid_i,(RTCRay4&)ray,prim.item);
         return ray.geomID == 0;
       }
+
+      static __forceinline void intersect(const Precalculations& pre, Ray4& ray, size_t k, const Primitive& prim, Scene* scene) {
+        intersect(bool4(1 << int(k)),pre,ray,prim,scene);
+      }
+
+      static __forceinline bool occluded(const Precalculations& pre, Ray4& ray, size_t k, const Primitive& prim, Scene* scene) {
+        occluded(bool4(1 << int(k)),pre,ray,prim,scene);
+        return ray.geomID[k] == 0;
+      }
     };
   }
 }
@@ -24,9 +24,13 @@
 #include "triangle8.h"
 #include "triangle8v.h"
 #include "trianglepairs8.h"
+#include "quad4v.h"
+#include "sphere4.h"
+#include "sphere4_mb.h"
 #include "subdivpatch1.h"
 #include "subdivpatch1cached.h"
 #include "object.h"
+#include "instance.h"
 
 namespace embree
 {
@@ -40,7 +44,7 @@ namespace embree
   Bezier1v::Type Bezier1v::type;
 
   Bezier1v::Type::Type () 
-    : PrimitiveType("bezier1v",sizeof(Bezier1v),1) {} 
+    : PrimitiveType("bezier1v",sizeof(Bezier1v),1,true) {} 
   
   size_t Bezier1v::Type::size(const char* This) const {
     return 1;
@@ -66,7 +70,7 @@ namespace embree
   Triangle4::Type Triangle4::type;
 
   Triangle4::Type::Type () 
-    : PrimitiveType("triangle4",sizeof(Triangle4),4) {} 
+    : PrimitiveType("triangle4",sizeof(Triangle4),4,true) {} 
 
   size_t Triangle4::Type::size(const char* This) const {
     return ((Triangle4*)This)->size();
@@ -79,13 +83,52 @@ namespace embree
   Triangle4v::Type Triangle4v::type;
 
   Triangle4v::Type::Type () 
-  : PrimitiveType("triangle4v",sizeof(Triangle4v),4) {} 
+  : PrimitiveType("triangle4v",sizeof(Triangle4v),4,true) {} 
   
   size_t Triangle4v::Type::size(const char* This) const {
     return ((Triangle4v*)This)->size();
   }
 #endif
 
+  /********************** Quad4v **************************/
+
+#if !defined(__AVX__)
+  Quad4v::Type Quad4v::type;
+
+  Quad4v::Type::Type () 
+  : PrimitiveType("quad4v",sizeof(Quad4v),4,true) {} 
+  
+  size_t Quad4v::Type::size(const char* This) const {
+    return ((Quad4v*)This)->size();
+  }
+#endif
+
+  /********************** Sphere4 **************************/
+
+#if !defined(__AVX__)
+  Sphere4::Type Sphere4::type;
+
+  Sphere4::Type::Type () 
+  : PrimitiveType("sphere4",sizeof(Sphere4),4,true) {} 
+  
+  size_t Sphere4::Type::size(const char* This) const {
+    return ((Sphere4*)This)->size();
+  }
+#endif
+
+  /********************** Sphere4MB **************************/
+
+#if !defined(__AVX__)
+  Sphere4MB::Type Sphere4MB::type;
+
+  Sphere4MB::Type::Type () 
+  : PrimitiveType("sphere4mb",sizeof(Sphere4MB),4,true) {} 
+  
+  size_t Sphere4MB::Type::size(const char* This) const {
+    return ((Sphere4MB*)This)->size();
+  }
+#endif
+
   /********************** Triangle4i **************************/
 
 #if !defined(__AVX__)
@@ -105,7 +148,7 @@ namespace embree
   Triangle4vMB::Type Triangle4vMB::type;
 
   Triangle4vMB::Type::Type () 
-  : PrimitiveType("triangle4vmb",sizeof(Triangle4vMB),4) {} 
+  : PrimitiveType("triangle4vmb",sizeof(Triangle4vMB),4,true) {} 
   
   size_t Triangle4vMB::Type::size(const char* This) const {
     return ((Triangle4vMB*)This)->size();
@@ -119,7 +162,7 @@ namespace embree
   Triangle8::Type Triangle8::type;
 
   Triangle8::Type::Type () 
-    : PrimitiveType("triangle8",2*sizeof(Triangle4),8) {}
+    : PrimitiveType("triangle8",2*sizeof(Triangle4),8,true) {}
 #else
   size_t Triangle8::Type::size(const char* This) const {
     return ((Triangle8*)This)->size();
@@ -134,7 +177,7 @@ namespace embree
   Triangle8v::Type Triangle8v::type;
 
   Triangle8v::Type::Type () 
-    : PrimitiveType("triangle8v",11*32,8) {}
+    : PrimitiveType("triangle8v",11*32,8,true) {}
 #else
   size_t Triangle8v::Type::size(const char* This) const {
     return ((Triangle8v*)This)->size();
@@ -149,7 +192,7 @@ namespace embree
   TrianglePairs8::Type TrianglePairs8::type;
 
   TrianglePairs8::Type::Type () 
-    : PrimitiveType("trianglepairs8",11*32,8) {}
+    : PrimitiveType("trianglepairs8",11*32,8,true) {}
 #else
   size_t TrianglePairs8::Type::size(const char* This) const {
     return ((TrianglePairs8*)This)->size();
@@ -195,4 +238,26 @@ namespace embree
     return 1;
   }
 #endif
+
+  /********************** Instance **************************/
+
+#if !defined(__AVX__)
+  InstancePrimitive::Type InstancePrimitive::type;
+
+  InstancePrimitive::Type::Type () 
+    : PrimitiveType("instance",sizeof(InstancePrimitive),1) {} 
+
+  size_t InstancePrimitive::Type::size(const char* This) const {
+    return 1;
+  }
+
+  InstancePrimitiveMB::Type InstancePrimitiveMB::type;
+
+  InstancePrimitiveMB::Type::Type () 
+    : PrimitiveType("instance_mb",sizeof(InstancePrimitiveMB),1) {} 
+
+  size_t InstancePrimitiveMB::Type::size(const char* This) const {
+    return 1;
+  }
+#endif
 }
@@ -0,0 +1,533 @@
+// ======================================================================== //
+// Copyright 2009-2015 Intel Corporation                                    //
+//                                                                          //
+// Licensed under the Apache License, Version 2.0 (the "License");          //
+// you may not use this file except in compliance with the License.         //
+// You may obtain a copy of the License at                                  //
+//                                                                          //
+//     http://www.apache.org/licenses/LICENSE-2.0                           //
+//                                                                          //
+// Unless required by applicable law or agreed to in writing, software      //
+// distributed under the License is distributed on an "AS IS" BASIS,        //
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. //
+// See the License for the specific language governing permissions and      //
+// limitations under the License.                                           //
+// ======================================================================== //
+
+#pragma once
+
+#include "../../common/ray.h"
+#include "filter.h"
+
+/*! This intersector intersects quads by splitting them into the two
+ *  triangles (v0,v1,v3) and (v2,v3,v1), which get intersected with
+ *  the same modified Moeller Trumbore test as triangles. Hits with
+ *  the second triangle are reported in the parametrization of the
+ *  quad, thus u=0,v=0 corresponds to v0, u=1,v=0 to v1, u=1,v=1 to v2,
+ *  and u=0,v=1 to v3. */
+
+namespace embree
+{
+  namespace isa
+  {
+    /*! Intersects a ray with a triangle and returns the valid mask and the hit. */
+    template<typename simdf>
+      __forceinline typename simdf::Mask quad_triangle_moeller_trumbore(const Vec3<simdf>& O, const Vec3<simdf>& D, 
+                                                                         const simdf& tnear, const simdf& tfar,
+                                                                         const Vec3<simdf>& tri_v0, 
+                                                                         const Vec3<simdf>& tri_e1, 
+                                                                         const Vec3<simdf>& tri_e2, 
+                                                                         const Vec3<simdf>& tri_Ng,
+                                                                         simdf& u, simdf& v, simdf& t)
+    {
+      typedef typename simdf::Mask simdb;
+
+      /* calculate denominator */
+      const Vec3<simdf> C = tri_v0 - O;
+      const Vec3<simdf> R = cross(D,C);
+      const simdf den = dot(tri_Ng,D);
+      const simdf absDen = abs(den);
+      const simdf sgnDen = signmsk(den);
+      
+      /* perform edge tests */
+      const simdf U = dot(R,tri_e2) ^ sgnDen;
+      const simdf V = dot(R,tri_e1) ^ sgnDen;
+      
+      /* perform backface culling */
+#if defined(RTCORE_BACKFACE_CULLING)
+      simdb valid = (den > simdf(zero)) & (U >= 0.0f) & (V >= 0.0f) & (U+V<=absDen);
+#else
+      simdb valid = (den != simdf(zero)) & (U >= 0.0f) & (V >= 0.0f) & (U+V<=absDen);
+#endif
+      if (likely(none(valid))) return valid;
+      
+      /* perform depth test */
+      const simdf T = dot(tri_Ng,C) ^ sgnDen;
+      valid &= (T > absDen*tnear) & (T < absDen*tfar);
+      if (likely(none(valid))) return valid;
+      
+      /* calculate hit information */
+      const simdf rcpAbsDen = rcp(absDen);
+      u = U * rcpAbsDen;
+      v = V * rcpAbsDen;
+      t = T * rcpAbsDen;
+      return valid;
+    }
+
+    /*! Intersects a ray with quads and returns the valid mask and the closest hit of each quad. */
+    template<typename simdf>
+      __forceinline typename simdf::Mask quad_intersect_moeller_trumbore(const Vec3<simdf>& O, const Vec3<simdf>& D, 
+                                                                          const simdf& tnear, const simdf& tfar,
+                                                                          const Vec3<simdf>& v0, 
+                                                                          const Vec3<simdf>& v1, 
+                                                                          const Vec3<simdf>& v2, 
+                                                                          const Vec3<simdf>& v3,
+                                                                          simdf& u, simdf& v, simdf& t, Vec3<simdf>& Ng)
+    {
+      typedef typename simdf::Mask simdb;
+
+      /* intersect first triangle (v0,v1,v3) */
+      const Vec3<simdf> e1a = v0-v1;
+      const Vec3<simdf> e2a = v3-v0;
+      const Vec3<simdf> Nga = cross(e1a,e2a);
+      simdf ua = zero, va = zero, ta = zero;
+      const simdb valida = quad_triangle_moeller_trumbore(O,D,tnear,tfar,v0,e1a,e2a,Nga,ua,va,ta);
+
+      /* intersect second triangle (v2,v3,v1) */
+      const Vec3<simdf> e1b = v2-v3;
+      const Vec3<simdf> e2b = v1-v2;
+      const Vec3<simdf> Ngb = cross(e1b,e2b);
+      simdf ub = zero, vb = zero, tb = zero;
+      const simdb validb = quad_triangle_moeller_trumbore(O,D,tnear,tfar,v2,e1b,e2b,Ngb,ub,vb,tb);
+
+      /* select closer hit and map it into the quad parametrization */
+      const simdb first = valida & (!validb | (ta <= tb));
+      u = select(first,ua,simdf(one)-ub);
+      v = select(first,va,simdf(one)-vb);
+      t = select(first,ta,tb);
+      Ng = Vec3<simdf>(select(first,Nga.x,Ngb.x),select(first,Nga.y,Ngb.y),select(first,Nga.z,Ngb.z));
+      return valida | validb;
+    }
+
+    /*! Intersect a ray with the N quads and updates the hit. */
+    template<bool enableIntersectionFilter, typename tsimdf, typename tsimdi>
+      __forceinline void quad_intersect_moeller_trumbore(Ray& ray, 
+                                                         const Vec3<tsimdf>& v0, const Vec3<tsimdf>& v1, const Vec3<tsimdf>& v2, const Vec3<tsimdf>& v3,
+                                                         const tsimdi& quad_geomIDs, const tsimdi& quad_primIDs, Scene* scene)
+    {
+      typedef typename tsimdf::Mask tsimdb;
+      typedef Vec3<tsimdf> tsimd3f;
+      tsimdf u, v, t; tsimd3f Ng;
+      tsimdb valid = quad_intersect_moeller_trumbore(tsimd3f(ray.org),tsimd3f(ray.dir),tsimdf(ray.tnear),tsimdf(ray.tfar),v0,v1,v2,v3,u,v,t,Ng);
+      if (likely(none(valid))) return;
+
+      size_t i = select_min(valid,t);
+      int geomID = quad_geomIDs[i];
+      
+      /* intersection filter test */
+#if defined(RTCORE_INTERSECTION_FILTER) || defined(RTCORE_RAY_MASK)
+      goto entry;
+      while (true) 
+      {
+        if (unlikely(none(valid))) return;
+        i = select_min(valid,t);
+        geomID = quad_geomIDs[i];
+      entry:
+        Geometry* geometry = scene->get(geomID);
+        
+#if defined(RTCORE_RAY_MASK)
+        /* goto next hit if mask test fails */
+        if ((geometry->mask & ray.mask) == 0) {
+          valid[i] = 0;
+          continue;
+        }
+#endif
+        
+#if defined(RTCORE_INTERSECTION_FILTER) 
+        /* call intersection filter function */
+        if (enableIntersectionFilter) {
+          if (unlikely(geometry->hasIntersectionFilter1())) {
+            const Vec3fa Ngi = Vec3fa(Ng.x[i],Ng.y[i],Ng.z[i]);
+            if (runIntersectionFilter1(geometry,ray,u[i],v[i],t[i],Ngi,geomID,quad_primIDs[i])) return;
+            valid[i] = 0;
+            continue;
+          }
+        }
+#endif
+        break;
+      }
+#endif
+      
+      /* update hit information */
+      ray.u = u[i];
+      ray.v = v[i];
+      ray.tfar = t[i];
+      ray.Ng.x = Ng.x[i];
+      ray.Ng.y = Ng.y[i];
+      ray.Ng.z = Ng.z[i];
+      ray.geomID = geomID;
+      ray.primID = quad_primIDs[i];
+    }
+
+    /*! Test if the ray is occluded by one of N quads. */
+    template<bool enableIntersectionFilter, typename tsimdf, typename tsimdi>
+      __forceinline bool quad_occluded_moeller_trumbore(Ray& ray, 
+                                                        const Vec3<tsimdf>& v0, const Vec3<tsimdf>& v1, const Vec3<tsimdf>& v2, const Vec3<tsimdf>& v3,
+                                                        const tsimdi& quad_geomIDs, const tsimdi& quad_primIDs, Scene* scene)
+    {
+      typedef typename tsimdf::Mask tsimdb;
+      typedef Vec3<tsimdf> tsimd3f;
+      tsimdf u, v, t; tsimd3f Ng;
+      tsimdb valid = quad_intersect_moeller_trumbore(tsimd3f(ray.org),tsimd3f(ray.dir),tsimdf(ray.tnear),tsimdf(ray.tfar),v0,v1,v2,v3,u,v,t,Ng);
+      if (unlikely(none(valid))) return false;
+      
+      /* intersection filter test */
+#if defined(RTCORE_INTERSECTION_FILTER) || defined(RTCORE_RAY_MASK)
+      size_t m=movemask(valid);
+      goto entry;
+      while (true)
+      {  
+        if (unlikely(m == 0)) return false;
+      entry:
+        size_t i=__bsf(m);
+        const int geomID = quad_geomIDs[i];
+        Geometry* geometry = scene->get(geomID);
+        
+#if defined(RTCORE_RAY_MASK)
+        /* goto next hit if mask test fails */
+        if ((geometry->mask & ray.mask) == 0) {
+          m=__btc(m,i);
+          continue;
+        }
+#endif
+        
+#if defined(RTCORE_INTERSECTION_FILTER)
+        /* if we have no filter then the test passed */
+        if (enableIntersectionFilter) {
+          if (unlikely(geometry->hasOcclusionFilter1())) 
+          {
+            const Vec3fa Ngi = Vec3fa(Ng.x[i],Ng.y[i],Ng.z[i]);
+            if (runOcclusionFilter1(geometry,ray,u[i],v[i],t[i],Ngi,geomID,quad_primIDs[i])) return true;
+            m=__btc(m,i);
+            continue;
+          }
+        }
+#endif
+        break;
+      }
+#endif
+      
+      return true;
+    }
+
+    /*! Intersects M rays with the i'th of N quads. */
+    template<bool enableIntersectionFilter, typename tsimdi, typename RayM>
+      __forceinline void quad_intersect_moeller_trumbore(const typename RayM::simdb& valid0, RayM& ray, 
+                                                         const Vec3<typename RayM::simdf>& v0, const Vec3<typename RayM::simdf>& v1, 
+                                                         const Vec3<typename RayM::simdf>& v2, const Vec3<typename RayM::simdf>& v3,
+                                                         const tsimdi& quad_geomIDs, const tsimdi& quad_primIDs, const size_t i, Scene* scene)
+    {
+      /* ray SIMD type shortcuts */
+      typedef typename RayM::simdb rsimdb;
+      typedef typename RayM::simdf rsimdf;
+      typedef typename RayM::simdi rsimdi;
+      typedef Vec3<rsimdf> rsimd3f;
+      
+      rsimdf u, v, t; rsimd3f Ng;
+      rsimdb valid = valid0 & quad_intersect_moeller_trumbore(ray.org,ray.dir,ray.tnear,ray.tfar,v0,v1,v2,v3,u,v,t,Ng);
+      if (likely(none(valid))) return;
+
+      const int geomID = quad_geomIDs[i];
+      const int primID = quad_primIDs[i];
+      Geometry* geometry = scene->get(geomID);
+      
+      /* ray masking test */
+#if defined(RTCORE_RAY_MASK)
+      valid &= (geometry->mask & ray.mask) != 0;
+      if (unlikely(none(valid))) return;
+#endif
+      
+      /* intersection filter test */
+#if defined(RTCORE_INTERSECTION_FILTER)
+      if (enableIntersectionFilter) {
+        if (unlikely(geometry->hasIntersectionFilter<rsimdf>())) {
+          runIntersectionFilter(valid,geometry,ray,u,v,t,Ng,geomID,primID);
+          return;
+        }
+      }
+#endif
+      
+      /* update hit information */
+      rsimdf::store(valid,&ray.u,u);
+      rsimdf::store(valid,&ray.v,v);
+      rsimdf::store(valid,&ray.tfar,t);
+      rsimdi::store(valid,&ray.geomID,geomID);
+      rsimdi::store(valid,&ray.primID,primID);
+      rsimdf::store(valid,&ray.Ng.x,Ng.x);
+      rsimdf::store(valid,&ray.Ng.y,Ng.y);
+      rsimdf::store(valid,&ray.Ng.z,Ng.z);
+    }
+
+    /*! Test for M rays if they are occluded by the i'th of N quads. */
+    template<bool enableIntersectionFilter, typename tsimdi, typename RayM>
+      __forceinline void quad_occluded_moeller_trumbore(typename RayM::simdb& valid0, RayM& ray, 
+                                                        const Vec3<typename RayM::simdf>& v0, const Vec3<typename RayM::simdf>& v1, 
+                                                        const Vec3<typename RayM::simdf>& v2, const Vec3<typename RayM::simdf>& v3,
+                                                        const tsimdi& quad_geomIDs, const tsimdi& quad_primIDs, const size_t i, Scene* scene)
+    {
+      /* ray SIMD type shortcuts */
+      typedef typename RayM::simdb rsimdb;
+      typedef typename RayM::simdf rsimdf;
+      typedef Vec3<rsimdf> rsimd3f;
+      
+      rsimdf u, v, t; rsimd3f Ng;
+      rsimdb valid = valid0 & quad_intersect_moeller_trumbore(ray.org,ray.dir,ray.tnear,ray.tfar,v0,v1,v2,v3,u,v,t,Ng);
+      if (likely(none(valid))) return;
+
+      /* ray masking test */
+      const int geomID = quad_geomIDs[i];
+      Geometry* geometry = scene->get(geomID);
+#if defined(RTCORE_RAY_MASK)
+      valid &= (geometry->mask & ray.mask) != 0;
+      if (unlikely(none(valid))) return;
+#endif
+      
+      /* intersection filter test */
+#if defined(RTCORE_INTERSECTION_FILTER)
+      if (enableIntersectionFilter) 
+      {
+        if (unlikely(geometry->hasOcclusionFilter<rsimdf>()))
+        {
+          const int primID = quad_primIDs[i];
+          valid = runOcclusionFilter(valid,geometry,ray,u,v,t,Ng,geomID,primID);
+        }
+      }
+#endif
+      
+      /* update occlusion */
+      valid0 &= !valid;
+    }
+
+    /*! Intersect the k'th ray of a packet with the N quads and updates the hit. */
+    template<bool enableIntersectionFilter, typename tsimdf, typename tsimdi, typename RayM>
+      __forceinline void quad_intersect_moeller_trumbore(RayM& ray, size_t k,
+                                                         const Vec3<tsimdf>& v0, const Vec3<tsimdf>& v1, const Vec3<tsimdf>& v2, const Vec3<tsimdf>& v3,
+                                                         const tsimdi& quad_geomIDs, const tsimdi& quad_primIDs, Scene* scene)
+    {
+      /* type shortcuts */
+      typedef typename RayM::simdf rsimdf;
+      typedef typename tsimdf::Mask tsimdb;
+      typedef Vec3<tsimdf> tsimd3f;
+
+      const tsimd3f O = broadcast<tsimdf>(ray.org,k);
+      const tsimd3f D = broadcast<tsimdf>(ray.dir,k);
+      tsimdf u, v, t; tsimd3f Ng;
+      tsimdb valid = quad_intersect_moeller_trumbore(O,D,tsimdf(ray.tnear[k]),tsimdf(ray.tfar[k]),v0,v1,v2,v3,u,v,t,Ng);
+      if (likely(none(valid))) return;
+
+      size_t i = select_min(valid,t);
+      int geomID = quad_geomIDs[i];
+      
+      /* intersection filter test */
+#if defined(RTCORE_INTERSECTION_FILTER) || defined(RTCORE_RAY_MASK)
+      goto entry;
+      while (true) 
+      {
+        if (unlikely(none(valid))) return;
+        i = select_min(valid,t);
+        geomID = quad_geomIDs[i];
+      entry:
+        Geometry* geometry = scene->get(geomID);
+        
+#if defined(RTCORE_RAY_MASK)
+        /* goto next hit if mask test fails */
+        if ((geometry->mask & ray.mask[k]) == 0) {
+          valid[i] = 0;
+          continue;
+        }
+#endif
+        
+#if defined(RTCORE_INTERSECTION_FILTER) 
+        /* call intersection filter function */
+        if (enableIntersectionFilter) {
+          if (unlikely(geometry->hasIntersectionFilter<rsimdf>())) {
+            const Vec3fa Ngi = Vec3fa(Ng.x[i],Ng.y[i],Ng.z[i]);
+            if (runIntersectionFilter(geometry,ray,k,u[i],v[i],t[i],Ngi,geomID,quad_primIDs[i])) return;
+            valid[i] = 0;
+            continue;
+          }
+        }
+#endif
+        break;
+      }
+#endif
+      
+      /* update hit information */
+      ray.u[k] = u[i];
+      ray.v[k] = v[i];
+      ray.tfar[k] = t[i];
+      ray.Ng.x[k] = Ng.x[i];
+      ray.Ng.y[k] = Ng.y[i];
+      ray.Ng.z[k] = Ng.z[i];
+      ray.geomID[k] = geomID;
+      ray.primID[k] = quad_primIDs[i];
+    }
+
+    /*! Test if the k'th ray of a packet is occluded by one of the N quads. */
+    template<bool enableIntersectionFilter, typename tsimdf, typename tsimdi, typename RayM>
+      __forceinline bool quad_occluded_moeller_trumbore(RayM& ray, size_t k, 
+                                                        const Vec3<tsimdf>& v0, const Vec3<tsimdf>& v1, const Vec3<tsimdf>& v2, const Vec3<tsimdf>& v3,
+                                                        const tsimdi& quad_geomIDs, const tsimdi& quad_primIDs, Scene* scene)
+    {
+      /* type shortcuts */
+      typedef typename RayM::simdf rsimdf;
+      typedef typename tsimdf::Mask tsimdb;
+      typedef Vec3<tsimdf> tsimd3f;
+      
+      const tsimd3f O = broadcast<tsimdf>(ray.org,k);
+      const tsimd3f D = broadcast<tsimdf>(ray.dir,k);
+      tsimdf u, v, t; tsimd3f Ng;
+      tsimdb valid = quad_intersect_moeller_trumbore(O,D,tsimdf(ray.tnear[k]),tsimdf(ray.tfar[k]),v0,v1,v2,v3,u,v,t,Ng);
+      if (unlikely(none(valid))) return false;
+      
+      /* intersection filter test */
+#if defined(RTCORE_INTERSECTION_FILTER) || defined(RTCORE_RAY_MASK)
+      size_t m=movemask(valid);
+      goto entry;
+      while (true)
+      {  
+        if (unlikely(m == 0)) return false;
+      entry:
+        size_t i=__bsf(m);
+        const int geomID = quad_geomIDs[i];
+        Geometry* geometry = scene->get(geomID);
+        
+#if defined(RTCORE_RAY_MASK)
+        /* goto next hit if mask test fails */
+        if ((geometry->mask & ray.mask[k]) == 0) {
+          m=__btc(m,i);
+          continue;
+        }
+#endif
+        
+#if defined(RTCORE_INTERSECTION_FILTER)
+        /* execute occlusion filer */
+        if (enableIntersectionFilter) {
+          if (unlikely(geometry->hasOcclusionFilter<rsimdf>())) 
+          {
+            const Vec3fa Ngi = Vec3fa(Ng.x[i],Ng.y[i],Ng.z[i]);
+            if (runOcclusionFilter(geometry,ray,k,u[i],v[i],t[i],Ngi,geomID,quad_primIDs[i])) return true;
+            m=__btc(m,i);
+            continue;
+          }
+        }
+#endif
+        break;
+      }
+#endif
+      
+      return true;
+    }
+    
+    /*! Intersects N quads with 1 ray */
+    template<typename QuadN, bool enableIntersectionFilter>
+      struct QuadNIntersector1MoellerTrumbore
+      {
+        typedef QuadN Primitive;
+        
+        /* type shortcuts */
+        typedef typename QuadN::simdb tsimdb;
+        typedef typename QuadN::simdf tsimdf;
+        typedef typename QuadN::simdi tsimdi;
+        typedef Vec3<tsimdf> tsimd3f;
+        
+        struct Precalculations {
+          __forceinline Precalculations (const Ray& ray, const void* ptr) {}
+        };
+        
+        /*! Intersect a ray with the N quads and updates the hit. */
+        static __forceinline void intersect(const Precalculations& pre, Ray& ray, const QuadN& quad, Scene* scene)
+        {
+          STAT3(normal.trav_prims,1,1,1);
+          quad_intersect_moeller_trumbore<enableIntersectionFilter>(ray,quad.v0,quad.v1,quad.v2,quad.v3,quad.geomIDs,quad.primIDs,scene);
+        }
+        
+        /*! Test if the ray is occluded by one of N quads. */
+        static __forceinline bool occluded(const Precalculations& pre, Ray& ray, const QuadN& quad, Scene* scene)
+        {
+          STAT3(shadow.trav_prims,1,1,1);
+          return quad_occluded_moeller_trumbore<enableIntersectionFilter>(ray,quad.v0,quad.v1,quad.v2,quad.v3,quad.geomIDs,quad.primIDs,scene);
+        }
+      };
+
+    /*! Intersector for N quads with M rays. */
+    template<typename RayM, typename QuadN, bool enableIntersectionFilter>
+      struct QuadNIntersectorMMoellerTrumbore
+      {
+        typedef QuadN Primitive;
+        
+        /* quad SIMD type shortcuts */
+        typedef typename QuadN::simdb tsimdb;
+        typedef typename QuadN::simdf tsimdf;
+        typedef Vec3<tsimdf> tsimd3f;
+        
+        /* ray SIMD type shortcuts */
+        typedef typename RayM::simdb rsimdb;
+        typedef typename RayM::simdf rsimdf;
+        typedef typename RayM::simdi rsimdi;
+        typedef Vec3<rsimdf> rsimd3f;
+        
+        struct Precalculations {
+          __forceinline Precalculations (const rsimdb& valid, const RayM& ray) {}
+        };
+        
+        /*! Intersects M rays with N quads. */
+        static __forceinline void intersect(const rsimdb& valid_i, Precalculations& pre, RayM& ray, const QuadN& quad, Scene* scene)
+        {
+          for (size_t i=0; i<QuadN::max_size(); i++)
+          {
+            if (!quad.valid(i)) break;
+            STAT3(normal.trav_prims,1,popcnt(valid_i),RayM::size());
+            const rsimd3f p0 = broadcast<rsimdf>(quad.v0,i);
+            const rsimd3f p1 = broadcast<rsimdf>(quad.v1,i);
+            const rsimd3f p2 = broadcast<rsimdf>(quad.v2,i);
+            const rsimd3f p3 = broadcast<rsimdf>(quad.v3,i);
+            quad_intersect_moeller_trumbore<enableIntersectionFilter>(valid_i,ray,p0,p1,p2,p3,quad.geomIDs,quad.primIDs,i,scene);
+          }
+        }
+        
+        /*! Test for M rays if they are occluded by any of the N quads. */
+        static __forceinline rsimdb occluded(const rsimdb& valid_i, Precalculations& pre, RayM& ray, const QuadN& quad, Scene* scene)
+        {
+          rsimdb valid0 = valid_i;
+          
+          for (size_t i=0; i<QuadN::max_size(); i++)
+          {
+            if (!quad.valid(i)) break;
+            STAT3(shadow.trav_prims,1,popcnt(valid0),RayM::size());
+            const rsimd3f p0 = broadcast<rsimdf>(quad.v0,i);
+            const rsimd3f p1 = broadcast<rsimdf>(quad.v1,i);
+            const rsimd3f p2 = broadcast<rsimdf>(quad.v2,i);
+            const rsimd3f p3 = broadcast<rsimdf>(quad.v3,i);
+            quad_occluded_moeller_trumbore<enableIntersectionFilter>(valid0,ray,p0,p1,p2,p3,quad.geomIDs,quad.primIDs,i,scene);
+            if (none(valid0)) break;
+          }
+          return !valid0;
+        }
+        
+        /*! Intersect the k'th ray with the N quads and updates the hit. */
+        static __forceinline void intersect(Precalculations& pre, RayM& ray, size_t k, const QuadN& quad, Scene* scene)
+        {
+          STAT3(normal.trav_prims,1,1,1);
+          quad_intersect_moeller_trumbore<enableIntersectionFilter>(ray,k,quad.v0,quad.v1,quad.v2,quad.v3,quad.geomIDs,quad.primIDs,scene);
+        }
+        
+        /*! Test if the k'th ray is occluded by one of the N quads. */
+        static __forceinline bool occluded(Precalculations& pre, RayM& ray, size_t k, const QuadN& quad, Scene* scene)
+        {
+          STAT3(shadow.trav_prims,1,1,1);
+          return quad_occluded_moeller_trumbore<enableIntersectionFilter>(ray,k,quad.v0,quad.v1,quad.v2,quad.v3,quad.geomIDs,quad.primIDs,scene);
+        }
+      };
+  }
+}
@@ -0,0 +1,125 @@
+// ======================================================================== //
+// Copyright 2009-2015 Intel Corporation                                    //
+//                                                                          //
+// Licensed under the Apache License, Version 2.0 (the "License");          //
+// you may not use this file except in compliance with the License.         //
+// You may obtain a copy of the License at                                  //
+//                                                                          //
+//     http://www.apache.org/licenses/LICENSE-2.0                           //
+//                                                                          //
+// Unless required by applicable law or agreed to in writing, software      //
+// distributed under the License is distributed on an "AS IS" BASIS,        //
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. //
+// See the License for the specific language governing permissions and      //
+// limitations under the License.                                           //
+// ======================================================================== //
+
+#pragma once
+
+#include "primitive.h"
+
+namespace embree
+{
+  /*! Stores the centers and radii of 4 spheres in struct of array layout. */
+  struct Sphere4
+  { 
+    typedef bool4 simdb;
+    typedef float4 simdf;
+    typedef int4 simdi;
+
+  public:
+    struct Type : public PrimitiveType 
+    {
+      Type ();
+      size_t size(const char* This) const;
+    };
+    static Type type;
+
+  public:
+
+    /*! returns maximal number of stored spheres */
+    static __forceinline size_t max_size() { return 4; }
+    
+     /*! returns required number of primitive blocks for N primitives */
+    static __forceinline size_t blocks(size_t N) { return (N+max_size()-1)/max_size(); }
+   
+  public:
+
+    /*! Default constructor. */
+    __forceinline Sphere4 () {}
+
+    /*! Construction from centers, radii and IDs. */
+    __forceinline Sphere4 (const Vec3f4& c, const float4& r, const int4& geomIDs, const int4& primIDs)
+      : c(c), r(r), geomIDs(geomIDs), primIDs(primIDs) {}
+    
+    /*! Returns a mask that tells which spheres are valid. */
+    __forceinline bool4 valid() const { return geomIDs != int4(-1); }
+
+    /*! Returns true if the specified sphere is valid. */
+    __forceinline bool valid(const size_t i) const { assert(i<4); return geomIDs[i] != -1; }
+
+    /*! Returns the number of stored spheres. */
+    __forceinline size_t size() const { return __bsf(~movemask(valid())); }
+
+    /*! returns the geometry IDs */
+    __forceinline int4 geomID() const { return geomIDs; }
+    __forceinline int geomID(const size_t i) const { assert(i<4); return geomIDs[i]; }
+
+    /*! returns the primitive IDs */
+    __forceinline int4 primID() const { return primIDs; }
+    __forceinline int  primID(const size_t i) const { assert(i<4); return primIDs[i]; }
+
+    /*! calculate the bounds of the spheres */
+    __forceinline BBox3fa bounds() const 
+    {
+      Vec3f4 lower = c-Vec3f4(r);
+      Vec3f4 upper = c+Vec3f4(r);
+      bool4 mask = valid();
+      lower.x = select(mask,lower.x,float4(pos_inf));
+      lower.y = select(mask,lower.y,float4(pos_inf));
+      lower.z = select(mask,lower.z,float4(pos_inf));
+      upper.x = select(mask,upper.x,float4(neg_inf));
+      upper.y = select(mask,upper.y,float4(neg_inf));
+      upper.z = select(mask,upper.z,float4(neg_inf));
+      return BBox3fa(Vec3fa(reduce_min(lower.x),reduce_min(lower.y),reduce_min(lower.z)),
+                     Vec3fa(reduce_max(upper.x),reduce_max(upper.y),reduce_max(upper.z)));
+    }
+    
+    /*! non temporal store */
+    __forceinline static void store_nt(Sphere4* dst, const Sphere4& src)
+    {
+      store4f_nt(&dst->c.x,src.c.x);
+      store4f_nt(&dst->c.y,src.c.y);
+      store4f_nt(&dst->c.z,src.c.z);
+      store4f_nt(&dst->r,src.r);
+      store4i_nt(&dst->geomIDs,src.geomIDs);
+      store4i_nt(&dst->primIDs,src.primIDs);
+    }
+
+    /*! fill spheres from point list */
+    __forceinline void fill(const PrimRef* prims, size_t& begin, size_t end, Scene* scene, const bool list)
+    {
+      int4 vgeomID = -1, vprimID = -1;
+      Vec3f4 vc = zero; float4 vr = zero;
+      
+      for (size_t i=0; i<4 && begin<end; i++, begin++)
+      {
+	const PrimRef& prim = prims[begin];
+        const size_t geomID = prim.geomID();
+        const size_t primID = prim.primID();
+        const Points* __restrict__ const points = scene->getPoints(geomID);
+        const Vec3fa p = points->vertex(primID);
+        vgeomID [i] = geomID;
+        vprimID [i] = primID;
+        vc.x[i] = p.x; vc.y[i] = p.y; vc.z[i] = p.z; vr[i] = p.w;
+      }
+      Sphere4::store_nt(this,Sphere4(vc,vr,vgeomID,vprimID));
+    }
+   
+  public:
+    Vec3f4 c;       //!< centers of the spheres
+    float4 r;       //!< radii of the spheres
+    int4 geomIDs;   //!< geometry ID
+    int4 primIDs;   //!< primitive ID
+  };
+}
@@ -0,0 +1,109 @@
+// ======================================================================== //
+// Copyright 2009-2015 Intel Corporation                                    //
+//                                                                          //
+// Licensed under the Apache License, Version 2.0 (the "License");          //
+// you may not use this file except in compliance with the License.         //
+// You may obtain a copy of the License at                                  //
+//                                                                          //
+//     http://www.apache.org/licenses/LICENSE-2.0                           //
+//                                                                          //
+// Unless required by applicable law or agreed to in writing, software      //
+// distributed under the License is distributed on an "AS IS" BASIS,        //
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. //
+// See the License for the specific language governing permissions and      //
+// limitations under the License.                                           //
+// ======================================================================== //
+
+#pragma once
+
+#include "primitive.h"
+
+namespace embree
+{
+  /*! Stores the centers and radii of 4 linearly moving spheres in
+   *  struct of array layout. */
+  struct Sphere4MB
+  {
+    typedef bool4 simdb;
+    typedef float4 simdf;
+    typedef int4 simdi;
+
+  public:
+    struct Type : public PrimitiveType 
+    {
+      Type ();
+      size_t size(const char* This) const;
+    };
+
+    static Type type;
+
+  public:
+    
+    /*! returns maximal number of stored spheres */
+    static __forceinline size_t max_size() { return 4; }
+    
+     /*! returns required number of primitive blocks for N primitives */
+    static __forceinline size_t blocks(size_t N) { return (N+max_size()-1)/max_size(); }
+   
+  public:
+
+    /*! Default constructor. */
+    __forceinline Sphere4MB () {}
+
+    /*! Construction from centers and radii at both time steps and IDs. */
+    __forceinline Sphere4MB (const Vec3f4& c0, const float4& r0, const Vec3f4& c1, const float4& r1, const int4& geomIDs, const int4& primIDs)
+      : c(c0), r(r0), dc(c1-c0), dr(r1-r0), geomIDs(geomIDs), primIDs(primIDs) {}
+
+     /*! Returns a mask that tells which spheres are valid. */
+    __forceinline bool4 valid() const { return geomIDs != int4(-1); }
+
+    /*! Returns if the specified sphere is valid. */
+    __forceinline bool valid(const size_t i) const { assert(i<4); return geomIDs[i] != -1; }
+
+    /*! Returns the number of stored spheres. */
+    __forceinline size_t size() const { return __bsf(~movemask(valid())); }
+
+    /*! returns the geometry IDs */
+    __forceinline int4 geomID() const { return geomIDs; }
+    __forceinline int geomID(const size_t i) const { assert(i<4); return geomIDs[i]; }
+
+    /*! returns the primitive IDs */
+    __forceinline int4 primID() const { return primIDs; }
+    __forceinline int  primID(const size_t i) const { assert(i<4); return primIDs[i]; }
+
+    /*! fill spheres from point list, storing the spheres at the start and end of the time range */
+    __forceinline std::pair<BBox3fa,BBox3fa> fill(const PrimRef* prims, size_t& begin, size_t end, Scene* scene, const BBox1f& time_range, const bool list)
+    {
+      int4 vgeomID = -1, vprimID = -1;
+      Vec3f4 vc0 = zero, vc1 = zero;
+      float4 vr0 = zero, vr1 = zero;
+
+      BBox3fa bounds0 = empty;
+      BBox3fa bounds1 = empty;
+      
+      for (size_t i=0; i<4 && begin<end; i++, begin++)
+      {
+	const PrimRef& prim = prims[begin];
+        const size_t geomID = prim.geomID();
+        const size_t primID = prim.primID();
+        const Points* __restrict__ const points = scene->getPoints(geomID);
+        const Vec3fa p0 = points->interpolateVertex(primID,time_range.lower); bounds0.extend(Points::sphereBounds(p0));
+        const Vec3fa p1 = points->interpolateVertex(primID,time_range.upper); bounds1.extend(Points::sphereBounds(p1));
+        vgeomID [i] = geomID;
+        vprimID [i] = primID;
+        vc0.x[i] = p0.x; vc0.y[i] = p0.y; vc0.z[i] = p0.z; vr0[i] = p0.w;
+        vc1.x[i] = p1.x; vc1.y[i] = p1.y; vc1.z[i] = p1.z; vr1[i] = p1.w;
+      }
+      new (this) Sphere4MB(vc0,vr0,vc1,vr1,vgeomID,vprimID);
+      return std::make_pair(bounds0,bounds1);
+    }
+   
+  public:
+    Vec3f4 c;       //!< centers of the spheres at the start of the time range
+    float4 r;       //!< radii of the spheres at the start of the time range
+    Vec3f4 dc;      //!< motion of the centers over the time range
+    float4 dr;      //!< change of the radii over the time range
+    int4 geomIDs;   //!< geometry ID
+    int4 primIDs;   //!< primitive ID
+  };
+}
@@ -0,0 +1,548 @@
+// ======================================================================== //
+// Copyright 2009-2015 Intel Corporation                                    //
+//                                                                          //
+// Licensed under the Apache License, Version 2.0 (the "License");          //
+// you may not use this file except in compliance with the License.         //
+// You may obtain a copy of the License at                                  //
+//                                                                          //
+//     http://www.apache.org/licenses/LICENSE-2.0                           //
+//                                                                          //
+// Unless required by applicable law or agreed to in writing, software      //
+// distributed under the License is distributed on an "AS IS" BASIS,        //
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. //
+// See the License for the specific language governing permissions and      //
+// limitations under the License.                                           //
+// ======================================================================== //
+
+#pragma once
+
+#include "../../common/ray.h"
+#include "filter.h"
+
+/*! This intersector analytically intersects rays with spheres. The
+ *  hit distance is the closest root of the quadratic equation
+ *  |O+t*D-C|^2 = r^2 inside the ray interval, the reported geometry
+ *  normal is the unnormalized vector from the sphere center to the
+ *  hit point and the hit coordinates u/v are always zero. */
+
+namespace embree
+{
+  namespace isa
+  {
+    /*! Intersects a ray with spheres and returns the valid mask and the hit. */
+    template<typename simdf>
+      __forceinline typename simdf::Mask sphere_intersect(const Vec3<simdf>& O, const Vec3<simdf>& D, 
+                                                          const simdf& tnear, const simdf& tfar,
+                                                          const Vec3<simdf>& c, const simdf& r,
+                                                          simdf& t, Vec3<simdf>& Ng)
+    {
+      typedef typename simdf::Mask simdb;
+
+      /* solve quadratic equation */
+      const Vec3<simdf> oc = O-c;
+      const simdf A = dot(D,D);
+      const simdf B = dot(oc,D);
+      const simdf C = dot(oc,oc)-r*r;
+      const simdf disc = B*B-A*C;
+      simdb valid = disc >= simdf(zero);
+      if (likely(none(valid))) return valid;
+      
+      /* take the closest root inside the ray interval */
+      const simdf Q = sqrt(max(disc,simdf(zero)));
+      const simdf rcpA = rcp(A);
+      const simdf t0 = (-B-Q)*rcpA;
+      const simdf t1 = (-B+Q)*rcpA;
+      const simdb valid0 = valid & (t0 > tnear) & (t0 < tfar);
+      const simdb valid1 = valid & (t1 > tnear) & (t1 < tfar);
+      valid = valid0 | valid1;
+      if (likely(none(valid))) return valid;
+      
+      /* calculate hit information */
+      t = select(valid0,t0,t1);
+      Ng = Vec3<simdf>(oc.x+t*D.x,oc.y+t*D.y,oc.z+t*D.z);
+      return valid;
+    }
+
+    /*! Intersect a ray with the N spheres and updates the hit. */
+    template<bool enableIntersectionFilter, typename tsimdf, typename tsimdi>
+      __forceinline void sphere_intersect(Ray& ray, const Vec3<tsimdf>& c, const tsimdf& r,
+                                          const tsimdi& sphere_geomIDs, const tsimdi& sphere_primIDs, Scene* scene)
+    {
+      typedef typename tsimdf::Mask tsimdb;
+      typedef Vec3<tsimdf> tsimd3f;
+      tsimdf t; tsimd3f Ng;
+      tsimdb valid = sphere_intersect(tsimd3f(ray.org),tsimd3f(ray.dir),tsimdf(ray.tnear),tsimdf(ray.tfar),c,r,t,Ng);
+      if (likely(none(valid))) return;
+
+      size_t i = select_min(valid,t);
+      int geomID = sphere_geomIDs[i];
+      
+      /* intersection filter test */
+#if defined(RTCORE_INTERSECTION_FILTER) || defined(RTCORE_RAY_MASK)
+      goto entry;
+      while (true) 
+      {
+        if (unlikely(none(valid))) return;
+        i = select_min(valid,t);
+        geomID = sphere_geomIDs[i];
+      entry:
+        Geometry* geometry = scene->get(geomID);
+        
+#if defined(RTCORE_RAY_MASK)
+        /* goto next hit if mask test fails */
+        if ((geometry->mask & ray.mask) == 0) {
+          valid[i] = 0;
+          continue;
+        }
+#endif
+        
+#if defined(RTCORE_INTERSECTION_FILTER) 
+        /* call intersection filter function */
+        if (enableIntersectionFilter) {
+          if (unlikely(geometry->hasIntersectionFilter1())) {
+            const Vec3fa Ngi = Vec3fa(Ng.x[i],Ng.y[i],Ng.z[i]);
+            if (runIntersectionFilter1(geometry,ray,0.0f,0.0f,t[i],Ngi,geomID,sphere_primIDs[i])) return;
+            valid[i] = 0;
+            continue;
+          }
+        }
+#endif
+        break;
+      }
+#endif
+      
+      /* update hit information */
+      ray.u = 0.0f;
+      ray.v = 0.0f;
+      ray.tfar = t[i];
+      ray.Ng.x = Ng.x[i];
+      ray.Ng.y = Ng.y[i];
+      ray.Ng.z = Ng.z[i];
+      ray.geomID = geomID;
+      ray.primID = sphere_primIDs[i];
+    }
+
+    /*! Test if the ray is occluded by one of N spheres. */
+    template<bool enableIntersectionFilter, typename tsimdf, typename tsimdi>
+      __forceinline bool sphere_occluded(Ray& ray, const Vec3<tsimdf>& c, const tsimdf& r,
+                                         const tsimdi& sphere_geomIDs, const tsimdi& sphere_primIDs, Scene* scene)
+    {
+      typedef typename tsimdf::Mask tsimdb;
+      typedef Vec3<tsimdf> tsimd3f;
+      tsimdf t; tsimd3f Ng;
+      tsimdb valid = sphere_intersect(tsimd3f(ray.org),tsimd3f(ray.dir),tsimdf(ray.tnear),tsimdf(ray.tfar),c,r,t,Ng);
+      if (unlikely(none(valid))) return false;
+      
+      /* intersection filter test */
+#if defined(RTCORE_INTERSECTION_FILTER) || defined(RTCORE_RAY_MASK)
+      size_t m=movemask(valid);
+      goto entry;
+      while (true)
+      {  
+        if (unlikely(m == 0)) return false;
+      entry:
+        size_t i=__bsf(m);
+        const int geomID = sphere_geomIDs[i];
+        Geometry* geometry = scene->get(geomID);
+        
+#if defined(RTCORE_RAY_MASK)
+        /* goto next hit if mask test fails */
+        if ((geometry->mask & ray.mask) == 0) {
+          m=__btc(m,i);
+          continue;
+        }
+#endif
+        
+#if defined(RTCORE_INTERSECTION_FILTER)
+        /* if we have no filter then the test passed */
+        if (enableIntersectionFilter) {
+          if (unlikely(geometry->hasOcclusionFilter1())) 
+          {
+            const Vec3fa Ngi = Vec3fa(Ng.x[i],Ng.y[i],Ng.z[i]);
+            if (runOcclusionFilter1(geometry,ray,0.0f,0.0f,t[i],Ngi,geomID,sphere_primIDs[i])) return true;
+            m=__btc(m,i);
+            continue;
+          }
+        }
+#endif
+        break;
+      }
+#endif
+      
+      return true;
+    }
+
+    /*! Intersects M rays with the i'th of N spheres. */
+    template<bool enableIntersectionFilter, typename tsimdi, typename RayM>
+      __forceinline void sphere_intersect(const typename RayM::simdb& valid0, RayM& ray, 
+                                          const Vec3<typename RayM::simdf>& c, const typename RayM::simdf& r,
+                                          const tsimdi& sphere_geomIDs, const tsimdi& sphere_primIDs, const size_t i, Scene* scene)
+    {
+      /* ray SIMD type shortcuts */
+      typedef typename RayM::simdb rsimdb;
+      typedef typename RayM::simdf rsimdf;
+      typedef typename RayM::simdi rsimdi;
+      typedef Vec3<rsimdf> rsimd3f;
+      
+      rsimdf t; rsimd3f Ng;
+      rsimdb valid = valid0 & sphere_intersect(ray.org,ray.dir,ray.tnear,ray.tfar,c,r,t,Ng);
+      if (likely(none(valid))) return;
+
+      const int geomID = sphere_geomIDs[i];
+      const int primID = sphere_primIDs[i];
+      Geometry* geometry = scene->get(geomID);
+      
+      /* ray masking test */
+#if defined(RTCORE_RAY_MASK)
+      valid &= (geometry->mask & ray.mask) != 0;
+      if (unlikely(none(valid))) return;
+#endif
+      
+      /* intersection filter test */
+#if defined(RTCORE_INTERSECTION_FILTER)
+      if (enableIntersectionFilter) {
+        if (unlikely(geometry->hasIntersectionFilter<rsimdf>())) {
+          runIntersectionFilter(valid,geometry,ray,rsimdf(zero),rsimdf(zero),t,Ng,geomID,primID);
+          return;
+        }
+      }
+#endif
+      
+      /* update hit information */
+      rsimdf::store(valid,&ray.u,rsimdf(zero));
+      rsimdf::store(valid,&ray.v,rsimdf(zero));
+      rsimdf::store(valid,&ray.tfar,t);
+      rsimdi::store(valid,&ray.geomID,geomID);
+      rsimdi::store(valid,&ray.primID,primID);
+      rsimdf::store(valid,&ray.Ng.x,Ng.x);
+      rsimdf::store(valid,&ray.Ng.y,Ng.y);
+      rsimdf::store(valid,&ray.Ng.z,Ng.z);
+    }
+
+    /*! Test for M rays if they are occluded by the i'th of N spheres. */
+    template<bool enableIntersectionFilter, typename tsimdi, typename RayM>
+      __forceinline void sphere_occluded(typename RayM::simdb& valid0, RayM& ray, 
+                                         const Vec3<typename RayM::simdf>& c, const typename RayM::simdf& r,
+                                         const tsimdi& sphere_geomIDs, const tsimdi& sphere_primIDs, const size_t i, Scene* scene)
+    {
+      /* ray SIMD type shortcuts */
+      typedef typename RayM::simdb rsimdb;
+      typedef typename RayM::simdf rsimdf;
+      typedef Vec3<rsimdf> rsimd3f;
+      
+      rsimdf t; rsimd3f Ng;
+      rsimdb valid = valid0 & sphere_intersect(ray.org,ray.dir,ray.tnear,ray.tfar,c,r,t,Ng);
+      if (likely(none(valid))) return;
+
+      /* ray masking test */
+      const int geomID = sphere_geomIDs[i];
+      Geometry* geometry = scene->get(geomID);
+#if defined(RTCORE_RAY_MASK)
+      valid &= (geometry->mask & ray.mask) != 0;
+      if (unlikely(none(valid))) return;
+#endif
+      
+      /* intersection filter test */
+#if defined(RTCORE_INTERSECTION_FILTER)
+      if (enableIntersectionFilter) 
+      {
+        if (unlikely(geometry->hasOcclusionFilter<rsimdf>()))
+        {
+          const int primID = sphere_primIDs[i];
+          valid = runOcclusionFilter(valid,geometry,ray,rsimdf(zero),rsimdf(zero),t,Ng,geomID,primID);
+        }
+      }
+#endif
+      
+      /* update occlusion */
+      valid0 &= !valid;
+    }
+
+    /*! Intersect the k'th ray of a packet with the N spheres and updates the hit. */
+    template<bool enableIntersectionFilter, typename tsimdf, typename tsimdi, typename RayM>
+      __forceinline void sphere_intersect(RayM& ray, size_t k, const Vec3<tsimdf>& c, const tsimdf& r,
+                                          const tsimdi& sphere_geomIDs, const tsimdi& sphere_primIDs, Scene* scene)
+    {
+      /* type shortcuts */
+      typedef typename RayM::simdf rsimdf;
+      typedef typename tsimdf::Mask tsimdb;
+      typedef Vec3<tsimdf> tsimd3f;
+
+      const tsimd3f O = broadcast<tsimdf>(ray.org,k);
+      const tsimd3f D = broadcast<tsimdf>(ray.dir,k);
+      tsimdf t; tsimd3f Ng;
+      tsimdb valid = sphere_intersect(O,D,tsimdf(ray.tnear[k]),tsimdf(ray.tfar[k]),c,r,t,Ng);
+      if (likely(none(valid))) return;
+
+      size_t i = select_min(valid,t);
+      int geomID = sphere_geomIDs[i];
+      
+      /* intersection filter test */
+#if defined(RTCORE_INTERSECTION_FILTER) || defined(RTCORE_RAY_MASK)
+      goto entry;
+      while (true) 
+      {
+        if (unlikely(none(valid))) return;
+        i = select_min(valid,t);
+        geomID = sphere_geomIDs[i];
+      entry:
+        Geometry* geometry = scene->get(geomID);
+        
+#if defined(RTCORE_RAY_MASK)
+        /* goto next hit if mask test fails */
+        if ((geometry->mask & ray.mask[k]) == 0) {
+          valid[i] = 0;
+          continue;
+        }
+#endif
+        
+#if defined(RTCORE_INTERSECTION_FILTER) 
+        /* call intersection filter function */
+        if (enableIntersectionFilter) {
+          if (unlikely(geometry->hasIntersectionFilter<rsimdf>())) {
+            const Vec3fa Ngi = Vec3fa(Ng.x[i],Ng.y[i],Ng.z[i]);
+            if (runIntersectionFilter(geometry,ray,k,0.0f,0.0f,t[i],Ngi,geomID,sphere_primIDs[i])) return;
+            valid[i] = 0;
+            continue;
+          }
+        }
+#endif
+        break;
+      }
+#endif
+      
+      /* update hit information */
+      ray.u[k] = 0.0f;
+      ray.v[k] = 0.0f;
+      ray.tfar[k] = t[i];
+      ray.Ng.x[k] = Ng.x[i];
+      ray.Ng.y[k] = Ng.y[i];
+      ray.Ng.z[k] = Ng.z[i];
+      ray.geomID[k] = geomID;
+      ray.primID[k] = sphere_primIDs[i];
+    }
+
+    /*! Test if the k'th ray of a packet is occluded by one of the N spheres. */
+    template<bool enableIntersectionFilter, typename tsimdf, typename tsimdi, typename RayM>
+      __forceinline bool sphere_occluded(RayM& ray, size_t k, const Vec3<tsimdf>& c, const tsimdf& r,
+                                         const tsimdi& sphere_geomIDs, const tsimdi& sphere_primIDs, Scene* scene)
+    {
+      /* type shortcuts */
+      typedef typename RayM::simdf rsimdf;
+      typedef typename tsimdf::Mask tsimdb;
+      typedef Vec3<tsimdf> tsimd3f;
+      
+      const tsimd3f O = broadcast<tsimdf>(ray.org,k);
+      const tsimd3f D = broadcast<tsimdf>(ray.dir,k);
+      tsimdf t; tsimd3f Ng;
+      tsimdb valid = sphere_intersect(O,D,tsimdf(ray.tnear[k]),tsimdf(ray.tfar[k]),c,r,t,Ng);
+      if (unlikely(none(valid))) return false;
+      
+      /* intersection filter test */
+#if defined(RTCORE_INTERSECTION_FILTER) || defined(RTCORE_RAY_MASK)
+      size_t m=movemask(valid);
+      goto entry;
+      while (true)
+      {  
+        if (unlikely(m == 0)) return false;
+      entry:
+        size_t i=__bsf(m);
+        const int geomID = sphere_geomIDs[i];
+        Geometry* geometry = scene->get(geomID);
+        
+#if defined(RTCORE_RAY_MASK)
+        /* goto next hit if mask test fails */
+        if ((geometry->mask & ray.mask[k]) == 0) {
+          m=__btc(m,i);
+          continue;
+        }
+#endif
+        
+#if defined(RTCORE_INTERSECTION_FILTER)
+        /* execute occlusion filer */
+        if (enableIntersectionFilter) {
+          if (unlikely(geometry->hasOcclusionFilter<rsimdf>())) 
+          {
+            const Vec3fa Ngi = Vec3fa(Ng.x[i],Ng.y[i],Ng.z[i]);
+            if (runOcclusionFilter(geometry,ray,k,0.0f,0.0f,t[i],Ngi,geomID,sphere_primIDs[i])) return true;
+            m=__btc(m,i);
+            continue;
+          }
+        }
+#endif
+        break;
+      }
+#endif
+      
+      return true;
+    }
+    
+    /*! Intersects N spheres with 1 ray */
+    template<typename SphereN, bool enableIntersectionFilter>
+      struct SphereNIntersector1
+      {
+        typedef SphereN Primitive;
+        
+        struct Precalculations {
+          __forceinline Precalculations (const Ray& ray, const void* ptr) {}
+        };
+        
+        /*! Intersect a ray with the N spheres and updates the hit. */
+        static __forceinline void intersect(const Precalculations& pre, Ray& ray, const SphereN& sphere, Scene* scene)
+        {
+          STAT3(normal.trav_prims,1,1,1);
+          sphere_intersect<enableIntersectionFilter>(ray,sphere.c,sphere.r,sphere.geomIDs,sphere.primIDs,scene);
+        }
+        
+        /*! Test if the ray is occluded by one of N spheres. */
+        static __forceinline bool occluded(const Precalculations& pre, Ray& ray, const SphereN& sphere, Scene* scene)
+        {
+          STAT3(shadow.trav_prims,1,1,1);
+          return sphere_occluded<enableIntersectionFilter>(ray,sphere.c,sphere.r,sphere.geomIDs,sphere.primIDs,scene);
+        }
+      };
+
+    /*! Intersector for N spheres with M rays. */
+    template<typename RayM, typename SphereN, bool enableIntersectionFilter>
+      struct SphereNIntersectorM
+      {
+        typedef SphereN Primitive;
+        
+        /* ray SIMD type shortcuts */
+        typedef typename RayM::simdb rsimdb;
+        typedef typename RayM::simdf rsimdf;
+        typedef Vec3<rsimdf> rsimd3f;
+        
+        struct Precalculations {
+          __forceinline Precalculations (const rsimdb& valid, const RayM& ray) {}
+        };
+        
+        /*! Intersects M rays with N spheres. */
+        static __forceinline void intersect(const rsimdb& valid_i, Precalculations& pre, RayM& ray, const SphereN& sphere, Scene* scene)
+        {
+          for (size_t i=0; i<SphereN::max_size(); i++)
+          {
+            if (!sphere.valid(i)) break;
+            STAT3(normal.trav_prims,1,popcnt(valid_i),RayM::size());
+            const rsimd3f c = broadcast<rsimdf>(sphere.c,i);
+            const rsimdf r = rsimdf(sphere.r[i]);
+            sphere_intersect<enableIntersectionFilter>(valid_i,ray,c,r,sphere.geomIDs,sphere.primIDs,i,scene);
+          }
+        }
+        
+        /*! Test for M rays if they are occluded by any of the N spheres. */
+        static __forceinline rsimdb occluded(const rsimdb& valid_i, Precalculations& pre, RayM& ray, const SphereN& sphere, Scene* scene)
+        {
+          rsimdb valid0 = valid_i;
+          
+          for (size_t i=0; i<SphereN::max_size(); i++)
+          {
+            if (!sphere.valid(i)) break;
+            STAT3(shadow.trav_prims,1,popcnt(valid0),RayM::size());
+            const rsimd3f c = broadcast<rsimdf>(sphere.c,i);
+            const rsimdf r = rsimdf(sphere.r[i]);
+            sphere_occluded<enableIntersectionFilter>(valid0,ray,c,r,sphere.geomIDs,sphere.primIDs,i,scene);
+            if (none(valid0)) break;
+          }
+          return !valid0;
+        }
+        
+        /*! Intersect the k'th ray with the N spheres and updates the hit. */
+        static __forceinline void intersect(Precalculations& pre, RayM& ray, size_t k, const SphereN& sphere, Scene* scene)
+        {
+          STAT3(normal.trav_prims,1,1,1);
+          sphere_intersect<enableIntersectionFilter>(ray,k,sphere.c,sphere.r,sphere.geomIDs,sphere.primIDs,scene);
+        }
+        
+        /*! Test if the k'th ray is occluded by one of the N spheres. */
+        static __forceinline bool occluded(Precalculations& pre, RayM& ray, size_t k, const SphereN& sphere, Scene* scene)
+        {
+          STAT3(shadow.trav_prims,1,1,1);
+          return sphere_occluded<enableIntersectionFilter>(ray,k,sphere.c,sphere.r,sphere.geomIDs,sphere.primIDs,scene);
+        }
+      };
+
+    /*! Intersects N moving spheres with 1 ray */
+    template<typename SphereNMblur, bool enableIntersectionFilter>
+      struct SphereNMblurIntersector1
+      {
+        typedef SphereNMblur Primitive;
+        
+        /* type shortcuts */
+        typedef typename SphereNMblur::simdf tsimdf;
+        typedef Vec3<tsimdf> tsimd3f;
+
+        struct Precalculations {
+          __forceinline Precalculations (const Ray& ray, const void* ptr) {}
+        };
+        
+        /*! Intersect a ray with the N spheres and updates the hit. */
+        static __forceinline void intersect(const Precalculations& pre, Ray& ray, const SphereNMblur& sphere, Scene* scene)
+        {
+          STAT3(normal.trav_prims,1,1,1);
+          const tsimdf time = tsimdf(ray.time);
+          const tsimd3f c = sphere.c + time*sphere.dc;
+          const tsimdf  r = sphere.r + time*sphere.dr;
+          sphere_intersect<enableIntersectionFilter>(ray,c,r,sphere.geomIDs,sphere.primIDs,scene);
+        }
+        
+        /*! Test if the ray is occluded by one of N spheres. */
+        static __forceinline bool occluded(const Precalculations& pre, Ray& ray, const SphereNMblur& sphere, Scene* scene)
+        {
+          STAT3(shadow.trav_prims,1,1,1);
+          const tsimdf time = tsimdf(ray.time);
+          const tsimd3f c = sphere.c + time*sphere.dc;
+          const tsimdf  r = sphere.r + time*sphere.dr;
+          return sphere_occluded<enableIntersectionFilter>(ray,c,r,sphere.geomIDs,sphere.primIDs,scene);
+        }
+      };
+
+    /*! Intersector for N moving spheres with M rays. */
+    template<typename RayM, typename SphereNMblur, bool enableIntersectionFilter>
+      struct SphereNMblurIntersectorM
+      {
+        typedef SphereNMblur Primitive;
+        
+        /* ray SIMD type shortcuts */
+        typedef typename RayM::simdb rsimdb;
+        typedef typename RayM::simdf rsimdf;
+        typedef Vec3<rsimdf> rsimd3f;
+        
+        struct Precalculations {
+          __forceinline Precalculations (const rsimdb& valid, const RayM& ray) {}
+        };
+        
+        /*! Intersects M rays with N spheres. */
+        static __forceinline void intersect(const rsimdb& valid_i, Precalculations& pre, RayM& ray, const SphereNMblur& sphere, Scene* scene)
+        {
+          for (size_t i=0; i<SphereNMblur::max_size(); i++)
+          {
+            if (!sphere.valid(i)) break;
+            STAT3(normal.trav_prims,1,popcnt(valid_i),RayM::size());
+            const rsimdf time = ray.time;
+            const rsimd3f c = broadcast<rsimdf>(sphere.c,i) + time*broadcast<rsimdf>(sphere.dc,i);
+            const rsimdf  r = rsimdf(sphere.r[i]) + time*rsimdf(sphere.dr[i]);
+            sphere_intersect<enableIntersectionFilter>(valid_i,ray,c,r,sphere.geomIDs,sphere.primIDs,i,scene);
+          }
+        }
+        
+        /*! Test for M rays if they are occluded by any of the N spheres. */
+        static __forceinline rsimdb occluded(const rsimdb& valid_i, Precalculations& pre, RayM& ray, const SphereNMblur& sphere, Scene* scene)
+        {
+          rsimdb valid0 = valid_i;
+          
+          for (size_t i=0; i<SphereNMblur::max_size(); i++)
+          {
+            if (!sphere.valid(i)) break;
+            STAT3(shadow.trav_prims,1,popcnt(valid0),RayM::size());
+            const rsimdf time = ray.time;
+            const rsimd3f c = broadcast<rsimdf>(sphere.c,i) + time*broadcast<rsimdf>(sphere.dc,i);
+            const rsimdf  r = rsimdf(sphere.r[i]) + time*rsimdf(sphere.dr[i]);
+            sphere_occluded<enableIntersectionFilter>(valid0,ray,c,r,sphere.geomIDs,sphere.primIDs,i,scene);
+            if (none(valid0)) break;
+          }
+          return !valid0;
+        }
+      };
+  }
+}
@@ -145,8 +145,8 @@ namespace embree
       new (this) Triangle4vMB(va0,va1,vb0,vb1,vc0,vc1,vgeomID,vprimID); // FIXME: store_nt
     }
     
-    /*! fill triangle from triangle list */
-    __forceinline std::pair<BBox3fa,BBox3fa> fill(const PrimRef* prims, size_t& begin, size_t end, Scene* scene, const bool list)
+    /*! fill triangle from triangle list, storing the vertices at the start and end of the time range */
+    __forceinline std::pair<BBox3fa,BBox3fa> fill(const PrimRef* prims, size_t& begin, size_t end, Scene* scene, const BBox1f& time_range, const bool list)
     {
       int4 vgeomID = -1, vprimID = -1;
       Vec3f4 va0 = zero, vb0 = zero, vc0 = zero;
@@ -162,12 +162,12 @@ namespace embree
         const size_t primID = prim.primID();
         const TriangleMesh* __restrict__ const mesh = scene->getTriangleMesh(geomID);
         const TriangleMesh::Triangle& tri = mesh->triangle(primID);
-	const Vec3fa& a0 = mesh->vertex(tri.v[0],0); bounds0.extend(a0);
-	const Vec3fa& a1 = mesh->vertex(tri.v[0],1); bounds1.extend(a1);
-        const Vec3fa& b0 = mesh->vertex(tri.v[1],0); bounds0.extend(b0);
-	const Vec3fa& b1 = mesh->vertex(tri.v[1],1); bounds1.extend(b1);
-        const Vec3fa& c0 = mesh->vertex(tri.v[2],0); bounds0.extend(c0);
-	const Vec3fa& c1 = mesh->vertex(tri.v[2],1); bounds1.extend(c1);
+	const Vec3fa a0 = mesh->interpolateVertex(tri.v[0],time_range.lower); bounds0.extend(a0);
+	const Vec3fa a1 = mesh->interpolateVertex(tri.v[0],time_range.upper); bounds1.extend(a1);
+        const Vec3fa b0 = mesh->interpolateVertex(tri.v[1],time_range.lower); bounds0.extend(b0);
+	const Vec3fa b1 = mesh->interpolateVertex(tri.v[1],time_range.upper); bounds1.extend(b1);
+        const Vec3fa c0 = mesh->interpolateVertex(tri.v[2],time_range.lower); bounds0.extend(c0);
+	const Vec3fa c1 = mesh->interpolateVertex(tri.v[2],time_range.upper); bounds1.extend(c1);
         vgeomID [i] = geomID;
         vprimID [i] = primID;
         va0.x[i] = a0.x; va0.y[i] = a0.y; va0.z[i] = a0.z;
@@ -652,7 +652,7 @@ PRINT(CORRECT_numPrims);
     for (size_t i=0;i<scene->size();i++)
       {
 	if (unlikely(scene->get(i) == nullptr)) continue;
-	if (unlikely((scene->get(i)->type != Geometry::USER_GEOMETRY) /*&& (scene->get(i)->type != INSTANCES)*/)) continue;
+	if (unlikely((scene->get(i)->type != Geometry::USER_GEOMETRY) && (scene->get(i)->type != Geometry::INSTANCE))) continue;
 	if (unlikely(!scene->get(i)->isEnabled())) continue;
         AccelSet* geom = (AccelSet*) scene->get(i);
 	numVirtualObjects += geom->size();
@@ -685,7 +685,7 @@ PRINT(CORRECT_numPrims);
     unsigned int g=0, numSkipped = 0;
     for (; g<numTotalGroups; g++) {       
       if (unlikely(scene->get(g) == nullptr)) continue;
-      if (unlikely((scene->get(g)->type != Geometry::USER_GEOMETRY) /*&& (scene->get(g)->type != INSTANCES)*/)) continue;
+      if (unlikely((scene->get(g)->type != Geometry::USER_GEOMETRY) && (scene->get(g)->type != Geometry::INSTANCE))) continue;
       if (unlikely(!scene->get(g)->isEnabled())) continue;
       const AccelSet* const geom = (AccelSet*) scene->get(g);
       const size_t numPrims = geom->size();
@@ -706,7 +706,7 @@ PRINT(CORRECT_numPrims);
     for (; g<numTotalGroups; g++) 
       {
 	if (unlikely(scene->get(g) == nullptr)) continue;
-	if (unlikely((scene->get(g)->type != Geometry::USER_GEOMETRY ) /*&& (scene->get(g)->type != INSTANCES)*/)) continue;
+	if (unlikely((scene->get(g)->type != Geometry::USER_GEOMETRY ) && (scene->get(g)->type != Geometry::INSTANCE))) continue;
 	if (unlikely(!scene->get(g)->isEnabled())) continue;
 
 	AccelSet *virtual_geometry = (AccelSet *)scene->get(g);
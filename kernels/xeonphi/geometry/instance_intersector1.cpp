@@ -20,11 +20,16 @@ namespace embree
 {
   namespace isa
   {
-    void InstanceBoundsFunction(const Instance* instance, size_t item, BBox3fa& bounds_o)
+    void InstanceBoundsFunction(Instance* instance, size_t item, BBox3fa& bounds_o)
     {
+      /* instances of an array without transformations are invalid */
+      if (instance->isArray && !instance->transforms) {
+        bounds_o = empty;
+        return;
+      }
       Vec3fa lower = instance->object->bounds.lower;
       Vec3fa upper = instance->object->bounds.upper;
-      AffineSpace3fa local2world = instance->local2world;
+      AffineSpace3fa local2world = instance->getLocal2World(item);
       Vec3fa p000 = xfmPoint(local2world,Vec3fa(lower.x,lower.y,lower.z));
       Vec3fa p001 = xfmPoint(local2world,Vec3fa(lower.x,lower.y,upper.z));
       Vec3fa p010 = xfmPoint(local2world,Vec3fa(lower.x,upper.y,lower.z));
@@ -39,16 +44,17 @@ namespace embree
 
     RTCBoundsFunc InstanceBoundsFunc = (RTCBoundsFunc) InstanceBoundsFunction;
 
-    void FastInstanceIntersector1::intersect(const Instance* instance, Ray& ray, size_t item)
+    void FastInstanceIntersector1::intersect(Instance* instance, Ray& ray, size_t item)
     {
       const Vec3fa ray_org = ray.org;
       const Vec3fa ray_dir = ray.dir;
       const int ray_geomID = ray.geomID;
       const int ray_instID = ray.instID;
-      ray.org = xfmPoint (instance->world2local,ray_org);
-      ray.dir = xfmVector(instance->world2local,ray_dir);
+      const AffineSpace3fa world2local = instance->getWorld2Local(item);
+      ray.org = xfmPoint (world2local,ray_org);
+      ray.dir = xfmVector(world2local,ray_dir);
       ray.geomID = -1;
-      ray.instID = instance->id;
+      ray.instID = instance->getInstID(item);
       instance->object->intersect((RTCRay&)ray);
       ray.org = ray_org;
       ray.dir = ray_dir;
@@ -58,12 +64,13 @@ namespace embree
       }
     }
     
-    void FastInstanceIntersector1::occluded (const Instance* instance, Ray& ray, size_t item)
+    void FastInstanceIntersector1::occluded (Instance* instance, Ray& ray, size_t item)
     {
       const Vec3fa ray_org = ray.org;
       const Vec3fa ray_dir = ray.dir;
-      ray.org = xfmPoint (instance->world2local,ray_org);
-      ray.dir = xfmVector(instance->world2local,ray_dir);
+      const AffineSpace3fa world2local = instance->getWorld2Local(item);
+      ray.org = xfmPoint (world2local,ray_org);
+      ray.dir = xfmVector(world2local,ray_dir);
       instance->object->occluded((RTCRay&)ray);
       ray.org = ray_org;
       ray.dir = ray_dir;
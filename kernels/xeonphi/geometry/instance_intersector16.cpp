@@ -22,17 +22,17 @@ namespace embree
   {
     typedef AffineSpaceT<LinearSpace3<Vec3f16> > AffineSpace3faMIC;
     
-    void FastInstanceIntersector16::intersect(int16* valid, const Instance* instance, Ray16& ray, size_t item)
+    void FastInstanceIntersector16::intersect(int16* valid, Instance* instance, Ray16& ray, size_t item)
     {
       const Vec3f16 ray_org = ray.org;
       const Vec3f16 ray_dir = ray.dir;
       const int16 ray_geomID = ray.geomID;
       const int16 ray_instID = ray.instID;
-      const AffineSpace3faMIC world2local(instance->world2local);
+      const AffineSpace3faMIC world2local(instance->getWorld2Local(item));
       ray.org = xfmPoint (world2local,ray_org);
       ray.dir = xfmVector(world2local,ray_dir);
       ray.geomID = -1;
-      ray.instID = instance->id;
+      ray.instID = instance->getInstID(item);
       instance->object->intersect16(valid,(RTCRay16&)ray);
       ray.org = ray_org;
       ray.dir = ray_dir;
@@ -41,15 +41,15 @@ namespace embree
       ray.instID = select(nohit,ray_instID,ray.instID);
     }
     
-    void FastInstanceIntersector16::occluded (int16* valid, const Instance* instance, Ray16& ray, size_t item)
+    void FastInstanceIntersector16::occluded (int16* valid, Instance* instance, Ray16& ray, size_t item)
     {
       const Vec3f16 ray_org = ray.org;
       const Vec3f16 ray_dir = ray.dir;
       const int16 ray_geomID = ray.geomID;
-      const AffineSpace3faMIC world2local(instance->world2local);
+      const AffineSpace3faMIC world2local(instance->getWorld2Local(item));
       ray.org = xfmPoint (world2local,ray_org);
       ray.dir = xfmVector(world2local,ray_dir);
-      ray.instID = instance->id;
+      ray.instID = instance->getInstID(item);
       instance->object->occluded16(valid,(RTCRay16&)ray);
       ray.org = ray_org;
       ray.dir = ray_dir;
@@ -153,6 +153,7 @@ namespace embree
     if (i & 8) flag |= RTC_SCENE_INCOHERENT;
     if (i & 16) flag |= RTC_SCENE_HIGH_QUALITY;
     if (i & 32) flag |= RTC_SCENE_ROBUST;
+    if (i & 64) flag |= RTC_SCENE_RELAYOUT;
     return (RTCSceneFlags) flag;
   }
 
@@ -179,6 +180,7 @@ namespace embree
     ray.tnear = 0.0f; ray.tfar = inf;
     ray.time = 0; ray.mask = -1;
     ray.geomID = ray.primID = ray.instID = -1;
+    for (size_t l=0; l<RTC_MAX_INSTANCE_DEPTH-1; l++) ray.instIDPath[l] = -1;
     return ray;
   }
 
@@ -190,6 +192,7 @@ namespace embree
     ray.tnear = tnear; ray.tfar = tfar;
     ray.time = 0; ray.mask = -1;
     ray.geomID = ray.primID = ray.instID = -1;
+    for (size_t l=0; l<RTC_MAX_INSTANCE_DEPTH-1; l++) ray.instIDPath[l] = -1;
     return ray;
   }
   
@@ -211,6 +214,7 @@ namespace embree
     ray_o.geomID[i] = ray_i.geomID;
     ray_o.primID[i] = ray_i.primID;
     ray_o.instID[i] = ray_i.instID;
+    for (size_t l=0; l<RTC_MAX_INSTANCE_DEPTH-1; l++) ray_o.instIDPath[l][i] = ray_i.instIDPath[l];
   }
 
   void setRay(RTCRay8& ray_o, int i, const RTCRay& ray_i)
@@ -231,6 +235,7 @@ namespace embree
     ray_o.geomID[i] = ray_i.geomID;
     ray_o.primID[i] = ray_i.primID;
     ray_o.instID[i] = ray_i.instID;
+    for (size_t l=0; l<RTC_MAX_INSTANCE_DEPTH-1; l++) ray_o.instIDPath[l][i] = ray_i.instIDPath[l];
   }
 
   void setRay(RTCRay16& ray_o, int i, const RTCRay& ray_i)
@@ -251,6 +256,7 @@ namespace embree
     ray_o.geomID[i] = ray_i.geomID;
     ray_o.primID[i] = ray_i.primID;
     ray_o.instID[i] = ray_i.instID;
+    for (size_t l=0; l<RTC_MAX_INSTANCE_DEPTH-1; l++) ray_o.instIDPath[l][i] = ray_i.instIDPath[l];
   }
 
   RTCRay getRay(RTCRay4& ray_i, int i)
@@ -264,6 +270,8 @@ namespace embree
     ray_o.dir[2] = ray_i.dirz[i];
     ray_o.tnear = ray_i.tnear[i];
     ray_o.tfar = ray_i.tfar[i];
+    ray_o.u = ray_i.u[i];
+    ray_o.v = ray_i.v[i];
     ray_o.Ng[0] = ray_i.Ngx[i];
     ray_o.Ng[1] = ray_i.Ngy[i];
     ray_o.Ng[2] = ray_i.Ngz[i];
@@ -272,6 +280,7 @@ namespace embree
     ray_o.geomID = ray_i.geomID[i];
     ray_o.primID = ray_i.primID[i];
     ray_o.instID = ray_i.instID[i];
+    for (size_t l=0; l<RTC_MAX_INSTANCE_DEPTH-1; l++) ray_o.instIDPath[l] = ray_i.instIDPath[l][i];
     return ray_o;
   }
 
@@ -286,6 +295,8 @@ namespace embree
     ray_o.dir[2] = ray_i.dirz[i];
     ray_o.tnear = ray_i.tnear[i];
     ray_o.tfar = ray_i.tfar[i];
+    ray_o.u = ray_i.u[i];
+    ray_o.v = ray_i.v[i];
     ray_o.Ng[0] = ray_i.Ngx[i];
     ray_o.Ng[1] = ray_i.Ngy[i];
     ray_o.Ng[2] = ray_i.Ngz[i];
@@ -294,6 +305,7 @@ namespace embree
     ray_o.geomID = ray_i.geomID[i];
     ray_o.primID = ray_i.primID[i];
     ray_o.instID = ray_i.instID[i];
+    for (size_t l=0; l<RTC_MAX_INSTANCE_DEPTH-1; l++) ray_o.instIDPath[l] = ray_i.instIDPath[l][i];
     return ray_o;
   }
 
@@ -308,6 +320,8 @@ namespace embree
     ray_o.dir[2] = ray_i.dirz[i];
     ray_o.tnear = ray_i.tnear[i];
     ray_o.tfar = ray_i.tfar[i];
+    ray_o.u = ray_i.u[i];
+    ray_o.v = ray_i.v[i];
     ray_o.Ng[0] = ray_i.Ngx[i];
     ray_o.Ng[1] = ray_i.Ngy[i];
     ray_o.Ng[2] = ray_i.Ngz[i];
@@ -316,6 +330,7 @@ namespace embree
     ray_o.geomID = ray_i.geomID[i];
     ray_o.primID = ray_i.primID[i];
     ray_o.instID = ray_i.instID[i];
+    for (size_t l=0; l<RTC_MAX_INSTANCE_DEPTH-1; l++) ray_o.instIDPath[l] = ray_i.instIDPath[l][i];
     return ray_o;
   }
 
@@ -1453,6 +1468,102 @@ namespace embree
     return true;
   }
 
+  bool rtcore_update_twolevel()
+  {
+    /* many small meshes, each moving along its own column, so that the two-level builder refits and partially rebuilds its toplevel BVH */
+    RTCScene scene = rtcDeviceNewScene(g_device,RTC_SCENE_DYNAMIC,aflags);
+    AssertNoError();
+    const size_t N = 64;
+    const size_t numPhi = 5;
+    const size_t numVertices = 2*numPhi*(numPhi+1);
+    Vec3fa pos[N]; bool enabled[N];
+    for (size_t i=0; i<N; i++) {
+      pos[i] = Vec3fa(4.0f*(i%8),0.0f,4.0f*(i/8));
+      enabled[i] = true;
+      addSphere(scene,RTC_GEOMETRY_DEFORMABLE,pos[i],1.0f,numPhi);
+    }
+    rtcCommit (scene);
+    AssertNoError();
+
+    for (size_t i=0; i<64; i++) 
+    {
+      /* move some meshes by small and some by large distances, and occasionally disable or enable one */
+      for (size_t j=0; j<N; j++) 
+      {
+        if (random<int>()%4) continue;
+        Vec3fa ds(0.0f,(i%8 == 7 ? 50.0f : 2.0f)*(2.0f*float(drand48())-1.0f),0.0f);
+        move_mesh_vec3f(scene,j,numVertices,ds); pos[j] += ds;
+      }
+      if (i%16 == 15) {
+        const size_t j = random<int>()%N;
+        if (enabled[j]) rtcDisable(scene,j); else rtcEnable(scene,j);
+        enabled[j] = !enabled[j];
+      }
+      rtcCommit (scene);
+      AssertNoError();
+
+      for (size_t j=0; j<N; j++) {
+        RTCRay ray = makeRay(pos[j]+Vec3fa(0.05f,100.0f,0.05f),Vec3fa(0,-1,0)); 
+        rtcIntersect(scene,ray);
+        if (ray.geomID != (enabled[j] ? unsigned(j) : RTC_INVALID_GEOMETRY_ID)) return false;
+      }
+    }
+    rtcDeleteScene (scene);
+    clearBuffers();
+    AssertNoError();
+    return true;
+  }
+
+  bool rtcore_save_load_scene()
+  {
+    const size_t N = 16;
+    const char* fileName = "verify_save_load.bin";
+    Vec3fa pos[N];
+    for (size_t i=0; i<N; i++) 
+      pos[i] = Vec3fa(4.0f*(i%4),0.0f,4.0f*(i/4));
+
+    RTCScene scene0 = rtcDeviceNewScene(g_device,RTC_SCENE_STATIC,aflags);
+    for (size_t i=0; i<N; i++) addSphere(scene0,RTC_GEOMETRY_STATIC,pos[i],1.0f,20);
+    rtcCommit (scene0);
+    rtcSaveScene(scene0,fileName);
+    AssertNoError();
+
+    /* the loaded scene has to report the same hits as the built one */
+    RTCScene scene1 = rtcDeviceNewScene(g_device,RTC_SCENE_STATIC,aflags);
+    for (size_t i=0; i<N; i++) addSphere(scene1,RTC_GEOMETRY_STATIC,pos[i],1.0f,20);
+    rtcLoadScene(scene1,fileName);
+    AssertNoError();
+
+    bool passed = true;
+    for (size_t i=0; i<N; i++) 
+    {
+      for (size_t j=0; j<16; j++) 
+      {
+        const Vec3fa org = pos[i]+Vec3fa(0.1f*float(j%4)-0.15f,10.0f,0.1f*float(j/4)-0.15f);
+        RTCRay ray0 = makeRay(org,Vec3fa(0,-1,0)); rtcIntersect(scene0,ray0);
+        RTCRay ray1 = makeRay(org,Vec3fa(0,-1,0)); rtcIntersect(scene1,ray1);
+        passed &= ray0.geomID == i && ray1.geomID == i && ray0.primID == ray1.primID && ray0.tfar == ray1.tfar;
+        RTCRay ray2 = makeRay(org,Vec3fa(0,-1,0)); rtcOccluded(scene1,ray2);
+        passed &= ray2.geomID == 0;
+      }
+    }
+    rtcDeleteScene (scene1);
+    AssertNoError();
+
+    /* loading into a scene with different geometries has to fail */
+    RTCScene scene2 = rtcDeviceNewScene(g_device,RTC_SCENE_STATIC,aflags);
+    for (size_t i=0; i<N-1; i++) addSphere(scene2,RTC_GEOMETRY_STATIC,pos[i],1.0f,20);
+    rtcLoadScene(scene2,fileName);
+    AssertError(RTC_INVALID_OPERATION);
+    rtcDeleteScene (scene2);
+
+    rtcDeleteScene (scene0);
+    remove(fileName);
+    clearBuffers();
+    AssertNoError();
+    return passed;
+  }
+
   bool rtcore_ray_masks_intersect(RTCSceneFlags sflags, RTCGeometryFlags gflags)
   {
     bool passed = true;
@@ -2479,6 +2590,201 @@ namespace embree
     return true;
   }
 
+  bool rtcore_high_quality_scene(size_t N)
+  {
+    /* large and strongly overlapping triangles trigger many spatial splits */
+    std::vector<Vec3fa> positions(3*N);
+    for (size_t i=0; i<3*N; i++)
+      positions[i] = Vec3fa(10.0f*drand48(),10.0f*drand48(),10.0f*drand48());
+
+    RTCScene scenes[2];
+    scenes[0] = rtcDeviceNewScene(g_device,RTC_SCENE_STATIC,aflags);
+    scenes[1] = rtcDeviceNewScene(g_device,RTCSceneFlags(RTC_SCENE_STATIC | RTC_SCENE_HIGH_QUALITY),aflags);
+    for (size_t s=0; s<2; s++)
+    {
+      unsigned mesh = rtcNewTriangleMesh (scenes[s], RTC_GEOMETRY_STATIC, N, 3*N);
+      Vertex3fa* vertices  = (Vertex3fa*) rtcMapBuffer(scenes[s],mesh,RTC_VERTEX_BUFFER);
+      Triangle*  triangles = (Triangle* ) rtcMapBuffer(scenes[s],mesh,RTC_INDEX_BUFFER);
+      for (size_t i=0; i<3*N; i++) {
+        vertices[i].x = positions[i].x; vertices[i].y = positions[i].y; vertices[i].z = positions[i].z;
+      }
+      for (size_t i=0; i<N; i++) {
+        triangles[i].v0 = 3*i+0; triangles[i].v1 = 3*i+1; triangles[i].v2 = 3*i+2;
+      }
+      rtcUnmapBuffer(scenes[s],mesh,RTC_VERTEX_BUFFER);
+      rtcUnmapBuffer(scenes[s],mesh,RTC_INDEX_BUFFER);
+      rtcCommit (scenes[s]);
+    }
+    AssertNoError();
+
+    /* spatial splits must not change the closest hits */
+    bool passed = true;
+    for (size_t i=0; i<1024; i++)
+    {
+      const Vec3fa org(-5.0f+20.0f*drand48(),-5.0f+20.0f*drand48(),-5.0f+20.0f*drand48());
+      const Vec3fa dir(2.0f*drand48()-1.0f,2.0f*drand48()-1.0f,2.0f*drand48()-1.0f);
+      RTCRay ray0 = makeRay(org,dir); rtcIntersect(scenes[0],ray0);
+      RTCRay ray1 = makeRay(org,dir); rtcIntersect(scenes[1],ray1);
+      passed &= ray0.geomID == ray1.geomID && ray0.primID == ray1.primID;
+      passed &= ray0.geomID == RTC_INVALID_GEOMETRY_ID || fabs(ray0.tfar-ray1.tfar) <= 1E-4f*ray0.tfar;
+      RTCRay ray2 = makeRay(org,dir); rtcOccluded(scenes[1],ray2);
+      passed &= (ray2.geomID == 0) == (ray0.geomID != RTC_INVALID_GEOMETRY_ID);
+    }
+
+    rtcDeleteScene (scenes[0]);
+    rtcDeleteScene (scenes[1]);
+    AssertNoError();
+    return passed;
+  }
+
+  bool rtcore_relayout_scene()
+  {
+    RTCScene scenes[2];
+    scenes[0] = rtcDeviceNewScene(g_device,RTC_SCENE_STATIC,aflags);
+    scenes[1] = rtcDeviceNewScene(g_device,RTCSceneFlags(RTC_SCENE_STATIC | RTC_SCENE_RELAYOUT),aflags);
+    for (size_t s=0; s<2; s++) {
+      for (size_t i=0; i<4; i++) 
+        addSphere(scenes[s],RTC_GEOMETRY_STATIC,Vec3fa(4.0f*i,0.0f,0.0f),2.0f,100);
+      addHair(scenes[s],RTC_GEOMETRY_STATIC,Vec3fa(0.0f,3.0f,0.0f),1.0f,0.1f,1000);
+      rtcCommit (scenes[s]);
+    }
+    AssertNoError();
+
+    /* the relayouted hierarchy has to report exactly the same hits */
+    bool passed = true;
+    for (size_t i=0; i<4096; i++)
+    {
+      const Vec3fa org(-4.0f+20.0f*drand48(),-4.0f+10.0f*drand48(),-10.0f);
+      const Vec3fa dir(0.2f*drand48()-0.1f,0.2f*drand48()-0.1f,1.0f);
+      RTCRay ray0 = makeRay(org,dir); rtcIntersect(scenes[0],ray0);
+      RTCRay ray1 = makeRay(org,dir); rtcIntersect(scenes[1],ray1);
+      passed &= ray0.geomID == ray1.geomID && ray0.primID == ray1.primID && ray0.tfar == ray1.tfar;
+      RTCRay ray2 = makeRay(org,dir); rtcOccluded(scenes[1],ray2);
+      passed &= (ray2.geomID == 0) == (ray0.geomID != RTC_INVALID_GEOMETRY_ID);
+    }
+
+    rtcDeleteScene (scenes[0]);
+    rtcDeleteScene (scenes[1]);
+    AssertNoError();
+    return passed;
+  }
+
+  bool rtcore_restructure_scene()
+  {
+    RTCScene scenes[2];
+    scenes[0] = rtcDeviceNewScene(g_device,RTC_SCENE_DYNAMIC,aflags);
+    scenes[1] = rtcDeviceNewScene(g_device,RTCSceneFlags(RTC_SCENE_DYNAMIC | RTC_SCENE_RESTRUCTURE),aflags);
+    for (size_t s=0; s<2; s++) {
+      for (size_t i=0; i<16; i++) {
+        const RTCGeometryFlags gflags = i%2 ? RTC_GEOMETRY_DYNAMIC : RTC_GEOMETRY_STATIC;
+        addSphere(scenes[s],gflags,Vec3fa(4.0f*(i%4),4.0f*(i/4),0.0f),1.5f,50);
+      }
+      rtcCommit (scenes[s]);
+    }
+    AssertNoError();
+
+    /* the restructured hierarchies have to report the same closest hits */
+    bool passed = true;
+    for (size_t i=0; i<4096; i++)
+    {
+      const Vec3fa org(-2.0f+16.0f*drand48(),-2.0f+16.0f*drand48(),-10.0f);
+      const Vec3fa dir(0.2f*drand48()-0.1f,0.2f*drand48()-0.1f,1.0f);
+      RTCRay ray0 = makeRay(org,dir); rtcIntersect(scenes[0],ray0);
+      RTCRay ray1 = makeRay(org,dir); rtcIntersect(scenes[1],ray1);
+      passed &= ray0.geomID == ray1.geomID && ray0.tfar == ray1.tfar;
+      RTCRay ray2 = makeRay(org,dir); rtcOccluded(scenes[1],ray2);
+      passed &= (ray2.geomID == 0) == (ray0.geomID != RTC_INVALID_GEOMETRY_ID);
+    }
+
+    rtcDeleteScene (scenes[0]);
+    rtcDeleteScene (scenes[1]);
+    AssertNoError();
+    return passed;
+  }
+
+  bool rtcore_hybrid_builder()
+  {
+    /* the dynamic mesh is large enough to get split into many clusters */
+    RTCScene scenes[2];
+    scenes[0] = rtcDeviceNewScene(g_device,RTC_SCENE_STATIC,aflags);
+    scenes[1] = rtcDeviceNewScene(g_device,RTC_SCENE_DYNAMIC,aflags);
+    addSphere(scenes[0],RTC_GEOMETRY_STATIC, zero,1.0f,100);
+    addSphere(scenes[1],RTC_GEOMETRY_DYNAMIC,zero,1.0f,100);
+    rtcCommit (scenes[0]);
+    rtcCommit (scenes[1]);
+    AssertNoError();
+
+    /* the hybrid and SAH hierarchies have to report the same hits */
+    bool passed = true;
+    for (size_t i=0; i<4096; i++)
+    {
+      const Vec3fa org(4.0f*drand48()-2.0f,4.0f*drand48()-2.0f,-4.0f);
+      const Vec3fa dir(0.0f,0.0f,1.0f);
+      RTCRay ray0 = makeRay(org,dir); rtcIntersect(scenes[0],ray0);
+      RTCRay ray1 = makeRay(org,dir); rtcIntersect(scenes[1],ray1);
+      passed &= ray0.geomID == ray1.geomID;
+      passed &= ray0.geomID == RTC_INVALID_GEOMETRY_ID || fabs(ray0.tfar-ray1.tfar) < 1E-4f;
+      RTCRay ray2 = makeRay(org,dir); rtcOccluded(scenes[1],ray2);
+      passed &= (ray2.geomID == 0) == (ray0.geomID != RTC_INVALID_GEOMETRY_ID);
+    }
+
+    rtcDeleteScene (scenes[0]);
+    rtcDeleteScene (scenes[1]);
+    AssertNoError();
+    return passed;
+  }
+
+  void traceDeviceConfigScenes(RTCDevice device, std::vector<RTCRay>& rays)
+  {
+    RTCScene scenes[2];
+    scenes[0] = rtcDeviceNewScene(device,RTC_SCENE_STATIC,aflags);
+    scenes[1] = rtcDeviceNewScene(device,RTC_SCENE_STATIC,aflags);
+    for (size_t s=0; s<2; s++) {
+      for (size_t i=0; i<4; i++) 
+        addSphere(scenes[s],RTC_GEOMETRY_STATIC,Vec3fa(4.0f*i,0.0f,0.0f),2.0f,100);
+    }
+    addHair(scenes[0],RTC_GEOMETRY_STATIC,Vec3fa(0.0f,3.0f,0.0f),1.0f,0.1f,1000);
+    rtcCommit (scenes[0]);
+    rtcCommit (scenes[1]);
+
+    for (size_t i=0; i<rays.size(); i++) {
+      if (i%3 == 0) rtcIntersect(scenes[0],rays[i]);
+      if (i%3 == 1) rtcOccluded (scenes[0],rays[i]);
+      if (i%3 == 2) rtcIntersect(scenes[1],rays[i]);
+    }
+
+    rtcDeleteScene (scenes[0]);
+    rtcDeleteScene (scenes[1]);
+  }
+
+  bool rtcore_device_config(const std::string& config)
+  {
+    std::vector<RTCRay> rays0, rays1;
+    for (size_t i=0; i<3*4096; i++) 
+    {
+      const Vec3fa org(-4.0f+20.0f*drand48(),-4.0f+10.0f*drand48(),-10.0f);
+      const Vec3fa dir(0.2f*drand48()-0.1f,0.2f*drand48()-0.1f,1.0f);
+      rays0.push_back(makeRay(org,dir));
+    }
+    rays1 = rays0;
+    traceDeviceConfigScenes(g_device,rays0);
+    AssertNoError();
+
+    /* only one device can exist at a time */
+    rtcDeleteDevice(g_device);
+    const std::string cfg = g_rtcore.empty() ? config : g_rtcore + "," + config;
+    g_device = rtcNewDevice(cfg.c_str());
+    traceDeviceConfigScenes(g_device,rays1);
+    bool passed = rtcDeviceGetError(g_device) == RTC_NO_ERROR;
+    rtcDeleteDevice(g_device);
+    g_device = rtcNewDevice(g_rtcore.c_str());
+
+    /* the configuration must not change any hits */
+    for (size_t i=0; i<rays0.size(); i++)
+      passed &= rays0[i].geomID == rays1[i].geomID && rays0[i].primID == rays1[i].primID && rays0[i].tfar == rays1[i].tfar;
+    return passed;
+  }
+
   bool rtcore_backface_culling (RTCSceneFlags sflags, RTCGeometryFlags gflags)
   {
     /* create triangle that is front facing for a right handed 
@@ -2546,6 +2852,635 @@ namespace embree
     numFailedTests += !passed;
   }
 
+  bool rtcore_ray_stream(RTCSceneFlags sflags, size_t M)
+  {
+    RTCScene scene = rtcDeviceNewScene(g_device,sflags,(RTCAlgorithmFlags)(aflags | RTC_INTERSECT_STREAM));
+    addSphere(scene,RTC_GEOMETRY_STATIC,Vec3fa(-1,0,0),1.0f,50);
+    addSphere(scene,RTC_GEOMETRY_STATIC,Vec3fa(+1,0,0),0.5f,50);
+    addHair  (scene,RTC_GEOMETRY_STATIC,Vec3fa(0,0,1),1.0f,0.5f,100);
+    rtcCommit (scene);
+    AssertNoError();
+
+    /* use a stride larger than the ray size */
+    const size_t stride = sizeof(RTCRay)+16;
+    char* stream0 = (char*) alignedMalloc(M*stride);
+    char* stream1 = (char*) alignedMalloc(M*stride);
+    std::vector<RTCRay> rays(M);
+    for (size_t i=0; i<M; i++) {
+      Vec3fa org(2.0f*drand48()-1.0f,2.0f*drand48()-1.0f,2.0f*drand48()-1.0f);
+      Vec3fa dir(2.0f*drand48()-1.0f,2.0f*drand48()-1.0f,2.0f*drand48()-1.0f);
+      rays[i] = makeRay(4.0f*org,dir);
+      *(RTCRay*)(stream0+i*stride) = rays[i];
+      *(RTCRay*)(stream1+i*stride) = rays[i];
+    }
+    rtcIntersect1M(scene,(RTCRay*)stream0,M,stride);
+    rtcOccluded1M (scene,(RTCRay*)stream1,M,stride);
+    AssertNoError();
+
+    /* same rays in struct of array layout */
+    std::vector<float> soa(15*M);
+    std::vector<int> ids(3*M), occludedIDs(M);
+    std::vector<float> occludedTfar(M);
+    RTCRayNp raysNp;
+    raysNp.orgx = &soa[0*M]; raysNp.orgy = &soa[1*M]; raysNp.orgz = &soa[2*M];
+    raysNp.dirx = &soa[3*M]; raysNp.diry = &soa[4*M]; raysNp.dirz = &soa[5*M];
+    raysNp.tnear = &soa[6*M]; raysNp.tfar = &soa[7*M]; 
+    raysNp.time = nullptr; raysNp.mask = nullptr;
+    raysNp.Ngx = &soa[8*M]; raysNp.Ngy = &soa[9*M]; raysNp.Ngz = &soa[10*M];
+    raysNp.u = &soa[11*M]; raysNp.v = &soa[12*M];
+    raysNp.geomID = &ids[0*M]; raysNp.primID = &ids[1*M]; raysNp.instID = &ids[2*M];
+    for (size_t l=0; l<RTC_MAX_INSTANCE_DEPTH-1; l++) raysNp.instIDPath[l] = nullptr;
+    for (size_t i=0; i<M; i++) {
+      raysNp.orgx[i] = rays[i].org[0]; raysNp.orgy[i] = rays[i].org[1]; raysNp.orgz[i] = rays[i].org[2];
+      raysNp.dirx[i] = rays[i].dir[0]; raysNp.diry[i] = rays[i].dir[1]; raysNp.dirz[i] = rays[i].dir[2];
+      raysNp.tnear[i] = rays[i].tnear; raysNp.tfar[i] = rays[i].tfar;
+      raysNp.geomID[i] = raysNp.primID[i] = raysNp.instID[i] = -1;
+    }
+    RTCRayNp occludedNp = raysNp;
+    occludedNp.tfar = &occludedTfar[0];
+    occludedNp.geomID = &occludedIDs[0];
+    for (size_t i=0; i<M; i++) {
+      occludedTfar[i] = rays[i].tfar;
+      occludedIDs[i] = -1;
+    }
+    rtcIntersectNp(scene,raysNp,M);
+    rtcOccludedNp(scene,occludedNp,M);
+    AssertNoError();
+
+    bool passed = true;
+    for (size_t i=0; i<M; i++) 
+    {
+      RTCRay ray0 = rays[i]; rtcIntersect(scene,ray0);
+      RTCRay ray1 = rays[i]; rtcOccluded (scene,ray1);
+      const RTCRay& hit0 = *(RTCRay*)(stream0+i*stride);
+      const RTCRay& hit1 = *(RTCRay*)(stream1+i*stride);
+      if (hit0.geomID != ray0.geomID || hit0.primID != ray0.primID) passed = false;
+      if (abs(hit0.tfar-ray0.tfar) > 1E-4f*max(1.0f,abs(ray0.tfar))) passed = false;
+      if (hit1.geomID != ray1.geomID) passed = false;
+      if (raysNp.geomID[i] != ray0.geomID || raysNp.primID[i] != ray0.primID) passed = false;
+      if (abs(raysNp.tfar[i]-ray0.tfar) > 1E-4f*max(1.0f,abs(ray0.tfar))) passed = false;
+      if (occludedIDs[i] != ray1.geomID) passed = false;
+    }
+
+    alignedFree(stream0);
+    alignedFree(stream1);
+    rtcDeleteScene (scene);
+    AssertNoError();
+    return passed;
+  }
+
+  bool rtcore_nested_instancing()
+  {
+    /* a sphere instanced twice in a cluster, the cluster instanced twice in the world */
+    RTCScene object = rtcDeviceNewScene(g_device,RTC_SCENE_STATIC,aflags);
+    addSphere(object,RTC_GEOMETRY_STATIC,zero,1.0f,50);
+    rtcCommit (object);
+    RTCScene cluster = rtcDeviceNewScene(g_device,RTC_SCENE_STATIC,aflags);
+    for (size_t i=0; i<2; i++) {
+      unsigned inst = rtcNewInstance(cluster,object);
+      const float xfm[12] = { 1,0,0, 0,1,0, 0,0,1, 4.0f*i,0,0 };
+      rtcSetTransform(cluster,inst,RTC_MATRIX_COLUMN_MAJOR,xfm);
+    }
+    rtcCommit (cluster);
+    RTCScene world = rtcDeviceNewScene(g_device,RTC_SCENE_STATIC,aflags);
+    for (size_t i=0; i<2; i++) {
+      unsigned inst = rtcNewInstance(world,cluster);
+      const float xfm[12] = { 1,0,0, 0,1,0, 0,0,1, 0,4.0f*i,0 };
+      rtcSetTransform(world,inst,RTC_MATRIX_COLUMN_MAJOR,xfm);
+    }
+    rtcCommit (world);
+    AssertNoError();
+
+    bool passed = true;
+    for (int y=0; y<2; y++) 
+    {
+      for (int x=0; x<2; x++) 
+      {
+        const RTCRay ray0 = makeRay(Vec3fa(4.0f*x,4.0f*y,-4.0f),Vec3fa(0,0,1));
+        auto check = [&] (int N) {
+          RTCRay ray = ray0; rtcIntersectN(world,ray,N);
+          if (ray.geomID != 0 || ray.instID != y || ray.instIDPath[0] != x) passed = false;
+          for (size_t l=1; l<RTC_MAX_INSTANCE_DEPTH-1; l++) 
+            if (ray.instIDPath[l] != -1) passed = false;
+        };
+        check(1);
+#if HAS_INTERSECT4
+        check(4);
+#endif
+#if HAS_INTERSECT8
+        if (hasISA(AVX)) check(8);
+#endif
+#if HAS_INTERSECT16
+        if (hasISA(AVX512F) || hasISA(KNC)) check(16);
+#endif
+      }
+    }
+
+    /* rays that miss keep their initial IDs */
+    RTCRay ray = makeRay(Vec3fa(2,2,-4),Vec3fa(0,0,1)); rtcIntersect(world,ray);
+    if (ray.geomID != -1 || ray.instID != -1 || ray.instIDPath[0] != -1) passed = false;
+
+    rtcDeleteScene (world);
+    rtcDeleteScene (cluster);
+    rtcDeleteScene (object);
+    AssertNoError();
+    return passed;
+  }
+
+  bool rtcore_instance_array()
+  {
+    RTCScene object = rtcDeviceNewScene(g_device,RTC_SCENE_STATIC,aflags);
+    addSphere(object,RTC_GEOMETRY_STATIC,zero,1.0f,50);
+    rtcCommit (object);
+    AssertNoError();
+
+    /* first array uses strided shared transforms and an ID buffer, second array mapped transforms only */
+    const size_t N = 1000;
+    struct Transform { float m[12]; float align[4]; };
+    std::vector<Transform> xfms(N);
+    std::vector<unsigned> ids(N);
+    for (size_t i=0; i<N; i++) {
+      const Transform xfm = { { 1,0,0, 0,1,0, 0,0,1, 4.0f*i,0,0 } };
+      xfms[i] = xfm;
+      ids[i] = 1000+i;
+    }
+    RTCScene world = rtcDeviceNewScene(g_device,RTC_SCENE_STATIC,aflags);
+    unsigned array0 = rtcNewInstanceArray(world,object,N);
+    rtcSetBuffer(world,array0,RTC_TRANSFORM_BUFFER,xfms.data(),0,sizeof(Transform));
+    rtcSetBuffer(world,array0,RTC_INSTANCE_ID_BUFFER,ids.data(),0,sizeof(unsigned));
+    unsigned array1 = rtcNewInstanceArray(world,object,N);
+    float* xfms1 = (float*) rtcMapBuffer(world,array1,RTC_TRANSFORM_BUFFER);
+    for (size_t i=0; i<N; i++) {
+      const float xfm[12] = { 1,0,0, 0,1,0, 0,0,1, 4.0f*i,4.0f,0 };
+      for (size_t j=0; j<12; j++) xfms1[12*i+j] = xfm[j];
+    }
+    rtcUnmapBuffer(world,array1,RTC_TRANSFORM_BUFFER);
+    AssertNoError();
+
+    /* transformations of arrays cannot get set individually */
+    const float xfm[12] = { 1,0,0, 0,1,0, 0,0,1, 0,0,0 };
+    rtcSetTransform(world,array1,RTC_MATRIX_COLUMN_MAJOR,xfm);
+    AssertError(RTC_INVALID_OPERATION);
+    rtcCommit (world);
+    AssertNoError();
+
+    bool passed = true;
+    for (size_t y=0; y<2; y++) 
+    {
+      for (size_t i=0; i<N; i+=7) 
+      {
+        const RTCRay ray0 = makeRay(Vec3fa(4.0f*i,4.0f*y,-4.0f),Vec3fa(0,0,1));
+        const int expectedID = y == 0 ? 1000+i : i;
+        auto check = [&] (int K) {
+          RTCRay ray = ray0; rtcIntersectN(world,ray,K);
+          if (ray.geomID != 0 || ray.instID != expectedID || ray.instIDPath[0] != -1) passed = false;
+          ray = ray0; rtcOccludedN(world,ray,K);
+          if (ray.geomID != 0) passed = false;
+        };
+        check(1);
+#if HAS_INTERSECT4
+        check(4);
+#endif
+#if HAS_INTERSECT8
+        if (hasISA(AVX)) check(8);
+#endif
+#if HAS_INTERSECT16
+        if (hasISA(AVX512F) || hasISA(KNC)) check(16);
+#endif
+      }
+    }
+
+    rtcDeleteScene (world);
+    rtcDeleteScene (object);
+    AssertNoError();
+    return passed;
+  }
+
+  bool rtcore_motion_blur_segments()
+  {
+    /* geometries move along x with alternating offsets at each timestep */
+    auto offset = [] (size_t numTimeSteps, float time) -> float {
+      const float t = time*float(numTimeSteps-1);
+      const size_t j = min(size_t(t),numTimeSteps-2);
+      const float f = t-float(j);
+      return (1.0f-f)*4.0f*float(j%2) + f*4.0f*float((j+1)%2);
+    };
+
+    RTCScene scene = rtcDeviceNewScene(g_device,RTC_SCENE_STATIC,aflags);
+    const size_t numTriangleTimeSteps[2] = { 5, 3 };
+    for (size_t i=0; i<2; i++) 
+    {
+      const size_t numTimeSteps = numTriangleTimeSteps[i];
+      unsigned mesh = rtcNewTriangleMesh(scene,RTC_GEOMETRY_STATIC,1,3,numTimeSteps);
+      int* triangles = (int*) rtcMapBuffer(scene,mesh,RTC_INDEX_BUFFER);
+      triangles[0] = 0; triangles[1] = 1; triangles[2] = 2;
+      rtcUnmapBuffer(scene,mesh,RTC_INDEX_BUFFER);
+      for (size_t t=0; t<numTimeSteps; t++) 
+      {
+        const float dx = offset(numTimeSteps,float(t)/float(numTimeSteps-1));
+        const float y = 10.0f*i;
+        Vec3fa* vertices = (Vec3fa*) rtcMapBuffer(scene,mesh,RTCBufferType(RTC_VERTEX_BUFFER0+t));
+        vertices[0] = Vec3fa(dx-1.0f,y-1.0f,0.0f);
+        vertices[1] = Vec3fa(dx+1.0f,y-1.0f,0.0f);
+        vertices[2] = Vec3fa(dx,     y+1.0f,0.0f);
+        rtcUnmapBuffer(scene,mesh,RTCBufferType(RTC_VERTEX_BUFFER0+t));
+      }
+    }
+    const size_t numHairTimeSteps = 4;
+    unsigned hair = rtcNewHairGeometry(scene,RTC_GEOMETRY_STATIC,1,4,numHairTimeSteps);
+    int* curves = (int*) rtcMapBuffer(scene,hair,RTC_INDEX_BUFFER);
+    curves[0] = 0;
+    rtcUnmapBuffer(scene,hair,RTC_INDEX_BUFFER);
+    for (size_t t=0; t<numHairTimeSteps; t++) 
+    {
+      const float dx = offset(numHairTimeSteps,float(t)/float(numHairTimeSteps-1));
+      Vec3fa* vertices = (Vec3fa*) rtcMapBuffer(scene,hair,RTCBufferType(RTC_VERTEX_BUFFER0+t));
+      for (size_t j=0; j<4; j++) vertices[j] = Vec3fa(dx,19.0f+2.0f*j/3.0f,0.0f,0.1f);
+      rtcUnmapBuffer(scene,hair,RTCBufferType(RTC_VERTEX_BUFFER0+t));
+    }
+
+    /* more than the maximal number of time steps is not supported */
+    rtcNewTriangleMesh(scene,RTC_GEOMETRY_STATIC,1,3,RTC_MAX_TIME_STEPS+1);
+    AssertError(RTC_INVALID_OPERATION);
+    rtcCommit (scene);
+    AssertNoError();
+
+    bool passed = true;
+    const size_t numTimeSteps[3] = { numTriangleTimeSteps[0], numTriangleTimeSteps[1], numHairTimeSteps };
+    const float times[9] = { 0.0f, 0.1f, 0.25f, 0.4f, 0.5f, 0.6f, 0.75f, 0.9f, 1.0f };
+    for (size_t g=0; g<3; g++) 
+    {
+      for (size_t i=0; i<9; i++) 
+      {
+        /* a ray through the geometry at its interpolated position hits, a ray next to it misses */
+        RTCRay hit = makeRay(Vec3fa(offset(numTimeSteps[g],times[i]),10.0f*g,-4.0f),Vec3fa(0,0,1)); hit.time = times[i];
+        RTCRay miss = makeRay(Vec3fa(offset(numTimeSteps[g],times[i])+2.0f,10.0f*g,-4.0f),Vec3fa(0,0,1)); miss.time = times[i];
+        auto check = [&] (int N) {
+          RTCRay ray = hit; rtcIntersectN(scene,ray,N);
+          if (ray.geomID != g) passed = false;
+          ray = hit; rtcOccludedN(scene,ray,N);
+          if (ray.geomID != 0) passed = false;
+          ray = miss; rtcIntersectN(scene,ray,N);
+          if (ray.geomID != -1) passed = false;
+        };
+        check(1);
+#if HAS_INTERSECT4
+        check(4);
+#endif
+#if HAS_INTERSECT8
+        if (hasISA(AVX)) check(8);
+#endif
+#if HAS_INTERSECT16
+        if (hasISA(AVX512F) || hasISA(KNC)) check(16);
+#endif
+      }
+    }
+
+#if HAS_INTERSECT4
+    /* rays of a packet with different times get traced through different time segments */
+    RTCRay4 ray4;
+    for (size_t i=0; i<4; i++) {
+      RTCRay ray = makeRay(Vec3fa(offset(5,times[2*i+1]),0.0f,-4.0f),Vec3fa(0,0,1)); ray.time = times[2*i+1];
+      setRay(ray4,i,ray);
+    }
+    __aligned(16) int valid[4] = { -1,-1,-1,-1 };
+    rtcIntersect4(valid,scene,ray4);
+    for (size_t i=0; i<4; i++) {
+      if (ray4.geomID[i] != 0) passed = false;
+      if (ray4.time[i] != times[2*i+1]) passed = false;
+    }
+#endif
+
+    rtcDeleteScene (scene);
+    AssertNoError();
+    return passed;
+  }
+
+  bool rtcore_motion_blur_instances()
+  {
+    /* instances move along x with alternating offsets at each timestep */
+    auto offset = [] (size_t numTimeSteps, float time) -> float {
+      const float t = time*float(numTimeSteps-1);
+      const size_t j = min(size_t(t),numTimeSteps-2);
+      const float f = t-float(j);
+      return (1.0f-f)*4.0f*float(j%2) + f*4.0f*float((j+1)%2);
+    };
+
+    RTCScene object = rtcDeviceNewScene(g_device,RTC_SCENE_STATIC,aflags);
+    unsigned mesh = rtcNewTriangleMesh(object,RTC_GEOMETRY_STATIC,1,3);
+    int* triangles = (int*) rtcMapBuffer(object,mesh,RTC_INDEX_BUFFER);
+    triangles[0] = 0; triangles[1] = 1; triangles[2] = 2;
+    rtcUnmapBuffer(object,mesh,RTC_INDEX_BUFFER);
+    Vec3fa* vertices = (Vec3fa*) rtcMapBuffer(object,mesh,RTC_VERTEX_BUFFER);
+    vertices[0] = Vec3fa(-1.0f,-1.0f,0.0f);
+    vertices[1] = Vec3fa(+1.0f,-1.0f,0.0f);
+    vertices[2] = Vec3fa( 0.0f,+1.0f,0.0f);
+    rtcUnmapBuffer(object,mesh,RTC_VERTEX_BUFFER);
+    rtcCommit (object);
+    AssertNoError();
+
+    /* first instance uses a single motion segment, second one several, third one does not move */
+    RTCScene world = rtcDeviceNewScene(g_device,RTC_SCENE_STATIC,aflags);
+    const size_t numTimeSteps[3] = { 2, 5, 1 };
+    unsigned instances[3];
+    for (size_t i=0; i<3; i++) 
+    {
+      instances[i] = rtcNewInstance2(world,object,numTimeSteps[i]);
+      for (size_t t=0; t<numTimeSteps[i]; t++) {
+        const float dx = numTimeSteps[i] == 1 ? 0.0f : offset(numTimeSteps[i],float(t)/float(numTimeSteps[i]-1));
+        const float xfm[12] = { 1,0,0, 0,1,0, 0,0,1, dx,10.0f*i,0 };
+        rtcSetTransform2(world,instances[i],RTC_MATRIX_COLUMN_MAJOR,xfm,t);
+      }
+      AssertNoError();
+    }
+
+    /* only existing timesteps can get set */
+    const float xfm[12] = { 1,0,0, 0,1,0, 0,0,1, 0,0,0 };
+    rtcSetTransform2(world,instances[0],RTC_MATRIX_COLUMN_MAJOR,xfm,2);
+    AssertError(RTC_INVALID_OPERATION);
+
+    /* more than the maximal number of time steps is not supported */
+    rtcNewInstance2(world,object,RTC_MAX_TIME_STEPS+1);
+    AssertError(RTC_INVALID_OPERATION);
+    rtcCommit (world);
+    AssertNoError();
+
+    bool passed = true;
+    const float times[9] = { 0.0f, 0.1f, 0.25f, 0.4f, 0.5f, 0.6f, 0.75f, 0.9f, 1.0f };
+    for (size_t g=0; g<3; g++) 
+    {
+      for (size_t i=0; i<9; i++) 
+      {
+        /* a ray through the instance at its interpolated position hits, a ray next to it misses */
+        const float dx = numTimeSteps[g] == 1 ? 0.0f : offset(numTimeSteps[g],times[i]);
+        RTCRay hit = makeRay(Vec3fa(dx,10.0f*g,-4.0f),Vec3fa(0,0,1)); hit.time = times[i];
+        RTCRay miss = makeRay(Vec3fa(dx+2.0f,10.0f*g,-4.0f),Vec3fa(0,0,1)); miss.time = times[i];
+        auto check = [&] (int N) {
+          RTCRay ray = hit; rtcIntersectN(world,ray,N);
+          if (ray.geomID != mesh || ray.instID != instances[g]) passed = false;
+          ray = hit; rtcOccludedN(world,ray,N);
+          if (ray.geomID != 0) passed = false;
+          ray = miss; rtcIntersectN(world,ray,N);
+          if (ray.geomID != -1) passed = false;
+        };
+        check(1);
+#if HAS_INTERSECT4
+        check(4);
+#endif
+#if HAS_INTERSECT8
+        if (hasISA(AVX)) check(8);
+#endif
+#if HAS_INTERSECT16
+        if (hasISA(AVX512F) || hasISA(KNC)) check(16);
+#endif
+      }
+    }
+
+#if HAS_INTERSECT4
+    /* rays of a packet with different times see the instance at different positions */
+    RTCRay4 ray4;
+    for (size_t i=0; i<4; i++) {
+      RTCRay ray = makeRay(Vec3fa(offset(5,times[2*i+1]),10.0f,-4.0f),Vec3fa(0,0,1)); ray.time = times[2*i+1];
+      setRay(ray4,i,ray);
+    }
+    __aligned(16) int valid[4] = { -1,-1,-1,-1 };
+    rtcIntersect4(valid,world,ray4);
+    for (size_t i=0; i<4; i++) {
+      if (ray4.geomID[i] != mesh || ray4.instID[i] != instances[1]) passed = false;
+      if (ray4.time[i] != times[2*i+1]) passed = false;
+    }
+#endif
+
+    rtcDeleteScene (world);
+    rtcDeleteScene (object);
+    AssertNoError();
+    return passed;
+  }
+
+  bool rtcore_quad_mesh()
+  {
+    /* unit quads next to each other, each quad gets split into the triangles (v0,v1,v3) and (v2,v3,v1) */
+    const size_t N = 16;
+    RTCScene scene = rtcDeviceNewScene(g_device,RTC_SCENE_STATIC,(RTCAlgorithmFlags)(aflags | RTC_INTERPOLATE));
+    unsigned mesh = rtcNewQuadMesh(scene,RTC_GEOMETRY_STATIC,N,4*N);
+    int* quads = (int*) rtcMapBuffer(scene,mesh,RTC_INDEX_BUFFER);
+    Vec3fa* vertices = (Vec3fa*) rtcMapBuffer(scene,mesh,RTC_VERTEX_BUFFER);
+    for (size_t i=0; i<N; i++) {
+      for (size_t j=0; j<4; j++) quads[4*i+j] = 4*i+j;
+      vertices[4*i+0] = Vec3fa(2.0f*i+0.0f,0.0f,0.0f);
+      vertices[4*i+1] = Vec3fa(2.0f*i+1.0f,0.0f,0.0f);
+      vertices[4*i+2] = Vec3fa(2.0f*i+1.0f,1.0f,0.0f);
+      vertices[4*i+3] = Vec3fa(2.0f*i+0.0f,1.0f,0.0f);
+    }
+    rtcUnmapBuffer(scene,mesh,RTC_VERTEX_BUFFER);
+    rtcUnmapBuffer(scene,mesh,RTC_INDEX_BUFFER);
+
+    /* quad meshes support only a single time step */
+    rtcNewQuadMesh(scene,RTC_GEOMETRY_STATIC,1,4,2);
+    AssertError(RTC_INVALID_OPERATION);
+    rtcCommit (scene);
+    AssertNoError();
+
+    bool passed = true;
+    const float uvs[4][2] = { { 0.25f, 0.25f }, { 0.75f, 0.75f }, { 0.2f, 0.7f }, { 0.9f, 0.4f } };
+    for (size_t i=0; i<N; i++)
+    {
+      for (size_t j=0; j<4; j++)
+      {
+        /* for unit quads the hit coordinates equal the position inside the quad */
+        const float u = uvs[j][0], v = uvs[j][1];
+        const RTCRay hit  = makeRay(Vec3fa(2.0f*i+u,v,-1.0f),Vec3fa(0,0,1));
+        const RTCRay miss = makeRay(Vec3fa(2.0f*i+1.0f+u,v,-1.0f),Vec3fa(0,0,1));
+        auto check = [&] (int K) {
+          RTCRay ray = hit; rtcIntersectN(scene,ray,K);
+          if (ray.geomID != mesh || ray.primID != i) passed = false;
+          if (abs(ray.u-u) > 1E-4f || abs(ray.v-v) > 1E-4f || abs(ray.tfar-1.0f) > 1E-4f) passed = false;
+          ray = hit; rtcOccludedN(scene,ray,K);
+          if (ray.geomID != 0) passed = false;
+          ray = miss; rtcIntersectN(scene,ray,K);
+          if (ray.geomID != -1) passed = false;
+        };
+        check(1);
+#if HAS_INTERSECT4
+        check(4);
+#endif
+#if HAS_INTERSECT8
+        if (hasISA(AVX)) check(8);
+#endif
+#if HAS_INTERSECT16
+        if (hasISA(AVX512F) || hasISA(KNC)) check(16);
+#endif
+        /* interpolation uses the same parametrization as the intersector */
+        float P[3], dPdu[3], dPdv[3];
+        rtcInterpolate(scene,mesh,i,u,v,RTC_VERTEX_BUFFER,P,dPdu,dPdv,3);
+        if (abs(P[0]-(2.0f*i+u)) > 1E-4f || abs(P[1]-v) > 1E-4f || abs(P[2]) > 1E-4f) passed = false;
+        if (abs(dPdu[0]-1.0f) > 1E-4f || abs(dPdv[1]-1.0f) > 1E-4f) passed = false;
+      }
+    }
+
+    rtcDeleteScene (scene);
+    AssertNoError();
+    return passed;
+  }
+
+  bool rtcore_point_geometry(RTCSceneFlags sflags)
+  {
+    /* spheres of growing radius next to each other */
+    const size_t N = 16;
+    RTCScene scene = rtcDeviceNewScene(g_device,sflags,aflags);
+    unsigned points = rtcNewPointGeometry(scene,RTC_GEOMETRY_STATIC,N);
+    Vec3fa* vertices = (Vec3fa*) rtcMapBuffer(scene,points,RTC_VERTEX_BUFFER);
+    for (size_t i=0; i<N; i++) {
+      vertices[i] = Vec3fa(3.0f*i,0.0f,0.0f);
+      vertices[i].w = 0.5f+0.05f*i;
+    }
+    rtcUnmapBuffer(scene,points,RTC_VERTEX_BUFFER);
+
+    /* sphere moving along x over 3 time steps */
+    unsigned moving = rtcNewPointGeometry(scene,RTC_GEOMETRY_STATIC,1,3);
+    const float xs[3] = { 0.0f, 2.0f, 2.0f };
+    for (size_t t=0; t<3; t++) {
+      Vec3fa* v = (Vec3fa*) rtcMapBuffer(scene,moving,RTCBufferType(RTC_VERTEX_BUFFER0+t));
+      v[0] = Vec3fa(xs[t],10.0f,0.0f); v[0].w = 0.5f;
+      rtcUnmapBuffer(scene,moving,RTCBufferType(RTC_VERTEX_BUFFER0+t));
+    }
+    rtcCommit (scene);
+    AssertNoError();
+
+    bool passed = true;
+    auto check = [&] (int K) 
+    {
+      for (size_t i=0; i<N; i++)
+      {
+        const float r = 0.5f+0.05f*i;
+        RTCRay ray = makeRay(Vec3fa(3.0f*i,0.0f,-5.0f),Vec3fa(0,0,1)); rtcIntersectN(scene,ray,K);
+        if (ray.geomID != points || ray.primID != i) passed = false;
+        if (abs(ray.tfar-(5.0f-r)) > 1E-4f || abs(ray.Ng[2]+r) > 1E-4f) passed = false;
+        ray = makeRay(Vec3fa(3.0f*i,0.0f,-5.0f),Vec3fa(0,0,1)); rtcOccludedN(scene,ray,K);
+        if (ray.geomID != 0) passed = false;
+        ray = makeRay(Vec3fa(3.0f*i+1.5f,0.0f,-5.0f),Vec3fa(0,0,1)); rtcIntersectN(scene,ray,K);
+        if (ray.geomID != -1) passed = false;
+      }
+      
+      /* the moving sphere is at x=1 at time 0.25 and at x=2 at time 0.75 */
+      RTCRay ray = makeRay(Vec3fa(1.0f,10.0f,-5.0f),Vec3fa(0,0,1)); ray.time = 0.25f; rtcIntersectN(scene,ray,K);
+      if (ray.geomID != moving || abs(ray.tfar-4.5f) > 1E-4f) passed = false;
+      ray = makeRay(Vec3fa(1.0f,10.0f,-5.0f),Vec3fa(0,0,1)); ray.time = 0.75f; rtcIntersectN(scene,ray,K);
+      if (ray.geomID != -1) passed = false;
+    };
+    check(1);
+#if HAS_INTERSECT4
+    check(4);
+#endif
+#if HAS_INTERSECT8
+    if (hasISA(AVX)) check(8);
+#endif
+#if HAS_INTERSECT16
+    if (hasISA(AVX512F) || hasISA(KNC)) check(16);
+#endif
+
+    rtcDeleteScene (scene);
+    AssertNoError();
+    return passed;
+  }
+
+  template<typename RTCRayK, int K>
+    void traceRaysK(void (*trace)(const void*, RTCScene, RTCRayK&), RTCScene scene, RTCRay* rays)
+  {
+    RTCRayK rayK;
+    for (size_t i=0; i<K; i++) setRay(rayK,i,rays[i]);
+    __aligned(64) int valid[K];
+    for (size_t i=0; i<K; i++) valid[i] = (i%3 == 2) ? 0 : -1;
+    trace(valid,scene,rayK);
+    for (size_t i=0; i<K; i++) if (valid[i]) rays[i] = getRay(rayK,i);
+  }
+
+  bool rtcore_mixed_toplevel()
+  {
+    /* a scene with different geometry types has to find the closest hit of the scenes with the individual geometries */
+    RTCScene scenes[5];
+    for (size_t i=0; i<5; i++) 
+    {
+      RTCScene scene = scenes[i] = rtcDeviceNewScene(g_device,RTC_SCENE_STATIC,aflags);
+      if (i == 0 || i == 1) addSphere(scene,RTC_GEOMETRY_STATIC,Vec3fa(-1,0,0),1.0f,50);
+      if (i == 0 || i == 2) addSphere(scene,RTC_GEOMETRY_STATIC,Vec3fa(+1,0,0),0.5f,50,-1,0.5f);
+      if (i == 0 || i == 3) addSubdivPlane(scene,RTC_GEOMETRY_STATIC,4,Vec3fa(-2,-1,-2),Vec3fa(4,0,0),Vec3fa(0,0,4));
+      if (i == 0 || i == 4) addHair(scene,RTC_GEOMETRY_STATIC,Vec3fa(0,0,1),1.0f,0.5f,100);
+      rtcCommit (scene);
+    }
+    AssertNoError();
+
+    bool passed = true;
+    for (size_t i=0; i<256; i++)
+    {
+      RTCRay rays[5][2][16];
+      for (size_t k=0; k<16; k++) {
+        Vec3fa org(2.0f*drand48()-1.0f,2.0f*drand48()-1.0f,2.0f*drand48()-1.0f);
+        Vec3fa dir(2.0f*drand48()-1.0f,2.0f*drand48()-1.0f,2.0f*drand48()-1.0f);
+        const float time = drand48();
+        for (size_t j=0; j<5; j++) {
+          rays[j][0][k] = rays[j][1][k] = makeRay(4.0f*org,dir);
+          rays[j][0][k].time = rays[j][1][k].time = time;
+        }
+      }
+      for (size_t j=0; j<5; j++) 
+      {
+        switch (i%4) {
+        case 0: 
+          for (size_t k=0; k<16; k++) {
+            rtcIntersect(scenes[j],rays[j][0][k]);
+            rtcOccluded (scenes[j],rays[j][1][k]);
+          }
+          break;
+#if HAS_INTERSECT4
+        case 1: 
+          for (size_t k=0; k<16; k+=4) {
+            traceRaysK<RTCRay4,4>(rtcIntersect4,scenes[j],&rays[j][0][k]);
+            traceRaysK<RTCRay4,4>(rtcOccluded4, scenes[j],&rays[j][1][k]);
+          }
+          break;
+#endif
+#if HAS_INTERSECT8
+        case 2: 
+          if (!hasISA(AVX)) break;
+          for (size_t k=0; k<16; k+=8) {
+            traceRaysK<RTCRay8,8>(rtcIntersect8,scenes[j],&rays[j][0][k]);
+            traceRaysK<RTCRay8,8>(rtcOccluded8, scenes[j],&rays[j][1][k]);
+          }
+          break;
+#endif
+#if HAS_INTERSECT16
+        case 3: 
+          if (!hasISA(AVX512F) && !hasISA(KNC)) break;
+          traceRaysK<RTCRay16,16>(rtcIntersect16,scenes[j],&rays[j][0][0]);
+          traceRaysK<RTCRay16,16>(rtcOccluded16, scenes[j],&rays[j][1][0]);
+          break;
+#endif
+        default: break;
+        }
+      }
+      for (size_t k=0; k<16; k++) 
+      {
+        /* the geometry of the mixed scene with ID g is the only geometry of scene g+1 */
+        int geomID = -1, primID = -1; float tfar = inf; bool occluded = false;
+        for (size_t j=1; j<5; j++) {
+          const RTCRay& ray = rays[j][0][k];
+          occluded |= rays[j][1][k].geomID == 0;
+          if (ray.geomID == -1 || ray.tfar >= tfar) continue;
+          geomID = j-1; primID = ray.primID; tfar = ray.tfar;
+        }
+        const RTCRay& ray = rays[0][0][k];
+        if (ray.geomID != geomID || ray.primID != primID) passed = false;
+        if (geomID != -1 && abs(ray.tfar-tfar) > 1E-4f*max(1.0f,abs(tfar))) passed = false;
+        if ((rays[0][1][k].geomID == 0) != occluded) passed = false;
+      }
+    }
+
+    for (size_t i=0; i<5; i++) rtcDeleteScene (scenes[i]);
+    AssertNoError();
+    return passed;
+  }
+
   bool rtcore_new_delete_geometry()
   {
     RTCScene scene = rtcDeviceNewScene(g_device,RTC_SCENE_DYNAMIC,aflags);
@@ -3622,9 +4557,29 @@ namespace embree
 
     POSITIVE("update_deformable",         rtcore_update(RTC_GEOMETRY_DEFORMABLE));
     POSITIVE("update_dynamic",            rtcore_update(RTC_GEOMETRY_DYNAMIC));
+    POSITIVE("update_twolevel",           rtcore_update_twolevel());
+    POSITIVE("save_load_scene",           rtcore_save_load_scene());
     POSITIVE("overlapping_triangles",     rtcore_overlapping_triangles(100000));
     POSITIVE("overlapping_hair",          rtcore_overlapping_hair(100000));
+    POSITIVE("high_quality_scene",        rtcore_high_quality_scene(10000));
+    POSITIVE("relayout_scene",            rtcore_relayout_scene());
+    POSITIVE("restructure_scene",         rtcore_restructure_scene());
+    POSITIVE("hybrid_builder",            rtcore_hybrid_builder());
+    POSITIVE("numa_replication",          rtcore_device_config("numa_replication=1")); // also creates a replica on single node systems
+    POSITIVE("hugepages_on",              rtcore_device_config("hugepages=on"));
+    POSITIVE("hugepages_off",             rtcore_device_config("hugepages=off"));
     POSITIVE("new_delete_geometry",       rtcore_new_delete_geometry());
+    POSITIVE("nested_instancing",         rtcore_nested_instancing());
+    POSITIVE("instance_array",            rtcore_instance_array());
+    POSITIVE("motion_blur_segments",      rtcore_motion_blur_segments());
+    POSITIVE("motion_blur_instances",     rtcore_motion_blur_instances());
+    POSITIVE("quad_mesh",                 rtcore_quad_mesh());
+    POSITIVE("point_geometry_static",     rtcore_point_geometry(RTC_SCENE_STATIC));
+    POSITIVE("point_geometry_dynamic",    rtcore_point_geometry(RTC_SCENE_DYNAMIC));
+    POSITIVE("mixed_toplevel",            rtcore_mixed_toplevel());
+    POSITIVE("ray_stream_static",         rtcore_ray_stream(RTC_SCENE_STATIC,1001));
+    POSITIVE("ray_stream_dynamic",        rtcore_ray_stream(RTC_SCENE_DYNAMIC,1001));
+    POSITIVE("ray_stream_reorder",        rtcore_ray_stream(RTCSceneFlags(RTC_SCENE_STATIC | RTC_SCENE_REORDER_RAYS),1001));
 
     POSITIVE("interpolate_subdiv4",                rtcore_interpolate_subdiv(4));
     POSITIVE("interpolate_subdiv5",                rtcore_interpolate_subdiv(5));
@@ -33,6 +33,9 @@
 
 #include "../../../common/simd/simd.h"
 
+/*! maximal supported instance nesting depth, has to match rtcore_ray.h */
+#define RTC_MAX_INSTANCE_DEPTH 4
+
   /*! Ray structure. Contains all information about a ray including
    *  precomputed reciprocal direction. */
   struct RTCRay
@@ -65,6 +68,7 @@
     int geomID;           //!< geometry ID
     int primID;           //!< primitive ID
     int instID;           //!< instance ID
+    int instIDPath[RTC_MAX_INSTANCE_DEPTH-1]; //!< instance IDs of nested instances below instID
   };
 
   /*! Outputs ray to stream. */
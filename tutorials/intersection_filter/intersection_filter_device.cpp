@@ -100,6 +100,7 @@ struct RTCRay2
   int geomID;    //!< geometry ID
   int primID;    //!< primitive ID
   int instID;    //!< instance ID
+  int instIDPath[RTC_MAX_INSTANCE_DEPTH-1]; //!< instance IDs of nested instances below instID
 
   // ray extensions
   float transparency; //!< accumulated transparency value